@@ -2319,6 +2319,9 @@ bool CBotIndexExpr::ExecuteVar(CBotVar* &pVar, CBotStack* &pile, CBotToken* prev
 
     int n = p->GetValInt();     // position in the table
 
+    // arrays are instances too, they may be shared with the other programs
+    if (pile->IfExtern()) return false;
+
     pVar = (static_cast<CBotVarArray*>(pVar))->GetItem(n, bExtend);
     if (pVar == nullptr)
     {
@@ -2326,6 +2329,7 @@ bool CBotIndexExpr::ExecuteVar(CBotVar* &pVar, CBotStack* &pile, CBotToken* prev
         return pj->Return(pile);
     }
 
+    if (pile->IfExtern(pVar)) return false;
     pVar->Maj(pile->GetPUser(), true);
 
     if ( m_next3 != nullptr &&
@@ -2410,6 +2414,11 @@ bool CBotFieldExpr::ExecuteVar(CBotVar* &pVar, CBotStack* &pile, CBotToken* prev
         pile->SetError(TX_NULLPT, prevToken);
         return pj->Return(pile);
     }
+
+    // the instance may be shared with the other programs,
+    // through static variables or an instance given to them
+    if (pile->IfExtern()) return false;
+
     if (pItem->GetUserPtr() == OBJECTDELETED)
     {
         pile->SetError(TX_DELETEDPT, prevToken);
@@ -2433,6 +2442,7 @@ bool CBotFieldExpr::ExecuteVar(CBotVar* &pVar, CBotStack* &pile, CBotToken* prev
     }
 
     // request the update of the element, if applicable
+    if (pile->IfExtern(pVar)) return false;
     pVar->Maj(pile->GetPUser(), true);
 
     if ( m_next3 != nullptr &&
@@ -2461,6 +2471,7 @@ CBotLeftExpr::CBotLeftExpr()
 {
     name    = "CBotLeftExpr";
     m_nIdent = 0;
+    m_varIndex = -1;
 }
 
 CBotLeftExpr::~CBotLeftExpr()
@@ -2517,6 +2528,7 @@ CBotLeftExpr* CBotLeftExpr::Compile(CBotToken* &p, CBotCStack* pStack)
                 var = var->GetItem(p->GetString());
                 i->SetUniqNum(var->GetUniqNum());
             }
+            inst->m_varIndex = pStk->GetVarIndex(inst->m_nIdent);
             p = p->GetNext();   // next token
 
             while (true)
@@ -2651,7 +2663,7 @@ bool CBotLeftExpr::ExecuteVar(CBotVar* &pVar, CBotStack* &pile, CBotToken* prevT
 {
     pile = pile->AddStack(this);
 
-    pVar = pile->FindVar(m_nIdent);
+    pVar = pile->FindVar(m_nIdent, m_varIndex);
     if (pVar == nullptr)
     {
 #ifdef    _DEBUG
@@ -3048,6 +3060,7 @@ CBotExprVar::CBotExprVar()
 {
     name    = "CBotExprVar";
     m_nIdent = 0;
+    m_varIndex = -1;
 }
 
 CBotExprVar::~CBotExprVar()
@@ -3096,6 +3109,8 @@ CBotInstr* CBotExprVar::Compile(CBotToken* &p, CBotCStack* pStack, int privat)
                 inst->AddNext3(i);  // added after
             }
 
+            (static_cast<CBotExprVar*>(inst))->m_varIndex = pStk->GetVarIndex((static_cast<CBotExprVar*>(inst))->m_nIdent);
+
             p = p->GetNext();   // next token
 
             while (true)
@@ -3206,6 +3221,7 @@ CBotInstr* CBotExprVar::CompileMethode(CBotToken* &p, CBotCStack* pStack)
 
         inst->SetToken(&pthis);
         (static_cast<CBotExprVar*>(inst))->m_nIdent = -2;    // ident for this
+        (static_cast<CBotExprVar*>(inst))->m_varIndex = pStk->GetVarIndex(-2);
 
         CBotToken* pp = p;
 
@@ -3292,7 +3308,7 @@ bool CBotExprVar::ExecuteVar(CBotVar* &pVar, CBotStack* &pj, CBotToken* prevToke
 
     if (bStep && m_nIdent>0 && pj->IfStep()) return false;
 
-    pVar = pj->FindVar(m_nIdent, true);     // tries with the variable update if necessary
+    pVar = pj->FindVar(m_nIdent, m_varIndex);
     if (pVar == nullptr)
     {
 #ifdef    _DEBUG
@@ -3301,6 +3317,8 @@ bool CBotExprVar::ExecuteVar(CBotVar* &pVar, CBotStack* &pj, CBotToken* prevToke
         pj->SetError(1, &m_token);
         return false;
     }
+    if (pj->IfExtern(pVar)) return false;
+    pVar->Maj(pj->GetPUser(), false);       // tries with the variable update if necessary
     if ( m_next3 != nullptr &&
          !m_next3->ExecuteVar(pVar, pj, &m_token, bStep, false) )
             return false;   // field of an instance, table, methode
@@ -61,6 +61,25 @@ class CBotDefParam; // paramerer list of a function
 // Management of the execution stack
 ////////////////////////////////////////////////////////////////////////
 
+/**\struct CBotRunContext
+ * \brief State shared by all levels of one execution stack.
+ * \brief It is owned by the first level of the stack (see CBotStack::FirstStack)
+ * \brief so that independent programs can be executed on different threads.*/
+struct CBotRunContext
+{
+    int             error = 0;                  // error number, <0 for break/continue/return
+    int             start = 0;                  // position of the error
+    int             end = 0;
+    CBotVar*        retvar = nullptr;           // result of a return
+    int             initimer = 0;               // number of steps per Run()
+    int             timer = 0;                  // steps left in current Run()
+    CBotString      labelBreak;                 // label of the current break/continue
+    void*           pUser = nullptr;            // user of the running program
+    bool            noExtern = false;           // stop before anything outside of the program
+    bool            externWait = false;         // stopped for this reason
+    bool            replay = false;             // going back to the point where it stopped
+};
+
 // actually, externally, the only thing it can do
 // is to create an instance of a stack
 // to use for routine CBotProgram :: Execute (CBotStack)
@@ -186,6 +205,18 @@ public:
     CBotVar* FindVar(long ident, bool bUpdate = false,
                                         bool bModif  = false);
 
+    /**
+     * \brief Fetch a variable at its known position on the stack
+     * \brief This avoids comparing all the variables of the enclosing blocks.
+     * \brief The position is first given by CBotCStack::GetVarIndex(). If the variable
+     * \brief is not there, it is searched by its identification number and the position
+     * \brief where it was found is kept for the next time
+     * \param [in] ident Identifier of a variable
+     * \param [in,out] index (depth << 16 | position in the block), or -1 if unknown
+     * \return Found variable
+     */
+    CBotVar* FindVar(long ident, std::atomic<int>& index);
+
     /**
      * \brief Find variable by its token and returns a copy of it.
      * \param Token Token upon which search is performed
@@ -214,6 +245,7 @@ public:
     int                GetState();                                            // in what state am I?
     bool            IncState(int lim = -10);                            // passes to the next state
     bool            IfStep();                                            // do step by step
+    bool            IfExtern(CBotVar* pVar = nullptr);                    // stop before an external access?
     bool            Execute();
 
     void            SetVar( CBotVar* var );
@@ -243,7 +275,11 @@ public:
     bool            RestoreState(FILE* pf, CBotStack* &pStack);
 
     static
-    void            SetTimer(int n);
+    void            SetTimer(int n);                                    // default number of steps per Run()
+    void            SetRunTimer(int n);                                    // number of steps for this stack only
+    void            SetNoExtern(bool bStop = false);                    // see CBotProgram::RunUntilExtern()
+    bool            IsWaitingExtern();
+    void            Resume(void* pUser);                                // continues after IfExtern() with the same timer
 
     void            GetRunPos(const char* &FunctionName, int &start, int &end);
     CBotVar*        GetStackVars(const char* &FunctionName, int level);
@@ -261,11 +297,7 @@ private:
 #endif
     int                m_state;
     int                m_step;
-    static int        m_error;
-    static int        m_start;
-    static int        m_end;
-    static
-    CBotVar*        m_retvar;                    // result of a return
+    CBotRunContext*    m_context;                    // shared by all levels of the stack
 
     CBotVar*        m_var;                        // result of the operations
     CBotVar*        m_listVar;                    // variables declared at this level
@@ -275,15 +307,6 @@ private:
 //    bool            m_bDontDelete;                // special, not to destroy the variable during delete
     CBotProgram*    m_prog;                        // user-defined functions
 
-    static
-    int                m_initimer;
-    static
-    int                m_timer;
-    static
-    CBotString        m_labelBreak;
-    static
-    void*            m_pUser;
-
     CBotInstr*        m_instr;                    // the corresponding instruction
     bool            m_bFunc;                    // an input of a function?
     CBotCall*        m_call;                        // recovery point in a extern call
@@ -294,7 +317,7 @@ private:
 
 inline bool CBotStack::IsOk()
 {
-    return (m_error == 0);
+    return (m_context->error == 0);
 }
 
 inline int CBotStack::GetState()
@@ -304,7 +327,7 @@ inline int CBotStack::GetState()
 
 inline int CBotStack::GetError()
 {
-    return m_error;
+    return m_context->error;
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -351,6 +374,7 @@ public:
     void            AddVar(CBotVar* p);            // adds a local variable
     CBotVar*        FindVar(CBotToken* &p);        // finds a variable
     CBotVar*        FindVar(CBotToken& Token);
+    int             GetVarIndex(long ident);    // position of a variable, for CBotStack::FindVar
     bool            CheckVarLocal(CBotToken* &pToken);
     CBotVar*        CopyVar(CBotToken& Token);    // finds and makes a copy
 
@@ -816,6 +840,7 @@ class CBotLeftExpr : public CBotInstr
 {
 private:
     long        m_nIdent;
+    std::atomic<int> m_varIndex;    // position of the variable on the stack
 
 public:
                 CBotLeftExpr();
@@ -1057,6 +1082,7 @@ class CBotExprVar : public CBotInstr
 {
 private:
     long        m_nIdent;
+    std::atomic<int> m_varIndex;    // position of the variable on the stack
     friend class CBotPostIncExpr;
     friend class CBotPreIncExpr;
 
@@ -1385,7 +1411,7 @@ private:
     CBotVar*        m_pVar;            // contents
     friend class    CBotVar;        // my daddy is a buddy WHAT? :D(\TODO mon papa est un copain )
     friend class    CBotVarPointer;    // and also the pointer
-    int                m_CptUse;        // counter usage
+    std::atomic<int>    m_CptUse;        // counter usage, instances can be shared between programs
     long            m_ItemIdent;    // identifier (unique) of an instance
     bool            m_bConstructor;    // set if a constructor has been called
 
@@ -1517,6 +1543,9 @@ extern bool ReadType(FILE* pf, CBotTypResult& type);
 
 extern float GetNumFloat( const char* p );
 
+// signals a change in the definitions known to the compiler (see CBotProgram::GetDefinitionVersion)
+extern void IncDefinitionVersion();
+
 #if 0
 extern void DEBUG( const char* text, int val, CBotStack* pile );
 #endif
@@ -1528,7 +1557,7 @@ class CBotCall
 {
 private:
     static
-    CBotCall*    m_ListCalls;
+    CBotCall*    m_ListCalls;        // filled by AddFunction() before any program runs, only read during execution
     static
     void*        m_pUser;
     long        m_nFuncIdent;
@@ -1659,10 +1688,12 @@ private:
     bool            m_bPublic;        // public function
     bool            m_bExtern;        // extern function
     CBotString        m_MasterClass;    // name of the class we derive
-    CBotProgram*    m_pProg;
+    CBotProgram*    m_pProg;        // program which compiled the function
     friend class CBotProgram;
     friend class CBotClass;
 
+    CBotProgram*    GetModule(CBotStack* pStack);
+
     CBotToken        m_extern;        // for the position of the word "extern"
     CBotToken        m_openpar;
     CBotToken        m_closepar;
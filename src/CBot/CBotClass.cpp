@@ -23,8 +23,11 @@
 
 #include "CBot.h"
 
+#include <mutex>
+
 
 CBotClass* CBotClass::m_ExClass = nullptr;
+static std::mutex g_lockMutex;          // protects the synchronized queues of all classes
 
 CBotClass::CBotClass(const char* name, CBotClass* pPapa, bool bIntrinsic)
 {
@@ -53,10 +56,13 @@ CBotClass::CBotClass(const char* name, CBotClass* pPapa, bool bIntrinsic)
     m_ExPrev  = nullptr;
     m_ExClass = this;
 
+    IncDefinitionVersion();
 }
 
 CBotClass::~CBotClass()
 {
+    IncDefinitionVersion();
+
     // removes the list of class
     if ( m_ExPrev ) m_ExPrev->m_ExNext = m_ExNext;
     else m_ExClass = m_ExNext;
@@ -85,6 +91,8 @@ void CBotClass::Purge()
 {
     if ( this == nullptr ) return;
 
+    IncDefinitionVersion();
+
     delete      m_pVar;
     m_pVar      = nullptr;
     delete      m_pCalls;
@@ -101,6 +109,7 @@ void CBotClass::Purge()
 
 bool CBotClass::Lock(CBotProgram* p)
 {
+    std::lock_guard<std::mutex> lock(g_lockMutex);
     int i = m_cptLock++;
 
     if ( i == 0 )
@@ -137,6 +146,7 @@ bool CBotClass::Lock(CBotProgram* p)
 
 void CBotClass::Unlock()
 {
+    std::lock_guard<std::mutex> lock(g_lockMutex);
     if ( --m_cptOne > 0 ) return ;
 
     int i = --m_cptLock;
@@ -155,6 +165,7 @@ void CBotClass::Unlock()
 
 void CBotClass::FreeLock(CBotProgram* p)
 {
+    std::lock_guard<std::mutex> lock(g_lockMutex);
     CBotClass* pClass = m_ExClass;
 
     while ( pClass != nullptr )
@@ -173,6 +184,19 @@ void CBotClass::FreeLock(CBotProgram* p)
     }
 }
 
+bool CBotClass::IsLocked(CBotProgram* p)
+{
+    std::lock_guard<std::mutex> lock(g_lockMutex);
+    CBotClass* pClass = m_ExClass;
+
+    while ( pClass != nullptr )
+    {
+        if ( p == pClass->m_ProgInLock[0] && pClass->m_cptOne > 0 ) return true;
+        pClass = pClass->m_ExNext;
+    }
+    return false;
+}
+
 
 
 bool CBotClass::AddItem(CBotString name, CBotTypResult type, int mPrivate)
@@ -201,6 +225,7 @@ bool CBotClass::AddItem(CBotString name, CBotTypResult type, int mPrivate)
 
 bool CBotClass::AddItem(CBotVar* pVar)
 {
+    IncDefinitionVersion();
     pVar->SetUniqNum(++m_nbVar);
 
     if ( m_pVar == nullptr ) m_pVar = pVar;
@@ -217,7 +242,7 @@ void CBotClass::AddNext(CBotClass* pClass)
     p->m_next = pClass;
 }
 
-CBotString  CBotClass::GetName()
+const CBotString& CBotClass::GetName()
 {
     return m_name;
 }
@@ -315,6 +340,7 @@ bool CBotClass::AddFunction(const char* name,
         p = p->m_next;
     }
 
+    IncDefinitionVersion();
     p = new CBotCallMethode(name, rExec, rCompile);
 
     if (m_pCalls == nullptr) m_pCalls = p;
@@ -329,6 +355,11 @@ bool CBotClass::AddUpdateFunc( void rMaj ( CBotVar* pThis, void* pUser ) )
     return true;
 }
 
+bool CBotClass::IsUpdated()
+{
+    return m_rMaj != nullptr;
+}
+
 // compiles a method associated with an instance of class
 // the method can be declared by the user or AddFunction
 
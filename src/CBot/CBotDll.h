@@ -28,7 +28,9 @@
 
 #include <stdio.h>
 #include "resource.h"
+#include <atomic>
 #include <map>
+#include <memory>
 #include <cstring>
 
 
@@ -262,11 +264,12 @@ public:
     CBotString();
     CBotString(const char* p);
     CBotString(const CBotString& p);
+    CBotString(CBotString&& p) NOEXCEPT;
     ~CBotString();
 
     void       Empty();
     bool       IsEmpty() const;
-    int        GetLength();
+    int        GetLength() const;
     int        Find(const char c);
     int        Find(const char* lpsz);
     int        ReverseFind(const char c);
@@ -281,11 +284,18 @@ public:
     void       MakeUpper();
     void       MakeLower();
 
+    /**
+     * \brief Compares with the \a lg first characters of \a p
+     * \brief Allows to compare with a part of a buffer without creating a CBotString
+     */
+    bool       IsEqual(const char* p, int lg) const;
+
 
     /**
      * \brief Overloaded oprators to work on CBotString classes
      */
     const CBotString& operator=(const CBotString& stringSrc);
+    const CBotString& operator=(CBotString&& stringSrc) NOEXCEPT;
     const CBotString& operator=(const char ch);
     const CBotString& operator=(const char* pString);
     const CBotString& operator+(const CBotString& str);
@@ -293,30 +303,51 @@ public:
 
     const CBotString& operator+=(const char ch);
     const CBotString& operator+=(const CBotString& str);
-    bool              operator==(const CBotString& str);
-    bool              operator==(const char* p);
-    bool              operator!=(const CBotString& str);
-    bool              operator!=(const char* p);
-    bool              operator>(const CBotString& str);
-    bool              operator>(const char* p);
-    bool              operator>=(const CBotString& str);
-    bool              operator>=(const char* p);
-    bool              operator<(const CBotString& str);
-    bool              operator<(const char* p);
-    bool              operator<=(const CBotString& str);
-    bool              operator<=(const char* p);
+    bool              operator==(const CBotString& str) const;
+    bool              operator==(const char* p) const;
+    bool              operator!=(const CBotString& str) const;
+    bool              operator!=(const char* p) const;
+    bool              operator>(const CBotString& str) const;
+    bool              operator>(const char* p) const;
+    bool              operator>=(const CBotString& str) const;
+    bool              operator>=(const char* p) const;
+    bool              operator<(const CBotString& str) const;
+    bool              operator<(const char* p) const;
+    bool              operator<=(const CBotString& str) const;
+    bool              operator<=(const char* p) const;
 
                       operator const char*() const;           // as a C string
 
 
 private:
+    //! Strings up to this length (with the final 0) are kept in the object itself
+    static const int SMALL_SIZE = 16;
 
-    /** \brief Pointer to string */
+    //! Returns the characters, in the buffer or in the object
+    char*       GetData()       { return m_ptr != nullptr ? m_ptr : m_small; }
+    const char* GetData() const { return m_ptr != nullptr ? m_ptr : m_small; }
+
+    //! Replaces the content by \a lg characters of \a p
+    void        Assign(const char* p, int lg);
+    //! Adds \a lg characters of \a p at the end
+    void        Append(const char* p, int lg);
+
+    /**
+     * \brief Allocated buffer, nullptr if the string is kept in m_small
+     * \brief A CBotString filled with zeros is a valid empty string
+     * \brief and it can be moved with memcpy (see CBotStringArray)
+     */
     char* m_ptr;
 
     /** \brief Length of the string */
     int m_lg;
 
+    /** \brief Size of m_ptr */
+    int m_size;
+
+    /** \brief Short strings */
+    char m_small[SMALL_SIZE];
+
     /** \brief Keeps the string corresponding to keyword ID */
     static const std::map<EID,const char *> s_keywordString;
 
@@ -366,6 +397,7 @@ class CBotProgram
 {
 private:
     CBotFunction*    m_Prog;            // the user-defined functions
+    std::shared_ptr<CBotFunction> m_code; // owns m_Prog, possibly with other programs (see Share())
     CBotFunction*    m_pRun;            // the basic function for the execution
     CBotClass*        m_pClass;        // classes defined in this part
     CBotStack*        m_pStack;        // execution stack
@@ -378,6 +410,8 @@ private:
 
     long            m_Ident;        // associated identifier
 
+    bool            Execute();      // common part of Run() and Resume()
+
 public:
     static CBotString        m_DebugVarStr;    // end of a debug
     bool m_bDebugDD;        // idem déclanchable par robot \TODO ???
@@ -407,6 +441,19 @@ public:
     //                ListFonctions returns the names of functions declared as extern
     //                pUser can pass a pointer to routines defined by AddFunction
 
+    bool            Share(CBotProgram* pProg, CBotStringArray& ListFonctions);
+    //                uses the code already compiled by pProg instead of compiling the same text again
+    //                only the execution stack and the instance stay specific to this program
+    //                returns false if pProg has no code or if its code can't be shared
+    //                because it defines classes or public functions
+    //                ListFonctions returns the names of functions declared as extern
+
+    static
+    long            GetDefinitionVersion();
+    //                changes each time something the compiler depends on is defined or removed:
+    //                functions (AddFunction), constants (DefineNum), classes and public functions
+    //                a compiled code can be shared only while this version doesn't change
+
     void            SetIdent(long n);
     //                associates an identifier with the instance CBotProgram
 
@@ -435,6 +482,19 @@ public:
     //                returns true if the program ended with or without error
     //                timer = 0 allows to advance step by step
 
+    bool            RunUntilExtern(void* pUser = nullptr, int timer = -1);
+    //                same as Run() but stops before anything shared with the rest of the world:
+    //                external functions and methods, classes updated by AddUpdateFunc,
+    //                fields of instances, elements of arrays and synchronized methods
+    //                it only touches the program itself, so it can run in any thread
+
+    bool            IsWaitingExtern();
+    //                true if RunUntilExtern() stopped for this reason
+
+    bool            Resume(void* pUser = nullptr);
+    //                continues after RunUntilExtern() without restriction
+    //                with the steps remaining from RunUntilExtern()
+
     bool            GetRunPos(const char* &FunctionName, int &start, int &end);
     //                gives the position in the executing program
     //                returns false if it is not running (program completion)
@@ -585,12 +645,20 @@ protected:
     friend class    CBotVarArray;
 
     long            m_ident;                    // unique identifier
-    static long        m_identcpt;                    // counter
+    static std::atomic<long> m_identcpt;            // counter
 
 public:
                     CBotVar();
 virtual                ~CBotVar( );                        // destructor
 
+    // variables are taken from a free list kept for each thread
+    static void*    operator new(std::size_t size);
+    static void     operator delete(void* p, std::size_t size);
+
+    static void     GetAllocCount(long& heap, long& pooled);
+    //                number of variables allocated on the heap and reused
+    //                from the free list by the current thread
+
     static
     CBotVar*        Create( const char* name, CBotTypResult type);
     //                creates from a complete type
@@ -621,7 +689,7 @@ virtual                ~CBotVar( );                        // destructor
     void*            GetUserPtr();
     //                makes the pointer associated with the variable
 
-    CBotString        GetName();                    // the name of the variable, if known
+    const CBotString& GetName();                    // the name of the variable, if known
     ////////////////////////////////////////////////////////////////////////////////////
     void            SetName(const char* name);    // changes the name of the variable
 
@@ -816,6 +884,9 @@ public:
     bool            AddUpdateFunc( void rMaj ( CBotVar* pThis, void* pUser ) );
     //                defines routine to be called to update the elements of the class
 
+    bool            IsUpdated();
+    //                true if the elements are updated by such a routine
+
     bool            AddItem(CBotString name, CBotTypResult type, int mPrivate = PR_PUBLIC);
     //                adds an element to the class
 //    bool            AddItem(CBotString name, CBotClass* pClass);
@@ -829,7 +900,7 @@ public:
     // adds an element by giving an element of type CBotVar
     void            AddNext(CBotClass* pClass);
 
-    CBotString        GetName();                    // gives the name of the class
+    const CBotString& GetName();                    // gives the name of the class
     CBotClass*        GetParent();                // gives the parent class (or nullptr)
 
     // true if a class is derived (Extends) of another
@@ -875,6 +946,8 @@ public:
     void            Unlock();
     static
     void            FreeLock(CBotProgram* p);
+    static
+    bool            IsLocked(CBotProgram* p);     // is p in a synchronized method?
 
     bool            CheckCall(CBotToken* &pToken, CBotDefParam* pParam);
 
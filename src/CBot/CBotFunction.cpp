@@ -68,9 +68,19 @@ CBotFunction::~CBotFunction()
             // if prev = next = null may not be in the list!
             if ( m_listPublic == this ) m_listPublic = m_nextpublic;
         }
+        IncDefinitionVersion();
     }
 }
 
+// the program in which the function runs: public functions run in the program
+// which defined them, the other ones in the calling program, which may use
+// a code shared with other programs (see CBotProgram::Share)
+CBotProgram* CBotFunction::GetModule(CBotStack* pStack)
+{
+    if ( m_bPublic ) return m_pProg;
+    return pStack->GetBotCall();
+}
+
 bool CBotFunction::IsPublic()
 {
     return m_bPublic;
@@ -381,7 +391,7 @@ bool CBotFunction::Execute(CBotVar** ppVars, CBotStack* &pj, CBotVar* pInstance)
     CBotStack*  pile = pj->AddStack(this, 2);               // one end of stack local to this function
 //  if ( pile == EOX ) return true;
 
-    pile->SetBotCall(m_pProg);                              // bases for routines
+    pile->SetBotCall(GetModule(pj));                        // bases for routines
 
     if ( pile->GetState() == 0 )
     {
@@ -432,7 +442,7 @@ void CBotFunction::RestoreState(CBotVar** ppVars, CBotStack* &pj, CBotVar* pInst
     if ( pile == nullptr ) return;
     CBotStack*  pile2 = pile;
 
-    pile->SetBotCall(m_pProg);                          // bases for routines
+    pile->SetBotCall(GetModule(pj));                    // bases for routines
 
     if ( pile->GetBlock() < 2 )
     {
@@ -644,7 +654,8 @@ int CBotFunction::DoCall(long& nIdent, const char* name, CBotVar** ppVars, CBotS
         CBotStack*  pStk1 = pStack->AddStack(pt, 2);    // to put "this"
 //      if ( pStk1 == EOX ) return true;
 
-        pStk1->SetBotCall(pt->m_pProg);                 // it may have changed module
+        CBotProgram* pProgCurrent = pStack->GetBotCall();
+        pStk1->SetBotCall(pt->GetModule(pStack));       // it may have changed module
 
         if ( pStk1->IfStep() ) return false;
 
@@ -656,7 +667,7 @@ int CBotFunction::DoCall(long& nIdent, const char* name, CBotVar** ppVars, CBotS
         {
             if ( !pt->m_MasterClass.IsEmpty() )
             {
-                CBotVar* pInstance = m_pProg->m_pInstance;
+                CBotVar* pInstance = pProgCurrent->m_pInstance;
                 // make "this" known
                 CBotVar* pThis ;
                 if ( pInstance == nullptr )
@@ -686,10 +697,10 @@ int CBotFunction::DoCall(long& nIdent, const char* name, CBotVar** ppVars, CBotS
         if ( !pStk3->GetRetVar(                     // puts the result on the stack
             pt->m_Block->Execute(pStk3) ))          // GetRetVar said if it is interrupted
         {
-            if ( !pStk3->IsOk() && pt->m_pProg != m_pProg )
+            if ( !pStk3->IsOk() && pStk1->GetBotCall() != pProgCurrent )
             {
 #ifdef _DEBUG
-                if ( m_pProg->GetFunctions()->GetName() == "LaCommande" ) return false;
+                if ( pProgCurrent->GetFunctions()->GetName() == "LaCommande" ) return false;
 #endif
                 pStk3->SetPosError(pToken);         // indicates the error on the procedure call
             }
@@ -717,7 +728,7 @@ void CBotFunction::RestoreCall(long& nIdent, const char* name, CBotVar** ppVars,
         pStk1 = pStack->RestoreStack(pt);
         if ( pStk1 == nullptr ) return;
 
-        pStk1->SetBotCall(pt->m_pProg);                 // it may have changed module
+        pStk1->SetBotCall(pt->GetModule(pStack));       // it may have changed module
 
         if ( pStk1->GetBlock() < 2 )
         {
@@ -807,6 +818,7 @@ int CBotFunction::DoCall(long& nIdent, const char* name, CBotVar* pThis, CBotVar
         {
             if ( pt->m_bSynchro )
             {
+                if ( pStk->IfExtern() ) return false;               // the lock is shared with the other programs
                 CBotProgram* pProgBase = pStk->GetBotCall(true);
                 if ( !pClass->Lock(pProgBase) ) return false;       // expected to power \TODO attend de pouvoir
             }
@@ -919,6 +931,7 @@ CBotFunction* CBotFunction::Next()
 
 void CBotFunction::AddPublic(CBotFunction* func)
 {
+    IncDefinitionVersion();
     if ( m_listPublic != nullptr )
     {
         func->m_nextpublic = m_listPublic;
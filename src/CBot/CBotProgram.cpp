@@ -23,6 +23,19 @@
 #include "CBot.h"
 #include <stdio.h>
 
+// version of the definitions known to the compiler, see CBotProgram::GetDefinitionVersion()
+static long g_definitionVersion = 0;
+
+void IncDefinitionVersion()
+{
+    g_definitionVersion++;
+}
+
+long CBotProgram::GetDefinitionVersion()
+{
+    return g_definitionVersion;
+}
+
 CBotProgram::CBotProgram()
 {
     m_Prog      = nullptr;
@@ -58,7 +71,8 @@ CBotProgram::~CBotProgram()
 
     CBotClass::FreeLock(this);
 
-    delete  m_Prog;
+    m_Prog      = nullptr;
+    m_code.reset();
 #if STACKMEM
     m_pStack->Delete();
 #else
@@ -76,7 +90,8 @@ bool CBotProgram::Compile( const char* program, CBotStringArray& ListFonctions,
     m_pClass->Purge();      // purge the old definitions of classes
                             // but without destroying the object
     m_pClass    = nullptr;
-    delete      m_Prog;     m_Prog= nullptr;
+    m_Prog      = nullptr;
+    m_code.reset();
 
     ListFonctions.SetSize(0);
     m_ErrorCode = 0;
@@ -158,9 +173,39 @@ bool CBotProgram::Compile( const char* program, CBotStringArray& ListFonctions,
     delete pBaseToken;
     delete pStack;
 
+    m_code.reset(m_Prog);
     return (m_Prog != nullptr);
 }
 
+bool CBotProgram::Share(CBotProgram* pProg, CBotStringArray& ListFonctions)
+{
+    if ( pProg == nullptr || pProg->m_Prog == nullptr ) return false;
+
+    // classes and public functions are known to the other programs
+    // through the program that defined them, so they can't be shared
+    if ( pProg->m_pClass != nullptr ) return false;
+    for ( CBotFunction* p = pProg->m_Prog ; p != nullptr ; p = p->Next() )
+    {
+        if ( p->IsPublic() ) return false;
+    }
+
+    Stop();
+
+    m_pClass->Purge();
+    m_pClass    = nullptr;
+    m_code      = pProg->m_code;
+    m_Prog      = pProg->m_Prog;
+
+    ListFonctions.SetSize(0);
+    m_ErrorCode = 0;
+
+    for ( CBotFunction* p = m_Prog ; p != nullptr ; p = p->Next() )
+    {
+        if ( p->IsExtern() ) ListFonctions.Add(p->GetName());
+    }
+    return true;
+}
+
 
 bool CBotProgram::Start(const char* name)
 {
@@ -212,14 +257,62 @@ bool CBotProgram::GetPosition(const char* name, int& start, int& stop, CBotGet m
 
 bool CBotProgram::Run(void* pUser, int timer)
 {
-    bool    ok;
-
-    if (m_pStack == nullptr || m_pRun == nullptr) goto error;
+    if (m_pStack == nullptr || m_pRun == nullptr)
+    {
+        m_ErrorCode = TX_NORUN;
+        return true;
+    }
 
     m_ErrorCode = 0;
 
     m_pStack->Reset(pUser);                         // empty the possible previous error, and resets the timer
-    if ( timer >= 0 ) m_pStack->SetTimer(timer);
+    if ( timer >= 0 ) m_pStack->SetRunTimer(timer);
+
+    return Execute();
+}
+
+bool CBotProgram::RunUntilExtern(void* pUser, int timer)
+{
+    if (m_pStack == nullptr || m_pRun == nullptr)
+    {
+        m_ErrorCode = TX_NORUN;
+        return true;
+    }
+
+    m_ErrorCode = 0;
+
+    m_pStack->Reset(pUser);
+    if ( timer >= 0 ) m_pStack->SetRunTimer(timer);
+
+    // the locks of synchronized methods are shared with the other programs
+    bool bLocked = CBotClass::IsLocked(this);
+    m_pStack->SetNoExtern(bLocked);
+    if ( bLocked ) return false;
+
+    return Execute();
+}
+
+bool CBotProgram::IsWaitingExtern()
+{
+    return m_pStack != nullptr && m_pStack->IsWaitingExtern();
+}
+
+bool CBotProgram::Resume(void* pUser)
+{
+    if (m_pStack == nullptr || m_pRun == nullptr)
+    {
+        m_ErrorCode = TX_NORUN;
+        return true;
+    }
+
+    m_pStack->Resume(pUser);                        // keeps the timer of RunUntilExtern()
+
+    return Execute();
+}
+
+bool CBotProgram::Execute()
+{
+    bool    ok;
 
     m_pStack->SetBotCall(this);                     // bases for routines
 
@@ -258,10 +351,6 @@ bool CBotProgram::Run(void* pUser, int timer)
 
     if ( ok ) m_pRun = nullptr;                        // more function in execution
     return ok;
-
-error:
-    m_ErrorCode = TX_NORUN;
-    return true;
 }
 
 void CBotProgram::Stop()
@@ -493,6 +582,7 @@ bool ReadType(FILE* pf, CBotTypResult& type)
 
 bool CBotProgram::DefineNum(const char* name, long val)
 {
+    IncDefinitionVersion();
     return CBotToken::DefineNum(name, val);
 }
 
@@ -578,7 +668,9 @@ CBotCall::~CBotCall()
 
 void CBotCall::Free()
 {
+    IncDefinitionVersion();
     delete CBotCall::m_ListCalls;
+    CBotCall::m_ListCalls = nullptr;
 }
 
 bool CBotCall::AddFunction(const char* name,
@@ -605,6 +697,7 @@ bool CBotCall::AddFunction(const char* name,
         p = p->m_next;
     }
 
+    IncDefinitionVersion();
     pp = new CBotCall(name, rExec, rCompile);
 
     if (p) p->m_next = pp;
@@ -834,6 +927,8 @@ bool CBotCall::Run(CBotStack* pStack)
     CBotVar*    pResult = pile2->GetVar();
     CBotVar*    pRes = pResult;
 
+    if ( pStack->IfExtern() ) return false;         // will be called again
+
     int         Exception = 0;
     int res = m_rExec(pVar, pResult, Exception, pStack->GetPUser());
 
@@ -937,6 +1032,12 @@ int CBotCallMethode::DoCall(long& nIdent, const char* name, CBotVar* pThis, CBot
         {
             // lists the parameters depending on the contents of the stack (pStackVar)
 
+            if (pStack->IfExtern())
+            {
+                pStack->SetVar(pResult);            // as if interrupted by the routine
+                return false;
+            }
+
             CBotVar*    pVar = MakeListVars(ppVars, true);
             CBotVar*    pVarToDelete = pVar;
 
@@ -970,6 +1071,12 @@ int CBotCallMethode::DoCall(long& nIdent, const char* name, CBotVar* pThis, CBot
         {
             // lists the parameters depending on the contents of the stack (pStackVar)
 
+            if (pStack->IfExtern())
+            {
+                pStack->SetVar(pResult);            // as if interrupted by the routine
+                return false;
+            }
+
             CBotVar*    pVar = MakeListVars(ppVars, true);
             CBotVar*    pVarToDelete = pVar;
 
@@ -33,14 +33,29 @@
 // management of a execution of a stack
 ////////////////////////////////////////////////////////////////////////////
 
-int         CBotStack::m_initimer = ITIMER;
-int         CBotStack::m_timer = 0;
-CBotVar*    CBotStack::m_retvar = nullptr;
-int         CBotStack::m_error = 0;
-int         CBotStack::m_start = 0;
-int         CBotStack::m_end   = 0;
-CBotString  CBotStack::m_labelBreak="";
-void*       CBotStack::m_pUser = nullptr;
+// initial timer of new stacks, see CBotStack::SetTimer()
+static int g_defaultTimer = ITIMER;
+
+// context of the last program run on this thread
+// independent stacks (initializers, destructors) take their user from it
+static thread_local CBotRunContext* g_currentContext = nullptr;
+
+static CBotRunContext* CreateContext()
+{
+    CBotRunContext* context = new CBotRunContext();
+    context->initimer = g_defaultTimer;
+    context->timer = context->initimer;             // sets the timer at the beginning
+    if (g_currentContext != nullptr)
+        context->pUser = g_currentContext->pUser;
+    return context;
+}
+
+static void DeleteContext(CBotRunContext* context)
+{
+    if (g_currentContext == context)
+        g_currentContext = nullptr;
+    delete context;
+}
 
 #if    STACKMEM
 
@@ -58,7 +73,7 @@ CBotStack* CBotStack::FirstStack()
     memset(p, 0, size);
 
     p-> m_bBlock = true;
-    m_timer = m_initimer;                // sets the timer at the beginning
+    p-> m_context = CreateContext();
 
     CBotStack* pp = p;
     pp += MAXSTACK;
@@ -78,7 +93,6 @@ CBotStack* CBotStack::FirstStack()
     }
 #endif
 
-    m_error = 0;    // avoids deadlocks because m_error is static
     return p;
 }
 
@@ -113,6 +127,7 @@ void CBotStack::Delete()
     delete m_listVar;
 
     CBotStack*    p = m_prev;
+    CBotRunContext* context = m_context;
     bool        bOver = m_bOver;
 #ifdef    _DEBUG
     int            n = m_index;
@@ -126,7 +141,10 @@ void CBotStack::Delete()
 #endif
 
     if ( p == nullptr )
+    {
+        DeleteContext(context);
         free( this );
+    }
 }
 
 
@@ -155,6 +173,7 @@ CBotStack* CBotStack::AddStack(CBotInstr* instr, bool bBlock)
     p->m_bBlock         = bBlock;
     p->m_instr         = instr;
     p->m_prog         = m_prog;
+    p->m_context     = m_context;
     p->m_step         = 0;
     p->m_prev         = this;
     p->m_state         = 0;
@@ -199,6 +218,7 @@ CBotStack* CBotStack::AddStack2(bool bBlock)
     p->m_prev = this;
     p->m_bBlock = bBlock;
     p->m_prog = m_prog;
+    p->m_context = m_context;
     p->m_step = 0;
     return    p;
 }
@@ -219,7 +239,7 @@ bool CBotStack::Return(CBotStack* pfils)
     m_next->Delete();m_next = nullptr;                // releases the stack above
     m_next2->Delete();m_next2 = nullptr;            // also the second stack (catch)
 
-    return (m_error == 0);                        // interrupted if error
+    return (m_context->error == 0);                        // interrupted if error
 }
 
 bool CBotStack::ReturnKeep(CBotStack* pfils)
@@ -230,13 +250,13 @@ bool CBotStack::ReturnKeep(CBotStack* pfils)
     m_var = pfils->m_var;                        // result transmitted
     pfils->m_var = nullptr;                        // not to destroy the variable
 
-    return (m_error == 0);                        // interrupted if error
+    return (m_context->error == 0);                        // interrupted if error
 }
 
 bool CBotStack::StackOver()
 {
     if (!m_bOver) return false;
-    m_error = TX_STACKOVER;
+    m_context->error = TX_STACKOVER;
     return true;
 }
 
@@ -253,7 +273,7 @@ CBotStack::CBotStack(CBotStack* ppapa)
     m_state = 0;
     m_step = 1;
 
-    if (ppapa == nullptr) m_timer = m_initimer;                // sets the timer at the beginning
+    m_context = (ppapa == nullptr) ? CreateContext() : ppapa->m_context;
 
     m_listVar = nullptr;
     m_bDontDelete = false;
@@ -275,6 +295,8 @@ CBotStack::~CBotStack()
 
     delete m_var;
     if ( !m_bDontDelete ) delete m_listVar;
+
+    if ( m_prev == nullptr ) DeleteContext(m_context);
 }
 
 // \TODO routine has/to optimize
@@ -342,7 +364,7 @@ bool CBotStack::Return(CBotStack* pfils)
     if ( m_next != EOX ) delete m_next;            // releases the stack above
     delete m_next2;m_next2 = nullptr;                // also the second stack (catch)
 
-    return (m_error == 0);                        // interrupted if error
+    return (m_context->error == 0);                        // interrupted if error
 }
 
 bool CBotStack::StackOver()
@@ -354,12 +376,16 @@ bool CBotStack::StackOver()
 
 void CBotStack::Reset(void* pUser)
 {
-    m_timer = m_initimer;        // resets the timer
-    m_error    = 0;
-//    m_start = 0;
-//    m_end    = 0;
-    m_labelBreak.Empty();
-    m_pUser = pUser;
+    m_context->timer = m_context->initimer;        // resets the timer
+    m_context->error    = 0;
+//    m_context->start = 0;
+//    m_context->end    = 0;
+    m_context->labelBreak.Empty();
+    m_context->pUser = pUser;
+    m_context->noExtern = false;
+    m_context->externWait = false;
+    m_context->replay = false;
+    g_currentContext = m_context;
 }
 
 
@@ -388,45 +414,90 @@ CBotStack* CBotStack::RestoreStackEOX(CBotCall* instr)
 // routine for execution step by step
 bool CBotStack::IfStep()
 {
-    if ( m_initimer > 0 || m_step++ > 0 ) return false;
+    if ( m_context->initimer > 0 || m_step++ > 0 ) return false;
+    return true;
+}
+
+// interrupts the execution before an external function, a shared variable
+// or a variable updated by the user (if pVar is given)
+bool CBotStack::IfExtern(CBotVar* pVar)
+{
+    if ( !m_context->noExtern && !m_context->replay ) return false;
+
+    if ( pVar != nullptr )
+    {
+        int type = pVar->GetType();
+        if ( type != CBotTypPointer && type != CBotTypClass && type != CBotTypIntrinsic ) return false;
+
+        CBotClass* pClass = pVar->GetClass();
+        if ( pClass == nullptr || !pClass->IsUpdated() ) return false;
+    }
+
+    if ( m_context->replay )
+    {
+        m_context->replay = false;      // back where RunUntilExtern() stopped
+        return false;
+    }
+
+    m_context->externWait = true;
+    m_context->replay = true;           // Resume() executes again up to here, without counting
     return true;
 }
 
+void CBotStack::SetNoExtern(bool bStop)
+{
+    m_context->noExtern = true;
+    m_context->externWait = bStop;
+}
+
+bool CBotStack::IsWaitingExtern()
+{
+    return m_context->externWait;
+}
+
+void CBotStack::Resume(void* pUser)
+{
+    m_context->pUser = pUser;
+    m_context->noExtern = false;
+    m_context->externWait = false;
+    g_currentContext = m_context;
+}
+
 
 bool CBotStack::BreakReturn(CBotStack* pfils, const char* name)
 {
-    if ( m_error>=0 ) return false;                // normal output
-    if ( m_error==-3 ) return false;            // normal output (return current)
+    if ( m_context->error>=0 ) return false;                // normal output
+    if ( m_context->error==-3 ) return false;            // normal output (return current)
 
-    if (!m_labelBreak.IsEmpty() && (name[0] == 0 || m_labelBreak != name))
+    if (!m_context->labelBreak.IsEmpty() && (name[0] == 0 || m_context->labelBreak != name))
         return false;                            // it's not for me
 
-    m_error = 0;
-    m_labelBreak.Empty();
+    m_context->error = 0;
+    m_context->labelBreak.Empty();
     return Return(pfils);
 }
 
 bool CBotStack::IfContinue(int state, const char* name)
 {
-    if ( m_error != -2 ) return false;
+    if ( m_context->error != -2 ) return false;
 
-    if (!m_labelBreak.IsEmpty() && (name == nullptr || m_labelBreak != name))
+    if (!m_context->labelBreak.IsEmpty() && (name == nullptr || m_context->labelBreak != name))
         return false;                            // it's not for me
 
     m_state = state;                            // where again?
-    m_error = 0;
-    m_labelBreak.Empty();
+    m_context->error = 0;
+    m_context->labelBreak.Empty();
     if ( m_next != EOX ) m_next->Delete();            // purge above stack
     return true;
 }
 
 void CBotStack::SetBreak(int val, const char* name)
 {
-    m_error = -val;                                // reacts as an Exception
-    m_labelBreak = name;
+    m_context->error = -val;                                // reacts as an Exception
+    m_context->labelBreak = name;
     if (val == 3)    // for a return
     {
-        m_retvar = m_var;
+        m_context->retvar = m_var;
         m_var = nullptr;
     }
 }
@@ -435,12 +506,12 @@ void CBotStack::SetBreak(int val, const char* name)
 
 bool CBotStack::GetRetVar(bool bRet)
 {
-    if (m_error == -3)
+    if (m_context->error == -3)
     {
         if ( m_var ) delete m_var;
-        m_var        = m_retvar;
-        m_retvar    = nullptr;
-        m_error        = 0;
+        m_var        = m_context->retvar;
+        m_context->retvar    = nullptr;
+        m_context->error        = 0;
         return        true;
     }
     return bRet;                        // interrupted by something other than return
@@ -448,9 +519,9 @@ bool CBotStack::GetRetVar(bool bRet)
 
 int CBotStack::GetError(int& start, int& end)
 {
-    start = m_start;
-    end      = m_end;
-    return m_error;
+    start = m_context->start;
+    end      = m_context->end;
+    return m_context->error;
 }
 
 
@@ -486,7 +557,7 @@ CBotVar* CBotStack::FindVar(CBotToken* &pToken, bool bUpdate, bool bModif)
             if (pp->GetName() == name)
             {
                 if ( bUpdate )
-                    pp->Maj(m_pUser, false);
+                    pp->Maj(m_context->pUser, false);
 
                 return pp;
             }
@@ -527,7 +598,7 @@ CBotVar* CBotStack::FindVar(long ident, bool bUpdate, bool bModif)
             if (pp->GetUniqNum() == ident)
             {
                 if ( bUpdate )
-                    pp->Maj(m_pUser, false);
+                    pp->Maj(m_context->pUser, false);
 
                 return pp;
             }
@@ -538,6 +609,57 @@ CBotVar* CBotStack::FindVar(long ident, bool bUpdate, bool bModif)
     return nullptr;
 }
 
+CBotVar* CBotStack::FindVar(long ident, std::atomic<int>& index)
+{
+    // the index may be updated by another program running the same public function
+    int    pos = index.load(std::memory_order_relaxed);
+
+    if ( pos >= 0 )
+    {
+        // goes down to the block of the variable, without leaving the function
+        int    depth = pos >> 16;
+        CBotStack*    p = this;
+        while ( p != nullptr )
+        {
+            if ( p->m_bBlock && depth-- == 0 ) break;
+            p = ( p->m_bFunc == 1 ) ? nullptr : p->m_prev;
+        }
+
+        if ( p != nullptr )
+        {
+            int    slot = pos & 0xFFFF;
+            CBotVar*    pp = p->m_listVar;
+            while ( pp != nullptr && slot-- > 0 ) pp = pp->m_next;
+
+            if ( pp != nullptr && pp->GetUniqNum() == ident ) return pp;
+        }
+    }
+
+    // not found at this position, searches by identifier and keeps the new position
+    int    depth = 0;
+    bool   bFunc = false;
+    CBotStack*    p = this;
+    while (p != nullptr)
+    {
+        int    slot = 0;
+        CBotVar*    pp = p->m_listVar;
+        while ( pp != nullptr)
+        {
+            if (pp->GetUniqNum() == ident)
+            {
+                if ( p->m_bBlock && !bFunc && depth <= 0x7FFF && slot <= 0xFFFF )
+                    index.store(depth << 16 | slot, std::memory_order_relaxed);
+                return pp;
+            }
+            pp = pp->m_next;
+            slot++;
+        }
+        if ( p->m_bBlock ) depth++;
+        if ( p->m_bFunc == 1 ) bFunc = true;
+        p = p->m_prev;
+    }
+    return nullptr;
+}
 
 CBotVar* CBotStack::FindVar(CBotToken& pToken, bool bUpdate, bool bModif)
 {
@@ -562,46 +684,52 @@ bool CBotStack::SetState(int n, int limite)
 {
     m_state = n;
 
-    m_timer--;                                    // decrement the operations \TODO decrement the operations
-    return ( m_timer > limite );                    // interrupted if timer pass
+    if ( !m_context->replay ) m_context->timer--;        // decrement the operations \TODO decrement the operations
+    return ( m_context->timer > limite );                    // interrupted if timer pass
 }
 
 bool CBotStack::IncState(int limite)
 {
     m_state++;
 
-    m_timer--;                                    // decrement the operations \TODO decompte les operations
-    return ( m_timer > limite );                    // interrupted if timer pass
+    if ( !m_context->replay ) m_context->timer--;        // decrement the operations \TODO decompte les operations
+    return ( m_context->timer > limite );                    // interrupted if timer pass
 }
 
 
 void CBotStack::SetError(int n, CBotToken* token)
 {
-    if ( n!= 0 && m_error != 0) return;    // does not change existing error
-    m_error = n;
+    if ( n!= 0 && m_context->error != 0) return;    // does not change existing error
+    m_context->error = n;
     if (token != nullptr)
     {
-        m_start = token->GetStart();
-        m_end   = token->GetEnd();
+        m_context->start = token->GetStart();
+        m_context->end   = token->GetEnd();
     }
 }
 
 void CBotStack::ResetError(int n, int start, int end)
 {
-    m_error = n;
-    m_start    = start;
-    m_end    = end;
+    m_context->error = n;
+    m_context->start    = start;
+    m_context->end    = end;
 }
 
 void CBotStack::SetPosError(CBotToken* token)
 {
-    m_start = token->GetStart();
-    m_end   = token->GetEnd();
+    m_context->start = token->GetStart();
+    m_context->end   = token->GetEnd();
 }
 
 void CBotStack::SetTimer(int n)
 {
-    m_initimer = n;
+    g_defaultTimer = n;
+}
+
+void CBotStack::SetRunTimer(int n)
+{
+    m_context->initimer = n;
+    m_context->timer = n;
 }
 
 bool CBotStack::Execute()
@@ -725,7 +853,7 @@ CBotProgram*  CBotStack::GetBotCall(bool bFirst)
 
 void* CBotStack::GetPUser()
 {
-    return m_pUser;
+    return m_context->pUser;
 }
 
 
@@ -1310,6 +1438,33 @@ CBotVar* CBotCStack::FindVar(CBotToken& Token)
     return FindVar(pt);
 }
 
+int CBotCStack::GetVarIndex(long ident)
+{
+    // the variables are stored on the levels which start a block,
+    // CBotStack::FindVar counts the blocks from the level of the instruction
+    int    depth = 0;
+    CBotCStack*    p = this;
+
+    while (p != nullptr)
+    {
+        if ( p->m_bBlock )
+        {
+            int    slot = 0;
+            CBotVar*    pp = p->m_listVar;
+            while ( pp != nullptr)
+            {
+                if (pp->GetUniqNum() == ident) return depth << 16 | slot;
+                pp = pp->m_next;
+                slot++;
+            }
+            depth++;
+        }
+        p = p->m_prev;
+    }
+
+    return -1;      // unknown, searched at the first execution
+}
+
 CBotVar* CBotCStack::CopyVar(CBotToken& Token)
 {
     CBotVar*    pVar = FindVar( Token );
@@ -126,6 +126,8 @@ CBotString::CBotString()
 {
     m_ptr = nullptr;
     m_lg  = 0;
+    m_size = 0;
+    m_small[0] = 0;
 }
 
 CBotString::~CBotString()
@@ -137,82 +139,101 @@ CBotString::~CBotString()
 
 CBotString::CBotString(const char* p)
 {
-    m_lg = strlen(p);
-
     m_ptr = nullptr;
-    if (m_lg>0)
-    {
-        m_ptr = new char[m_lg+1];
-        strcpy(m_ptr, p);
-    }
+    m_lg  = 0;
+    m_size = 0;
+    m_small[0] = 0;
+
+    if (p != nullptr) Assign(p, strlen(p));
 }
 
 CBotString::CBotString(const CBotString& srcString)
 {
-    m_lg = srcString.m_lg;
-
     m_ptr = nullptr;
-    if (m_lg>0)
+    m_lg  = 0;
+    m_size = 0;
+    m_small[0] = 0;
+
+    Assign(srcString.GetData(), srcString.m_lg);
+}
+
+CBotString::CBotString(CBotString&& srcString) NOEXCEPT
+{
+    m_ptr  = srcString.m_ptr;
+    m_lg   = srcString.m_lg;
+    m_size = srcString.m_size;
+    memcpy(m_small, srcString.m_small, SMALL_SIZE);
+
+    srcString.m_ptr  = nullptr;
+    srcString.m_lg   = 0;
+    srcString.m_size = 0;
+    srcString.m_small[0] = 0;
+}
+
+
+void CBotString::Assign(const char* p, int lg)
+{
+    m_lg = 0;
+    Append(p, lg);
+}
+
+void CBotString::Append(const char* p, int lg)
+{
+    char*   old = nullptr;
+    int     size = m_ptr != nullptr ? m_size : SMALL_SIZE;
+
+    if (m_lg+lg >= size)
     {
-        m_ptr = new char[m_lg+1];
-        strcpy(m_ptr, srcString.m_ptr);
+        // grows by at least half, so that adding characters one by one is not quadratic
+        size = std::max(m_lg+lg+1, size + size/2);
+        char* buffer = new char[size];
+        memcpy(buffer, GetData(), m_lg);
+
+        old = m_ptr;
+        m_ptr  = buffer;
+        m_size = size;
     }
-}
 
+    char* data = GetData();
+    memmove(data+m_lg, p, lg);      // p may be a part of this string
+    m_lg += lg;
+    data[m_lg] = 0;
 
+    delete[] old;
+}
 
 
-int CBotString::GetLength()
+int CBotString::GetLength() const
 {
-    if (m_ptr == nullptr) return 0;
-    return strlen( m_ptr );
+    return m_lg;
 }
 
 
 
 CBotString CBotString::Left(int nCount) const
 {
-    char    chain[2000];
-
     // clamp nCount to correct value
     if(nCount < 0) nCount = 0;
     if(nCount > m_lg) nCount = m_lg;
 
-    int i;
-    for (i = 0; i < m_lg && i < nCount && i < 1999; ++i)
-    {
-        chain[i] = m_ptr[i];
-    }
-    chain[i] = 0 ;
-
-    return CBotString(chain);
+    CBotString res;
+    res.Assign(GetData(), nCount);
+    return res;
 }
 
 CBotString CBotString::Right(int nCount) const
 {
-    char chain[2000];
-
     // clamp nCount to correct value
     if(nCount < 0) nCount = 0;
     if(nCount > m_lg) nCount = m_lg;
 
-    int i = m_lg - nCount;
-    if ( i < 0 ) i = 0;
-
-    int j;
-    for (j = 0 ; i < m_lg && i < 1999; ++i)
-    {
-        chain[j++] = m_ptr[i];
-    }
-    chain[j] = 0 ;
-
-    return CBotString(chain);
+    CBotString res;
+    res.Assign(GetData() + m_lg - nCount, nCount);
+    return res;
 }
 
 CBotString CBotString::Mid(int nFirst, int nCount) const
 {
-    char chain[2000];
-
     // clamps nFirst to correct value
     if(nFirst < 0) nFirst = 0;
     if(nFirst > m_lg) nFirst = m_lg;
@@ -222,83 +243,63 @@ CBotString CBotString::Mid(int nFirst, int nCount) const
     if(nCount > remaining) nCount = remaining;
     if(nCount < 0) nCount = 0;
 
-    int i;
-    for (i = nFirst; i < m_lg && i < 1999 && i <= nFirst + nCount; ++i)
-    {
-        chain[i] = m_ptr[i];
-    }
-    chain[i] = 0 ;
-
-    return CBotString(chain);
+    CBotString res;
+    res.Assign(GetData() + nFirst, nCount);
+    return res;
 }
 
 CBotString CBotString::Mid(int nFirst) const
 {
-    char chain[2000];
-
     // clamp nFirst to correct value
     if(nFirst < 0) nFirst = 0;
     if(nFirst > m_lg) nFirst = m_lg;
 
-    int i;
-    for (i = nFirst; i < m_lg && i < 1999 ; ++i)
-    {
-        chain[i] = m_ptr[i];
-    }
-    chain[i] = 0 ;
-
-    return CBotString(chain);
+    CBotString res;
+    res.Assign(GetData() + nFirst, m_lg - nFirst);
+    return res;
 }
 
 
 int CBotString::Find(const char c)
 {
+    const char* data = GetData();
     for (int i = 0; i < m_lg; ++i)
     {
-        if (m_ptr[i] == c) return i;
+        if (data[i] == c) return i;
     }
     return -1;
 }
 
 int CBotString::Find(const char * lpsz)
 {
+    const char* data = GetData();
     int l = strlen(lpsz);
 
-    for (size_t i = 0; static_cast<int>(i) <= m_lg-l; ++i)
+    for (int i = 0; i <= m_lg-l; ++i)
     {
-        for (size_t j = 0; static_cast<int>(j) < l; ++j)
-        {
-            if (m_ptr[i+j] != lpsz[j]) goto bad;
-        }
-        return i;
-bad:;
+        if (memcmp(data+i, lpsz, l) == 0) return i;
     }
     return -1;
 }
 
 int CBotString::ReverseFind(const char c)
 {
-    int i;
-    for (i = m_lg-1; i >= 0; --i)
+    const char* data = GetData();
+    for (int i = m_lg-1; i >= 0; --i)
     {
-        if (m_ptr[i] == c) return i;
+        if (data[i] == c) return i;
     }
     return -1;
 }
 
 int CBotString::ReverseFind(const char * lpsz)
 {
-    int i, j;
+    const char* data = GetData();
     int l = strlen(lpsz);
 
-    for (i = m_lg-l; i >= 0; --i)
+    for (int i = m_lg-l; i >= 0; --i)
     {
-        for (j = 0; j < l; ++j)
-        {
-            if (m_ptr[i+j] != lpsz[j]) goto bad;
-        }
-        return i;
-bad:;
+        if (memcmp(data+i, lpsz, l) == 0) return i;
     }
     return -1;
 }
@@ -307,40 +308,35 @@ CBotString CBotString::Mid(int start, int lg)
 {
     CBotString res;
 
-    if (lg == -1) lg = 2000;
-
     // clamp start to correct value
     if (start < 0) start = 0;
     if (start >= m_lg) return res;
 
     int remaining = m_lg - start;
-    if (lg > remaining) lg = remaining;
+    if (lg == -1 || lg > remaining) lg = remaining;
     if (lg < 0) lg = 0;
 
-    char* p = new char[m_lg+1];
-    strcpy(p, m_ptr+start);
-    p[lg] = 0;
-
-    res = p;
-    delete[] p;
+    res.Assign(GetData() + start, lg);
     return res;
 }
 
 void CBotString::MakeUpper()
 {
-    for (size_t i = 0; static_cast<int>(i) < m_lg && static_cast<int>(i) < 1999 ; ++i)
+    char* data = GetData();
+    for (int i = 0; i < m_lg; ++i)
     {
-        char c = m_ptr[i];
-        if ( c >= 'a' && c <= 'z' ) m_ptr[i] = c - 'a' + 'A';
+        char c = data[i];
+        if ( c >= 'a' && c <= 'z' ) data[i] = c - 'a' + 'A';
     }
 }
 
 void CBotString::MakeLower()
 {
-    for (size_t i = 0; static_cast<int>(i) < m_lg && static_cast<int>(i) < 1999 ; ++i)
+    char* data = GetData();
+    for (int i = 0; i < m_lg; ++i)
     {
-        char    c = m_ptr[i];
-        if ( c >= 'A' && c <= 'Z' ) m_ptr[i] = c - 'A' + 'a';
+        char    c = data[i];
+        if ( c >= 'A' && c <= 'Z' ) data[i] = c - 'A' + 'a';
     }
 }
 
@@ -348,33 +344,39 @@ bool CBotString::LoadString(unsigned int id)
 {
     const char * str = nullptr;
     str = MapIdToString(static_cast<EID>(id));
-    if (m_ptr != nullptr)
-        delete[] m_ptr;
 
-    m_lg = strlen(str);
-    m_ptr = nullptr;
-    if (m_lg > 0)
-    {
-        m_ptr = new char[m_lg+1];
-        strcpy(m_ptr, str);
-        return true;
-    }
-    return false;
+    Assign(str, strlen(str));
+    return m_lg > 0;
+}
+
+bool CBotString::IsEqual(const char* p, int lg) const
+{
+    return m_lg == lg && memcmp(GetData(), p, lg) == 0;
 }
 
 
 const CBotString& CBotString::operator=(const CBotString& stringSrc)
 {
+    if (this != &stringSrc) Assign(stringSrc.GetData(), stringSrc.m_lg);
+
+    return *this;
+}
+
+const CBotString& CBotString::operator=(CBotString&& stringSrc) NOEXCEPT
+{
+    if (this == &stringSrc) return *this;
+
     delete[] m_ptr;
-    m_ptr = nullptr;
 
-    m_lg = stringSrc.m_lg;
+    m_ptr  = stringSrc.m_ptr;
+    m_lg   = stringSrc.m_lg;
+    m_size = stringSrc.m_size;
+    memcpy(m_small, stringSrc.m_small, SMALL_SIZE);
 
-    if (m_lg > 0)
-    {
-        m_ptr = new char[m_lg+1];
-        strcpy(m_ptr, stringSrc.m_ptr);
-    }
+    stringSrc.m_ptr  = nullptr;
+    stringSrc.m_lg   = 0;
+    stringSrc.m_size = 0;
+    stringSrc.m_small[0] = 0;
 
     return *this;
 }
@@ -382,53 +384,29 @@ const CBotString& CBotString::operator=(const CBotString& stringSrc)
 CBotString operator+(const CBotString& string, const char * lpsz)
 {
     CBotString s(string);
-    s += lpsz;
+    if (lpsz != nullptr) s.Append(lpsz, strlen(lpsz));
     return s;
 }
 
 const CBotString& CBotString::operator+(const CBotString& stringSrc)
 {
-    char* p = new char[m_lg+stringSrc.m_lg+1];
-
-    if (m_ptr!=nullptr) strcpy(p, m_ptr);
-    char* pp = p + m_lg;
-    if (stringSrc.m_ptr!=nullptr) strcpy(pp, stringSrc.m_ptr);
-
-    delete[] m_ptr;
-    m_ptr = p;
-    m_lg += stringSrc.m_lg;
+    Append(stringSrc.GetData(), stringSrc.m_lg);
 
     return *this;
 }
 
 const CBotString& CBotString::operator=(const char ch)
 {
-    delete[] m_ptr;
-
-    m_lg = 1;
-
-    m_ptr = new char[2];
-    m_ptr[0] = ch;
-    m_ptr[1] = 0;
+    // the 0 character would end the string
+    Assign(&ch, ch != 0 ? 1 : 0);
 
     return *this;
 }
 
 const CBotString& CBotString::operator=(const char* pString)
 {
-    delete[] m_ptr;
-    m_ptr = nullptr;
-
-    if (pString != nullptr)
-    {
-        m_lg = strlen(pString);
-
-        if (m_lg != 0)
-        {
-            m_ptr = new char[m_lg+1];
-            strcpy(m_ptr, pString);
-        }
-    }
+    if (pString == nullptr) Empty();
+    else                    Assign(pString, strlen(pString));
 
     return *this;
 }
@@ -436,92 +414,74 @@ const CBotString& CBotString::operator=(const char* pString)
 
 const CBotString& CBotString::operator+=(const char ch)
 {
-    char* p = new char[m_lg+2];
-
-    if (m_ptr != nullptr) strcpy(p, m_ptr);
-    p[m_lg++] = ch;
-    p[m_lg]   = 0;
-
-    delete[] m_ptr;
-
-    m_ptr = p;
+    if (ch != 0) Append(&ch, 1);
 
     return *this;
 }
 
 const CBotString& CBotString::operator+=(const CBotString& str)
 {
-    char* p = new char[m_lg+str.m_lg+1];
-
-    strcpy(p, m_ptr);
-    char* pp = p + m_lg;
-    strcpy(pp, str.m_ptr);
-
-    m_lg = m_lg + str.m_lg;
-
-    delete[] m_ptr;
-
-    m_ptr = p;
+    Append(str.GetData(), str.m_lg);
 
     return *this;
 }
 
-bool CBotString::operator==(const CBotString& str)
+bool CBotString::operator==(const CBotString& str) const
 {
-    return Compare(str) == 0;
+    return IsEqual(str.GetData(), str.m_lg);
 }
 
-bool CBotString::operator==(const char* p)
+bool CBotString::operator==(const char* p) const
 {
     return Compare(p) == 0;
 }
 
-bool CBotString::operator!=(const CBotString& str)
+bool CBotString::operator!=(const CBotString& str) const
 {
-    return Compare(str) != 0;
+    return !IsEqual(str.GetData(), str.m_lg);
 }
 
-bool CBotString::operator!=(const char* p)
+bool CBotString::operator!=(const char* p) const
 {
     return Compare(p) != 0;
 }
 
-bool CBotString::operator>(const CBotString& str)
+bool CBotString::operator>(const CBotString& str) const
 {
     return Compare(str) > 0;
 }
 
-bool CBotString::operator>(const char* p)
+bool CBotString::operator>(const char* p) const
 {
     return Compare(p) > 0;
 }
 
-bool CBotString::operator>=(const CBotString& str)
+bool CBotString::operator>=(const CBotString& str) const
 {
     return Compare(str) >= 0;
 }
 
-bool CBotString::operator>=(const char* p)
+bool CBotString::operator>=(const char* p) const
 {
     return Compare(p) >= 0;
 }
 
-bool CBotString::operator<(const CBotString& str)
+bool CBotString::operator<(const CBotString& str) const
 {
     return Compare(str) < 0;
 }
 
-bool CBotString::operator<(const char* p)
+bool CBotString::operator<(const char* p) const
 {
     return Compare(p) < 0;
 }
 
-bool CBotString::operator<=(const CBotString& str)
+bool CBotString::operator<=(const CBotString& str) const
 {
     return Compare(str) <= 0;
 }
 
-bool CBotString::operator<=(const char* p)
+bool CBotString::operator<=(const char* p) const
 {
     return Compare(p) <= 0;
 }
@@ -536,23 +496,23 @@ void CBotString::Empty()
     delete[] m_ptr;
     m_ptr = nullptr;
     m_lg = 0;
+    m_size = 0;
+    m_small[0] = 0;
 }
 
 static char emptyString[] = {0};
 
 CBotString::operator const char * () const
 {
-    if (this == nullptr || m_ptr == nullptr) return emptyString;
-    return m_ptr;
+    if (this == nullptr) return emptyString;
+    return GetData();
 }
 
 
 int CBotString::Compare(const char * lpsz) const
 {
-    char* p = m_ptr;
     if (lpsz  == nullptr) lpsz = emptyString;
-    if (m_ptr == nullptr) p = emptyString;
-    return strcmp(p, lpsz);    // wcscmp
+    return strcmp(GetData(), lpsz);    // wcscmp
 }
 
 const char * CBotString::MapIdToString(EID id)
@@ -450,9 +450,10 @@ int CBotToken::GetKeyWords(const char* w)
         l = m_ListKeyWords.GetSize();
     }
 
+    int     lg = strlen(w);
     for (i = 0; i < l; i++)
     {
-        if (m_ListKeyWords[i] == w) return m_ListIdKeyWords[ i ];
+        if (m_ListKeyWords[i].IsEqual(w, lg)) return m_ListIdKeyWords[ i ];
     }
 
     return -1;
@@ -463,9 +464,10 @@ bool CBotToken::GetKeyDefNum(const char* w, CBotToken* &token)
     int     i;
     int     l = m_ListKeyDefine.GetSize();
 
+    int     lg = strlen(w);
     for (i = 0; i < l; i++)
     {
-        if (m_ListKeyDefine[i] == w)
+        if (m_ListKeyDefine[i].IsEqual(w, lg))
         {
             token->m_IdKeyWord = m_ListKeyNums[i];
             token->m_type      = TokenTypDef;
@@ -28,8 +28,108 @@
 #include <cassert>
 #include <cmath>
 #include <cstdio>
+#include <mutex>
 
-long CBotVar::m_identcpt = 0;
+std::atomic<long> CBotVar::m_identcpt(9999);   // first number given is 10000
+
+////////////////////////////////////////////////////////////////////
+// Free lists of variables
+// expressions create and destroy a variable for each intermediate
+// result; released blocks are kept by size to be reused.
+// The lists are kept per thread, so that programs running on
+// different threads never share them
+
+namespace
+{
+
+const std::size_t    POOL_GRANULARITY = 16;         // block sizes are rounded to this
+const std::size_t    POOL_MAX_SIZE    = 192;        // larger variables are not kept
+const int            POOL_MAX_FREE    = 512;        // number of blocks kept per size
+
+struct CBotVarBlock
+{
+    CBotVarBlock*    next;
+};
+
+struct CBotVarPool
+{
+    CBotVarBlock*    freeList[POOL_MAX_SIZE / POOL_GRANULARITY] = {};
+    int              freeCount[POOL_MAX_SIZE / POOL_GRANULARITY] = {};
+
+    ~CBotVarPool();
+};
+
+thread_local CBotVarPool   g_varPool;
+thread_local bool          g_varPoolDestroyed = false;  // variables freed at the exit of the thread
+thread_local long          g_heapCount = 0;
+thread_local long          g_pooledCount = 0;
+
+CBotVarPool::~CBotVarPool()
+{
+    for (CBotVarBlock* p : freeList)
+    {
+        while (p != nullptr)
+        {
+            CBotVarBlock* next = p->next;
+            ::operator delete(p);
+            p = next;
+        }
+    }
+    g_varPoolDestroyed = true;
+}
+
+} // anonymous namespace
+
+void* CBotVar::operator new(std::size_t size)
+{
+    if ( size > POOL_MAX_SIZE || g_varPoolDestroyed )
+    {
+        g_heapCount++;
+        return ::operator new(size);
+    }
+
+    int i = (size - 1) / POOL_GRANULARITY;
+    CBotVarBlock* p = g_varPool.freeList[i];
+    if ( p != nullptr )
+    {
+        g_varPool.freeList[i] = p->next;
+        g_varPool.freeCount[i]--;
+        g_pooledCount++;
+        return p;
+    }
+
+    g_heapCount++;
+    return ::operator new((i + 1) * POOL_GRANULARITY);
+}
+
+void CBotVar::operator delete(void* p, std::size_t size)
+{
+    if ( p == nullptr ) return;
+
+    if ( size > POOL_MAX_SIZE || g_varPoolDestroyed )
+    {
+        ::operator delete(p);
+        return;
+    }
+
+    int i = (size - 1) / POOL_GRANULARITY;
+    if ( g_varPool.freeCount[i] >= POOL_MAX_FREE )
+    {
+        ::operator delete(p);
+        return;
+    }
+
+    CBotVarBlock* block = static_cast<CBotVarBlock*>(p);
+    block->next = g_varPool.freeList[i];
+    g_varPool.freeList[i] = block;
+    g_varPool.freeCount[i]++;
+}
+
+void CBotVar::GetAllocCount(long& heap, long& pooled)
+{
+    heap   = g_heapCount;
+    pooled = g_pooledCount;
+}
 
 CBotVar::CBotVar( )
 {
@@ -110,6 +210,7 @@ CBotVarBoolean::CBotVarBoolean( const CBotToken* name )
 }
 
 CBotVarClass* CBotVarClass::m_ExClass = nullptr;
+static std::mutex g_exClassMutex;                   // protects the list of instances
 
 CBotVarClass::CBotVarClass( const CBotToken* name, const CBotTypResult& type)
 {
@@ -154,10 +255,13 @@ void CBotVarClass::InitCBotVarClass( const CBotToken* name, CBotTypResult& type
 
     // se place tout seul dans la liste
     // TODO stands alone in the list (stands only in a list)
-    if (m_ExClass) m_ExClass->m_ExPrev = this;
-    m_ExNext  = m_ExClass;
-    m_ExPrev  = nullptr;
-    m_ExClass = this;
+    {
+        std::lock_guard<std::mutex> lock(g_exClassMutex);
+        if (m_ExClass) m_ExClass->m_ExPrev = this;
+        m_ExNext  = m_ExClass;
+        m_ExPrev  = nullptr;
+        m_ExClass = this;
+    }
 
     CBotClass* pClass = type.GetClass();
     CBotClass* pClass2 = pClass->GetParent();
@@ -184,12 +288,15 @@ CBotVarClass::~CBotVarClass( )
 //        m_Indirect->DecrementUse();
 
     // removes the class list
-    if ( m_ExPrev ) m_ExPrev->m_ExNext = m_ExNext;
-    else m_ExClass = m_ExNext;
+    {
+        std::lock_guard<std::mutex> lock(g_exClassMutex);
+        if ( m_ExPrev ) m_ExPrev->m_ExNext = m_ExNext;
+        else m_ExClass = m_ExNext;
 
-    if ( m_ExNext ) m_ExNext->m_ExPrev = m_ExPrev;
-    m_ExPrev = nullptr;
-    m_ExNext = nullptr;
+        if ( m_ExNext ) m_ExNext->m_ExPrev = m_ExPrev;
+        m_ExPrev = nullptr;
+        m_ExNext = nullptr;
+    }
 
     delete    m_pVar;
 }
@@ -252,8 +359,7 @@ void CBotVar::SetUniqNum(long n)
 
 long CBotVar::NextUniqNum()
 {
-    if (++m_identcpt < 10000) m_identcpt = 10000;
-    return m_identcpt;
+    return ++m_identcpt;
 }
 
 long CBotVar::GetUniqNum()
@@ -506,7 +612,7 @@ void CBotVar::SetInit(CBotVar::InitType bInit)
     }
 }
 
-CBotString CBotVar::GetName()
+const CBotString& CBotVar::GetName()
 {
     return    m_token->GetString();
 }
@@ -1675,8 +1781,7 @@ void CBotVarClass::IncrementUse()
 
 void CBotVarClass::DecrementUse()
 {
-    m_CptUse--;
-    if ( m_CptUse == 0 )
+    if ( --m_CptUse == 0 )
     {
         // if there is one, call the destructor
         // but only if a constructor had been called.
@@ -1684,13 +1789,8 @@ void CBotVarClass::DecrementUse()
         {
             m_CptUse++;    // does not return to the destructor
 
-            // m_error is static in the stack
-            // saves the value for return
-            int    err, start, end;
-            CBotStack*    pile = nullptr;
-            err = pile->GetError(start,end);    // stack == nullptr it does not bother!
-
-            pile = CBotStack::FirstStack();        // clears the error
+            // an independent stack, the error of the running program is kept in its own stack
+            CBotStack*    pile = CBotStack::FirstStack();
             CBotVar*    ppVars[1];
             ppVars[0] = nullptr;
 
@@ -1703,8 +1803,6 @@ void CBotVarClass::DecrementUse()
 
             while ( pile->IsOk() && !m_pClass->ExecuteMethode(ident, nom, pThis, ppVars, pResult, pile, nullptr)) ;    // waits for the end
 
-            pile->ResetError(err, start,end);
-
             pile->Delete();
             delete pThis;
             m_CptUse--;
@@ -1724,6 +1822,7 @@ CBotVarClass* CBotVarClass::GetPointer()
 
 CBotVarClass* CBotVarClass::Find(long id)
 {
+    std::lock_guard<std::mutex> lock(g_exClassMutex);
     CBotVarClass*    p = m_ExClass;
 
     while ( p != nullptr )
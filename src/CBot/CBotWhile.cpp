@@ -977,14 +977,14 @@ bool CBotTry :: Execute(CBotStack* &pj)
         }
 
         val = pile1->GetError();
-        if ( val == 0 && CBotStack::m_initimer == 0 )           // mode step?
+        if ( val == 0 && pile1->m_context->initimer == 0 )      // mode step?
             return false;                                       // does not make the catch
 
         pile1->IncState();
         pile2->SetState(val);                                   // stores the error number
         pile1->SetError(0);                                     // for now there is are more errors!
 
-        if ( val == 0 && CBotStack::m_initimer < 0 )            // mode step?
+        if ( val == 0 && pile1->m_context->initimer < 0 )       // mode step?
             return false;                                       // does not make the catch
     }
 
@@ -37,6 +37,8 @@
 
 #include "graphics/core/nulldevice.h"
 
+#include "graphics/engine/particle.h"
+
 #include "graphics/opengl/glutil.h"
 
 #include "object/object_manager.h"
@@ -53,6 +55,8 @@
 #include <SDL.h>
 #include <SDL_image.h>
 
+#include <algorithm>
+#include <fstream>
 #include <stdlib.h>
 #include <libintl.h>
 #include <getopt.h>
@@ -67,6 +71,31 @@ char CApplication::m_languageLocale[] = { 0 };
 //! Interval of timer called to update joystick state
 const int JOYSTICK_TIMER_INTERVAL = 1000/30;
 
+//! Maximum number of fixed simulation steps between two rendered frames
+const int MAX_FIXED_STEPS_PER_FRAME = 5;
+
+//! Fixed simulation steps per second in batch mode, unless given with -fixedstep
+const int BATCH_FIXED_STEP_RATE = 30;
+
+//! Names of performance counters used in batch mode report
+const char* const PERFORMANCE_COUNTER_NAMES[PCNT_MAX] =
+{
+    "event_processing",
+    "update_all",
+    "update_engine",
+    "update_particle",
+    "update_game",
+    "render_all",
+    "render_particle",
+    "render_water",
+    "render_terrain",
+    "render_objects",
+    "render_interface",
+    "render_shadow_map",
+    "swap_buffers",
+    "all",
+};
+
 //! Function called by the timer
 Uint32 JoystickTimerCallback(Uint32 interval, void *);
 
@@ -132,6 +161,10 @@ CApplication::CApplication(CSystemUtils* systemUtils)
     m_absTime = 0.0f;
     m_relTime = 0.0f;
 
+    m_fixedStepRate = 0;
+    m_fixedStep = 0LL;
+    m_stepAccumulator = 0LL;
+
     m_baseTimeStamp = m_systemUtils->CreateTimeStamp();
     m_curTimeStamp = m_systemUtils->CreateTimeStamp();
     m_lastTimeStamp = m_systemUtils->CreateTimeStamp();
@@ -143,6 +176,8 @@ CApplication::CApplication(CSystemUtils* systemUtils)
     {
         m_performanceCounters[i][0] = m_systemUtils->CreateTimeStamp();
         m_performanceCounters[i][1] = m_systemUtils->CreateTimeStamp();
+        m_performanceCountersData[i] = 0.0f;
+        m_performanceCountersTotal[i] = 0LL;
     }
 
     m_joystickEnabled = false;
@@ -153,6 +188,9 @@ CApplication::CApplication(CSystemUtils* systemUtils)
     m_runSceneRank = 0;
 
     m_sceneTest = false;
+    m_batchTime = 0.0f;
+    m_batchFrames = 0LL;
+    m_particleStress = 0;
     m_headless = false;
     m_resolutionOverride = false;
 
@@ -241,7 +279,11 @@ ParseArgsStatus CApplication::ParseArguments(int argc, char *argv[])
         OPT_MOD,
         OPT_RESOLUTION,
         OPT_HEADLESS,
-        OPT_DEVICE
+        OPT_DEVICE,
+        OPT_FIXEDSTEP,
+        OPT_BATCH,
+        OPT_BATCHTIME,
+        OPT_PARTICLESTRESS
     };
 
     option options[] =
@@ -259,6 +301,10 @@ ParseArgsStatus CApplication::ParseArguments(int argc, char *argv[])
         { "resolution", required_argument, nullptr, OPT_RESOLUTION },
         { "headless", no_argument, nullptr, OPT_HEADLESS },
         { "graphics", required_argument, nullptr, OPT_DEVICE },
+        { "fixedstep", required_argument, nullptr, OPT_FIXEDSTEP },
+        { "batch", required_argument, nullptr, OPT_BATCH },
+        { "batchtime", required_argument, nullptr, OPT_BATCHTIME },
+        { "particlestress", required_argument, nullptr, OPT_PARTICLESTRESS },
         { nullptr, 0, nullptr, 0}
     };
 
@@ -303,6 +349,10 @@ ParseArgsStatus CApplication::ParseArguments(int argc, char *argv[])
                 GetLogger()->Message("  -resolution WxH     set resolution\n");
                 GetLogger()->Message("  -headless           headless mode - disables graphics, sound and user interaction\n");
                 GetLogger()->Message("  -graphics           changes graphics device (defaults to opengl)\n");
+                GetLogger()->Message("  -fixedstep rate     simulate rate fixed steps per second, independently of rendering\n");
+                GetLogger()->Message("  -batch file         run the scene given with -runscene headless and as fast as possible, then write report to file\n");
+                GetLogger()->Message("  -batchtime seconds  in batch mode, stop after given game time if the mission has not ended\n");
+                GetLogger()->Message("  -particlestress n   keep n particles alive around the camera (particle engine benchmark, use with -batch)\n");
                 return PARSE_ARGS_HELP;
             }
             case OPT_DEBUG:
@@ -418,11 +468,61 @@ ParseArgsStatus CApplication::ParseArguments(int argc, char *argv[])
                 m_graphics = optarg;
                 break;
             }
+            case OPT_FIXEDSTEP:
+            {
+                int rate = atoi(optarg);
+                if (rate < 0)
+                {
+                    GetLogger()->Error("Invalid fixed step rate: '%s'\n", optarg);
+                    return PARSE_ARGS_FAIL;
+                }
+                SetFixedStepRate(rate);
+                break;
+            }
+            case OPT_BATCH:
+            {
+                m_batchReport = optarg;
+                break;
+            }
+            case OPT_BATCHTIME:
+            {
+                m_batchTime = static_cast<float>(atof(optarg));
+                if (m_batchTime < 0.0f)
+                {
+                    GetLogger()->Error("Invalid batch time: '%s'\n", optarg);
+                    return PARSE_ARGS_FAIL;
+                }
+                break;
+            }
+            case OPT_PARTICLESTRESS:
+            {
+                m_particleStress = atoi(optarg);
+                if (m_particleStress < 0)
+                {
+                    GetLogger()->Error("Invalid particle count: '%s'\n", optarg);
+                    return PARSE_ARGS_FAIL;
+                }
+                break;
+            }
             default:
                 assert(false); // should never get here
         }
     }
 
+    if (GetBatchMode())
+    {
+        if (m_runSceneCategory == LevelCategory::Max)
+        {
+            GetLogger()->Error("Batch mode requires a scene given with -runscene\n");
+            return PARSE_ARGS_FAIL;
+        }
+
+        GetLogger()->Info("Running in batch mode, report will be written to '%s'\n", m_batchReport.c_str());
+        m_headless = true;
+        if (m_fixedStepRate == 0)
+            SetFixedStepRate(BATCH_FIXED_STEP_RATE);
+    }
+
     return PARSE_ARGS_OK;
 }
 
@@ -988,25 +1088,39 @@ int CApplication::Run()
 
             StartPerformanceCounter(PCNT_UPDATE_ALL);
 
-            // Prepare and process step simulation event
-            Event event = CreateUpdateEvent();
-            if (event.type != EVENT_NULL && m_controller != nullptr)
+            if (m_fixedStepRate > 0)
             {
-                LogEvent(event);
-
-                m_sound->FrameMove(m_relTime);
-
-                StartPerformanceCounter(PCNT_UPDATE_GAME);
-                m_controller->ProcessEvent(event);
-                StopPerformanceCounter(PCNT_UPDATE_GAME);
+                // Prepare and process fixed simulation steps
+                int steps = PrepareFixedSteps();
+                for (int i = 0; i < steps; ++i)
+                {
+                    m_engine->BeginSimulationStep();
+                    ProcessUpdateEvent(CreateFixedUpdateEvent());
+                }
 
-                StartPerformanceCounter(PCNT_UPDATE_ENGINE);
-                m_engine->FrameUpdate();
-                StopPerformanceCounter(PCNT_UPDATE_ENGINE);
+                m_engine->SetStepInterpolation(static_cast<float>(m_stepAccumulator) / m_fixedStep);
+            }
+            else
+            {
+                // Prepare and process step simulation event
+                ProcessUpdateEvent(CreateUpdateEvent());
             }
 
             StopPerformanceCounter(PCNT_UPDATE_ALL);
 
+            if (GetBatchMode())
+            {
+                // Nobody is watching, skip rendering altogether
+                StopPerformanceCounter(PCNT_ALL);
+                UpdatePerformanceCountersData();
+                m_batchFrames++;
+
+                if (IsBatchTimeOver())
+                    goto end; // exit the loop
+
+                continue;
+            }
+
             /* Update mouse position explicitly right before rendering
              * because mouse events are usually way behind */
             UpdateMouse();
@@ -1025,6 +1139,9 @@ int CApplication::Run()
     }
 
 end:
+    if (GetBatchMode() && !WriteBatchReport())
+        m_exitCode = 8;
+
     return m_exitCode;
 }
 
@@ -1351,6 +1468,7 @@ void CApplication::InternalResumeSimulation()
     m_systemUtils->CopyTimeStamp(m_curTimeStamp, m_baseTimeStamp);
     m_realAbsTimeBase = m_realAbsTime;
     m_absTimeBase = m_exactAbsTime;
+    m_stepAccumulator = 0LL;
 }
 
 bool CApplication::GetSimulationSuspended() const
@@ -1369,15 +1487,12 @@ void CApplication::SetSimulationSpeed(float speed)
     GetLogger()->Info("Simulation speed = %.2f\n", speed);
 }
 
-Event CApplication::CreateUpdateEvent()
+bool CApplication::UpdateRealTime(long long& absDiff)
 {
-    if (m_simulationSuspended)
-        return Event(EVENT_NULL);
-
     m_systemUtils->CopyTimeStamp(m_lastTimeStamp, m_curTimeStamp);
     m_systemUtils->GetCurrentTimeStamp(m_curTimeStamp);
 
-    long long absDiff = m_systemUtils->TimeStampExactDiff(m_baseTimeStamp, m_curTimeStamp);
+    absDiff = m_systemUtils->TimeStampExactDiff(m_baseTimeStamp, m_curTimeStamp);
     long long newRealAbsTime = m_realAbsTimeBase + absDiff;
     long long newRealRelTime = m_systemUtils->TimeStampExactDiff(m_lastTimeStamp, m_curTimeStamp);
 
@@ -1386,19 +1501,66 @@ Event CApplication::CreateUpdateEvent()
         GetLogger()->Error("Fatal error: got negative system counter difference!\n");
         GetLogger()->Error("This should never happen. Please report this error.\n");
         m_eventQueue->AddEvent(Event(EVENT_SYS_QUIT));
-        return Event(EVENT_NULL);
+        return false;
     }
+
+    m_realAbsTime = newRealAbsTime;
+    m_realRelTime = newRealRelTime;
+    return true;
+}
+
+Event CApplication::CreateUpdateEvent()
+{
+    if (m_simulationSuspended)
+        return Event(EVENT_NULL);
+
+    long long absDiff = 0;
+    if (!UpdateRealTime(absDiff))
+        return Event(EVENT_NULL);
+
+    // m_baseTimeStamp is updated on simulation speed change, so this is OK
+    m_exactAbsTime = m_absTimeBase + m_simulationSpeed * absDiff;
+    m_absTime = (m_absTimeBase + m_simulationSpeed * absDiff) / 1e9f;
+
+    m_exactRelTime = m_simulationSpeed * m_realRelTime;
+    m_relTime = (m_simulationSpeed * m_realRelTime) / 1e9f;
+
+    Event frameEvent(EVENT_FRAME);
+    frameEvent.rTime = m_relTime;
+    m_input->EventProcess(frameEvent);
+
+    return frameEvent;
+}
+
+int CApplication::PrepareFixedSteps()
+{
+    if (m_simulationSuspended)
+        return 0;
+
+    long long absDiff = 0;
+    if (!UpdateRealTime(absDiff))
+        return 0;
+
+    if (m_headless)
+        m_stepAccumulator += m_fixedStep; // nothing to keep pace with, run as fast as possible
     else
-    {
-        m_realAbsTime = newRealAbsTime;
-        // m_baseTimeStamp is updated on simulation speed change, so this is OK
-        m_exactAbsTime = m_absTimeBase + m_simulationSpeed * absDiff;
-        m_absTime = (m_absTimeBase + m_simulationSpeed * absDiff) / 1e9f;
+        m_stepAccumulator += static_cast<long long>(m_simulationSpeed * m_realRelTime);
 
-        m_realRelTime = newRealRelTime;
-        m_exactRelTime = m_simulationSpeed * m_realRelTime;
-        m_relTime = (m_simulationSpeed * m_realRelTime) / 1e9f;
-    }
+    int steps = static_cast<int>(m_stepAccumulator / m_fixedStep);
+    m_stepAccumulator %= m_fixedStep;
+
+    // After a long frame, the simulation slows down rather than
+    // running so many steps that the next frame is even longer
+    return std::min(steps, MAX_FIXED_STEPS_PER_FRAME);
+}
+
+Event CApplication::CreateFixedUpdateEvent()
+{
+    m_exactRelTime = m_fixedStep;
+    m_relTime = m_fixedStep / 1e9f;
+
+    m_exactAbsTime += m_fixedStep;
+    m_absTime = m_exactAbsTime / 1e9f;
 
     Event frameEvent(EVENT_FRAME);
     frameEvent.rTime = m_relTime;
@@ -1407,6 +1569,50 @@ Event CApplication::CreateUpdateEvent()
     return frameEvent;
 }
 
+void CApplication::ProcessUpdateEvent(Event event)
+{
+    if (event.type == EVENT_NULL || m_controller == nullptr)
+        return;
+
+    LogEvent(event);
+
+    m_sound->FrameMove(m_relTime);
+
+    StartPerformanceCounter(PCNT_UPDATE_GAME);
+    m_controller->ProcessEvent(event);
+    StopPerformanceCounter(PCNT_UPDATE_GAME);
+
+    if (m_particleStress > 0)
+        UpdateParticleStress();
+
+    StartPerformanceCounter(PCNT_UPDATE_ENGINE);
+    m_engine->FrameUpdate();
+    StopPerformanceCounter(PCNT_UPDATE_ENGINE);
+}
+
+void CApplication::SetFixedStepRate(int updatesPerSecond)
+{
+    m_fixedStepRate = std::max(updatesPerSecond, 0);
+    m_fixedStep = m_fixedStepRate > 0 ? 1000000000LL / m_fixedStepRate : 0LL;
+    m_stepAccumulator = 0LL;
+
+    // Absolute time goes on from its current value in both modes
+    m_systemUtils->GetCurrentTimeStamp(m_baseTimeStamp);
+    m_systemUtils->CopyTimeStamp(m_curTimeStamp, m_baseTimeStamp);
+    m_realAbsTimeBase = m_realAbsTime;
+    m_absTimeBase = m_exactAbsTime;
+
+    if (m_fixedStepRate == 0 && m_engine != nullptr)
+        m_engine->SetStepInterpolation(-1.0f);
+
+    GetLogger()->Info("Fixed step rate = %d\n", m_fixedStepRate);
+}
+
+int CApplication::GetFixedStepRate() const
+{
+    return m_fixedStepRate;
+}
+
 float CApplication::GetSimulationSpeed() const
 {
     return m_simulationSpeed;
@@ -1825,6 +2031,11 @@ float CApplication::GetPerformanceCounterData(PerformanceCounter counter) const
     return m_performanceCountersData[counter];
 }
 
+long long CApplication::GetPerformanceCounterTotal(PerformanceCounter counter) const
+{
+    return m_performanceCountersTotal[counter];
+}
+
 void CApplication::ResetPerformanceCounters()
 {
     for (int i = 0; i < PCNT_MAX; ++i)
@@ -1846,6 +2057,7 @@ void CApplication::UpdatePerformanceCountersData()
 
         m_performanceCountersData[static_cast<PerformanceCounter>(i)] =
             static_cast<float>(diff) / static_cast<float>(sum);
+        m_performanceCountersTotal[i] += diff;
     }
 }
 
@@ -1853,3 +2065,95 @@ bool CApplication::GetSceneTestMode()
 {
     return m_sceneTest;
 }
+
+bool CApplication::GetBatchMode() const
+{
+    return !m_batchReport.empty();
+}
+
+bool CApplication::IsBatchTimeOver()
+{
+    if (m_batchTime <= 0.0f || m_controller == nullptr)
+        return false;
+
+    return m_controller->GetRobotMain()->GetGameTime() >= m_batchTime;
+}
+
+bool CApplication::WriteBatchReport()
+{
+    std::string result = "aborted";
+    float gameTime = 0.0f;
+    if (m_controller != nullptr)
+    {
+        CRobotMain* robotMain = m_controller->GetRobotMain();
+        gameTime = robotMain->GetGameTime();
+
+        Error missionResult = robotMain->GetMissionResult();
+        if (missionResult == INFO_LOST || missionResult == INFO_LOSTq)
+            result = "lost";
+        else if (IsBatchTimeOver())
+            result = "timeout";
+        else if (missionResult == ERR_OK)
+            result = "won";
+    }
+
+    std::ofstream report(m_batchReport);
+    if (!report.good())
+    {
+        GetLogger()->Error("Unable to write batch report to '%s'\n", m_batchReport.c_str());
+        return false;
+    }
+
+    report << "{\n";
+    report << "  \"result\": \"" << result << "\",\n";
+    report << "  \"game_time\": " << gameTime << ",\n";
+    report << "  \"real_time\": " << m_realAbsTime / 1e9 << ",\n";
+    report << "  \"frames\": " << m_batchFrames << ",\n";
+    report << "  \"step_rate\": " << m_fixedStepRate << ",\n";
+    report << "  \"particle_stress\": " << m_particleStress << ",\n";
+    report << "  \"performance_counters\": {\n";
+    for (int i = 0; i < PCNT_MAX; ++i)
+    {
+        report << "    \"" << PERFORMANCE_COUNTER_NAMES[i] << "\": " << m_performanceCountersTotal[i] / 1e9;
+        report << (i + 1 < PCNT_MAX ? ",\n" : "\n");
+    }
+    report << "  }\n";
+    report << "}\n";
+
+    GetLogger()->Info("Batch run ended with result '%s' after %.2f s of game time\n", result.c_str(), gameTime);
+    return report.good();
+}
+
+void CApplication::UpdateParticleStress()
+{
+    // A mix of particles with different update and drawing code
+    static const Gfx::ParticleType types[] =
+    {
+        Gfx::PARTISMOKE1, Gfx::PARTIGAS, Gfx::PARTIBLUE,
+        Gfx::PARTIGLINT,  Gfx::PARTIFIRE, Gfx::PARTIFLIC
+    };
+    const int typeCount = sizeof(types) / sizeof(types[0]);
+
+    Gfx::CParticle* particle = m_engine->GetParticle();
+    Math::Vector center = m_engine->GetLookatPt();
+
+    int missing = m_particleStress - particle->GetParticleCount();
+    for (int i = 0; i < missing; ++i)
+    {
+        Math::Vector pos = center;
+        pos.x += (Math::Rand()-0.5f)*100.0f;
+        pos.y += Math::Rand()*20.0f;
+        pos.z += (Math::Rand()-0.5f)*100.0f;
+
+        Math::Vector speed;
+        speed.x = (Math::Rand()-0.5f)*10.0f;
+        speed.y = Math::Rand()*10.0f;
+        speed.z = (Math::Rand()-0.5f)*10.0f;
+
+        float duration = 1.0f+Math::Rand()*3.0f;
+        float mass = (i % 2 == 0) ? 20.0f : 0.0f;  // half of them fall and bounce
+
+        // Fails when the pool of this type is full, see ParticlePoolSize setting
+        particle->CreateParticle(pos, speed, Math::Point(1.0f, 1.0f), types[i % typeCount], duration, mass);
+    }
+}
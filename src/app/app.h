@@ -240,6 +240,15 @@ public:
     float           GetSimulationSpeed() const;
     //@}
 
+    //@{
+    //! Management of fixed simulation step
+    /** With a rate > 0, the simulation advances in steps of 1/rate seconds and rendered frames
+     *  are interpolated between the last two steps. In headless mode, the simulation then
+     *  runs one step per loop, as fast as possible. Rate 0 means one step per rendered frame. */
+    void            SetFixedStepRate(int updatesPerSecond);
+    int             GetFixedStepRate() const;
+    //@}
+
     //! Returns the absolute time counter [seconds]
     float       GetAbsTime() const;
     //! Returns the exact absolute time counter [nanoseconds]
@@ -318,10 +327,15 @@ public:
     void        StartPerformanceCounter(PerformanceCounter counter);
     void        StopPerformanceCounter(PerformanceCounter counter);
     float       GetPerformanceCounterData(PerformanceCounter counter) const;
+    //! Returns the time spent in given counter since start [nanoseconds]
+    long long   GetPerformanceCounterTotal(PerformanceCounter counter) const;
     //@}
 
     bool        GetSceneTestMode();
 
+    //! Returns true if running a scene in batch mode (see -batch option)
+    bool        GetBatchMode() const;
+
     //! Renders the image in window
     void        Render();
 
@@ -338,6 +352,14 @@ protected:
     Event       CreateVirtualEvent(const Event& sourceEvent);
     //! Prepares a simulation update event
     TEST_VIRTUAL Event CreateUpdateEvent();
+    //! Reads the system clock and returns the number of fixed steps to simulate
+    TEST_VIRTUAL int PrepareFixedSteps();
+    //! Prepares a simulation update event for one fixed step
+    TEST_VIRTUAL Event CreateFixedUpdateEvent();
+    //! Updates real time counters from the system clock; returns false on clock error
+    bool        UpdateRealTime(long long& absDiff);
+    //! Processes a simulation update event
+    void        ProcessUpdateEvent(Event event);
     //! Logs debug data for event
     void        LogEvent(const Event& event);
 
@@ -354,6 +376,13 @@ protected:
     //! Updates performance counters from gathered timer data
     void UpdatePerformanceCountersData();
 
+    //! Returns true if the game time limit of batch mode was reached
+    bool IsBatchTimeOver();
+    //! Writes the report of batch mode run
+    bool WriteBatchReport();
+    //! Creates particles until there are as many as requested with -particlestress
+    void UpdateParticleStress();
+
 protected:
     //! System utils instance
     CSystemUtils* m_systemUtils;
@@ -402,6 +431,7 @@ protected:
 
     SystemTimeStamp* m_performanceCounters[PCNT_MAX][2];
     float            m_performanceCountersData[PCNT_MAX];
+    long long        m_performanceCountersTotal[PCNT_MAX];
 
     long long       m_realAbsTimeBase;
     long long       m_realAbsTime;
@@ -416,6 +446,13 @@ protected:
 
     float           m_simulationSpeed;
     bool            m_simulationSuspended;
+
+    //! Fixed simulation steps per second; 0 if disabled
+    int             m_fixedStepRate;
+    //! Length of fixed simulation step [nanoseconds]
+    long long       m_fixedStep;
+    //! Simulation time not yet consumed by fixed steps [nanoseconds]
+    long long       m_stepAccumulator;
     //@}
 
     SystemTimeStamp* m_manualFrameLast;
@@ -445,6 +482,18 @@ protected:
     //! Scene test mode
     bool            m_sceneTest;
 
+    //@{
+    //! Batch mode: file to write the report to; empty if disabled
+    std::string     m_batchReport;
+    //! Batch mode: game time after which the run is stopped [seconds]; 0 if no limit
+    float           m_batchTime;
+    //! Batch mode: number of frames run
+    long long       m_batchFrames;
+    //@}
+
+    //! Number of particles kept alive for benchmarking the particle engine; 0 if disabled
+    int             m_particleStress;
+
     //! Application language
     Language        m_language;
 
@@ -26,7 +26,9 @@
 
 
 #include <iostream>
+#include <vector>
 
+#include <cstdint>
 #include <cstring>
 
 namespace IOUtils
@@ -163,5 +165,28 @@ std::string ReadBinaryString(std::istream &istr)
     return str;
 }
 
+//! Returns 64-bit FNV-1a hash of everything left in input stream
+/**
+ * Used to detect that a source file changed since a file generated from it was written.
+ */
+inline uint64_t HashStream(std::istream &istr)
+{
+    uint64_t hash = 14695981039346656037ULL;
+
+    std::vector<char> buffer(64 * 1024);
+    while (istr)
+    {
+        istr.read(buffer.data(), buffer.size());
+        std::streamsize count = istr.gcount();
+        for (std::streamsize i = 0; i < count; ++i)
+        {
+            hash ^= static_cast<unsigned char>(buffer[i]);
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
 } // namespace IOUtils
 
@@ -0,0 +1,156 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+
+#include "common/resources/mapped_file.h"
+
+#if PLATFORM_WINDOWS
+    #include "app/system_windows.h"
+
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+CMappedFile::CMappedFile()
+    : m_data(nullptr)
+    , m_size(0)
+#if PLATFORM_WINDOWS
+    , m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(nullptr)
+#endif
+{
+}
+
+CMappedFile::~CMappedFile()
+{
+    Close();
+}
+
+#if PLATFORM_WINDOWS
+
+bool CMappedFile::Open(const std::string& path)
+{
+    Close();
+
+    HANDLE file = CreateFileW(CSystemUtilsWindows::UTF8_Decode(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    m_file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        Close();
+        return false;
+    }
+    m_mapping = mapping;
+
+    m_data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    return true;
+}
+
+void CMappedFile::Close()
+{
+    if (m_data != nullptr)
+        UnmapViewOfFile(m_data);
+    if (m_mapping != nullptr)
+        CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool CMappedFile::Open(const std::string& path)
+{
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping stays valid
+
+    if (data == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<const unsigned char*>(data);
+    m_size = static_cast<std::size_t>(info.st_size);
+    return true;
+}
+
+void CMappedFile::Close()
+{
+    if (m_data != nullptr)
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif
+
+bool CMappedFile::IsOpen() const
+{
+    return m_data != nullptr;
+}
+
+const unsigned char* CMappedFile::GetData() const
+{
+    return m_data;
+}
+
+std::size_t CMappedFile::GetSize() const
+{
+    return m_size;
+}
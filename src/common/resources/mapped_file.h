@@ -0,0 +1,69 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+/**
+ * \file common/resources/mapped_file.h
+ * \brief CMappedFile - read-only memory mapping of a file
+ */
+
+#pragma once
+
+#include "common/config.h"
+
+#include <cstddef>
+#include <string>
+
+
+/**
+ * \class CMappedFile
+ * \brief Maps a whole file into memory for reading
+ *
+ * Unlike the rest of resource classes, this works with real paths, not PHYSFS
+ * ones, as PHYSFS cannot map files. Use it only for files in the save location
+ * (see CResourceManager::GetSaveLocation()).
+ */
+class CMappedFile
+{
+public:
+    CMappedFile();
+    ~CMappedFile();
+
+    CMappedFile(const CMappedFile&) = delete;
+    CMappedFile& operator=(const CMappedFile&) = delete;
+
+    //! Maps file at \a path, closing the previous one; returns false on error or if the file is empty
+    bool Open(const std::string& path);
+    //! Unmaps the file
+    void Close();
+
+    bool IsOpen() const;
+    //! Returns the mapped contents
+    const unsigned char* GetData() const;
+    //! Returns the size of file in bytes
+    std::size_t GetSize() const;
+
+private:
+    const unsigned char* m_data;
+    std::size_t m_size;
+#if PLATFORM_WINDOWS
+    void* m_file;
+    void* m_mapping;
+#endif
+};
@@ -109,6 +109,31 @@ std::string CResourceManager::GetSaveLocation()
     return "";
 }
 
+std::string CResourceManager::GetRealPath(const std::string& filename)
+{
+    if (PHYSFS_isInit())
+    {
+        const char* dir = PHYSFS_getRealDir(CleanPath(filename).c_str());
+        if (dir == nullptr)
+            return "";
+
+        try
+        {
+            #if PLATFORM_WINDOWS
+            bool isDirectory = fs::is_directory(CSystemUtilsWindows::UTF8_Decode(dir));
+            #else
+            bool isDirectory = fs::is_directory(dir);
+            #endif
+            if (isDirectory)
+                return std::string(dir) + "/" + CleanPath(filename);
+        }
+        catch (std::exception&)
+        {
+        }
+    }
+    return "";
+}
+
 std::unique_ptr<CSDLFileWrapper> CResourceManager::GetSDLFileHandler(const std::string &filename)
 {
     return MakeUnique<CSDLFileWrapper>(CleanPath(filename));
@@ -39,6 +39,8 @@ public:
 
     static bool SetSaveLocation(const std::string &location);
     static std::string GetSaveLocation();
+    //! Returns path of \a filename in the real filesystem, or empty string if it is not in a directory (e.g. in an archive)
+    static std::string GetRealPath(const std::string &filename);
 
     static std::unique_ptr<CSDLFileWrapper> GetSDLFileHandler(const std::string &filename);
     static std::unique_ptr<CSNDFileWrapper> GetSNDFileHandler(const std::string &filename);
@@ -26,6 +26,7 @@
 
 #include "graphics/engine/camera.h"
 #include "graphics/engine/engine.h"
+#include "graphics/engine/particle.h"
 
 #include "level/robotmain.h"
 
@@ -89,6 +90,7 @@ void CSettings::SaveSettings()
     GetConfigFile().SetBoolProperty("Setup", "LightMode", engine->GetLightMode());
     GetConfigFile().SetIntProperty("Setup", "UseJoystick", app->GetJoystickEnabled() ? app->GetJoystick().index : -1);
     GetConfigFile().SetFloatProperty("Setup", "ParticleDensity", engine->GetParticleDensity());
+    GetConfigFile().SetIntProperty("Setup", "ParticlePoolSize", engine->GetParticle()->GetPoolSize());
     GetConfigFile().SetFloatProperty("Setup", "ClippingDistance", engine->GetClippingDistance());
     GetConfigFile().SetIntProperty("Setup", "AudioVolume", sound->GetAudioVolume());
     GetConfigFile().SetIntProperty("Setup", "MusicVolume", sound->GetMusicVolume());
@@ -203,6 +205,9 @@ void CSettings::LoadSettings()
     if (GetConfigFile().GetFloatProperty("Setup", "ParticleDensity", fValue))
         engine->SetParticleDensity(fValue);
 
+    if (GetConfigFile().GetIntProperty("Setup", "ParticlePoolSize", iValue))
+        engine->GetParticle()->SetPoolSize(iValue);
+
     if (GetConfigFile().GetFloatProperty("Setup", "ClippingDistance", fValue))
         engine->SetClippingDistance(fValue);
 
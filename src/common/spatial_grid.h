@@ -0,0 +1,213 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file common/spatial_grid.h
+ * \brief CSpatialGrid - uniform grid index on the XZ plane
+ */
+
+#pragma once
+
+#include "math/vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * \class CSpatialGrid
+ * \brief Uniform grid of items keyed on their XZ position
+ *
+ * Items are bucketed into square cells of given size. Only non-empty cells
+ * are stored, so the grid is unbounded and its memory usage depends only
+ * on the number of items.
+ *
+ * Queries return every item whose cell overlaps the square around the
+ * query center. The caller is responsible for exact distance tests.
+ */
+template<typename T>
+class CSpatialGrid
+{
+public:
+    explicit CSpatialGrid(float cellSize)
+        : m_cellSize(cellSize)
+    {
+        assert(cellSize > 0.0f);
+    }
+
+    //! Adds item at given position, or moves it if already present
+    void Insert(T item, const Math::Vector& pos)
+    {
+        CellKey key = GetKey(pos);
+
+        auto it = m_itemCells.find(item);
+        if (it != m_itemCells.end())
+        {
+            if (it->second == key)
+                return;
+
+            RemoveFromCell(item, it->second);
+            it->second = key;
+        }
+        else
+        {
+            m_itemCells[item] = key;
+        }
+
+        m_cells[key].push_back(item);
+    }
+
+    //! Moves an item already present in the grid; unknown items are ignored
+    void Update(T item, const Math::Vector& pos)
+    {
+        auto it = m_itemCells.find(item);
+        if (it == m_itemCells.end())
+            return;
+
+        CellKey key = GetKey(pos);
+        if (it->second == key)
+            return;
+
+        RemoveFromCell(item, it->second);
+        it->second = key;
+        m_cells[key].push_back(item);
+    }
+
+    //! Removes item from the grid
+    void Remove(T item)
+    {
+        auto it = m_itemCells.find(item);
+        if (it == m_itemCells.end())
+            return;
+
+        RemoveFromCell(item, it->second);
+        m_itemCells.erase(it);
+    }
+
+    //! Removes all items
+    void Clear()
+    {
+        m_cells.clear();
+        m_itemCells.clear();
+    }
+
+    //! Returns true if item is present in the grid
+    bool Contains(T item) const
+    {
+        return m_itemCells.find(item) != m_itemCells.end();
+    }
+
+    //! Returns number of items
+    std::size_t GetCount() const
+    {
+        return m_itemCells.size();
+    }
+
+    //! Appends to \a result all items in cells overlapping the square of half-side \a radius around \a center
+    void Query(const Math::Vector& center, float radius, std::vector<T>& result) const
+    {
+        int minX = GetCoord(center.x - radius);
+        int maxX = GetCoord(center.x + radius);
+        int minZ = GetCoord(center.z - radius);
+        int maxZ = GetCoord(center.z + radius);
+
+        // When the range spans more cells than there are occupied ones,
+        // it is cheaper to filter the occupied cells directly
+        double rangeCells = (static_cast<double>(maxX) - minX + 1.0) * (static_cast<double>(maxZ) - minZ + 1.0);
+        if (rangeCells > static_cast<double>(m_cells.size()))
+        {
+            for (const auto& cell : m_cells)
+            {
+                int x = GetKeyX(cell.first);
+                int z = GetKeyZ(cell.first);
+                if (x < minX || x > maxX || z < minZ || z > maxZ)
+                    continue;
+
+                result.insert(result.end(), cell.second.begin(), cell.second.end());
+            }
+            return;
+        }
+
+        for (int x = minX; x <= maxX; ++x)
+        {
+            for (int z = minZ; z <= maxZ; ++z)
+            {
+                auto it = m_cells.find(MakeKey(x, z));
+                if (it == m_cells.end())
+                    continue;
+
+                result.insert(result.end(), it->second.begin(), it->second.end());
+            }
+        }
+    }
+
+private:
+    using CellKey = std::uint64_t;
+
+    int GetCoord(float value) const
+    {
+        return static_cast<int>(std::floor(value / m_cellSize));
+    }
+
+    static CellKey MakeKey(int x, int z)
+    {
+        return (static_cast<CellKey>(static_cast<std::uint32_t>(x)) << 32) |
+                static_cast<CellKey>(static_cast<std::uint32_t>(z));
+    }
+
+    static int GetKeyX(CellKey key)
+    {
+        return static_cast<int>(static_cast<std::uint32_t>(key >> 32));
+    }
+
+    static int GetKeyZ(CellKey key)
+    {
+        return static_cast<int>(static_cast<std::uint32_t>(key & 0xFFFFFFFFu));
+    }
+
+    CellKey GetKey(const Math::Vector& pos) const
+    {
+        return MakeKey(GetCoord(pos.x), GetCoord(pos.z));
+    }
+
+    void RemoveFromCell(T item, CellKey key)
+    {
+        auto cellIt = m_cells.find(key);
+        assert(cellIt != m_cells.end());
+
+        auto& items = cellIt->second;
+        auto it = std::find(items.begin(), items.end(), item);
+        assert(it != items.end());
+
+        *it = items.back();
+        items.pop_back();
+
+        if (items.empty())
+            m_cells.erase(cellIt);
+    }
+
+private:
+    float m_cellSize;
+    std::unordered_map<CellKey, std::vector<T>> m_cells;
+    std::unordered_map<T, CellKey> m_itemCells;
+};
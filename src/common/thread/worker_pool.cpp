@@ -0,0 +1,136 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+#include "common/thread/worker_pool.h"
+
+#include "common/logger.h"
+
+#include <thread>
+
+
+CWorkerPool::CWorkerPool(int threadCount)
+    : m_nextTask(0)
+{
+    if (threadCount < 0)
+        threadCount = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+
+    for (int i = 0; i < threadCount; ++i)
+    {
+        SDL_Thread* thread = SDL_CreateThread(WorkerMain, this);
+        if (thread == nullptr)
+        {
+            GetLogger()->Warn("Could not create worker thread, using %d threads\n", i);
+            break;
+        }
+        m_threads.push_back(thread);
+    }
+}
+
+CWorkerPool::~CWorkerPool()
+{
+    SDL_LockMutex(*m_mutex);
+    m_quit = true;
+    SDL_CondBroadcast(*m_startCond);
+    SDL_UnlockMutex(*m_mutex);
+
+    for (SDL_Thread* thread : m_threads)
+        SDL_WaitThread(thread, nullptr);
+}
+
+int CWorkerPool::GetThreadCount() const
+{
+    return static_cast<int>(m_threads.size());
+}
+
+void CWorkerPool::Run(int count, const std::function<void(int)>& task)
+{
+    if (count <= 0)
+        return;
+
+    m_task = &task;
+    m_taskCount = count;
+    m_nextTask = 0;
+
+    if (m_threads.empty() || count == 1)
+    {
+        ProcessTasks();
+        m_task = nullptr;
+        return;
+    }
+
+    SDL_LockMutex(*m_mutex);
+    m_busyThreads = static_cast<int>(m_threads.size());
+    m_generation++;
+    SDL_CondBroadcast(*m_startCond);
+    SDL_UnlockMutex(*m_mutex);
+
+    ProcessTasks();
+
+    SDL_LockMutex(*m_mutex);
+    while (m_busyThreads > 0)
+        SDL_CondWait(*m_doneCond, *m_mutex);
+    SDL_UnlockMutex(*m_mutex);
+
+    m_task = nullptr;
+}
+
+int CWorkerPool::WorkerMain(void* data)
+{
+    static_cast<CWorkerPool*>(data)->WorkerLoop();
+    return 0;
+}
+
+void CWorkerPool::WorkerLoop()
+{
+    int generation = 0;
+
+    SDL_LockMutex(*m_mutex);
+    for (;;)
+    {
+        while (!m_quit && m_generation == generation)
+            SDL_CondWait(*m_startCond, *m_mutex);
+
+        if (m_quit)
+            break;
+
+        generation = m_generation;
+        SDL_UnlockMutex(*m_mutex);
+
+        ProcessTasks();
+
+        SDL_LockMutex(*m_mutex);
+        if (--m_busyThreads == 0)
+            SDL_CondSignal(*m_doneCond);
+    }
+    SDL_UnlockMutex(*m_mutex);
+}
+
+void CWorkerPool::ProcessTasks()
+{
+    const std::function<void(int)>& task = *m_task;
+    for (;;)
+    {
+        int i = m_nextTask++;
+        if (i >= m_taskCount)
+            break;
+
+        task(i);
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+/**
+ * \file common/thread/worker_pool.h
+ * \brief CWorkerPool - runs independent tasks on worker threads
+ */
+
+#pragma once
+
+#include "common/thread/sdl_cond_wrapper.h"
+#include "common/thread/sdl_mutex_wrapper.h"
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+
+/**
+ * \class CWorkerPool
+ * \brief Pool of worker threads running numbered tasks
+ *
+ * Run() calls the given function once for each task index and returns when
+ * all calls are done. Indices are handed out one by one from a shared counter,
+ * so threads which finish early take over the remaining tasks. The calling
+ * thread takes part in the work. With a single core, everything runs on
+ * the calling thread.
+ *
+ * Tasks must not depend on each other nor on the order they are run in.
+ */
+class CWorkerPool
+{
+public:
+    //! Creates the pool; \a threadCount < 0 means one thread less than the number of cores
+    explicit CWorkerPool(int threadCount = -1);
+    ~CWorkerPool();
+
+    CWorkerPool(const CWorkerPool&) = delete;
+    CWorkerPool& operator=(const CWorkerPool&) = delete;
+
+    //! Returns the number of worker threads
+    int GetThreadCount() const;
+
+    //! Calls \a task for every index in [0, \a count) and waits for all of them to finish
+    void Run(int count, const std::function<void(int)>& task);
+
+private:
+    static int WorkerMain(void* data);
+    void WorkerLoop();
+    void ProcessTasks();
+
+private:
+    std::vector<SDL_Thread*> m_threads;
+    CSDLMutexWrapper m_mutex;
+    CSDLCondWrapper m_startCond;
+    CSDLCondWrapper m_doneCond;
+
+    const std::function<void(int)>* m_task = nullptr;
+    int m_taskCount = 0;
+    std::atomic<int> m_nextTask;
+    int m_generation = 0;       // incremented for each Run()
+    int m_busyThreads = 0;      // workers still processing current generation
+    bool m_quit = false;
+};
@@ -36,6 +36,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 
 class CImage;
@@ -309,8 +310,13 @@ public:
     virtual Texture CreateTexture(CImage *image, const TextureCreateParams &params) = 0;
     //! Creates a texture from raw image data; image data can be freed after that
     virtual Texture CreateTexture(ImageData *data, const TextureCreateParams &params) = 0;
+    //! Creates a texture from raw image data of each mipmap level, starting from the full size; image data can be freed after that
+    /** Mipmap levels are generated only if \a levels has just one */
+    virtual Texture CreateTexture(const std::vector<ImageData*> &levels, const TextureCreateParams &params) = 0;
     //! Creates a depth texture with specific dimensions and depth
     virtual Texture CreateDepthTexture(int width, int height, int depth) = 0;
+    //! Replaces part of a texture with raw image data, starting at \a offset in pixels
+    virtual void UpdateTexture(const Texture& texture, Math::IntPoint offset, ImageData* data, TexImgFormat format) = 0;
     //! Deletes a given texture, freeing it from video memory
     virtual void DestroyTexture(const Texture &texture) = 0;
     //! Deletes all textures created so far
@@ -352,6 +358,10 @@ public:
     //! Creates a static buffer composed of given primitives with solid color
     virtual unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount) = 0;
 
+    //! Creates a static buffer with multitexturing whose primitives are given by \a indices to \a vertices
+    virtual unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                                            const unsigned int* indices, int indexCount) = 0;
+
     //! Updates the static buffer composed of given primitives with single texture vertices
     virtual void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const Vertex* vertices, int vertexCount) = 0;
 
@@ -361,12 +371,22 @@ public:
     //! Updates the static buffer composed of given primitives with solid color
     virtual void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount) = 0;
 
-    //! Draws a static buffer
+    //! Updates the static buffer with multitexturing whose primitives are given by \a indices to \a vertices
+    virtual void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                                    const unsigned int* indices, int indexCount) = 0;
+
+    //! Draws a static buffer, using its indices if it has them
     virtual void DrawStaticBuffer(unsigned int bufferId) = 0;
 
+    //! Draws a static buffer once for each of given world transforms; the current world transform is kept
+    virtual void DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount) = 0;
+
     //! Deletes a static buffer
     virtual void DestroyStaticBuffer(unsigned int bufferId) = 0;
 
+    //! Returns the number of draw calls issued since the device was created
+    virtual long long GetDrawCallCount() = 0;
+
     //! Tests whether a sphere is (partially) within the frustum volume
     //! Returns a mask of frustum planes for which the test is positive
     virtual int ComputeSphereVisibility(const Math::Vector &center, float radius) = 0;
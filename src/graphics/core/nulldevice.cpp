@@ -104,6 +104,13 @@ Texture CNullDevice::CreateTexture(ImageData *data, const TextureCreateParams &p
     return tex;
 }
 
+Texture CNullDevice::CreateTexture(const std::vector<ImageData*> &levels, const TextureCreateParams &params)
+{
+    Texture tex;
+    tex.id = 1; // tex.id = 0 => invalid texture
+    return tex;
+}
+
 Texture CNullDevice::CreateDepthTexture(int width, int height, int depth)
 {
     Texture tex;
@@ -111,6 +118,10 @@ Texture CNullDevice::CreateDepthTexture(int width, int height, int depth)
     return tex;
 }
 
+void CNullDevice::UpdateTexture(const Texture& texture, Math::IntPoint offset, ImageData* data, TexImgFormat format)
+{
+}
+
 void CNullDevice::DestroyTexture(const Texture &texture)
 {
 }
@@ -151,15 +162,18 @@ void CNullDevice::SetTextureCoordGeneration(int index, TextureGenerationParams &
 void CNullDevice::DrawPrimitive(PrimitiveType type, const Vertex *vertices, int vertexCount,
                               Color color)
 {
+    m_drawCallCount++;
 }
 
 void CNullDevice::DrawPrimitive(PrimitiveType type, const VertexTex2 *vertices, int vertexCount,
                               Color color)
 {
+    m_drawCallCount++;
 }
 
 void CNullDevice::DrawPrimitive(PrimitiveType type, const VertexCol *vertices, int vertexCount)
 {
+    m_drawCallCount++;
 }
 
 unsigned int CNullDevice::CreateStaticBuffer(PrimitiveType primitiveType, const Vertex* vertices, int vertexCount)
@@ -177,6 +191,12 @@ unsigned int CNullDevice::CreateStaticBuffer(PrimitiveType primitiveType, const
     return 0;
 }
 
+unsigned int CNullDevice::CreateStaticBuffer(PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                                             const unsigned int* indices, int indexCount)
+{
+    return 0;
+}
+
 void CNullDevice::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const Vertex* vertices, int vertexCount)
 {
 }
@@ -189,14 +209,30 @@ void CNullDevice::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primit
 {
 }
 
+void CNullDevice::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                                     const unsigned int* indices, int indexCount)
+{
+}
+
 void CNullDevice::DrawStaticBuffer(unsigned int bufferId)
 {
+    m_drawCallCount++;
+}
+
+void CNullDevice::DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount)
+{
+    m_drawCallCount++;
 }
 
 void CNullDevice::DestroyStaticBuffer(unsigned int bufferId)
 {
 }
 
+long long CNullDevice::GetDrawCallCount()
+{
+    return m_drawCallCount;
+}
+
 int CNullDevice::ComputeSphereVisibility(const Math::Vector &center, float radius)
 {
     return 0;
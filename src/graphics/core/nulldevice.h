@@ -65,7 +65,9 @@ public:
 
     Texture CreateTexture(CImage *image, const TextureCreateParams &params) override;
     Texture CreateTexture(ImageData *data, const TextureCreateParams &params) override;
+    Texture CreateTexture(const std::vector<ImageData*> &levels, const TextureCreateParams &params) override;
     Texture CreateDepthTexture(int width, int height, int depth) override;
+    void UpdateTexture(const Texture& texture, Math::IntPoint offset, ImageData* data, TexImgFormat format) override;
     void DestroyTexture(const Texture &texture) override;
     void DestroyAllTextures() override;
 
@@ -86,12 +88,19 @@ public:
     unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const Vertex* vertices, int vertexCount) override;
     unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount) override;
     unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount) override;
+    unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                                    const unsigned int* indices, int indexCount) override;
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const Vertex* vertices, int vertexCount) override;
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount) override;
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount) override;
+    void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                            const unsigned int* indices, int indexCount) override;
     void DrawStaticBuffer(unsigned int bufferId) override;
+    void DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount) override;
     void DestroyStaticBuffer(unsigned int bufferId) override;
 
+    long long GetDrawCallCount() override;
+
     int ComputeSphereVisibility(const Math::Vector &center, float radius) override;
 
     void SetViewport(int x, int y, int width, int height) override;
@@ -147,6 +156,7 @@ private:
     Math::Matrix m_matrix;
     Material     m_material;
     Light        m_light;
+    long long    m_drawCallCount = 0;
 };
 
 
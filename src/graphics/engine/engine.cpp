@@ -32,6 +32,7 @@
 #include "common/stringutils.h"
 
 #include "common/thread/resource_owning_thread.h"
+#include "common/thread/worker_pool.h"
 
 #include "graphics/core/device.h"
 
@@ -39,12 +40,16 @@
 #include "graphics/engine/cloud.h"
 #include "graphics/engine/lightman.h"
 #include "graphics/engine/lightning.h"
+#include "graphics/engine/mesh_optimizer.h"
 #include "graphics/engine/oldmodelmanager.h"
 #include "graphics/engine/particle.h"
 #include "graphics/engine/planet.h"
 #include "graphics/engine/pyro_manager.h"
 #include "graphics/engine/terrain.h"
 #include "graphics/engine/text.h"
+#include "graphics/engine/texture_cache.h"
+#include "graphics/engine/texture_loader.h"
+#include "graphics/engine/texture_recolor.h"
 #include "graphics/engine/water.h"
 
 #include "graphics/model/model_mesh.h"
@@ -58,7 +63,11 @@
 
 #include "ui/controls/interface.h"
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <iomanip>
+#include <tuple>
 #include <boost/algorithm/string/predicate.hpp>
 
 template<> Gfx::CEngine* CSingleton<Gfx::CEngine>::m_instance = nullptr;
@@ -114,6 +123,9 @@ CEngine::CEngine(CApplication *app, CSystemUtils* systemUtils)
     m_secondTex         = "";
     m_eyeDirH           = 0.0f;
     m_eyeDirV           = 0.0f;
+    m_upVec             = Math::Vector(0.0f, 1.0f, 0.0f);
+    m_hasPreviousView   = false;
+    m_stepInterpolation = -1.0f;
     m_backgroundName    = "";  // no background image
     m_backgroundColorUp   = Color();
     m_backgroundColorDown = Color();
@@ -151,9 +163,6 @@ CEngine::CEngine(CApplication *app, CSystemUtils* systemUtils)
     m_tracePrecision = 1.0f;
 
 
-    m_updateGeometry = false;
-    m_updateStaticBuffers = false;
-
     m_interfaceMode = false;
 
     m_debugLights = false;
@@ -199,6 +208,10 @@ CEngine::CEngine(CApplication *app, CSystemUtils* systemUtils)
 
     m_lastState = -1;
     m_statisticTriangle = 0;
+    m_statisticDrawCalls = 0;
+    m_statisticParticleDrawCalls = 0;
+    m_drawCallsAtFrameStart = 0;
+    m_particleDrawCalls = 0;
     m_fps = 0.0f;
     m_firstGroundSpot = false;
 }
@@ -303,6 +316,10 @@ bool CEngine::Create()
     m_lightning  = MakeUnique<CLightning>(this);
     m_planet     = MakeUnique<CPlanet>(this);
     m_pause      = MakeUnique<CPauseManager>();
+    m_workerPool = MakeUnique<CWorkerPool>();
+    m_recolorCache = MakeUnique<CTextureRecolorCache>();
+    m_textureCache = MakeUnique<CTextureCache>();
+    m_textureLoader = MakeUnique<CTextureLoader>(m_textureCache.get());
 
     m_lightMan->SetDevice(m_device);
     m_particle->SetDevice(m_device);
@@ -353,6 +370,10 @@ void CEngine::Destroy()
     }
 
     m_pause.reset();
+    m_textureLoader.reset();
+    m_textureCache.reset();
+    m_workerPool.reset();
+    m_recolorCache.reset();
     m_lightMan.reset();
     m_text.reset();
     m_particle.reset();
@@ -404,6 +425,8 @@ void CEngine::ResetAfterDeviceChanged()
                 p3.updateStaticBuffer = true;
             }
         }
+
+        MarkBaseObjectDirty(baseObjRank, false, true);
     }
 
     // Update the camera projection matrix for new aspect ratio
@@ -709,6 +732,7 @@ void CEngine::DeleteAllBaseObjects()
     }
 
     m_baseObjects.clear();
+    m_dirtyBaseObjects.clear();
 }
 
 void CEngine::CopyBaseObject(int sourceBaseObjRank, int destBaseObjRank)
@@ -723,6 +747,13 @@ void CEngine::CopyBaseObject(int sourceBaseObjRank, int destBaseObjRank)
     if (! p1.used)
         return;
 
+    // The copy is not in the dirty list yet
+    bool updateGeometry = p1.updateGeometry;
+    bool updateStaticBuffers = p1.updateStaticBuffers;
+    p1.updateGeometry = false;
+    p1.updateStaticBuffers = false;
+    MarkBaseObjectDirty(destBaseObjRank, updateGeometry, updateStaticBuffers);
+
     for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
     {
         EngineBaseObjTexTier& p2 = p1.next[l2];
@@ -748,7 +779,7 @@ void CEngine::AddBaseObjTriangles(int baseObjRank, const std::vector<VertexTex2>
     p3.vertices.insert(p3.vertices.end(), vertices.begin(), vertices.end());
 
     p3.updateStaticBuffer = true;
-    m_updateStaticBuffers = true;
+    MarkBaseObjectDirty(baseObjRank, false, true);
 
     for (int i = 0; i < static_cast<int>( vertices.size() ); i++)
     {
@@ -765,7 +796,7 @@ void CEngine::AddBaseObjTriangles(int baseObjRank, const std::vector<VertexTex2>
     p1.totalTriangles += vertices.size() / 3;
 }
 
-void CEngine::AddBaseObjQuick(int baseObjRank, const EngineBaseObjDataTier& buffer,
+void CEngine::AddBaseObjQuick(int baseObjRank, EngineBaseObjDataTier buffer,
                               std::string tex1Name, std::string tex2Name,
                               bool globalUpdate)
 {
@@ -774,15 +805,28 @@ void CEngine::AddBaseObjQuick(int baseObjRank, const EngineBaseObjDataTier& buff
     EngineBaseObject&      p1 = m_baseObjects[baseObjRank];
     EngineBaseObjTexTier&  p2 = AddLevel2(p1, tex1Name, tex2Name);
 
-    p2.next.push_back(buffer);
+    // Refill a tier emptied by ClearBaseObjGeometry(), so that its static buffer is reused
+    auto it = std::find_if(p2.next.begin(), p2.next.end(),
+                           [](const EngineBaseObjDataTier& tier) { return tier.vertices.empty(); });
+    if (it != p2.next.end())
+    {
+        unsigned int staticBufferId = it->staticBufferId;
+        *it = std::move(buffer);
+        it->staticBufferId = staticBufferId;
+    }
+    else
+    {
+        p2.next.push_back(std::move(buffer));
+        it = p2.next.end() - 1;
+    }
 
-    EngineBaseObjDataTier& p3 = p2.next.back();
+    EngineBaseObjDataTier& p3 = *it;
 
-    UpdateStaticBuffer(p3);
+    UpdateStaticBuffer(p3, true);
 
     if (globalUpdate)
     {
-        m_updateGeometry = true;
+        MarkBaseObjectDirty(baseObjRank, true, false);
     }
     else
     {
@@ -805,6 +849,33 @@ void CEngine::AddBaseObjQuick(int baseObjRank, const EngineBaseObjDataTier& buff
         p1.totalTriangles += p3.vertices.size() - 2;
 }
 
+void CEngine::ClearBaseObjGeometry(int baseObjRank)
+{
+    assert(baseObjRank >= 0 && baseObjRank < static_cast<int>( m_baseObjects.size() ));
+
+    EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+
+    for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
+    {
+        EngineBaseObjTexTier& p2 = p1.next[l2];
+
+        for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
+        {
+            EngineBaseObjDataTier& p3 = p2.next[l3];
+            p3.vertices.clear();
+            p3.updateStaticBuffer = false;
+        }
+    }
+
+    p1.bboxMin.LoadZero();
+    p1.bboxMax.LoadZero();
+    p1.radius = 0.0f;
+    p1.totalTriangles = 0;
+
+    // Tiers left empty are removed by UpdateGeometry()
+    MarkBaseObjectDirty(baseObjRank, true, false);
+}
+
 void CEngine::DebugObject(int objRank)
 {
     assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
@@ -853,6 +924,22 @@ void CEngine::DebugObject(int objRank)
     l->Debug("  totalTriangles: %d\n", p1.totalTriangles);
     l->Debug("  radius: %f\n", p1.radius);
 
+    std::size_t rawBytes = 0, bufferBytes = 0;
+    for (const EngineBaseObjTexTier& p2 : p1.next)
+    {
+        for (const EngineBaseObjDataTier& p3 : p2.next)
+        {
+            if (p3.staticBufferId == 0)
+                continue;
+
+            rawBytes += p3.vertices.size() * sizeof(VertexTex2);
+            bufferBytes += p3.staticVertexCount * sizeof(VertexTex2) + p3.staticIndexCount * sizeof(unsigned int);
+        }
+    }
+    l->Debug("  static buffers: %u bytes, %u bytes without indices (%u bytes saved)\n",
+             static_cast<unsigned int>(bufferBytes), static_cast<unsigned int>(rawBytes),
+             static_cast<unsigned int>(rawBytes - bufferBytes));
+
     for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
     {
         EngineBaseObjTexTier& p2 = p1.next[l2];
@@ -869,6 +956,8 @@ void CEngine::DebugObject(int objRank)
             l->Debug("    type: %d\n", p3.type);
             l->Debug("    state: %d\n", p3.state);
             l->Debug("    staticBufferId: %u\n", p3.staticBufferId);
+            l->Debug("    vertices: %d, in static buffer: %d, indices: %d\n",
+                     static_cast<int>(p3.vertices.size()), p3.staticVertexCount, p3.staticIndexCount);
             l->Debug("    updateStaticBuffer: %s\n", p3.updateStaticBuffer ? "true" : "false");
         }
     }
@@ -957,6 +1046,7 @@ void CEngine::SetObjectTransform(int objRank, const Math::Matrix& transform)
     assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
 
     m_objects[objRank].transform = transform;
+    m_objects[objRank].renderTransform = transform;  // until the next UpdateRenderTransforms()
 }
 
 void CEngine::GetObjectTransform(int objRank, Math::Matrix& transform)
@@ -1221,7 +1311,7 @@ void CEngine::ChangeTextureMapping(int objRank, const Material& mat, int state,
         }
     }
 
-    UpdateStaticBuffer(*p4);
+    UpdateStaticBuffer(*p4, false);
 }
 
 void CEngine::TrackTextureMapping(int objRank, const Material& mat, int state,
@@ -1317,7 +1407,8 @@ void CEngine::TrackTextureMapping(int objRank, const Material& mat, int state,
         tBase += 6;
     }
 
-    UpdateStaticBuffer(*p4);
+    // Done every frame for moving tracks, so the vertices are not welded again
+    UpdateStaticBuffer(*p4, false);
 }
 
 
@@ -1520,11 +1611,108 @@ bool CEngine::GetBBox2D(int objRank, Math::Point &min, Math::Point &max)
     return true;
 }
 
+namespace
+{
+
+//! Size of the ground spot textures; neighbouring tiles share a 1 pixel border
+const int GROUND_SPOT_TILE_SIZE = 256;
+
+//! Returns the pixels covered by ground spot tile \a s, in the pixels of the whole map
+void GetGroundSpotTileBounds(int s, Math::Point& min, Math::Point& max)
+{
+    min.x = (s%4) * 254.0f - 1.0f;  // 1 pixel cover
+    min.y = (s/4) * 254.0f - 1.0f;
+    max.x = min.x + 254.0f + 2.0f;
+    max.y = min.y + 254.0f + 2.0f;
+}
+
+//! Position of a ground spot or of the ground mark in the pixels of the whole map
+struct GroundSpotPixels
+{
+    float cx = 0.0f, cy = 0.0f;  //!< center
+    float px = 0.0f, py = 0.0f;  //!< center rounded down
+    int dot = 0;                 //!< radius
+
+    //! Returns whether the spot covers part of tile \a s
+    bool Touches(int s) const
+    {
+        Math::Point min, max;
+        GetGroundSpotTileBounds(s, min, max);
+        return px+dot >= min.x && py+dot >= min.y &&
+               px-dot <= max.x && py-dot <= max.y;
+    }
+};
+
+GroundSpotPixels GetGroundSpotPixels(const Math::Vector& pos, float radius)
+{
+    GroundSpotPixels pixels;
+    pixels.dot = static_cast<int>(radius/2.0f);
+
+    float tu = (pos.x+1600.0f)/3200.0f;
+    float tv = (pos.z+1600.0f)/3200.0f;  // 0..1
+
+    pixels.cx = (tu*254.0f*4.0f)-0.5f;
+    pixels.cy = (tv*254.0f*4.0f)-0.5f;
+
+    if (pixels.dot == 0)
+    {
+        pixels.cx += 0.5f;
+        pixels.cy += 0.5f;
+    }
+
+    pixels.px = pixels.cx-Math::Mod(pixels.cx, 1.0f);
+    pixels.py = pixels.cy-Math::Mod(pixels.cy, 1.0f);  // multiple of 1
+    return pixels;
+}
+
+/**
+ * \brief Writes a row of ground spot pixels
+ *
+ * Pixels with \a covered set to 0 are left untouched; \a covered can be nullptr.
+ * Kept free of branches and calls so that the compiler vectorises it.
+ */
+void DrawGroundSpotRow(const Color& color, const float* intensity, const char* covered,
+                       int count, unsigned int* pixels)
+{
+    for (int i = 0; i < count; i++)
+    {
+        float r = std::min(std::max(color.r + intensity[i], 0.0f), 1.0f);
+        float g = std::min(std::max(color.g + intensity[i], 0.0f), 1.0f);
+        float b = std::min(std::max(color.b + intensity[i], 0.0f), 1.0f);
+
+        // Transparent, as with CImage::SetPixel() of a Color with default alpha
+        unsigned int pixel = (static_cast<unsigned int>(r * 255.0f) << 16) |
+                             (static_cast<unsigned int>(g * 255.0f) << 8) |
+                              static_cast<unsigned int>(b * 255.0f);
+
+        if (covered == nullptr || covered[i])
+            pixels[i] = pixel;
+    }
+}
+
+//! Pixel rectangle of the ground mark within tile \a s, clipped to the tile
+bool GetGroundMarkRect(const GroundSpotPixels& mark, int s, Math::IntPoint& min, Math::IntPoint& max)
+{
+    Math::Point tileMin, tileMax;
+    GetGroundSpotTileBounds(s, tileMin, tileMax);
+
+    min.x = std::max(static_cast<int>(mark.px - tileMin.x) - mark.dot, 0);
+    min.y = std::max(static_cast<int>(mark.py - tileMin.y) - mark.dot, 0);
+    max.x = std::min(static_cast<int>(mark.px - tileMin.x) + mark.dot, GROUND_SPOT_TILE_SIZE - 1);
+    max.y = std::min(static_cast<int>(mark.py - tileMin.y) + mark.dot, GROUND_SPOT_TILE_SIZE - 1);
+    return min.x <= max.x && min.y <= max.y;
+}
+
+} // anonymous namespace
+
 void CEngine::DeleteAllGroundSpots()
 {
     m_groundSpots.clear();
     m_firstGroundSpot = true;
 
+    for (EngineGroundSpotTile& tile : m_groundSpotTiles)
+        tile.valid = false;
+
     for (int s = 0; s < 16; s++)
     {
         CImage shadowImg(Math::IntPoint(256, 256));
@@ -1567,6 +1755,8 @@ void CEngine::DeleteGroundSpot(int rank)
 {
     assert(rank >= 0 && rank < static_cast<int>( m_groundSpots.size() ));
 
+    InvalidateGroundSpotTiles(m_groundSpots[rank]);
+
     m_groundSpots[rank].used = false;
     m_groundSpots[rank].pos = Math::Vector(0.0f, 0.0f, 0.0f);
 }
@@ -1575,36 +1765,71 @@ void CEngine::SetObjectGroundSpotPos(int rank, const Math::Vector& pos)
 {
     assert(rank >= 0 && rank < static_cast<int>( m_groundSpots.size() ));
 
+    InvalidateGroundSpotTiles(m_groundSpots[rank]);
     m_groundSpots[rank].pos = pos;
+    InvalidateGroundSpotTiles(m_groundSpots[rank]);
 }
 
 void CEngine::SetObjectGroundSpotRadius(int rank, float radius)
 {
     assert(rank >= 0 && rank < static_cast<int>( m_groundSpots.size() ));
 
+    InvalidateGroundSpotTiles(m_groundSpots[rank]);
     m_groundSpots[rank].radius = radius;
+    InvalidateGroundSpotTiles(m_groundSpots[rank]);
 }
 
 void CEngine::SetObjectGroundSpotColor(int rank, const Color& color)
 {
     assert(rank >= 0 && rank < static_cast<int>( m_groundSpots.size() ));
 
+    InvalidateGroundSpotTiles(m_groundSpots[rank]);
     m_groundSpots[rank].color = color;
+    InvalidateGroundSpotTiles(m_groundSpots[rank]);
 }
 
 void CEngine::SetObjectGroundSpotMinMax(int rank, float min, float max)
 {
     assert(rank >= 0 && rank < static_cast<int>( m_groundSpots.size() ));
 
+    InvalidateGroundSpotTiles(m_groundSpots[rank]);
     m_groundSpots[rank].min = min;
     m_groundSpots[rank].max = max;
+    InvalidateGroundSpotTiles(m_groundSpots[rank]);
 }
 
 void CEngine::SetObjectGroundSpotSmooth(int rank, float smooth)
 {
     assert(rank >= 0 && rank < static_cast<int>( m_groundSpots.size() ));
 
+    InvalidateGroundSpotTiles(m_groundSpots[rank]);
     m_groundSpots[rank].smooth = smooth;
+    InvalidateGroundSpotTiles(m_groundSpots[rank]);
+}
+
+void CEngine::InvalidateGroundSpotLevels()
+{
+    for (const EngineGroundSpot& spot : m_groundSpots)
+    {
+        if (spot.used && (spot.min != 0.0f || spot.max != 0.0f))
+            InvalidateGroundSpotTiles(spot);
+    }
+}
+
+void CEngine::InvalidateGroundSpotTiles(const EngineGroundSpot& spot)
+{
+    if (!spot.used || spot.radius == 0.0f)
+        return;
+
+    // Spots limited by altitude cover all tiles
+    bool levels = spot.min != 0.0f || spot.max != 0.0f;
+    GroundSpotPixels pixels = GetGroundSpotPixels(spot.pos, spot.radius);
+
+    for (int s = 0; s < 16; s++)
+    {
+        if (levels || pixels.Touches(s))
+            m_groundSpotTiles[s].valid = false;
+    }
 }
 
 void CEngine::CreateGroundMark(Math::Vector pos, float radius,
@@ -1646,17 +1871,76 @@ void CEngine::ComputeDistance()
     }
 }
 
-void CEngine::UpdateGeometry()
+void CEngine::BeginSimulationStep()
 {
-    if (! m_updateGeometry)
-        return;
+    for (int i = 0; i < static_cast<int>( m_objects.size() ); i++)
+    {
+        if (! m_objects[i].used)
+            continue;
 
-    for (int baseObjRank = 0; baseObjRank < static_cast<int>( m_baseObjects.size() ); baseObjRank++)
+        m_objects[i].previousTransform = m_objects[i].transform;
+        m_objects[i].hasPreviousTransform = true;
+    }
+
+    m_previousEyePt = m_eyePt;
+    m_previousLookatPt = m_lookatPt;
+    m_hasPreviousView = true;
+}
+
+void CEngine::SetStepInterpolation(float alpha)
+{
+    m_stepInterpolation = alpha;
+}
+
+void CEngine::UpdateRenderTransforms()
+{
+    float alpha = m_stepInterpolation;
+
+    for (int i = 0; i < static_cast<int>( m_objects.size() ); i++)
+    {
+        EngineObject& object = m_objects[i];
+        if (! object.used)
+            continue;
+
+        if (alpha < 0.0f || !object.hasPreviousTransform ||
+            memcmp(object.previousTransform.m, object.transform.m, sizeof(object.transform.m)) == 0)
+        {
+            object.renderTransform = object.transform;
+            continue;
+        }
+
+        object.renderTransform = Math::InterpolateTransform(object.previousTransform, object.transform, alpha);
+    }
+
+    if (alpha >= 0.0f && m_hasPreviousView)
+    {
+        Math::Vector eyePt = m_previousEyePt + (m_eyePt - m_previousEyePt) * alpha;
+        Math::Vector lookatPt = m_previousLookatPt + (m_lookatPt - m_previousLookatPt) * alpha;
+        Math::LoadViewMatrix(m_matView, eyePt, lookatPt, m_upVec);
+    }
+}
+
+void CEngine::MarkBaseObjectDirty(int baseObjRank, bool geometry, bool staticBuffers)
+{
+    EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+
+    if (! p1.updateGeometry && ! p1.updateStaticBuffers && (geometry || staticBuffers))
+        m_dirtyBaseObjects.push_back(baseObjRank);
+
+    p1.updateGeometry = p1.updateGeometry || geometry;
+    p1.updateStaticBuffers = p1.updateStaticBuffers || staticBuffers;
+}
+
+void CEngine::UpdateGeometry()
+{
+    for (int baseObjRank : m_dirtyBaseObjects)
     {
         EngineBaseObject &p1 = m_baseObjects[baseObjRank];
-        if (! p1.used)
+        if (! p1.used || ! p1.updateGeometry)
             continue;
 
+        p1.updateGeometry = false;
+
         p1.bboxMin.LoadZero();
         p1.bboxMax.LoadZero();
         p1.radius = 0;
@@ -1665,6 +1949,16 @@ void CEngine::UpdateGeometry()
         {
             EngineBaseObjTexTier& p2 = p1.next[l2];
 
+            // Removes tiers emptied by ClearBaseObjGeometry() and not refilled
+            for (int l3 = static_cast<int>( p2.next.size() ) - 1; l3 >= 0; l3--)
+            {
+                if (! p2.next[l3].vertices.empty())
+                    continue;
+
+                m_device->DestroyStaticBuffer(p2.next[l3].staticBufferId);
+                p2.next.erase(p2.next.begin() + l3);
+            }
+
             for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
             {
                 EngineBaseObjDataTier& p3 = p2.next[l3];
@@ -1683,11 +1977,9 @@ void CEngine::UpdateGeometry()
             }
         }
     }
-
-    m_updateGeometry = false;
 }
 
-void CEngine::UpdateStaticBuffer(EngineBaseObjDataTier& p4)
+void CEngine::UpdateStaticBuffer(EngineBaseObjDataTier& p4, bool indexed)
 {
     PrimitiveType type;
     if (p4.type == ENG_TRIANGLE_TYPE_TRIANGLES)
@@ -1695,27 +1987,51 @@ void CEngine::UpdateStaticBuffer(EngineBaseObjDataTier& p4)
     else
         type = PRIMITIVE_TRIANGLE_STRIP;
 
+    if (indexed && type == PRIMITIVE_TRIANGLES && ! p4.vertices.empty())
+    {
+        // Store the shared vertices once, unless the indices would take more than that saves
+        IndexedMesh mesh = BuildIndexedMesh(p4.vertices.data(), p4.vertices.size());
+        if (mesh.vertices.size() * sizeof(VertexTex2) + mesh.indices.size() * sizeof(unsigned int) <
+            p4.vertices.size() * sizeof(VertexTex2))
+        {
+            if (p4.staticBufferId == 0)
+            {
+                p4.staticBufferId = m_device->CreateStaticBuffer(type, mesh.vertices.data(), mesh.vertices.size(),
+                                                                 mesh.indices.data(), mesh.indices.size());
+            }
+            else
+            {
+                m_device->UpdateStaticBuffer(p4.staticBufferId, type, mesh.vertices.data(), mesh.vertices.size(),
+                                             mesh.indices.data(), mesh.indices.size());
+            }
+
+            p4.staticVertexCount = mesh.vertices.size();
+            p4.staticIndexCount = mesh.indices.size();
+            p4.updateStaticBuffer = false;
+            return;
+        }
+    }
+
     if (p4.staticBufferId == 0)
         p4.staticBufferId = m_device->CreateStaticBuffer(type, &p4.vertices[0], p4.vertices.size());
     else
         m_device->UpdateStaticBuffer(p4.staticBufferId, type, &p4.vertices[0], p4.vertices.size());
 
+    p4.staticVertexCount = p4.vertices.size();
+    p4.staticIndexCount = 0;
     p4.updateStaticBuffer = false;
 }
 
 void CEngine::UpdateStaticBuffers()
 {
-    if (!m_updateStaticBuffers)
-        return;
-
-    m_updateStaticBuffers = false;
-
-    for (int baseObjRank = 0; baseObjRank < static_cast<int>( m_baseObjects.size() ); baseObjRank++)
+    for (int baseObjRank : m_dirtyBaseObjects)
     {
         EngineBaseObject& p1 = m_baseObjects[baseObjRank];
-        if (! p1.used)
+        if (! p1.used || ! p1.updateStaticBuffers)
             continue;
 
+        p1.updateStaticBuffers = false;
+
         for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
         {
             EngineBaseObjTexTier& p2 = p1.next[l2];
@@ -1727,10 +2043,12 @@ void CEngine::UpdateStaticBuffers()
                 if (! p3.updateStaticBuffer)
                         continue;
 
-                UpdateStaticBuffer(p3);
+                UpdateStaticBuffer(p3, true);
             }
         }
     }
+
+    m_dirtyBaseObjects.clear();
 }
 
 void CEngine::Update()
@@ -1901,34 +2219,86 @@ bool CEngine::DetectTriangle(Math::Point mouse, VertexTex2* triangle, int objRan
     return true;
 }
 
-//! Use only after world transform already set
 bool CEngine::IsVisible(int objRank)
 {
     assert(objRank >= 0 && objRank < static_cast<int>(m_objects.size()));
 
+    Math::Vector center;
+    float radius = 0.0f;
+    if (GetObjectBoundingSphere(objRank, center, radius) && m_cameraFrustum.IsSphereVisible(center, radius))
+    {
+        m_objects[objRank].visible = true;
+        return true;
+    }
+
+    m_objects[objRank].visible = false;
+    return false;
+}
+
+bool CEngine::GetObjectBoundingSphere(int objRank, Math::Vector& center, float& radius)
+{
     int baseObjRank = m_objects[objRank].baseObjRank;
     if (baseObjRank == -1)
         return false;
 
     assert(baseObjRank >= 0 && baseObjRank < static_cast<int>(m_baseObjects.size()));
 
-    float radius = m_baseObjects[baseObjRank].radius;
-    Math::Vector center(0.0f, 0.0f, 0.0f);
-    if (m_device->ComputeSphereVisibility(center, radius) == Gfx::FRUSTUM_PLANE_ALL)
+    Math::Matrix transform = m_objects[objRank].renderTransform;
+    center = Math::Transform(transform, Math::Vector(0.0f, 0.0f, 0.0f));
+
+    // The largest scale along any axis
+    float scale = Math::Max(Math::Vector(transform.Get(1, 1), transform.Get(2, 1), transform.Get(3, 1)).Length(),
+                            Math::Vector(transform.Get(1, 2), transform.Get(2, 2), transform.Get(3, 2)).Length(),
+                            Math::Vector(transform.Get(1, 3), transform.Get(2, 3), transform.Get(3, 3)).Length());
+
+    radius = m_baseObjects[baseObjRank].radius * scale;
+    return true;
+}
+
+void CEngine::UpdateObjectBounds()
+{
+    m_objectCuller.Clear();
+
+    for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
     {
-        m_objects[objRank].visible = true;
-        return true;
+        if (! m_objects[objRank].used)
+            continue;
+
+        Math::Vector center;
+        float radius = 0.0f;
+        if (! GetObjectBoundingSphere(objRank, center, radius))
+            continue;
+
+        if (! m_baseObjects[m_objects[objRank].baseObjRank].used)
+            continue;
+
+        m_objectCuller.Add(objRank, center, radius);
     }
 
-    m_objects[objRank].visible = false;
-    return false;
+    m_objectCuller.Build();
+
+    Math::Matrix scale;
+    Math::LoadScaleMatrix(scale, Math::Vector(1.0f, 1.0f, -1.0f));
+    m_cameraFrustum.Set(Math::MultiplyMatrices(m_matProj, Math::MultiplyMatrices(scale, m_matView)));
+}
+
+void CEngine::CullObjects()
+{
+    for (EngineObject& object : m_objects)
+        object.visible = false;
+
+    m_culledObjects.clear();
+    m_objectCuller.Cull(m_cameraFrustum, m_culledObjects);
+
+    for (int objRank : m_culledObjects)
+        m_objects[objRank].visible = true;
 }
 
 bool CEngine::TransformPoint(Math::Vector& p2D, int objRank, Math::Vector p3D)
 {
     assert(objRank >= 0 && objRank < static_cast<int>(m_objects.size()));
 
-    p3D = Math::Transform(m_objects[objRank].transform, p3D);
+    p3D = Math::Transform(m_objects[objRank].renderTransform, p3D);
     p3D = Math::Transform(m_matView, p3D);
 
     if (p3D.z < 2.0f)
@@ -2217,6 +2587,7 @@ void CEngine::SetViewParams(const Math::Vector& eyePt, const Math::Vector& looka
 {
     m_eyePt = eyePt;
     m_lookatPt = lookatPt;
+    m_upVec = upVec;
     m_eyeDirH = Math::RotateAngle(eyePt.x - lookatPt.x, eyePt.z - lookatPt.z);
     m_eyeDirV = Math::RotateAngle(Math::DistanceProjected(eyePt, lookatPt), eyePt.y - lookatPt.y);
 
@@ -2242,6 +2613,18 @@ Texture CEngine::CreateTexture(const std::string& texName, const TextureCreatePa
 
     if (image == nullptr)
     {
+        uint64_t sourceHash = 0;
+        bool hashed = m_textureCache != nullptr && CTextureCache::GetSourceHash(texName, sourceHash);
+
+        bool cached = false;
+        if (hashed)
+        {
+            std::unique_ptr<CBakedTexture> baked = m_textureCache->Load(texName, sourceHash);
+            cached = baked != nullptr;
+            if (cached && baked->MatchesPadding(params.padToNearestPowerOfTwo))
+                return CreateTexture(texName, params, baked.get());
+        }
+
         if (!img.Load(texName))
         {
             std::string error = img.GetError();
@@ -2250,11 +2633,41 @@ Texture CEngine::CreateTexture(const std::string& texName, const TextureCreatePa
             return Texture(); // invalid texture
         }
 
-        image = &img;
+        // Stored as given to the device, so that it can be uploaded as it is next time
+        int bpp = img.GetData()->surface->format->BytesPerPixel;
+        if (bpp != 3 && bpp != 4)
+            img.ConvertToRGBA();
+
+        Math::IntPoint originalSize = img.GetSize();
+        if (params.padToNearestPowerOfTwo)
+            img.PadToNearestPowerOfTwo();
+
+        // A texture loaded both with and without padding keeps the first one cached
+        if (hashed && !cached)
+            m_textureCache->Store(texName, sourceHash, img, originalSize);
+
+        tex = m_device->CreateTexture(&img, params);
+        tex.originalSize = originalSize;
+
+        return AddTexture(texName, tex);
     }
 
     tex = m_device->CreateTexture(image, params);
 
+    return AddTexture(texName, tex);
+}
+
+Texture CEngine::CreateTexture(const std::string& texName, const TextureCreateParams& params, CBakedTexture* baked)
+{
+    // The device uploads the image and its stored mipmap levels straight from the mapped file
+    Texture tex = m_device->CreateTexture(baked->GetLevels(), params);
+    tex.originalSize = baked->GetOriginalSize();
+
+    return AddTexture(texName, tex);
+}
+
+Texture CEngine::AddTexture(const std::string& texName, const Texture& tex)
+{
     if (! tex.Valid())
     {
         GetLogger()->Error("Couldn't load texture '%s', blacklisting\n", texName.c_str());
@@ -2288,9 +2701,108 @@ Texture CEngine::LoadTexture(const std::string& name, const TextureCreateParams&
     if (it != m_texNameMap.end())
         return (*it).second;
 
+    if (m_textureLoader != nullptr && m_textureLoader->IsPending(name))
+        return GetPlaceholderTexture();
+
     return CreateTexture(name, params);
 }
 
+Texture CEngine::RequestTexture(const std::string& name, const TextureCreateParams& params)
+{
+    if (m_texBlacklist.find(name) != m_texBlacklist.end())
+        return Texture();
+
+    auto it = m_texNameMap.find(name);
+    if (it != m_texNameMap.end())
+        return (*it).second;
+
+    if (m_textureLoader == nullptr)
+        return CreateTexture(name, params);
+
+    m_textureLoader->Request(name, params);
+    return GetPlaceholderTexture();
+}
+
+Texture CEngine::GetPlaceholderTexture()
+{
+    if (! m_placeholderTexture.Valid())
+    {
+        CImage img(Math::IntPoint(8, 8));
+        img.Fill(IntColor(128, 128, 128, 255));
+
+        TextureCreateParams params;
+        params.format = TEX_IMG_BGRA;
+        params.filter = TEX_FILTER_NEAREST;
+        params.mipmap = false;
+        m_placeholderTexture = m_device->CreateTexture(&img, params);
+    }
+
+    return m_placeholderTexture;
+}
+
+void CEngine::UploadLoadedTextures()
+{
+    if (m_textureLoader == nullptr || ! m_textureLoader->HasPending())
+        return;
+
+    // Creating a texture stalls the frame, so only a few are done each frame
+    const int MAX_UPLOADS_PER_FRAME = 4;
+
+    std::vector<LoadedTexture> loaded;
+    if (m_textureLoader->GetLoaded(loaded, MAX_UPLOADS_PER_FRAME) == 0)
+        return;
+
+    std::map<std::string, Texture> done;
+    for (LoadedTexture& texture : loaded)
+    {
+        Texture tex;
+        if (texture.baked != nullptr)
+        {
+            tex = CreateTexture(texture.name, texture.params, texture.baked.get());
+        }
+        else if (texture.image == nullptr)
+        {
+            GetLogger()->Error("Couldn't load texture '%s': %s, blacklisting\n", texture.name.c_str(), texture.error.c_str());
+            m_texBlacklist.insert(texture.name);
+        }
+        else
+        {
+            tex = CreateTexture(texture.name, texture.params, texture.image.get());
+            if (tex.Valid())
+            {
+                // The image was padded before, so the device sees only the padded size
+                tex.originalSize = texture.originalSize;
+                m_texNameMap[texture.name] = tex;
+            }
+        }
+
+        done[texture.name] = tex;
+    }
+
+    for (EngineBaseObject& p1 : m_baseObjects)
+    {
+        if (! p1.used)
+            continue;
+
+        for (EngineBaseObjTexTier& p2 : p1.next)
+        {
+            if (! p2.tex1Name.empty())
+            {
+                auto it = done.find("textures/"+p2.tex1Name);
+                if (it != done.end())
+                    p2.tex1 = (*it).second;
+            }
+
+            if (! p2.tex2Name.empty())
+            {
+                auto it = done.find("textures/"+p2.tex2Name);
+                if (it != done.end())
+                    p2.tex2 = (*it).second;
+            }
+        }
+    }
+}
+
 bool CEngine::LoadAllTextures()
 {
     m_miceTexture = LoadTexture("textures/interface/mouse.png");
@@ -2339,61 +2851,65 @@ bool CEngine::LoadAllTextures()
         if (! p1.used)
             continue;
 
-        for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
-        {
-            EngineBaseObjTexTier& p2 = p1.next[l2];
-
-            if (! p2.tex1Name.empty())
-            {
-                if (terrain)
-                    p2.tex1 = LoadTexture("textures/"+p2.tex1Name, m_terrainTexParams);
-                else
-                    p2.tex1 = LoadTexture("textures/"+p2.tex1Name);
-
-                if (! p2.tex1.Valid())
-                    ok = false;
-            }
+        if (! LoadBaseObjTextures(p1, terrain))
+            ok = false;
+    }
 
-            if (! p2.tex2Name.empty())
-            {
-                if (terrain)
-                {
-                    if (! boost::starts_with(p2.tex2Name, "shadow")) // shadow ground textures are created dynamically
-                    {
-                        p2.tex2 = LoadTexture("textures/"+p2.tex2Name, m_terrainTexParams);
-                    }
-                }
-                else
-                    p2.tex2 = LoadTexture("textures/"+p2.tex2Name);
+    // Terrain resolutions not used by any object at the moment
+    if (m_terrain != nullptr)
+    {
+        for (int baseObjRank : m_terrain->GetLevelOfDetailBaseObjRanks())
+        {
+            if (baseObjRank == -1 || ! m_baseObjects[baseObjRank].used)
+                continue;
 
-                if (! p2.tex2.Valid())
-                    ok = false;
-            }
+            if (! LoadBaseObjTextures(m_baseObjects[baseObjRank], true))
+                ok = false;
         }
     }
 
     return ok;
 }
 
-bool IsExcludeColor(Math::Point *exclude, int x, int y)
+bool CEngine::LoadBaseObjTextures(EngineBaseObject& p1, bool terrain)
 {
-    int i = 0;
-    while ( exclude[i+0].x != 0.0f || exclude[i+0].y != 0.0f ||
-            exclude[i+1].y != 0.0f || exclude[i+1].y != 0.0f )
+    bool ok = true;
+
+    for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
     {
-        if ( x >= static_cast<int>(exclude[i+0].x*256.0f) &&
-             x <  static_cast<int>(exclude[i+1].x*256.0f) &&
-             y >= static_cast<int>(exclude[i+0].y*256.0f) &&
-             y <  static_cast<int>(exclude[i+1].y*256.0f) )
-            return true;  // exclude
+        EngineBaseObjTexTier& p2 = p1.next[l2];
+
+        if (! p2.tex1Name.empty())
+        {
+            if (terrain)
+                p2.tex1 = RequestTexture("textures/"+p2.tex1Name, m_terrainTexParams);
+            else
+                p2.tex1 = RequestTexture("textures/"+p2.tex1Name, m_defaultTexParams);
+
+            if (! p2.tex1.Valid())
+                ok = false;
+        }
 
-        i += 2;
+        if (! p2.tex2Name.empty())
+        {
+            if (terrain)
+            {
+                if (! boost::starts_with(p2.tex2Name, "shadow")) // shadow ground textures are created dynamically
+                {
+                    p2.tex2 = RequestTexture("textures/"+p2.tex2Name, m_terrainTexParams);
+                }
+            }
+            else
+                p2.tex2 = RequestTexture("textures/"+p2.tex2Name, m_defaultTexParams);
+
+            if (! p2.tex2.Valid())
+                ok = false;
+        }
     }
 
-    return false;  // point to include
+    return ok;
 }
 
-
 bool CEngine::ChangeTextureColor(const std::string& texName,
                                  const std::string& srcName,
                                  Color colorRef1, Color colorNew1,
@@ -2404,113 +2920,60 @@ bool CEngine::ChangeTextureColor(const std::string& texName,
 {
     DeleteTexture(texName);
 
-    CImage img;
-    if (!img.Load(srcName))
-    {
-        std::string error = img.GetError();
-        GetLogger()->Error("Couldn't load texture '%s': %s, blacklisting\n", srcName.c_str(), error.c_str());
-        m_texBlacklist.insert(srcName);
-        return false;
-    }
+    RecolorParams params;
+    params.colorRef1 = colorRef1;
+    params.colorNew1 = colorNew1;
+    params.colorRef2 = colorRef2;
+    params.colorNew2 = colorNew2;
+    params.tolerance1 = tolerance1;
+    params.tolerance2 = tolerance2;
+    params.shift = shift;
+    params.hsv = hsv;
 
-    bool changeColorsNeeded = true;
+    std::string key = CTextureRecolorCache::GetKey(srcName, params, ts, ti, exclude);
+    std::unique_ptr<CImage> img = m_recolorCache->Get(key);
 
-    if (colorRef1.r == colorNew1.r &&
-        colorRef1.g == colorNew1.g &&
-        colorRef1.b == colorNew1.b &&
-        colorRef2.r == colorNew2.r &&
-        colorRef2.g == colorNew2.g &&
-        colorRef2.b == colorNew2.b)
+    if (img == nullptr)
     {
-        changeColorsNeeded = false;
-    }
-
-
-    int dx = img.GetSize().x;
-    int dy = img.GetSize().y;
-
-    int sx = static_cast<int>(Math::Max(ts.x*dx, 0));
-    int sy = static_cast<int>(Math::Max(ts.y*dy, 0));
-
-    int ex = static_cast<int>(Math::Min(ti.x*dx, dx));
-    int ey = static_cast<int>(Math::Min(ti.y*dy, dy));
+        img = MakeUnique<CImage>();
+        if (!img->Load(srcName))
+        {
+            std::string error = img->GetError();
+            GetLogger()->Error("Couldn't load texture '%s': %s, blacklisting\n", srcName.c_str(), error.c_str());
+            m_texBlacklist.insert(srcName);
+            return false;
+        }
 
+        bool changeColorsNeeded = true;
 
-    ColorHSV cr1 = RGB2HSV(colorRef1);
-    ColorHSV cn1 = RGB2HSV(colorNew1);
-    ColorHSV cr2 = RGB2HSV(colorRef2);
-    ColorHSV cn2 = RGB2HSV(colorNew2);
+        if (colorRef1.r == colorNew1.r &&
+            colorRef1.g == colorNew1.g &&
+            colorRef1.b == colorNew1.b &&
+            colorRef2.r == colorNew2.r &&
+            colorRef2.g == colorNew2.g &&
+            colorRef2.b == colorNew2.b)
+        {
+            changeColorsNeeded = false;
+        }
 
-    if (changeColorsNeeded)
-    {
-        for (int y = sy; y < ey; y++)
+        if (changeColorsNeeded)
         {
-            for (int x = sx; x < ex; x++)
-            {
-                if (exclude != nullptr && IsExcludeColor(exclude, x,y) )
-                    continue;
+            int dx = img->GetSize().x;
+            int dy = img->GetSize().y;
 
-                Color color = img.GetPixel(Math::IntPoint(x, y));
+            int sx = static_cast<int>(Math::Max(ts.x*dx, 0));
+            int sy = static_cast<int>(Math::Max(ts.y*dy, 0));
 
-                if (hsv)
-                {
-                    ColorHSV c = RGB2HSV(color);
-                    if (c.s > 0.01f && fabs(c.h - cr1.h) < tolerance1)
-                    {
-                        c.h += cn1.h - cr1.h;
-                        c.s += cn1.s - cr1.s;
-                        c.v += cn1.v - cr1.v;
-                        if (c.h < 0.0f) c.h -= 1.0f;
-                        if (c.h > 1.0f) c.h += 1.0f;
-                        color = HSV2RGB(c);
-                        color.r = Math::Norm(color.r + shift);
-                        color.g = Math::Norm(color.g + shift);
-                        color.b = Math::Norm(color.b + shift);
-                        img.SetPixel(Math::IntPoint(x, y), color);
-                    }
-                    else if (tolerance2 != -1.0f &&
-                            c.s > 0.01f && fabs(c.h - cr2.h) < tolerance2)
-                    {
-                        c.h += cn2.h - cr2.h;
-                        c.s += cn2.s - cr2.s;
-                        c.v += cn2.v - cr2.v;
-                        if (c.h < 0.0f) c.h -= 1.0f;
-                        if (c.h > 1.0f) c.h += 1.0f;
-                        color = HSV2RGB(c);
-                        color.r = Math::Norm(color.r + shift);
-                        color.g = Math::Norm(color.g + shift);
-                        color.b = Math::Norm(color.b + shift);
-                        img.SetPixel(Math::IntPoint(x, y), color);
-                    }
-                }
-                else
-                {
-                    if ( fabs(color.r - colorRef1.r) +
-                        fabs(color.g - colorRef1.g) +
-                        fabs(color.b - colorRef1.b) < tolerance1 * 3.0f)
-                    {
-                        color.r = Math::Norm(colorNew1.r + color.r - colorRef1.r + shift);
-                        color.g = Math::Norm(colorNew1.g + color.g - colorRef1.g + shift);
-                        color.b = Math::Norm(colorNew1.b + color.b - colorRef1.b + shift);
-                        img.SetPixel(Math::IntPoint(x, y), color);
-                    }
-                    else if (tolerance2 != -1 &&
-                            fabs(color.r - colorRef2.r) +
-                            fabs(color.g - colorRef2.g) +
-                            fabs(color.b - colorRef2.b) < tolerance2 * 3.0f)
-                    {
-                        color.r = Math::Norm(colorNew2.r + color.r - colorRef2.r + shift);
-                        color.g = Math::Norm(colorNew2.g + color.g - colorRef2.g + shift);
-                        color.b = Math::Norm(colorNew2.b + color.b - colorRef2.b + shift);
-                        img.SetPixel(Math::IntPoint(x, y), color);
-                    }
-                }
-            }
+            int ex = static_cast<int>(Math::Min(ti.x*dx, dx));
+            int ey = static_cast<int>(Math::Min(ti.y*dy, dy));
+
+            RecolorImage(*img, params, Math::IntPoint(sx, sy), Math::IntPoint(ex, ey), exclude);
         }
-    }
 
+        m_recolorCache->Add(key, *img);
+    }
 
-    Texture tex = m_device->CreateTexture(&img, m_defaultTexParams);
+    Texture tex = m_device->CreateTexture(img.get(), m_defaultTexParams);
 
     if (! tex.Valid())
     {
@@ -2537,6 +3000,9 @@ bool CEngine::ChangeTextureColor(const std::string& texName,
 
 void CEngine::DeleteTexture(const std::string& texName)
 {
+    if (m_textureLoader != nullptr)
+        m_textureLoader->Cancel(texName);
+
     auto it = m_texNameMap.find(texName);
     if (it == m_texNameMap.end())
         return;
@@ -2570,6 +3036,10 @@ void CEngine::FlushTextureCache()
 {
     m_device->DestroyAllTextures();
 
+    if (m_textureLoader != nullptr)
+        m_textureLoader->CancelAll();
+
+    m_placeholderTexture.SetInvalid();
     m_backgroundTex.SetInvalid();
     m_foregroundTex.SetInvalid();
 
@@ -2589,21 +3059,16 @@ bool CEngine::SetTexture(const std::string& name, int stage)
         return true;
     }
 
-    if (! LoadTexture(name).Valid())
+    // Texture still loading in background gives the placeholder
+    Texture tex = LoadTexture(name);
+    if (! tex.Valid())
     {
         m_device->SetTexture(stage, 0); // invalid texture
         return false;
     }
 
-    it = m_texNameMap.find(name);
-    if (it != m_texNameMap.end())
-    {
-        m_device->SetTexture(stage, (*it).second);
-        return true;
-    }
-
-    m_device->SetTexture(stage, 0); // invalid texture
-    return false; // should not happen normally
+    m_device->SetTexture(stage, tex);
+    return true;
 }
 
 void CEngine::SetTexture(const Texture& tex, int stage)
@@ -3123,13 +3588,27 @@ void CEngine::Render()
     if (! m_render)
         return;
 
+    UploadLoadedTextures();
+
     m_statisticTriangle = 0;
+    long long drawCalls = m_device->GetDrawCallCount();
+    m_statisticDrawCalls = static_cast<int>(drawCalls - m_drawCallsAtFrameStart);
+    m_statisticParticleDrawCalls = m_particleDrawCalls;
+    m_drawCallsAtFrameStart = drawCalls;
+    m_particleDrawCalls = 0;
     m_lastState = -1;
     m_lastColor = Color(-1.0f);
     m_lastMaterial = Material();
 
     m_lightMan->UpdateLights();
 
+    UpdateRenderTransforms();
+
+    if (m_terrain != nullptr)
+        m_terrain->UpdateLevelOfDetail(m_eyePt);
+
+    UpdateObjectBounds();
+
     Color color;
     if (m_cloud->GetLevel() != 0.0f)  // clouds?
         color = m_backgroundCloudDown;
@@ -3188,6 +3667,8 @@ void CEngine::Draw3DScene()
 
     m_water->DrawBack();  // draws water background
 
+    CullObjects();
+
     m_app->StartPerformanceCounter(PCNT_RENDER_TERRAIN);
 
     // Draw terrain
@@ -3207,9 +3688,7 @@ void CEngine::Draw3DScene()
         if (! m_objects[objRank].drawWorld)
             continue;
 
-        m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
-
-        if (! IsVisible(objRank))
+        if (! m_objects[objRank].visible)
             continue;
 
         int baseObjRank = m_objects[objRank].baseObjRank;
@@ -3222,25 +3701,11 @@ void CEngine::Draw3DScene()
         if (! p1.used)
             continue;
 
-        for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
-        {
-            EngineBaseObjTexTier& p2 = p1.next[l2];
-
-            SetTexture(p2.tex1, 0);
-            SetTexture(p2.tex2, 1);
-
-            for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
-            {
-                EngineBaseObjDataTier& p3 = p2.next[l3];
-
-                SetMaterial(p3.material);
-                SetState(p3.state);
-
-                DrawObject(p3);
-            }
-        }
+        QueueObject(objRank, p1);
     }
 
+    DrawRenderQueue();
+
     if (!m_qualityShadows)
         UseShadowMapping(false);
 
@@ -3268,9 +3733,7 @@ void CEngine::Draw3DScene()
         if (! m_objects[objRank].drawWorld)
             continue;
 
-        m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
-
-        if (! IsVisible(objRank))
+        if (! m_objects[objRank].visible)
             continue;
 
         int baseObjRank = m_objects[objRank].baseObjRank;
@@ -3283,33 +3746,17 @@ void CEngine::Draw3DScene()
         if (! p1.used)
             continue;
 
-        m_lightMan->UpdateDeviceLights(m_objects[objRank].type);
-
-        for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
+        if (m_objects[objRank].transparency != 0.0f)  // transparent ?
         {
-            EngineBaseObjTexTier& p2 = p1.next[l2];
-
-            SetTexture(p2.tex1, 0);
-            SetTexture(p2.tex2, 1);
-
-            for (int l3 = 0; l3 < static_cast<int>( p2.next.size() ); l3++)
-            {
-                EngineBaseObjDataTier& p3 = p2.next[l3];
-
-                if (m_objects[objRank].transparency != 0.0f)  // transparent ?
-                {
-                    transparent = true;
-                    continue;
-                }
-
-                SetMaterial(p3.material);
-                SetState(p3.state);
-
-                DrawObject(p3);
-            }
+            transparent = true;
+            continue;
         }
+
+        QueueObject(objRank, p1);
     }
 
+    DrawRenderQueue();
+
     UseShadowMapping(false);
 
     // Draw transparent objects
@@ -3330,11 +3777,11 @@ void CEngine::Draw3DScene()
             if (! m_objects[objRank].drawWorld)
                 continue;
 
-            m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
-
-            if (! IsVisible(objRank))
+            if (! m_objects[objRank].visible)
                 continue;
 
+            m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].renderTransform);
+
             int baseObjRank = m_objects[objRank].baseObjRank;
             if (baseObjRank == -1)
                 continue;
@@ -3390,7 +3837,7 @@ void CEngine::Draw3DScene()
     m_device->SetRenderState(RENDER_STATE_LIGHTING, false);
 
     m_app->StartPerformanceCounter(PCNT_RENDER_PARTICLE);
-    m_particle->DrawParticle(SH_WORLD); // draws the particles of the 3D world
+    DrawParticles(SH_WORLD); // draws the particles of the 3D world
     m_app->StopPerformanceCounter(PCNT_RENDER_PARTICLE);
 
     m_device->SetRenderState(RENDER_STATE_LIGHTING, true);
@@ -3524,26 +3971,20 @@ void CEngine::RenderShadowMap()
     m_device->SetTexture(0, 0);
     m_device->SetTexture(1, 0);
 
+    // only objects within the volume covered by shadow map
+    CFrustum shadowFrustum(Math::MultiplyMatrices(m_shadowProjMat, Math::MultiplyMatrices(scaleMat, m_shadowViewMat)));
+    m_culledObjects.clear();
+    m_objectCuller.Cull(shadowFrustum, m_culledObjects);
+
     // render objects into shadow map
-    for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
+    for (int objRank : m_culledObjects)
     {
-        if (!m_objects[objRank].used)
-            continue;
-
         if (m_objects[objRank].type == ENG_OBJTYPE_TERRAIN)
            continue;
 
-        m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
+        EngineBaseObject& p1 = m_baseObjects[m_objects[objRank].baseObjRank];
 
-        int baseObjRank = m_objects[objRank].baseObjRank;
-        if (baseObjRank == -1)
-            continue;
-
-        assert(baseObjRank >= 0 && baseObjRank < static_cast<int>(m_baseObjects.size()));
-
-        EngineBaseObject& p1 = m_baseObjects[baseObjRank];
-        if (!p1.used)
-            continue;
+        m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].renderTransform);
 
         for (int l2 = 0; l2 < static_cast<int>(p1.next.size()); l2++)
         {
@@ -3811,6 +4252,148 @@ void CEngine::DrawObject(const EngineBaseObjDataTier& p4)
     }
 }
 
+void CEngine::QueueObject(int objRank, const EngineBaseObject& p1)
+{
+    EngineRenderItem item;
+    item.type = m_objects[objRank].type;
+    item.objRank = objRank;
+
+    for (const EngineBaseObjTexTier& p2 : p1.next)
+    {
+        item.texTier = &p2;
+
+        for (const EngineBaseObjDataTier& p3 : p2.next)
+        {
+            item.state = p3.state;
+            item.dataTier = &p3;
+            m_renderQueue.push_back(item);
+        }
+    }
+}
+
+namespace
+{
+
+//! Smallest number of objects drawn with one instanced draw call
+const int MIN_INSTANCE_COUNT = 2;
+
+bool ColorLess(const Color& a, const Color& b)
+{
+    return std::tie(a.r, a.g, a.b, a.a) < std::tie(b.r, b.g, b.b, b.a);
+}
+
+bool MaterialLess(const Material& a, const Material& b)
+{
+    if (a.diffuse != b.diffuse)
+        return ColorLess(a.diffuse, b.diffuse);
+    if (a.ambient != b.ambient)
+        return ColorLess(a.ambient, b.ambient);
+    return ColorLess(a.specular, b.specular);
+}
+
+//! Returns true for states which CEngine::SetState() draws blended, without writing depth
+bool IsBlendedState(int state)
+{
+    return (state & (ENG_RSTATE_TTEXTURE_BLACK | ENG_RSTATE_TTEXTURE_WHITE |
+                     ENG_RSTATE_TCOLOR_BLACK   | ENG_RSTATE_TCOLOR_WHITE   |
+                     ENG_RSTATE_TDIFFUSE       | ENG_RSTATE_OPAQUE_TEXTURE |
+                     ENG_RSTATE_OPAQUE_COLOR   | ENG_RSTATE_TEXT          |
+                     ENG_RSTATE_TTEXTURE_ALPHA | ENG_RSTATE_TCOLOR_ALPHA)) != 0;
+}
+
+//! Puts blended items after all opaque ones, so that they are blended with
+//! everything behind them, then orders from the most to the least expensive
+//! change of state and puts together the instances of the same part of base object
+bool RenderItemLess(const EngineRenderItem& a, const EngineRenderItem& b)
+{
+    bool blendedA = IsBlendedState(a.state);
+    bool blendedB = IsBlendedState(b.state);
+    if (blendedA != blendedB)
+        return blendedB;
+    if (a.type != b.type)
+        return a.type < b.type;
+    if (a.state != b.state)
+        return a.state < b.state;
+    if (a.texTier->tex1.id != b.texTier->tex1.id)
+        return a.texTier->tex1.id < b.texTier->tex1.id;
+    if (a.texTier->tex2.id != b.texTier->tex2.id)
+        return a.texTier->tex2.id < b.texTier->tex2.id;
+    if (a.dataTier->material != b.dataTier->material)
+        return MaterialLess(a.dataTier->material, b.dataTier->material);
+    if (a.dataTier != b.dataTier)
+        return std::less<const EngineBaseObjDataTier*>()(a.dataTier, b.dataTier);
+    return a.objRank < b.objRank;
+}
+
+} // anonymous namespace
+
+void CEngine::DrawRenderQueue()
+{
+    std::sort(m_renderQueue.begin(), m_renderQueue.end(), RenderItemLess);
+
+    const EngineRenderItem* last = nullptr;
+    int transformObjRank = -1;  // object whose transform is set in the device
+
+    for (std::size_t i = 0; i < m_renderQueue.size(); )
+    {
+        const EngineRenderItem& item = m_renderQueue[i];
+
+        // Parts of objects sharing the same base object are next to each other
+        std::size_t end = i + 1;
+        while (end < m_renderQueue.size() && m_renderQueue[end].dataTier == item.dataTier)
+            end++;
+
+        if (last == nullptr || item.type != last->type)
+            m_lightMan->UpdateDeviceLights(item.type);
+
+        if (last == nullptr || item.texTier->tex1.id != last->texTier->tex1.id)
+            SetTexture(item.texTier->tex1, 0);
+        if (last == nullptr || item.texTier->tex2.id != last->texTier->tex2.id)
+            SetTexture(item.texTier->tex2, 1);
+
+        if (last == nullptr || item.dataTier->material != last->dataTier->material)
+            SetMaterial(item.dataTier->material);
+
+        SetState(item.state); // already skips unchanged state
+
+        const EngineBaseObjDataTier& p4 = *item.dataTier;
+        int instanceCount = static_cast<int>(end - i);
+
+        if (instanceCount >= MIN_INSTANCE_COUNT && p4.staticBufferId != 0)
+        {
+            m_instanceTransforms.clear();
+            for (std::size_t j = i; j < end; ++j)
+                m_instanceTransforms.push_back(m_objects[m_renderQueue[j].objRank].renderTransform);
+
+            m_device->DrawStaticBufferInstanced(p4.staticBufferId, m_instanceTransforms.data(), instanceCount);
+
+            if (p4.type == ENG_TRIANGLE_TYPE_TRIANGLES)
+                m_statisticTriangle += instanceCount * (p4.vertices.size() / 3);
+            else
+                m_statisticTriangle += instanceCount * (p4.vertices.size() - 2);
+        }
+        else
+        {
+            for (std::size_t j = i; j < end; ++j)
+            {
+                int objRank = m_renderQueue[j].objRank;
+                if (objRank != transformObjRank)
+                {
+                    m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].renderTransform);
+                    transformObjRank = objRank;
+                }
+
+                DrawObject(p4);
+            }
+        }
+
+        last = &m_renderQueue[end - 1];
+        i = end;
+    }
+
+    m_renderQueue.clear();
+}
+
 void CEngine::DrawInterface()
 {
     m_device->SetRenderState(RENDER_STATE_DEPTH_TEST, false);
@@ -3839,7 +4422,7 @@ void CEngine::DrawInterface()
 
     if (!m_screenshotMode && m_renderInterface)
     {
-        m_particle->DrawParticle(SH_INTERFACE);  // draws the particles of the interface
+        DrawParticles(SH_INTERFACE);  // draws the particles of the interface
     }
 
     // 3D objects drawn in front of interface
@@ -3872,11 +4455,11 @@ void CEngine::DrawInterface()
             if (! m_objects[objRank].drawFront)
                 continue;
 
-            m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].transform);
-
             if (! IsVisible(objRank))
                 continue;
 
+            m_device->SetTransform(TRANSFORM_WORLD, m_objects[objRank].renderTransform);
+
             int baseObjRank = m_objects[objRank].baseObjRank;
             if (baseObjRank == -1)
                 continue;
@@ -3908,7 +4491,7 @@ void CEngine::DrawInterface()
             }
         }
 
-        m_particle->DrawParticle(SH_FRONT);  // draws the particles of the 3D world
+        DrawParticles(SH_FRONT);  // draws the particles of the 3D world
 
         m_device->SetRenderState(RENDER_STATE_DEPTH_TEST, false);
         m_device->SetRenderState(RENDER_STATE_LIGHTING, false);
@@ -3934,249 +4517,152 @@ void CEngine::DrawInterface()
 
 void CEngine::UpdateGroundSpotTextures()
 {
+    // Tiles invalidated by changed ground spots or terraforming are drawn again even if the mark didn't move
+    bool invalidTiles = false;
+    for (const EngineGroundSpotTile& tile : m_groundSpotTiles)
+        invalidTiles = invalidTiles || !tile.valid;
+
     if (!m_firstGroundSpot                                   &&
+        !invalidTiles                                        &&
         m_groundMark.drawPos.x     == m_groundMark.pos.x     &&
         m_groundMark.drawPos.z     == m_groundMark.pos.z     &&
         m_groundMark.drawRadius    == m_groundMark.radius    &&
         m_groundMark.drawIntensity == m_groundMark.intensity)
         return;
 
-    for (int s = 0; s < 16; s++)
-    {
-        Math::Point min, max;
-        min.x = (s%4) * 254.0f - 1.0f;  // 1 pixel cover
-        min.y = (s/4) * 254.0f - 1.0f;
-        max.x = min.x + 254.0f + 2.0f;
-        max.y = min.y + 254.0f + 2.0f;
+    // Area to be erased and area to draw
+    GroundSpotPixels oldMark = GetGroundSpotPixels(m_groundMark.drawPos, m_groundMark.drawRadius);
+    GroundSpotPixels newMark = GetGroundSpotPixels(m_groundMark.pos, m_groundMark.radius);
 
-        bool clear = false;
-        bool set   = false;
+    bool clear[16], set[16], fullUpload[16];
 
-        // Calculate the area to be erased.
-        int dot = static_cast<int>(m_groundMark.drawRadius/2.0f);
-
-        float tu, tv;
-        float cx, cy;
-
-        tu = (m_groundMark.drawPos.x+1600.0f)/3200.0f;
-        tv = (m_groundMark.drawPos.z+1600.0f)/3200.0f;  // 0..1
-
-        cx = (tu*254.0f*4.0f)-0.5f;
-        cy = (tv*254.0f*4.0f)-0.5f;
-
-        if (dot == 0)
-        {
-            cx += 0.5f;
-            cy += 0.5f;
-        }
-
-        float px = cx-Math::Mod(cx, 1.0f);
-        float py = cy-Math::Mod(cy, 1.0f);  // multiple of 1
-
-        if (m_firstGroundSpot ||
-            (m_groundMark.drawRadius != 0.0f    &&
-             px+dot >= min.x && py+dot >= min.y &&
-             px-dot <= max.x && py-dot <= max.y))
-        {
-            clear = true;
-        }
+    m_groundSpotUpdates.clear();
+    for (int s = 0; s < 16; s++)
+    {
+        clear[s] = m_firstGroundSpot || (m_groundMark.drawRadius != 0.0f && oldMark.Touches(s));
+        set[s]   = m_groundMark.draw && newMark.Touches(s);
+        fullUpload[s] = m_firstGroundSpot || !m_groundSpotTiles[s].valid;
 
-        // Calculate the area to draw.
-        dot = static_cast<int>(m_groundMark.radius/2.0f);
+        if (clear[s] || set[s] || fullUpload[s])
+            m_groundSpotUpdates.push_back(s);
+    }
 
-        tu = (m_groundMark.pos.x+1600.0f)/3200.0f;
-        tv = (m_groundMark.pos.z+1600.0f)/3200.0f;  // 0..1
+    // Ground spots rarely change, so usually just the mark is drawn again
+    m_workerPool->Run(static_cast<int>(m_groundSpotUpdates.size()), [this](int i)
+    {
+        int s = m_groundSpotUpdates[i];
+        if (!m_groundSpotTiles[s].valid)
+            DrawGroundSpotTile(s);
+    });
 
-        cx = (tu*254.0f*4.0f)-0.5f;
-        cy = (tv*254.0f*4.0f)-0.5f;
+    CImage shadowImg(Math::IntPoint(GROUND_SPOT_TILE_SIZE, GROUND_SPOT_TILE_SIZE));
+    SDL_Surface* surface = shadowImg.GetData()->surface;
 
-        if ( dot == 0 )
+    for (int s : m_groundSpotUpdates)
+    {
+        const std::vector<unsigned int>& pixels = m_groundSpotTiles[s].pixels;
+        for (int y = 0; y < GROUND_SPOT_TILE_SIZE; y++)
         {
-            cx += 0.5f;
-            cy += 0.5f;
+            memcpy(static_cast<char*>(surface->pixels) + y * surface->pitch,
+                   &pixels[y * GROUND_SPOT_TILE_SIZE], GROUND_SPOT_TILE_SIZE * sizeof(unsigned int));
         }
 
-        px = cx - Math::Mod(cx, 1.0f);
-        py = cy - Math::Mod(cy, 1.0f);  // multiple of 1
-
-        if (m_groundMark.draw &&
-            px+dot >= min.x && py+dot >= min.y &&
-            px-dot <= max.x && py-dot <= max.y)
-        {
-            set = true;
-        }
+        Math::Point min, max;
+        GetGroundSpotTileBounds(s, min, max);
 
-        if (clear || set)
+        if (set[s])
         {
-            CImage shadowImg(Math::IntPoint(256, 256));
-            shadowImg.Fill(Gfx::IntColor(255, 255, 255, 255));
+            float px = newMark.px;
+            float py = newMark.py;
+            int dot = newMark.dot;
 
-            // Draw the new shadows.
-            for (int i = 0; i < static_cast<int>( m_groundSpots.size() ); i++)
+            for (int iy = -dot; iy <= dot; iy++)
             {
-                if (m_groundSpots[i].used == false ||
-                    m_groundSpots[i].radius == 0.0f)
-                    continue;
-
-                if (m_groundSpots[i].min == 0.0f &&
-                    m_groundSpots[i].max == 0.0f)
+                for (int ix = -dot; ix <= dot; ix++)
                 {
-                    dot = static_cast<int>(m_groundSpots[i].radius/2.0f);
+                    float ppx = px+ix;
+                    float ppy = py+iy;
 
-                    tu = (m_groundSpots[i].pos.x+1600.0f)/3200.0f;
-                    tv = (m_groundSpots[i].pos.z+1600.0f)/3200.0f;  // 0..1
-
-                    cx = (tu*254.0f*4.0f) - 0.5f;
-                    cy = (tv*254.0f*4.0f) - 0.5f;
-
-                    if (dot == 0)
-                    {
-                        cx += 0.5f;
-                        cy += 0.5f;
-                    }
-
-                    px = cx-Math::Mod(cx, 1.0f);
-                    py = cy-Math::Mod(cy, 1.0f);  // multiple of 1
-
-                    if (px+dot < min.x || py+dot < min.y ||
-                        px-dot > max.x || py-dot > max.y)
+                    if (ppx <  min.x || ppy <  min.y ||
+                        ppx >= max.x || ppy >= max.y)
                         continue;
 
-                    for (int iy = -dot; iy <= dot; iy++)
-                    {
-                        for (int ix =- dot; ix <= dot; ix++)
-                        {
-                            float ppx = px+ix;
-                            float ppy = py+iy;
-
-                            if (ppx <  min.x || ppy <  min.y ||
-                                ppx >= max.x || ppy >= max.y)
-                                continue;
-
-                            float intensity;
-                            if (dot == 0)
-                                intensity = 0.0f;
-                            else
-                                intensity = Math::Point(ppx-cx, ppy-cy).Length()/dot;
+                    ppx -= min.x;  // on the texture
+                    ppy -= min.y;
 
-                            Gfx::Color color;
-                            color.r = Math::Norm(m_groundSpots[i].color.r+intensity);
-                            color.g = Math::Norm(m_groundSpots[i].color.g+intensity);
-                            color.b = Math::Norm(m_groundSpots[i].color.b+intensity);
+                    float intensity = 1.0f - Math::Point(ix, iy).Length() / dot;
+                    if (intensity <= 0.0f)
+                        continue;
 
-                            ppx -= min.x;  // on the texture
-                            ppy -= min.y;
+                    intensity *= m_groundMark.intensity;
 
-                            shadowImg.SetPixel(Math::IntPoint(ppx, ppy), color);
-                        }
-                    }
-                }
-                else
-                {
-                    for (int iy = 0; iy < 256; iy++)
+                    int j = (ix+dot) + (iy+dot) * m_groundMark.dx;
+                    if (m_groundMark.table[j] == 1)  // green ?
                     {
-                        for (int ix = 0; ix < 256; ix++)
-                        {
-                            Math::Vector pos;
-                            pos.x = (256.0f * (s%4) + ix) * 3200.0f/1024.0f - 1600.0f;
-                            pos.z = (256.0f * (s/4) + iy) * 3200.0f/1024.0f - 1600.0f;
-                            pos.y = 0.0f;
-
-                            float level = m_terrain->GetFloorLevel(pos, true);
-                            if (level < m_groundSpots[i].min ||
-                                level > m_groundSpots[i].max)
-                                continue;
-
-                            float intensity;
-                            if (level > (m_groundSpots[i].max+m_groundSpots[i].min)/2.0f)
-                                intensity = 1.0f - (m_groundSpots[i].max-level) / m_groundSpots[i].smooth;
-                            else
-                                intensity = 1.0f - (level-m_groundSpots[i].min) / m_groundSpots[i].smooth;
-
-                            if (intensity < 0.0f) intensity = 0.0f;
-
-                            Gfx::Color color;
-                            color.r = Math::Norm(m_groundSpots[i].color.r+intensity);
-                            color.g = Math::Norm(m_groundSpots[i].color.g+intensity);
-                            color.b = Math::Norm(m_groundSpots[i].color.b+intensity);
-
-                            shadowImg.SetPixel(Math::IntPoint(ix, iy), color);
-                        }
+                        Gfx::Color color;
+                        color.r = Math::Norm(1.0f-intensity);
+                        color.g = 1.0f;
+                        color.b = Math::Norm(1.0f-intensity);
+                        shadowImg.SetPixel(Math::IntPoint(ppx, ppy), color);
                     }
-                }
-            }
-
-            if (set)
-            {
-                dot = static_cast<int>(m_groundMark.radius/2.0f);
-
-                tu = (m_groundMark.pos.x + 1600.0f) / 3200.0f;
-                tv = (m_groundMark.pos.z + 1600.0f) / 3200.0f;  // 0..1
-
-                cx = (tu*254.0f*4.0f)-0.5f;
-                cy = (tv*254.0f*4.0f)-0.5f;
-
-                if (dot == 0)
-                {
-                    cx += 0.5f;
-                    cy += 0.5f;
-                }
-
-                px = cx-Math::Mod(cx, 1.0f);
-                py = cy-Math::Mod(cy, 1.0f);  // multiple of 1
-
-                for (int iy = -dot; iy <= dot; iy++)
-                {
-                    for (int ix = -dot; ix <= dot; ix++)
+                    if (m_groundMark.table[j] == 2)  // red ?
                     {
-                        float ppx = px+ix;
-                        float ppy = py+iy;
-
-                        if (ppx <  min.x || ppy <  min.y ||
-                            ppx >= max.x || ppy >= max.y)
-                            continue;
-
-                        ppx -= min.x;  // on the texture
-                        ppy -= min.y;
-
-                        float intensity = 1.0f - Math::Point(ix, iy).Length() / dot;
-                        if (intensity <= 0.0f)
-                            continue;
-
-                        intensity *= m_groundMark.intensity;
-
-                        int j = (ix+dot) + (iy+dot) * m_groundMark.dx;
-                        if (m_groundMark.table[j] == 1)  // green ?
-                        {
-                            Gfx::Color color;
-                            color.r = Math::Norm(1.0f-intensity);
-                            color.g = 1.0f;
-                            color.b = Math::Norm(1.0f-intensity);
-                            shadowImg.SetPixel(Math::IntPoint(ppx, ppy), color);
-                        }
-                        if (m_groundMark.table[j] == 2)  // red ?
-                        {
-                            Gfx::Color color;
-                            color.r = 1.0f;
-                            color.g = Math::Norm(1.0f-intensity);
-                            color.b = Math::Norm(1.0f-intensity);
-                            shadowImg.SetPixel(Math::IntPoint(ppx, ppy), color);
-                        }
+                        Gfx::Color color;
+                        color.r = 1.0f;
+                        color.g = Math::Norm(1.0f-intensity);
+                        color.b = Math::Norm(1.0f-intensity);
+                        shadowImg.SetPixel(Math::IntPoint(ppx, ppy), color);
                     }
                 }
             }
+        }
 
-            std::stringstream str;
-            str << "textures/shadow" << std::setfill('0') << std::setw(2) << s << ".png";
-            std::string texName = str.str();
-
-            DeleteTexture(texName);
+        std::stringstream str;
+        str << "textures/shadow" << std::setfill('0') << std::setw(2) << s << ".png";
+        std::string texName = str.str();
 
+        auto it = m_texNameMap.find(texName);
+        if (it == m_texNameMap.end())
+        {
             Gfx::Texture tex = m_device->CreateTexture(&shadowImg, m_defaultTexParams);
 
             m_texNameMap[texName] = tex;
             m_revTexNameMap[tex] = texName;
         }
+        else if (fullUpload[s])
+        {
+            m_device->UpdateTexture(it->second, Math::IntPoint(0, 0), shadowImg.GetData(), TEX_IMG_BGRA);
+        }
+        else
+        {
+            // Only the pixels under the old and the new mark changed
+            Math::IntPoint rectMin(GROUND_SPOT_TILE_SIZE, GROUND_SPOT_TILE_SIZE), rectMax(-1, -1);
+            Math::IntPoint markMin, markMax;
+            if (clear[s] && GetGroundMarkRect(oldMark, s, markMin, markMax))
+            {
+                rectMin = markMin;
+                rectMax = markMax;
+            }
+            if (set[s] && GetGroundMarkRect(newMark, s, markMin, markMax))
+            {
+                rectMin = Math::IntPoint(std::min(rectMin.x, markMin.x), std::min(rectMin.y, markMin.y));
+                rectMax = Math::IntPoint(std::max(rectMax.x, markMax.x), std::max(rectMax.y, markMax.y));
+            }
+
+            if (rectMin.x > rectMax.x || rectMin.y > rectMax.y)
+                continue;
+
+            CImage rectImg(Math::IntPoint(rectMax.x - rectMin.x + 1, rectMax.y - rectMin.y + 1));
+            SDL_Surface* rectSurface = rectImg.GetData()->surface;
+            for (int y = 0; y < rectSurface->h; y++)
+            {
+                memcpy(static_cast<char*>(rectSurface->pixels) + y * rectSurface->pitch,
+                       static_cast<char*>(surface->pixels) + (rectMin.y + y) * surface->pitch + rectMin.x * sizeof(unsigned int),
+                       rectSurface->w * sizeof(unsigned int));
+            }
+
+            m_device->UpdateTexture(it->second, rectMin, rectImg.GetData(), TEX_IMG_BGRA);
+        }
     }
 
     for (int i = 0; i < static_cast<int>( m_groundSpots.size() ); i++)
@@ -4200,6 +4686,93 @@ void CEngine::UpdateGroundSpotTextures()
     m_firstGroundSpot = false;
 }
 
+void CEngine::DrawGroundSpotTile(int s)
+{
+    const int size = GROUND_SPOT_TILE_SIZE;
+
+    EngineGroundSpotTile& tile = m_groundSpotTiles[s];
+    tile.pixels.assign(size * size, 0xFFFFFFFF);
+
+    Math::Point min, max;
+    GetGroundSpotTileBounds(s, min, max);
+
+    std::vector<float> levels;  // terrain level under each pixel, computed when needed
+    std::vector<float> intensity(size);
+    std::vector<char> covered(size);
+
+    for (const EngineGroundSpot& spot : m_groundSpots)
+    {
+        if (!spot.used || spot.radius == 0.0f)
+            continue;
+
+        if (spot.min == 0.0f && spot.max == 0.0f)
+        {
+            GroundSpotPixels pixels = GetGroundSpotPixels(spot.pos, spot.radius);
+            if (!pixels.Touches(s))
+                continue;
+
+            int dot = pixels.dot;
+
+            // Part of the spot inside the tile
+            int ixMin = std::max(-dot, static_cast<int>(min.x - pixels.px));
+            int ixMax = std::min( dot, static_cast<int>(max.x - pixels.px) - 1);
+            int iyMin = std::max(-dot, static_cast<int>(min.y - pixels.py));
+            int iyMax = std::min( dot, static_cast<int>(max.y - pixels.py) - 1);
+            int count = ixMax - ixMin + 1;
+            if (count <= 0)
+                continue;
+
+            for (int iy = iyMin; iy <= iyMax; iy++)
+            {
+                float dy = pixels.py + iy - pixels.cy;
+                float dx = pixels.px + ixMin - pixels.cx;
+                for (int i = 0; i < count; i++)
+                    intensity[i] = dot == 0 ? 0.0f : std::sqrt((dx+i)*(dx+i) + dy*dy) / dot;
+
+                int x = static_cast<int>(pixels.px - min.x) + ixMin;
+                int y = static_cast<int>(pixels.py - min.y) + iy;
+                DrawGroundSpotRow(spot.color, intensity.data(), nullptr, count, &tile.pixels[y * size + x]);
+            }
+        }
+        else
+        {
+            if (levels.empty())
+            {
+                levels.resize(size * size);
+                for (int iy = 0; iy < size; iy++)
+                {
+                    for (int ix = 0; ix < size; ix++)
+                    {
+                        Math::Vector pos;
+                        pos.x = (256.0f * (s%4) + ix) * 3200.0f/1024.0f - 1600.0f;
+                        pos.z = (256.0f * (s/4) + iy) * 3200.0f/1024.0f - 1600.0f;
+                        pos.y = 0.0f;
+
+                        levels[iy * size + ix] = m_terrain->GetFloorLevel(pos, true);
+                    }
+                }
+            }
+
+            float middle = (spot.max+spot.min)/2.0f;
+            for (int iy = 0; iy < size; iy++)
+            {
+                const float* level = &levels[iy * size];
+                for (int ix = 0; ix < size; ix++)
+                {
+                    float value = level[ix] > middle ? 1.0f - (spot.max-level[ix]) / spot.smooth
+                                                     : 1.0f - (level[ix]-spot.min) / spot.smooth;
+                    intensity[ix] = std::max(value, 0.0f);
+                    covered[ix] = level[ix] >= spot.min && level[ix] <= spot.max;
+                }
+
+                DrawGroundSpotRow(spot.color, intensity.data(), covered.data(), size, &tile.pixels[iy * size]);
+            }
+        }
+    }
+
+    tile.valid = true;
+}
+
 void CEngine::DrawShadowSpots()
 {
     m_device->SetRenderState(RENDER_STATE_DEPTH_WRITE, false);
@@ -4777,6 +5350,13 @@ void CEngine::DrawMouseSprite(Math::Point pos, Math::Point size, int icon)
     AddStatisticTriangle(2);
 }
 
+void CEngine::DrawParticles(int sheet)
+{
+    long long drawCalls = m_device->GetDrawCallCount();
+    m_particle->DrawParticle(sheet);
+    m_particleDrawCalls += static_cast<int>(m_device->GetDrawCallCount() - drawCalls);
+}
+
 void CEngine::DrawStats()
 {
     if (!m_showStats)
@@ -4784,7 +5364,7 @@ void CEngine::DrawStats()
 
     float height = m_text->GetAscent(FONT_COLOBOT, 13.0f);
     float width = 0.25f;
-    const int TOTAL_LINES = 20;
+    const int TOTAL_LINES = 22;
 
     Math::Point pos(0.05f * m_size.x/m_size.y, 0.05f + TOTAL_LINES * height);
 
@@ -4867,6 +5447,8 @@ void CEngine::DrawStats()
     drawStatsCounter("Swap buffers & VSync",  PCNT_SWAP_BUFFERS);
     drawStatsLine("", "");
     drawStatsLine(   "Triangles",         StrUtils::ToString<int>(m_statisticTriangle));
+    drawStatsLine(   "Draw calls",        StrUtils::ToString<int>(m_statisticDrawCalls));
+    drawStatsLine(   "    Particle draw calls", StrUtils::ToString<int>(m_statisticParticleDrawCalls));
     drawStatsValue(  "FPS",               m_fps);
     drawStatsLine("", "");
     str.str("");
@@ -4899,20 +5481,41 @@ void CEngine::AddBaseObjTriangles(int baseObjRank, const std::vector<Gfx::ModelT
 
         int state = GetEngineState(triangle);
 
-        std::string tex1Name;
-        if (!triangle.tex1Name.empty())
-            tex1Name = "objects/" + triangle.tex1Name;
-
-        std::string tex2Name;
-        if (triangle.variableTex2)
-            tex2Name = GetSecondTexture();
-        else
-            tex2Name = triangle.tex2Name;
+        std::string tex1Name, tex2Name;
+        GetModelTextureNames(triangle, tex1Name, tex2Name);
 
         AddBaseObjTriangles(baseObjRank, vs, material, state, tex1Name, tex2Name);
     }
 }
 
+void CEngine::AddBaseObjTriangleGroup(int baseObjRank, const Gfx::ModelTriangle& attributes, std::vector<VertexTex2> vertices)
+{
+    Material material;
+    material.ambient = attributes.ambient;
+    material.diffuse = attributes.diffuse;
+    material.specular = attributes.specular;
+
+    EngineBaseObjDataTier buffer(ENG_TRIANGLE_TYPE_TRIANGLES, material, GetEngineState(attributes));
+    buffer.vertices = std::move(vertices);
+
+    std::string tex1Name, tex2Name;
+    GetModelTextureNames(attributes, tex1Name, tex2Name);
+
+    AddBaseObjQuick(baseObjRank, std::move(buffer), tex1Name, tex2Name, false);
+}
+
+void CEngine::GetModelTextureNames(const ModelTriangle& triangle, std::string& tex1Name, std::string& tex2Name)
+{
+    tex1Name.clear();
+    if (!triangle.tex1Name.empty())
+        tex1Name = "objects/" + triangle.tex1Name;
+
+    if (triangle.variableTex2)
+        tex2Name = GetSecondTexture();
+    else
+        tex2Name = triangle.tex2Name;
+}
+
 int CEngine::GetEngineState(const ModelTriangle& triangle)
 {
     int state = 0;
@@ -31,6 +31,8 @@
 #include "graphics/core/texture.h"
 #include "graphics/core/vertex.h"
 
+#include "graphics/engine/frustum_culler.h"
+
 #include "math/intpoint.h"
 #include "math/matrix.h"
 #include "math/point.h"
@@ -51,6 +53,7 @@ class CSoundInterface;
 class CImage;
 class CPauseManager;
 class CSystemUtils;
+class CWorkerPool;
 struct SystemTimeStamp;
 struct Event;
 
@@ -70,6 +73,10 @@ class CCloud;
 class CLightning;
 class CPlanet;
 class CTerrain;
+class CBakedTexture;
+class CTextureCache;
+class CTextureLoader;
+class CTextureRecolorCache;
 class CPyroManager;
 class CModelMesh;
 struct ModelShadowSpot;
@@ -200,6 +207,10 @@ struct EngineBaseObjDataTier
     std::vector<VertexTex2> vertices;
     unsigned int            staticBufferId;
     bool                    updateStaticBuffer;
+    //! Number of vertices in static buffer, less than in \a vertices if they were welded
+    int                     staticVertexCount;
+    //! Number of indices in static buffer, 0 if it is drawn without them
+    int                     staticIndexCount;
 
     inline EngineBaseObjDataTier(EngineTriangleType type = ENG_TRIANGLE_TYPE_TRIANGLES,
                                  const Material& material = Material(),
@@ -209,6 +220,8 @@ struct EngineBaseObjDataTier
      , state(state)
      , staticBufferId(0)
      , updateStaticBuffer(false)
+     , staticVertexCount(0)
+     , staticIndexCount(0)
     {}
 };
 
@@ -249,6 +262,10 @@ struct EngineBaseObject
     Math::Vector           bboxMax;
     //! Radius of the sphere at the origin
     float                  radius = 0.0f;
+    //! If true, bounding box and radius must be recomputed
+    bool                   updateGeometry = false;
+    //! If true, some tier 3 has updateStaticBuffer set
+    bool                   updateStaticBuffers = false;
     //! Next tier (Tex)
     std::vector<EngineBaseObjTexTier> next;
 
@@ -278,6 +295,12 @@ struct EngineObject
     EngineObjectType       type = ENG_OBJTYPE_NULL;
     //! Transformation matrix
     Math::Matrix           transform;
+    //! Transformation matrix at the start of the current simulation step
+    Math::Matrix           previousTransform;
+    //! If true, previousTransform is valid
+    bool                   hasPreviousTransform = false;
+    //! Transformation matrix used for rendering the current frame
+    Math::Matrix           renderTransform;
     //! Distance to object from eye point
     float                  distance = 0.0f;
     //! Rank of the associated shadow
@@ -292,6 +315,27 @@ struct EngineObject
     }
 };
 
+/**
+ * \struct EngineRenderItem
+ * \brief Part of object queued for drawing in one frame
+ *
+ * Items are sorted by their lights, state, textures and material,
+ * so that consecutive items share as much device state as possible.
+ */
+struct EngineRenderItem
+{
+    //! Type of object, which selects the lights
+    EngineObjectType             type = ENG_OBJTYPE_NULL;
+    //! Render state (see EngineRenderState)
+    int                          state = 0;
+    //! Rank of object, which selects the world transform
+    int                          objRank = -1;
+    //! Texture tier with textures used
+    const EngineBaseObjTexTier*  texTier = nullptr;
+    //! Data tier to draw
+    const EngineBaseObjDataTier* dataTier = nullptr;
+};
+
 /**
  * \struct EngineShadowType
  * \brief Type of shadow drawn by the graphics engine
@@ -423,6 +467,18 @@ struct EngineGroundMark
     }
 };
 
+/**
+ * \struct EngineGroundSpotTile
+ * \brief Cached content of one of the 16 ground spot textures
+ */
+struct EngineGroundSpotTile
+{
+    //! Pixels with the ground spots but without the ground mark, as 0xAARRGGBB
+    std::vector<unsigned int> pixels;
+    //! False if the ground spots over the tile changed since the pixels were drawn
+    bool valid = false;
+};
+
 /**
  * \enum EngineTextureMapping
  * \brief Type of texture mapping
@@ -672,6 +728,14 @@ public:
     //! Called once per frame, the call is the entry point for animating the scene
     void            FrameUpdate();
 
+    //@{
+    //! Interpolation of rendered frames between fixed simulation steps
+    //! Saves object transforms and view as the start of the next simulation step
+    void            BeginSimulationStep();
+    //! Sets the position of rendered frames between the last two steps [0, 1]; negative value disables interpolation
+    void            SetStepInterpolation(float alpha);
+    //@}
+
 
     //! Writes a screenshot containing the current frame
     void            WriteScreenShot(const std::string& fileName);
@@ -769,12 +833,24 @@ public:
 
     //! Adds triangles to given object with the specified params
     void AddBaseObjTriangles(int baseObjRank, const std::vector<Gfx::ModelTriangle>& triangles);
+    //! Adds triangles which all have the textures, material and flags of \a attributes as one data tier
+    void AddBaseObjTriangleGroup(int baseObjRank, const Gfx::ModelTriangle& attributes, std::vector<VertexTex2> vertices);
 
     //! Adds a tier 4 engine object directly
-    void            AddBaseObjQuick(int baseObjRank, const EngineBaseObjDataTier& buffer,
+    void            AddBaseObjQuick(int baseObjRank, EngineBaseObjDataTier buffer,
                                     std::string tex1Name, std::string tex2Name,
                                     bool globalUpdate);
 
+    /**
+     * \brief Prepares a base object for rebuilding its geometry in place
+     *
+     * Vertices of all tiers are removed, but the tiers keep their static buffers.
+     * The following calls to AddBaseObjQuick() refill the emptied tiers in the order
+     * they were created and update their buffers instead of creating new ones.
+     * Tiers which remain empty are removed on the next Update().
+     */
+    void            ClearBaseObjGeometry(int baseObjRank);
+
     // Objects
 
     //! Print debug info about an object
@@ -883,6 +959,8 @@ public:
     void            SetObjectGroundSpotMinMax(int rank, float min, float max);
     void            SetObjectGroundSpotSmooth(int rank, float smooth);
     //@}
+    //! Redraws ground spots which depend on the terrain height, after the terrain changed
+    void            InvalidateGroundSpotLevels();
 
     //! Creates the ground mark with the given params
     void            CreateGroundMark(Math::Vector pos, float radius,
@@ -1190,11 +1268,20 @@ protected:
     void        UseMSAA(bool enable);
     //! Draw 3D object
     void        DrawObject(const EngineBaseObjDataTier& p4);
+    //! Adds all parts of object to the render queue
+    void        QueueObject(int objRank, const EngineBaseObject& p1);
+    //! Sorts the render queue and draws it, skipping redundant changes of state
+    //! and drawing objects with the same base object with instanced draw calls
+    void        DrawRenderQueue();
     //! Draws the user interface over the scene
     void        DrawInterface();
 
     //! Updates the textures used for drawing ground spot
     void        UpdateGroundSpotTextures();
+    //! Draws the ground spots of the given tile into its cached pixels; called from worker threads
+    void        DrawGroundSpotTile(int s);
+    //! Marks the tiles under the given ground spot to be drawn again
+    void        InvalidateGroundSpotTiles(const EngineGroundSpot& spot);
 
     //! Draws old-style shadow spots
     void        DrawShadowSpots();
@@ -1216,6 +1303,8 @@ protected:
     void        DrawMouse();
     //! Draw part of mouse cursor sprite
     void        DrawMouseSprite(Math::Point pos, Math::Point dim, int icon);
+    //! Draws the particles of the given sheet, counting the draw calls used
+    void        DrawParticles(int sheet);
     //! Draw statistic texts
     void        DrawStats();
     //! Draw mission timer
@@ -1229,9 +1318,25 @@ protected:
 
     //! Create texture and add it to cache
     Texture CreateTexture(const std::string &texName, const TextureCreateParams &params, CImage* image = nullptr);
-
-    //! Tests whether the given object is visible
+    //! Create texture from cached image and add it to cache
+    Texture CreateTexture(const std::string &texName, const TextureCreateParams &params, CBakedTexture* baked);
+    //! Adds texture created by device to cache, blacklisting the name if it is invalid
+    Texture AddTexture(const std::string &texName, const Texture &tex);
+    //! Like LoadTexture(), but loads the image in background and returns a placeholder until it is ready
+    Texture RequestTexture(const std::string& name, const TextureCreateParams& params);
+    //! Returns the texture shown in place of textures which are still loading
+    Texture GetPlaceholderTexture();
+    //! Creates a limited number of textures loaded in background and puts them in place of placeholders
+    void    UploadLoadedTextures();
+
+    //! Tests whether the given object is within the view frustum of camera
     bool        IsVisible(int objRank);
+    //! Computes bounding sphere of object in world space
+    bool        GetObjectBoundingSphere(int objRank, Math::Vector& center, float& radius);
+    //! Computes bounding spheres of objects and the camera frustum for current frame
+    void        UpdateObjectBounds();
+    //! Marks objects within the camera frustum as visible
+    void        CullObjects();
 
     //! Detects whether an object is affected by the mouse
     bool        DetectBBox(int objRank, Math::Point mouse);
@@ -1249,20 +1354,31 @@ protected:
     //! Calculates the distances between the viewpoint and the origin of different objects
     void        ComputeDistance();
 
-    //! Updates geometric parameters of objects (bounding box and radius)
+    //! Computes transforms and view matrix of the rendered frame
+    void        UpdateRenderTransforms();
+
+    //! Schedules update of bounding box and/or static buffers of a base object
+    void        MarkBaseObjectDirty(int baseObjRank, bool geometry, bool staticBuffers);
+
+    //! Updates geometric parameters of changed objects (bounding box and radius)
     void        UpdateGeometry();
 
-    //! Updates a given static buffer
-    void        UpdateStaticBuffer(EngineBaseObjDataTier& p4);
+    //! Updates a given static buffer; if \a indexed, triangles are welded and stored with indices when that is smaller
+    void        UpdateStaticBuffer(EngineBaseObjDataTier& p4, bool indexed);
 
     //! Updates static buffers of changed objects
     void        UpdateStaticBuffers();
 
+    //! Loads the textures of base object; returns false if some of them failed
+    bool        LoadBaseObjTextures(EngineBaseObject& p1, bool terrain);
+
     void            AddBaseObjTriangles(int baseObjRank, const std::vector<VertexTex2>& vertices,
                                         const Material& material, int state,
                                         std::string tex1Name, std::string tex2Name);
 
     int GetEngineState(const ModelTriangle& triangle);
+    //! Returns names of textures of tiers for \a triangle from a model
+    void GetModelTextureNames(const ModelTriangle& triangle, std::string& tex1Name, std::string& tex2Name);
 
     struct WriteScreenShotData
     {
@@ -1336,17 +1452,41 @@ protected:
     std::vector<EngineBaseObject> m_baseObjects;
     //! Object parameters
     std::vector<EngineObject>     m_objects;
+    //! Bounding spheres of objects in current frame
+    CFrustumCuller                m_objectCuller;
+    //! View frustum of camera in current frame
+    CFrustum                      m_cameraFrustum;
+    //! Objects found by last culling
+    std::vector<int>              m_culledObjects;
+    //! Parts of objects to draw in current pass
+    std::vector<EngineRenderItem> m_renderQueue;
+    //! World transforms of objects drawn with one instanced draw call
+    std::vector<Math::Matrix>     m_instanceTransforms;
     //! Shadow list
     std::vector<EngineShadow>     m_shadowSpots;
     //! Ground spot list
     std::vector<EngineGroundSpot> m_groundSpots;
     //! Ground mark
     EngineGroundMark              m_groundMark;
+    //! Content of the 16 ground spot textures
+    EngineGroundSpotTile          m_groundSpotTiles[16];
+    //! Ranks of the tiles redrawn by UpdateGroundSpotTextures()
+    std::vector<int>              m_groundSpotUpdates;
+    //! Threads drawing ground spot tiles
+    std::unique_ptr<CWorkerPool>  m_workerPool;
 
     //! Location of camera
     Math::Vector    m_eyePt;
     //! Camera target
     Math::Vector    m_lookatPt;
+    //! Camera up vector
+    Math::Vector    m_upVec;
+    //! Location of camera and target at the start of the current simulation step
+    Math::Vector    m_previousEyePt;
+    Math::Vector    m_previousLookatPt;
+    bool            m_hasPreviousView;
+    //! Position between last two simulation steps; negative if not interpolating
+    float           m_stepInterpolation;
     float           m_eyeDirH;
     float           m_eyeDirV;
     int             m_rankView;
@@ -1357,9 +1497,16 @@ protected:
     float           m_fogStart[2];
     Color           m_waterAddColor;
     int             m_statisticTriangle;
+    //! Draw calls made in the last complete frame, in total and for particles
+    int             m_statisticDrawCalls;
+    int             m_statisticParticleDrawCalls;
+    //! Device draw call count at the start of the current frame
+    long long       m_drawCallsAtFrameStart;
+    //! Draw calls made by particles so far in the current frame
+    int             m_particleDrawCalls;
     Math::Vector    m_statisticPos;
-    bool            m_updateGeometry;
-    bool            m_updateStaticBuffers;
+    //! Ranks of base objects with updateGeometry or updateStaticBuffers set
+    std::vector<int> m_dirtyBaseObjects;
     bool            m_firstGroundSpot;
     std::string     m_secondTex;
     bool            m_backgroundFull;
@@ -1435,6 +1582,14 @@ protected:
     /** Textures on this list were not successful in first loading,
      *  so are disabled for subsequent load calls. */
     std::set<std::string> m_texBlacklist;
+    //! Textures recolored by ChangeTextureColor()
+    std::unique_ptr<CTextureRecolorCache> m_recolorCache;
+    //! Decoded texture images stored in the save location
+    std::unique_ptr<CTextureCache> m_textureCache;
+    //! Loads textures requested with RequestTexture() in background
+    std::unique_ptr<CTextureLoader> m_textureLoader;
+    //! Small texture used while the requested ones are loading
+    Texture         m_placeholderTexture;
 
     //! Mouse cursor definitions
     EngineMouse     m_mice[ENG_MOUSE_COUNT];
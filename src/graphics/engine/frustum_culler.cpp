@@ -0,0 +1,267 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/frustum_culler.h"
+
+#include "math/func.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+namespace
+{
+
+//! Maximum number of spheres in a leaf of the tree
+const int LEAF_SIZE = 4;
+
+float GetAxis(const Math::Vector& v, int axis)
+{
+    return v.Array()[axis];
+}
+
+} // anonymous namespace
+
+
+CFrustum::CFrustum()
+{
+    // Everything is inside until the planes are set
+    for (int i = 0; i < PLANE_COUNT; ++i)
+    {
+        m_normal[i] = Math::Vector(0.0f, 0.0f, 0.0f);
+        m_distance[i] = 0.0f;
+    }
+}
+
+CFrustum::CFrustum(const Math::Matrix& viewProj)
+{
+    Set(viewProj);
+}
+
+void CFrustum::Set(const Math::Matrix& viewProj)
+{
+    Math::Matrix m = viewProj;
+
+    // Each plane is the 4th row of the matrix plus or minus one of the others
+    auto setPlane = [&](int plane, int row, float sign)
+    {
+        Math::Vector normal(m.Get(4, 1) + sign * m.Get(row, 1),
+                            m.Get(4, 2) + sign * m.Get(row, 2),
+                            m.Get(4, 3) + sign * m.Get(row, 3));
+        float distance = m.Get(4, 4) + sign * m.Get(row, 4);
+
+        float length = normal.Length();
+        if (length < 1e-6f)
+            length = 1.0f;
+
+        m_normal[plane] = normal / length;
+        m_distance[plane] = distance / length;
+    };
+
+    setPlane(0, 1,  1.0f);  // left
+    setPlane(1, 1, -1.0f);  // right
+    setPlane(2, 2,  1.0f);  // bottom
+    setPlane(3, 2, -1.0f);  // top
+    setPlane(4, 3,  1.0f);  // front
+    setPlane(5, 3, -1.0f);  // back
+}
+
+bool CFrustum::IsSphereVisible(const Math::Vector& center, float radius) const
+{
+    return TestSphere(center, radius, ALL_PLANES);
+}
+
+bool CFrustum::TestSphere(const Math::Vector& center, float radius, int planeMask) const
+{
+    for (int i = 0; i < PLANE_COUNT; ++i)
+    {
+        if ((planeMask & (1 << i)) == 0)
+            continue;
+
+        if (Math::DotProduct(m_normal[i], center) + m_distance[i] < -radius)
+            return false;
+    }
+
+    return true;
+}
+
+bool CFrustum::TestBox(const Math::Vector& center, const Math::Vector& extent, int& planeMask) const
+{
+    for (int i = 0; i < PLANE_COUNT; ++i)
+    {
+        if ((planeMask & (1 << i)) == 0)
+            continue;
+
+        // Radius of the box projected on the plane normal
+        float radius = fabs(m_normal[i].x) * extent.x +
+                       fabs(m_normal[i].y) * extent.y +
+                       fabs(m_normal[i].z) * extent.z;
+
+        float distance = Math::DotProduct(m_normal[i], center) + m_distance[i];
+        if (distance < -radius)
+            return false;
+
+        if (distance >= radius)
+            planeMask &= ~(1 << i);
+    }
+
+    return true;
+}
+
+
+CFrustumCuller::CFrustumCuller()
+{
+}
+
+CFrustumCuller::~CFrustumCuller()
+{
+}
+
+void CFrustumCuller::Clear()
+{
+    m_spheres.clear();
+    m_nodes.clear();
+}
+
+void CFrustumCuller::Add(int id, const Math::Vector& center, float radius)
+{
+    Sphere sphere;
+    sphere.id = id;
+    sphere.center = center;
+    sphere.radius = radius;
+    m_spheres.push_back(sphere);
+}
+
+void CFrustumCuller::Build()
+{
+    m_nodes.clear();
+
+    if (m_spheres.empty())
+        return;
+
+    m_nodes.reserve(2 * m_spheres.size() / LEAF_SIZE + 1);
+    BuildNode(0, static_cast<int>(m_spheres.size()));
+}
+
+int CFrustumCuller::BuildNode(int first, int last)
+{
+    int index = static_cast<int>(m_nodes.size());
+    m_nodes.push_back(Node());
+
+    Node node;
+    node.first = first;
+    node.last = last;
+
+    Math::Vector centerMin = m_spheres[first].center;
+    Math::Vector centerMax = m_spheres[first].center;
+    node.min = m_spheres[first].center;
+    node.max = m_spheres[first].center;
+
+    for (int i = first; i < last; ++i)
+    {
+        const Sphere& sphere = m_spheres[i];
+        Math::Vector radius(sphere.radius, sphere.radius, sphere.radius);
+
+        node.min.x = Math::Min(node.min.x, sphere.center.x - radius.x);
+        node.min.y = Math::Min(node.min.y, sphere.center.y - radius.y);
+        node.min.z = Math::Min(node.min.z, sphere.center.z - radius.z);
+        node.max.x = Math::Max(node.max.x, sphere.center.x + radius.x);
+        node.max.y = Math::Max(node.max.y, sphere.center.y + radius.y);
+        node.max.z = Math::Max(node.max.z, sphere.center.z + radius.z);
+
+        centerMin.x = Math::Min(centerMin.x, sphere.center.x);
+        centerMin.y = Math::Min(centerMin.y, sphere.center.y);
+        centerMin.z = Math::Min(centerMin.z, sphere.center.z);
+        centerMax.x = Math::Max(centerMax.x, sphere.center.x);
+        centerMax.y = Math::Max(centerMax.y, sphere.center.y);
+        centerMax.z = Math::Max(centerMax.z, sphere.center.z);
+    }
+
+    if (last - first > LEAF_SIZE)
+    {
+        // Split at the median along the longest axis of sphere centers
+        Math::Vector size = centerMax - centerMin;
+        int axis = 0;
+        if (size.y > GetAxis(size, axis)) axis = 1;
+        if (size.z > GetAxis(size, axis)) axis = 2;
+
+        int middle = (first + last) / 2;
+        std::nth_element(m_spheres.begin() + first, m_spheres.begin() + middle, m_spheres.begin() + last,
+                         [axis](const Sphere& a, const Sphere& b)
+                         {
+                             return GetAxis(a.center, axis) < GetAxis(b.center, axis);
+                         });
+
+        node.left = BuildNode(first, middle);
+        node.right = BuildNode(middle, last);
+    }
+
+    m_nodes[index] = node;
+    return index;
+}
+
+void CFrustumCuller::Cull(const CFrustum& frustum, std::vector<int>& result) const
+{
+    if (m_nodes.empty())
+        return;
+
+    CullNode(0, frustum, CFrustum::ALL_PLANES, result);
+}
+
+void CFrustumCuller::CullNode(int index, const CFrustum& frustum, int planeMask, std::vector<int>& result) const
+{
+    const Node& node = m_nodes[index];
+
+    if (! frustum.TestBox((node.min + node.max) * 0.5f, (node.max - node.min) * 0.5f, planeMask))
+        return;
+
+    if (planeMask == 0)
+    {
+        // Entirely inside
+        for (int i = node.first; i < node.last; ++i)
+            result.push_back(m_spheres[i].id);
+        return;
+    }
+
+    if (node.left == -1)
+    {
+        for (int i = node.first; i < node.last; ++i)
+        {
+            const Sphere& sphere = m_spheres[i];
+            if (frustum.TestSphere(sphere.center, sphere.radius, planeMask))
+                result.push_back(sphere.id);
+        }
+        return;
+    }
+
+    CullNode(node.left, frustum, planeMask, result);
+    CullNode(node.right, frustum, planeMask, result);
+}
+
+int CFrustumCuller::GetCount() const
+{
+    return static_cast<int>(m_spheres.size());
+}
+
+
+} // namespace Gfx
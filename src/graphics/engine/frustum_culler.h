@@ -0,0 +1,133 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file graphics/engine/frustum_culler.h
+ * \brief Frustum culling of bounding spheres - CFrustum and CFrustumCuller classes
+ */
+
+#pragma once
+
+
+#include "math/matrix.h"
+#include "math/vector.h"
+
+#include <vector>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \class CFrustum
+ * \brief View frustum given by its six planes in world space
+ */
+class CFrustum
+{
+public:
+    CFrustum();
+    //! Creates the frustum of given projection * view matrix
+    explicit CFrustum(const Math::Matrix& viewProj);
+
+    //! Sets the planes from given projection * view matrix
+    void        Set(const Math::Matrix& viewProj);
+
+    //! Returns true if sphere is (partially) within the frustum
+    bool        IsSphereVisible(const Math::Vector& center, float radius) const;
+
+    //! Returns false if sphere is outside any of planes in \a planeMask
+    bool        TestSphere(const Math::Vector& center, float radius, int planeMask) const;
+    /**
+     * \brief Tests axis-aligned box against planes in \a planeMask
+     * \param center center of box
+     * \param extent half of size of box
+     * \param planeMask bit mask of planes to test; planes the box is entirely inside of are removed
+     * \return false if box is outside any of the planes
+     */
+    bool        TestBox(const Math::Vector& center, const Math::Vector& extent, int& planeMask) const;
+
+    //! Number of planes of frustum
+    static const int PLANE_COUNT = 6;
+    //! Mask of all planes
+    static const int ALL_PLANES = (1 << PLANE_COUNT) - 1;
+
+private:
+    Math::Vector m_normal[PLANE_COUNT];
+    float        m_distance[PLANE_COUNT];
+};
+
+/**
+ * \class CFrustumCuller
+ * \brief Bounding volume hierarchy of spheres, culled against frusta
+ *
+ * Spheres are added with an id and the tree is built once with Build(),
+ * after which it can be culled against any number of frusta. Subtrees
+ * entirely outside a frustum are skipped, and subtrees entirely inside
+ * are accepted without testing their spheres.
+ */
+class CFrustumCuller
+{
+public:
+    CFrustumCuller();
+    ~CFrustumCuller();
+
+    //! Removes all spheres
+    void        Clear();
+    //! Adds sphere with given id; Build() must be called before culling
+    void        Add(int id, const Math::Vector& center, float radius);
+    //! Builds the tree of spheres added so far
+    void        Build();
+
+    //! Appends to \a result ids of spheres (partially) within the frustum
+    void        Cull(const CFrustum& frustum, std::vector<int>& result) const;
+
+    //! Returns number of spheres
+    int         GetCount() const;
+
+private:
+    struct Sphere
+    {
+        int          id;
+        Math::Vector center;
+        float        radius;
+    };
+
+    //! Node covering spheres [first, last) with their bounding box
+    struct Node
+    {
+        Math::Vector min;
+        Math::Vector max;
+        int          first = 0;
+        int          last = 0;
+        //! Indexes of child nodes; -1 for leaves
+        int          left = -1;
+        int          right = -1;
+    };
+
+    int         BuildNode(int first, int last);
+    void        CullNode(int index, const CFrustum& frustum, int planeMask, std::vector<int>& result) const;
+
+private:
+    std::vector<Sphere> m_spheres;
+    std::vector<Node>   m_nodes;
+};
+
+
+} // namespace Gfx
@@ -78,6 +78,7 @@ CLightManager::CLightManager(CEngine* engine)
     m_engine = engine;
 
     m_time = 0.0f;
+    m_deviceLightsValid = false;
 }
 
 CLightManager::~CLightManager()
@@ -90,6 +91,7 @@ void CLightManager::SetDevice(CDevice* device)
 {
     m_device = device;
     m_lightMap = std::vector<int>(m_device->GetMaxLightCount(), -1);
+    InvalidateLightMaps();
 }
 
 void CLightManager::DebugDumpLights()
@@ -150,6 +152,7 @@ void CLightManager::DebugDumpLights()
 void CLightManager::FlushLights()
 {
     m_dynLights.clear();
+    InvalidateLightMaps();
 }
 
 /** Returns the index of light created. */
@@ -185,6 +188,8 @@ int CLightManager::CreateLight(LightPriority priority)
     m_dynLights[index].colorGreen.Init(0.5f);
     m_dynLights[index].colorBlue.Init(0.5f);  // gray
 
+    InvalidateLightMaps();
+
     return index;
 }
 
@@ -194,6 +199,7 @@ bool CLightManager::DeleteLight(int lightRank)
         return false;
 
     m_dynLights[lightRank].used = false;
+    InvalidateLightMaps();
     return true;
 }
 
@@ -208,6 +214,7 @@ bool CLightManager::SetLight(int lightRank, const Light &light)
     m_dynLights[lightRank].colorGreen.Init(m_dynLights[lightRank].light.diffuse.g);
     m_dynLights[lightRank].colorBlue.Init(m_dynLights[lightRank].light.diffuse.b);
 
+    InvalidateLightMaps();
     return true;
 }
 
@@ -226,6 +233,7 @@ bool CLightManager::SetLightEnabled(int lightRank, bool enabled)
         return false;
 
     m_dynLights[lightRank].enabled = enabled;
+    InvalidateLightMaps();
     return true;
 }
 
@@ -235,6 +243,7 @@ bool CLightManager::SetLightPriority(int lightRank, LightPriority priority)
         return false;
 
     m_dynLights[lightRank].priority = priority;
+    InvalidateLightMaps();
     return true;
 }
 
@@ -244,6 +253,7 @@ bool CLightManager::SetLightIncludeType(int lightRank, EngineObjectType type)
         return false;
 
     m_dynLights[lightRank].includeType = type;
+    InvalidateLightMaps();
     return true;
 }
 
@@ -253,6 +263,7 @@ bool CLightManager::SetLightExcludeType(int lightRank, EngineObjectType type)
         return false;
 
     m_dynLights[lightRank].excludeType = type;
+    InvalidateLightMaps();
     return true;
 }
 
@@ -262,6 +273,7 @@ bool CLightManager::SetLightPos(int lightRank, const Math::Vector &pos)
         return false;
 
     m_dynLights[lightRank].light.position = pos;
+    InvalidateLightMaps();
     return true;
 }
 
@@ -279,6 +291,7 @@ bool CLightManager::SetLightDir(int lightRank, const Math::Vector &dir)
         return false;
 
     m_dynLights[lightRank].light.direction = dir;
+    InvalidateLightMaps();
     return true;
 }
 
@@ -412,6 +425,9 @@ void CLightManager::UpdateProgression(float rTime)
 
 void CLightManager::UpdateLights()
 {
+    // Lights change from frame to frame
+    InvalidateLightMaps();
+
     for (int i = 0; i < static_cast<int>( m_dynLights.size() ); i++)
     {
         if (! m_dynLights[i].used)
@@ -444,55 +460,87 @@ void CLightManager::UpdateLights()
 
 void CLightManager::UpdateDeviceLights(EngineObjectType type)
 {
-    for (int i = 0; i < static_cast<int>( m_lightMap.size() ); ++i)
-        m_lightMap[i] = -1;
+    auto it = m_lightMapCache.find(type);
+    if (it == m_lightMapCache.end())
+    {
+        it = m_lightMapCache.insert(std::make_pair(type, std::vector<int>())).first;
+        ComputeLightMap(type, it->second);
+    }
+
+    const std::vector<int>& lightMap = it->second;
+
+    for (int i = 0; i < static_cast<int>( lightMap.size() ); ++i)
+    {
+        // Device light is already set
+        if (m_deviceLightsValid && m_lightMap[i] == lightMap[i])
+            continue;
+
+        int rank = lightMap[i];
+        if (rank != -1)
+        {
+            Light light = m_dynLights[rank].light;
+            light.ambient = Gfx::Color(0.2f, 0.2f, 0.2f);
+            m_device->SetLight(i, light);
+            m_device->SetLightEnabled(i, true);
+        }
+        else
+        {
+            m_device->SetLightEnabled(i, false);
+        }
+    }
+
+    m_lightMap = lightMap;
+    m_deviceLightsValid = true;
+}
+
+void CLightManager::ComputeLightMap(EngineObjectType type, std::vector<int>& lightMap)
+{
+    lightMap.assign(m_lightMap.size(), -1);
+
+    m_sortedLights.resize(m_dynLights.size());
+    for (int i = 0; i < static_cast<int>( m_dynLights.size() ); ++i)
+        m_sortedLights[i] = i;
 
-    std::vector<DynamicLight> sortedLights = m_dynLights;
     LightsComparator lightsComparator(m_engine->GetEyePt(), type);
-    std::sort(sortedLights.begin(), sortedLights.end(), lightsComparator);
+    std::sort(m_sortedLights.begin(), m_sortedLights.end(), [&](int left, int right)
+    {
+        return lightsComparator(m_dynLights[left], m_dynLights[right]);
+    });
 
     int lightMapIndex = 0;
-    for (int i = 0; i < static_cast<int>( sortedLights.size() ); i++)
+    for (int i = 0; i < static_cast<int>( m_sortedLights.size() ); i++)
     {
-        if (! sortedLights[i].used)
+        const DynamicLight& dynLight = m_dynLights[m_sortedLights[i]];
+
+        if (! dynLight.used)
             continue;
-        if (! sortedLights[i].enabled)
+        if (! dynLight.enabled)
             continue;
-        if (sortedLights[i].intensity.current == 0.0f)
+        if (dynLight.intensity.current == 0.0f)
             continue;
 
         bool enabled = true;
-        if (sortedLights[i].includeType != ENG_OBJTYPE_NULL)
-            enabled = (sortedLights[i].includeType == type);
+        if (dynLight.includeType != ENG_OBJTYPE_NULL)
+            enabled = (dynLight.includeType == type);
 
-        if (sortedLights[i].excludeType != ENG_OBJTYPE_NULL)
-            enabled = (sortedLights[i].excludeType != type);
+        if (dynLight.excludeType != ENG_OBJTYPE_NULL)
+            enabled = (dynLight.excludeType != type);
 
         if (enabled)
         {
-            m_lightMap[lightMapIndex] = sortedLights[i].rank;
+            lightMap[lightMapIndex] = dynLight.rank;
             ++lightMapIndex;
         }
 
-        if (lightMapIndex >= static_cast<int>( m_lightMap.size() ))
+        if (lightMapIndex >= static_cast<int>( lightMap.size() ))
             break;
     }
+}
 
-    for (int i = 0; i < static_cast<int>( m_lightMap.size() ); ++i)
-    {
-        int rank = m_lightMap[i];
-        if (rank != -1)
-        {
-            Light light = m_dynLights[rank].light;
-            light.ambient = Gfx::Color(0.2f, 0.2f, 0.2f);
-            m_device->SetLight(i, light);
-            m_device->SetLightEnabled(i, true);
-        }
-        else
-        {
-            m_device->SetLightEnabled(i, false);
-        }
-    }
+void CLightManager::InvalidateLightMaps()
+{
+    m_lightMapCache.clear();
+    m_deviceLightsValid = false;
 }
 
 // -----------
@@ -32,6 +32,9 @@
 
 #include "math/vector.h"
 
+#include <map>
+#include <vector>
+
 
 // Graphics module namespace
 namespace Gfx
@@ -209,8 +212,18 @@ public:
     //! Updates (recalculates) all dynamic lights
     void            UpdateLights();
     //! Enables or disables dynamic lights affecting the given object type
+    /**
+     * Lights chosen for each object type are kept until the lights change or the next
+     * UpdateLights(), and only device lights different from the current ones are set.
+     */
     void            UpdateDeviceLights(EngineObjectType type);
 
+protected:
+    //! Chooses lights for given object type, returning light map as in m_lightMap
+    void            ComputeLightMap(EngineObjectType type, std::vector<int>& lightMap);
+    //! Forgets the lights chosen for object types
+    void            InvalidateLightMaps();
+
 protected:
     class LightsComparator
     {
@@ -236,6 +249,12 @@ protected:
     std::vector<DynamicLight> m_dynLights;
     //! Map of current light allocation: graphics light -> dynamic light
     std::vector<int>  m_lightMap;
+    //! If true, m_lightMap is what is set in the device
+    bool              m_deviceLightsValid;
+    //! Light maps chosen for object types since the lights last changed
+    std::map<EngineObjectType, std::vector<int>> m_lightMapCache;
+    //! Indexes of dynamic lights for sorting
+    std::vector<int>  m_sortedLights;
 };
 
 } // namespace Gfx
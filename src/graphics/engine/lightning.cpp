@@ -313,16 +313,13 @@ void CLightning::Draw()
 
 CObject* CLightning::SearchObject(Math::Vector pos)
 {
-    // Lightning conductors
-    std::vector<CObject*> paraObj;
-    paraObj.reserve(100);
-    std::vector<Math::Vector> paraObjPos;
-    paraObjPos.reserve(100);
+    CObjectManager* objectManager = CObjectManager::GetInstancePointer();
 
     // Seeking the object closest to the point of impact of lightning.
+    // Hit probability is at most 1, so nothing further than m_magnetic can be hit.
     CObject* bestObj = nullptr;
     float min = 100000.0f;
-    for (CObject* obj : CObjectManager::GetInstancePointer()->GetAllObjects())
+    for (CObject* obj : objectManager->GetObjectsInRange(pos, m_magnetic))
     {
         if (!obj->GetDetectable()) continue;  // inactive object?
 
@@ -331,11 +328,7 @@ CObject* CLightning::SearchObject(Math::Vector pos)
         ObjectType type = obj->GetType();
         if ( type == OBJECT_BASE ||
              type == OBJECT_PARA )  // building a lightning effect?
-        {
-            paraObj.push_back(obj);
-            paraObjPos.push_back(obj->GetPosition());
             continue;
-        }
 
         if (!obj->Implements(ObjectInterfaceType::Destroyable)) continue;
 
@@ -357,11 +350,19 @@ CObject* CLightning::SearchObject(Math::Vector pos)
 
     // Under the protection of a lightning conductor?
     Math::Vector oPos = bestObj->GetPosition();
+    std::vector<CObject*> paraObj = objectManager->GetObjectsInRange(oPos, LTNG_PROTECTION_RADIUS);
     for (int i = paraObj.size()-1; i >= 0; i--)
     {
-        float dist = Math::DistanceProjected(oPos, paraObjPos[i]);
+        CObject* obj = paraObj[i];
+        if (!obj->GetDetectable()) continue;
+        if (IsObjectBeingTransported(obj)) continue;
+
+        ObjectType type = obj->GetType();
+        if (type != OBJECT_BASE && type != OBJECT_PARA) continue;
+
+        float dist = Math::DistanceProjected(oPos, obj->GetPosition());
         if (dist <= LTNG_PROTECTION_RADIUS)
-            return paraObj[i];
+            return obj;
     }
 
     return bestObj;
@@ -0,0 +1,295 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+#include "graphics/engine/mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+namespace
+{
+
+static_assert(sizeof(VertexTex2) == 10 * sizeof(float), "VertexTex2 must not have padding to be compared bitwise");
+
+struct VertexHash
+{
+    std::size_t operator()(const VertexTex2& vertex) const
+    {
+        // FNV-1a
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&vertex);
+        uint64_t hash = 14695981039346656037ULL;
+        for (std::size_t i = 0; i < sizeof(VertexTex2); ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return static_cast<std::size_t>(hash);
+    }
+};
+
+struct VertexEqual
+{
+    bool operator()(const VertexTex2& a, const VertexTex2& b) const
+    {
+        return memcmp(&a, &b, sizeof(VertexTex2)) == 0;
+    }
+};
+
+// Parameters of the algorithm as given by Tom Forsyth
+const int   CACHE_SIZE = 32;
+const float CACHE_DECAY_POWER = 1.5f;
+const float LAST_TRIANGLE_SCORE = 0.75f;
+const float VALENCE_BOOST_SCALE = 2.0f;
+const float VALENCE_BOOST_POWER = 0.5f;
+
+float GetVertexScore(int cachePosition, int remainingTriangles)
+{
+    if (remainingTriangles == 0)
+        return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        // The vertices of the last triangle get a fixed score so that
+        // the next triangle does not simply reuse its most recent edge
+        if (cachePosition < 3)
+        {
+            score = LAST_TRIANGLE_SCORE;
+        }
+        else
+        {
+            float scaler = 1.0f / (CACHE_SIZE - 3);
+            score = powf(1.0f - (cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+        }
+    }
+
+    score += VALENCE_BOOST_SCALE * powf(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+
+    return score;
+}
+
+} // anonymous namespace
+
+IndexedMesh WeldVertices(const VertexTex2* vertices, int vertexCount)
+{
+    IndexedMesh mesh;
+    mesh.indices.reserve(vertexCount);
+
+    std::unordered_map<VertexTex2, unsigned int, VertexHash, VertexEqual> uniqueIndices;
+    uniqueIndices.reserve(vertexCount);
+
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        auto result = uniqueIndices.emplace(vertices[i], static_cast<unsigned int>(mesh.vertices.size()));
+        if (result.second)
+            mesh.vertices.push_back(vertices[i]);
+
+        mesh.indices.push_back(result.first->second);
+    }
+
+    return mesh;
+}
+
+void OptimizeVertexCache(std::vector<unsigned int>& indices, int vertexCount)
+{
+    int triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    // Triangles using each vertex, as one array with offsets
+    std::vector<int> triangleOffsets(vertexCount + 1, 0);
+    for (int i = 0; i < triangleCount * 3; ++i)
+        triangleOffsets[indices[i] + 1]++;
+    for (int v = 0; v < vertexCount; ++v)
+        triangleOffsets[v + 1] += triangleOffsets[v];
+
+    std::vector<int> remainingTriangles(vertexCount);
+    for (int v = 0; v < vertexCount; ++v)
+        remainingTriangles[v] = triangleOffsets[v + 1] - triangleOffsets[v];
+
+    std::vector<int> vertexTriangles(triangleCount * 3);
+    {
+        std::vector<int> filled(vertexCount, 0);
+        for (int t = 0; t < triangleCount; ++t)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                unsigned int v = indices[t * 3 + k];
+                vertexTriangles[triangleOffsets[v] + filled[v]++] = t;
+            }
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (int v = 0; v < vertexCount; ++v)
+        vertexScore[v] = GetVertexScore(-1, remainingTriangles[v]);
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> triangleAdded(triangleCount, false);
+    for (int t = 0; t < triangleCount; ++t)
+    {
+        triangleScore[t] = vertexScore[indices[t * 3]] +
+                           vertexScore[indices[t * 3 + 1]] +
+                           vertexScore[indices[t * 3 + 2]];
+    }
+
+    std::vector<unsigned int> result;
+    result.reserve(triangleCount * 3);
+
+    std::vector<int> cache, newCache;
+    cache.reserve(CACHE_SIZE + 3);
+    newCache.reserve(CACHE_SIZE + 3);
+
+    int bestTriangle = -1;
+    int nextUnadded = 0;
+
+    for (int added = 0; added < triangleCount; ++added)
+    {
+        // Without a candidate from the cache, start with any remaining triangle
+        if (bestTriangle < 0)
+        {
+            while (triangleAdded[nextUnadded])
+                ++nextUnadded;
+            bestTriangle = nextUnadded;
+        }
+
+        triangleAdded[bestTriangle] = true;
+
+        newCache.clear();
+        for (int k = 0; k < 3; ++k)
+        {
+            unsigned int v = indices[bestTriangle * 3 + k];
+            result.push_back(v);
+            if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+                newCache.push_back(v);
+
+            // Remove the triangle from the list of the vertex
+            auto begin = vertexTriangles.begin() + triangleOffsets[v];
+            auto end = begin + remainingTriangles[v];
+            std::iter_swap(std::find(begin, end, bestTriangle), end - 1);
+            remainingTriangles[v]--;
+        }
+
+        for (int v : cache)
+        {
+            if (v != static_cast<int>(indices[bestTriangle * 3]) &&
+                v != static_cast<int>(indices[bestTriangle * 3 + 1]) &&
+                v != static_cast<int>(indices[bestTriangle * 3 + 2]))
+            {
+                newCache.push_back(v);
+            }
+        }
+
+        for (int i = 0; i < static_cast<int>(newCache.size()); ++i)
+            cachePosition[newCache[i]] = i < CACHE_SIZE ? i : -1;
+
+        // Rescore the vertices in cache and their triangles, finding the best one
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (int v : newCache)
+        {
+            float newScore = GetVertexScore(cachePosition[v], remainingTriangles[v]);
+            float diff = newScore - vertexScore[v];
+            vertexScore[v] = newScore;
+
+            int begin = triangleOffsets[v];
+            int end = begin + remainingTriangles[v];
+            for (int i = begin; i < end; ++i)
+            {
+                int t = vertexTriangles[i];
+                triangleScore[t] += diff;
+                if (triangleScore[t] > bestScore)
+                {
+                    bestScore = triangleScore[t];
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        if (static_cast<int>(newCache.size()) > CACHE_SIZE)
+            newCache.resize(CACHE_SIZE);
+
+        std::swap(cache, newCache);
+    }
+
+    indices = std::move(result);
+}
+
+void OptimizeVertexFetch(IndexedMesh& mesh)
+{
+    std::vector<int> remap(mesh.vertices.size(), -1);
+    std::vector<VertexTex2> vertices;
+    vertices.reserve(mesh.vertices.size());
+
+    for (unsigned int& index : mesh.indices)
+    {
+        if (remap[index] < 0)
+        {
+            remap[index] = vertices.size();
+            vertices.push_back(mesh.vertices[index]);
+        }
+
+        index = remap[index];
+    }
+
+    mesh.vertices = std::move(vertices);
+}
+
+IndexedMesh BuildIndexedMesh(const VertexTex2* vertices, int vertexCount)
+{
+    IndexedMesh mesh = WeldVertices(vertices, vertexCount);
+    OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+    OptimizeVertexFetch(mesh);
+    return mesh;
+}
+
+float GetAverageCacheMissRatio(const std::vector<unsigned int>& indices, int vertexCount, int cacheSize)
+{
+    int triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return 0.0f;
+
+    // Time at which each vertex entered the FIFO cache
+    std::vector<int> cacheTime(vertexCount, -cacheSize - 1);
+    int time = 0;
+    int misses = 0;
+
+    for (unsigned int index : indices)
+    {
+        if (time - cacheTime[index] > cacheSize)
+        {
+            cacheTime[index] = time++;
+            misses++;
+        }
+    }
+
+    return static_cast<float>(misses) / triangleCount;
+}
+
+} // namespace Gfx
@@ -0,0 +1,87 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+/**
+ * \file graphics/engine/mesh_optimizer.h
+ * \brief Vertex welding and index generation for static buffers
+ */
+
+#pragma once
+
+
+#include "graphics/core/vertex.h"
+
+#include <vector>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \struct IndexedMesh
+ * \brief Triangle list given as unique vertices and indices to them
+ */
+struct IndexedMesh
+{
+    std::vector<VertexTex2>   vertices;
+    std::vector<unsigned int> indices;
+};
+
+/**
+ * \brief Merges bitwise identical vertices of triangle list \a vertices
+ *
+ * The unique vertices are in order of their first occurrence and
+ * the indices give the original triangles in original order.
+ */
+IndexedMesh WeldVertices(const VertexTex2* vertices, int vertexCount);
+
+/**
+ * \brief Reorders triangles given by \a indices for the post-transform vertex cache
+ *
+ * Uses the linear-speed greedy algorithm by Tom Forsyth which picks
+ * the next triangle by scores of its vertices, favouring vertices recently
+ * used and vertices with few remaining triangles.
+ */
+void OptimizeVertexCache(std::vector<unsigned int>& indices, int vertexCount);
+
+/**
+ * \brief Reorders vertices of \a mesh in the order in which indices use them
+ *
+ * This keeps the vertex fetches of consecutive triangles close in memory.
+ */
+void OptimizeVertexFetch(IndexedMesh& mesh);
+
+/**
+ * \brief Returns triangle list \a vertices welded and optimized for drawing
+ *
+ * This is WeldVertices() followed by OptimizeVertexCache() and OptimizeVertexFetch().
+ */
+IndexedMesh BuildIndexedMesh(const VertexTex2* vertices, int vertexCount);
+
+/**
+ * \brief Returns the average number of vertex cache misses per triangle of \a indices
+ *
+ * Simulates a FIFO cache of \a cacheSize vertices; the result is 0.5 for
+ * an ideal regular grid and 3 for triangles not sharing vertices at all.
+ */
+float GetAverageCacheMissRatio(const std::vector<unsigned int>& indices, int vertexCount, int cacheSize = 16);
+
+} // namespace Gfx
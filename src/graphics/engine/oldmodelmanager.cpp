@@ -21,17 +21,22 @@
 
 #include "app/app.h"
 
+#include "common/ioutils.h"
 #include "common/logger.h"
 #include "common/stringutils.h"
 
 #include "common/resources/inputstream.h"
+#include "common/resources/mapped_file.h"
+#include "common/resources/resourcemanager.h"
 
 #include "graphics/engine/engine.h"
 
+#include "graphics/model/model_groups.h"
 #include "graphics/model/model_input.h"
 #include "graphics/model/model_io_exception.h"
 
 #include <cstdio>
+#include <utility>
 
 namespace Gfx
 {
@@ -49,6 +54,9 @@ bool COldModelManager::LoadModel(const std::string& fileName, bool mirrored, int
 {
     GetLogger()->Debug("Loading model '%s'\n", fileName.c_str());
 
+    if (LoadGroupedModel(fileName, mirrored, variant))
+        return true;
+
     CModel model;
     try
     {
@@ -86,6 +94,84 @@ bool COldModelManager::LoadModel(const std::string& fileName, bool mirrored, int
     return true;
 }
 
+bool COldModelManager::LoadGroupedModel(const std::string& fileName, bool mirrored, int variant)
+{
+    std::string modelFileName = "models/" + fileName;
+    std::string groupedFileName = "models/" + fileName.substr(0, fileName.find_last_of('.')) + ".gmod";
+    if (!CResourceManager::Exists(groupedFileName))
+        return false;
+
+    std::string realPath = CResourceManager::GetRealPath(groupedFileName);
+    bool hasModel = CResourceManager::Exists(modelFileName);
+
+    // A model in another directory, e.g. of a mod, overrides the grouped file made from the original one
+    if (hasModel && !realPath.empty())
+    {
+        std::string realModelPath = CResourceManager::GetRealPath(modelFileName);
+        if (!realModelPath.empty() &&
+            realPath.substr(0, realPath.find_last_of('/')) != realModelPath.substr(0, realModelPath.find_last_of('/')))
+            return false;
+    }
+
+    CMappedFile file;
+    CModelGroups groups;
+    try
+    {
+        if (!realPath.empty() && file.Open(realPath))
+        {
+            groups.Read(file.GetData(), file.GetSize());
+        }
+        else
+        {
+            CInputStream stream;
+            stream.open(groupedFileName);
+            if (!stream.is_open())
+                throw CModelIOException(std::string("Could not open file '") + groupedFileName + "'");
+
+            groups.Read(stream);
+        }
+    }
+    catch (const CModelIOException& e)
+    {
+        GetLogger()->Error("Loading grouped model '%s' failed: %s\n", groupedFileName.c_str(), e.what());
+        return false;
+    }
+
+    if (hasModel)
+    {
+        CInputStream stream;
+        stream.open(modelFileName);
+        if (stream.is_open() && IOUtils::HashStream(stream) != groups.GetSourceHash())
+        {
+            GetLogger()->Debug("Grouped model '%s' is out of date, using '%s'\n", groupedFileName.c_str(), modelFileName.c_str());
+            return false;
+        }
+    }
+
+    ModelInfo modelInfo;
+    modelInfo.baseObjRank = m_engine->CreateBaseObject();
+
+    for (const ModelTriangleGroup& group : groups.GetGroups())
+    {
+        const VertexTex2* vertices = groups.GetVertices() + group.firstVertex;
+        std::vector<VertexTex2> groupVertices(vertices, vertices + group.vertexCount);
+
+        if (mirrored)
+            Mirror(groupVertices);
+
+        ModelTriangle attributes = group.attributes;
+        if (variant != 0 && HasVariants(attributes.tex1Name))
+            attributes.tex1Name += StrUtils::ToString<int>(variant);
+
+        m_engine->AddBaseObjTriangleGroup(modelInfo.baseObjRank, attributes, std::move(groupVertices));
+    }
+
+    FileInfo fileInfo(fileName, mirrored, variant);
+    m_models[fileInfo] = modelInfo;
+
+    return true;
+}
+
 bool COldModelManager::AddModelReference(const std::string& fileName, bool mirrored, int objRank, int variant)
 {
     auto it = m_models.find(FileInfo(fileName, mirrored, variant));
@@ -183,23 +269,40 @@ void COldModelManager::Mirror(std::vector<ModelTriangle>& triangles)
     }
 }
 
+void COldModelManager::Mirror(std::vector<VertexTex2>& vertices)
+{
+    for (int i = 0; i + 2 < static_cast<int>( vertices.size() ); i += 3)
+    {
+        std::swap(vertices[i], vertices[i+1]);
+
+        for (int j = i; j < i + 3; j++)
+        {
+            vertices[j].coord.z = -vertices[j].coord.z;
+            vertices[j].normal.z = -vertices[j].normal.z;
+        }
+    }
+}
+
 void COldModelManager::ChangeVariant(std::vector<ModelTriangle>& triangles, int variant)
 {
     for (int i = 0; i < static_cast<int>( triangles.size() ); i++)
     {
-        if (triangles[i].tex1Name == "base1.png"   ||
-            triangles[i].tex1Name == "convert.png" ||
-            triangles[i].tex1Name == "derrick.png" ||
-            triangles[i].tex1Name == "factory.png" ||
-            triangles[i].tex1Name == "lemt.png"    ||
-            triangles[i].tex1Name == "roller.png"  ||
-            triangles[i].tex1Name == "search.png"  ||
-            triangles[i].tex1Name == "drawer.png"  ||
-            triangles[i].tex1Name == "subm.png"     )
-        {
+        if (HasVariants(triangles[i].tex1Name))
             triangles[i].tex1Name += StrUtils::ToString<int>(variant);
-        }
     }
 }
 
+bool COldModelManager::HasVariants(const std::string& tex1Name)
+{
+    return tex1Name == "base1.png"   ||
+           tex1Name == "convert.png" ||
+           tex1Name == "derrick.png" ||
+           tex1Name == "factory.png" ||
+           tex1Name == "lemt.png"    ||
+           tex1Name == "roller.png"  ||
+           tex1Name == "search.png"  ||
+           tex1Name == "drawer.png"  ||
+           tex1Name == "subm.png";
+}
+
 }
@@ -51,6 +51,10 @@ class CModelFile;
  * There is also a possibility of creating a copy of model so it has
  * its own and unique base engine object. This is especially useful
  * for models where the geometry must be altered.
+ *
+ * If there is a grouped model file (ModelFormat::Grouped) with the same name
+ * and extension .gmod next to the model, it is used instead. It is mapped
+ * into memory if possible and its groups go to the engine as they are.
  */
 class COldModelManager
 {
@@ -82,10 +86,17 @@ public:
     void UnloadAllModels();
 
 protected:
+    //! Loads a model from grouped model file; returns false if there is none or it is invalid
+    bool LoadGroupedModel(const std::string& fileName, bool mirrored, int variant);
+
     //! Mirrors the model along the Z axis
     void Mirror(std::vector<ModelTriangle>& triangles);
+    //! Mirrors triangles given as consecutive vertices along the Z axis
+    void Mirror(std::vector<VertexTex2>& vertices);
     //! Changes variant
     void ChangeVariant(std::vector<ModelTriangle>& triangles, int variant);
+    //! Returns whether texture \a tex1Name has variants
+    bool HasVariants(const std::string& tex1Name);
 
 private:
     struct ModelInfo
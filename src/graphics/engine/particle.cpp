@@ -44,7 +44,9 @@
 
 #include "sound/sound.h"
 
+#include <algorithm>
 #include <cstring>
+#include <tuple>
 
 
 // Graphics module namespace
@@ -74,6 +76,7 @@ CParticle::CParticle(CEngine* engine)
     : m_engine(engine)
 {
     std::fill_n(m_frameUpdate, SH_MAX, true);
+    SetPoolSize(MAXPARTICULE);
 }
 
 CParticle::~CParticle()
@@ -87,8 +90,10 @@ void CParticle::SetDevice(CDevice* device)
 
 void CParticle::FlushParticle()
 {
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
-        m_particle[i].used = false;
+    std::fill(m_used.begin(), m_used.end(), false);
+
+    for (int t = 0; t < MAXPARTITYPE; t++)
+        m_liveRanks[t].clear();
 
     for (int i = 0; i < MAXPARTITYPE; i++)
     {
@@ -113,12 +118,16 @@ void CParticle::FlushParticle()
 
 void CParticle::FlushParticle(int sheet)
 {
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
+    for (int t = 0; t < MAXPARTITYPE; t++)
     {
-        if (!m_particle[i].used) continue;
-        if (m_particle[i].sheet != sheet) continue;
+        // DeleteRank() removes the rank from the list
+        for (int j = static_cast<int>(m_liveRanks[t].size()) - 1; j >= 0; j--)
+        {
+            int i = m_liveRanks[t][j];
+            if (m_particle[i].sheet != sheet) continue;
 
-        m_particle[i].used = false;
+            DeleteRank(i);
+        }
     }
 
     for (int i = 0; i < MAXPARTITYPE; i++)
@@ -134,6 +143,55 @@ void CParticle::FlushParticle(int sheet)
     }
 }
 
+void CParticle::SetPoolSize(int size)
+{
+    // The rank must fit in the lower 16 bits of a channel
+    size = std::max(1, std::min(size, 0xffff / MAXPARTITYPE));
+
+    m_poolSize = size;
+
+    int total = m_poolSize*MAXPARTITYPE;
+    std::vector<Particle>(total).swap(m_particle);
+    std::vector<char>(total, false).swap(m_used);
+    std::vector<Math::Vector>(total).swap(m_pos);
+    std::vector<Math::Vector>(total).swap(m_speed);
+    std::vector<float>(total, 0.0f).swap(m_time);
+    std::vector<float>(total, 0.0f).swap(m_duration);
+    std::vector<float>(total, 0.0f).swap(m_moveStep);
+    std::vector<float>(total, 0.0f).swap(m_timeStep);
+    std::vector<int>(total, -1).swap(m_livePos);
+    std::vector<EngineTriangle>(m_poolSize).swap(m_triangle);
+
+    for (int t = 0; t < MAXPARTITYPE; t++)
+    {
+        m_liveRanks[t].clear();
+        m_liveRanks[t].reserve(m_poolSize);
+    }
+    m_frameRanks.reserve(total);
+
+    FlushParticle();
+}
+
+int CParticle::GetPoolSize() const
+{
+    return m_poolSize;
+}
+
+int CParticle::GetParticleCount() const
+{
+    int count = 0;
+    for (int t = 0; t < MAXPARTITYPE; t++)
+        count += m_liveRanks[t].size();
+
+    return count;
+}
+
+
+//! Returns the intensity of a particle rounded to 256 levels, as drawn in the frame buffer
+int IntensityLevel(float intensity)
+{
+    return static_cast<int>(Math::Min(Math::Max(intensity, 0.0f), 1.0f)*255.0f + 0.5f);
+}
 
 //! Returns file name of the effect effectNN.png, with NN = number
 void NameParticle(std::string &name, int num)
@@ -173,135 +231,135 @@ char RandomLetter()
     return chars[rand()%chars.size()];
 }
 
+//! Returns the texture type of a particle created by CreateParticle(), or -1
+int GetParticleTextureType(ParticleType type)
+{
+    switch (type)
+    {
+        case PARTIEXPLOT:
+        case PARTIEXPLOO:
+        case PARTIMOTOR:
+        case PARTIBLITZ:
+        case PARTICRASH:
+        case PARTIVAPOR:
+        case PARTIGAS:
+        case PARTIBASE:
+        case PARTIFIRE:
+        case PARTIFIREZ:
+        case PARTIBLUE:
+        case PARTIROOT:
+        case PARTIRECOVER:
+        case PARTIEJECT:
+        case PARTISCRAPS:
+        case PARTIGUN2:
+        case PARTIGUN3:
+        case PARTIGUN4:
+        case PARTIQUEUE:
+        case PARTIORGANIC1:
+        case PARTIORGANIC2:
+        case PARTIFLAME:
+        case PARTIBUBBLE:
+        case PARTIERROR:
+        case PARTIWARNING:  // same value as PARTIINFO
+        case PARTISPHERE1:
+        case PARTISPHERE2:
+        case PARTISPHERE4:
+        case PARTISPHERE5:
+        case PARTISPHERE6:
+        case PARTIPLOUF0:
+        case PARTITRACK1:
+        case PARTITRACK2:
+        case PARTITRACK3:
+        case PARTITRACK4:
+        case PARTITRACK5:
+        case PARTITRACK6:
+        case PARTITRACK7:
+        case PARTITRACK8:
+        case PARTITRACK9:
+        case PARTITRACK10:
+        case PARTITRACK11:
+        case PARTITRACK12:
+        case PARTILENS1:
+        case PARTILENS2:
+        case PARTILENS3:
+        case PARTILENS4:
+        case PARTIGFLAT:
+        case PARTIDROP:
+        case PARTIWATER:
+        case PARTILIMIT1:
+        case PARTILIMIT2:
+        case PARTILIMIT3:
+        case PARTIEXPLOG1:
+        case PARTIEXPLOG2:
+            return 1;  // effect00
+
+        case PARTIGLINT:
+        case PARTIGLINTb:
+        case PARTIGLINTr:
+        case PARTITOTO:
+        case PARTISELY:
+        case PARTISELR:
+        case PARTIQUARTZ:
+        case PARTIGUNDEL:
+        case PARTICONTROL:
+        case PARTISHOW:
+        case PARTICHOC:
+        case PARTIFOG4:
+        case PARTIFOG5:
+        case PARTIFOG6:
+        case PARTIFOG7:
+            return 2;  // effect01
+
+        case PARTIGUN1:
+        case PARTIFLIC:
+        case PARTISPHERE0:
+        case PARTISPHERE3:
+        case PARTIFOG0:
+        case PARTIFOG1:
+        case PARTIFOG2:
+        case PARTIFOG3:
+            return 3;  // effect02
+
+        case PARTISMOKE1:
+        case PARTISMOKE2:
+        case PARTISMOKE3:
+        case PARTIBLOOD:
+        case PARTIBLOODM:
+            return 4;  // effect03 (ENG_RSTATE_TTEXTURE_WHITE)
+
+        case PARTIVIRUS:
+            return 5;  // text render
+
+        default:
+            return -1;
+    }
+}
+
 /** Returns the channel of the particle created or -1 on error. */
 int CParticle::CreateParticle(Math::Vector pos, Math::Vector speed, Math::Point dim,
                               ParticleType type,
                               float duration, float mass,
                               float windSensitivity, int sheet)
 {
-    if (m_main == nullptr)
-        m_main = CRobotMain::GetInstancePointer();
-
-    int t = -1;
-    if ( type == PARTIEXPLOT   ||
-         type == PARTIEXPLOO   ||
-         type == PARTIMOTOR    ||
-         type == PARTIBLITZ    ||
-         type == PARTICRASH    ||
-         type == PARTIVAPOR    ||
-         type == PARTIGAS      ||
-         type == PARTIBASE     ||
-         type == PARTIFIRE     ||
-         type == PARTIFIREZ    ||
-         type == PARTIBLUE     ||
-         type == PARTIROOT     ||
-         type == PARTIRECOVER  ||
-         type == PARTIEJECT    ||
-         type == PARTISCRAPS   ||
-         type == PARTIGUN2     ||
-         type == PARTIGUN3     ||
-         type == PARTIGUN4     ||
-         type == PARTIQUEUE    ||
-         type == PARTIORGANIC1 ||
-         type == PARTIORGANIC2 ||
-         type == PARTIFLAME    ||
-         type == PARTIBUBBLE   ||
-         type == PARTIERROR    ||
-         type == PARTIWARNING  ||
-         type == PARTIINFO     ||
-         type == PARTISPHERE1  ||
-         type == PARTISPHERE2  ||
-         type == PARTISPHERE4  ||
-         type == PARTISPHERE5  ||
-         type == PARTISPHERE6  ||
-         type == PARTIPLOUF0   ||
-         type == PARTITRACK1   ||
-         type == PARTITRACK2   ||
-         type == PARTITRACK3   ||
-         type == PARTITRACK4   ||
-         type == PARTITRACK5   ||
-         type == PARTITRACK6   ||
-         type == PARTITRACK7   ||
-         type == PARTITRACK8   ||
-         type == PARTITRACK9   ||
-         type == PARTITRACK10  ||
-         type == PARTITRACK11  ||
-         type == PARTITRACK12  ||
-         type == PARTILENS1    ||
-         type == PARTILENS2    ||
-         type == PARTILENS3    ||
-         type == PARTILENS4    ||
-         type == PARTIGFLAT    ||
-         type == PARTIDROP     ||
-         type == PARTIWATER    ||
-         type == PARTILIMIT1   ||
-         type == PARTILIMIT2   ||
-         type == PARTILIMIT3   ||
-         type == PARTIEXPLOG1  ||
-         type == PARTIEXPLOG2  )
-    {
-        t = 1;  // effect00
-    }
-    if ( type == PARTIGLINT   ||
-         type == PARTIGLINTb  ||
-         type == PARTIGLINTr  ||
-         type == PARTITOTO    ||
-         type == PARTISELY    ||
-         type == PARTISELR    ||
-         type == PARTIQUARTZ  ||
-         type == PARTIGUNDEL  ||
-         type == PARTICONTROL ||
-         type == PARTISHOW    ||
-         type == PARTICHOC    ||
-         type == PARTIFOG4    ||
-         type == PARTIFOG5    ||
-         type == PARTIFOG6    ||
-         type == PARTIFOG7    )
-    {
-        t = 2;  // effect01
-    }
-    if ( type == PARTIGUN1    ||
-         type == PARTIFLIC    ||
-         type == PARTISPHERE0 ||
-         type == PARTISPHERE3 ||
-         type == PARTIFOG0    ||
-         type == PARTIFOG1    ||
-         type == PARTIFOG2    ||
-         type == PARTIFOG3    )
-    {
-        t = 3;  // effect02
-    }
-    if ( type == PARTISMOKE1  ||
-         type == PARTISMOKE2  ||
-         type == PARTISMOKE3  ||
-         type == PARTIBLOOD   ||
-         type == PARTIBLOODM  )
-    {
-        t = 4;  // effect03 (ENG_RSTATE_TTEXTURE_WHITE)
-    }
-    if ( type == PARTIVIRUS )
-    {
-        t = 5; // text render
-    }
+    int t = GetParticleTextureType(type);
     if (t >= MAXPARTITYPE) return -1;
     if (t == -1) return -1;
 
-    for (int j = 0; j < MAXPARTICULE; j++)
+    for (int j = 0; j < m_poolSize; j++)
     {
-        int i = MAXPARTICULE*t+j;
+        int i = m_poolSize*t+j;
 
-        if (! m_particle[i].used)
+        if (! m_used[i])
         {
-            m_particle[i] = Particle();
-            m_particle[i].used      = true;
+            InitRank(i);
             m_particle[i].ray       = false;
             m_particle[i].uniqueStamp = m_uniqueStamp++;
             m_particle[i].sheet     = sheet;
             m_particle[i].mass      = mass;
-            m_particle[i].duration  = duration;
-            m_particle[i].pos       = pos;
+            m_duration[i]  = duration;
+            m_pos[i]       = pos;
             m_particle[i].goal      = pos;
-            m_particle[i].speed     = speed;
+            m_speed[i]     = speed;
             m_particle[i].windSensitivity = windSensitivity;
             m_particle[i].dim       = dim;
             m_particle[i].zoom      = 1.0f;
@@ -313,7 +371,7 @@ int CParticle::CreateParticle(Math::Vector pos, Math::Vector speed, Math::Point
             m_particle[i].texSup.y  = 0.0f;
             m_particle[i].texInf.x  = 0.0f;
             m_particle[i].texInf.y  = 0.0f;
-            m_particle[i].time      = 0.0f;
+            m_time[i]      = 0.0f;
             m_particle[i].phaseTime = 0.0f;
             m_particle[i].testTime  = 0.0f;
             m_particle[i].objLink   = nullptr;
@@ -361,22 +419,21 @@ int CParticle::CreateFrag(Math::Vector pos, Math::Vector speed,
                           float windSensitivity, int sheet)
 {
     int t = 0;
-    for (int j = 0; j < MAXPARTICULE; j++)
+    for (int j = 0; j < m_poolSize; j++)
     {
-        int i = MAXPARTICULE*t+j;
+        int i = m_poolSize*t+j;
 
-        if (!m_particle[i].used)
+        if (!m_used[i])
         {
-            m_particle[i] = Particle();
-            m_particle[i].used      = true;
+            InitRank(i);
             m_particle[i].ray       = false;
             m_particle[i].uniqueStamp = m_uniqueStamp++;
             m_particle[i].sheet     = sheet;
             m_particle[i].mass      = mass;
-            m_particle[i].duration  = duration;
-            m_particle[i].pos       = pos;
+            m_duration[i]  = duration;
+            m_pos[i]       = pos;
             m_particle[i].goal      = pos;
-            m_particle[i].speed     = speed;
+            m_speed[i]     = speed;
             m_particle[i].windSensitivity = windSensitivity;
             m_particle[i].zoom      = 1.0f;
             m_particle[i].angle     = 0.0f;
@@ -387,7 +444,7 @@ int CParticle::CreateFrag(Math::Vector pos, Math::Vector speed,
             m_particle[i].texSup.y  = 0.0f;
             m_particle[i].texInf.x  = 0.0f;
             m_particle[i].texInf.y  = 0.0f;
-            m_particle[i].time      = 0.0f;
+            m_time[i]      = 0.0f;
             m_particle[i].phaseTime = 0.0f;
             m_particle[i].testTime  = 0.0f;
             m_particle[i].objLink   = nullptr;
@@ -465,23 +522,22 @@ int CParticle::CreatePart(Math::Vector pos, Math::Vector speed,
                           float windSensitivity, int sheet)
 {
     int t = 0;
-    for (int j = 0; j < MAXPARTICULE; j++)
+    for (int j = 0; j < m_poolSize; j++)
     {
-        int i = MAXPARTICULE*t+j;
+        int i = m_poolSize*t+j;
 
-        if (!m_particle[i].used)
+        if (!m_used[i])
         {
-            m_particle[i] = Particle();
-            m_particle[i].used      = true;
+            InitRank(i);
             m_particle[i].ray       = false;
             m_particle[i].uniqueStamp = m_uniqueStamp++;
             m_particle[i].sheet     = sheet;
             m_particle[i].mass      = mass;
             m_particle[i].weight    = weight;
-            m_particle[i].duration  = duration;
-            m_particle[i].pos       = pos;
+            m_duration[i]  = duration;
+            m_pos[i]       = pos;
             m_particle[i].goal      = pos;
-            m_particle[i].speed     = speed;
+            m_speed[i]     = speed;
             m_particle[i].windSensitivity = windSensitivity;
             m_particle[i].zoom      = 1.0f;
             m_particle[i].angle     = 0.0f;
@@ -492,7 +548,7 @@ int CParticle::CreatePart(Math::Vector pos, Math::Vector speed,
             m_particle[i].texSup.y  = 0.0f;
             m_particle[i].texInf.x  = 0.0f;
             m_particle[i].texInf.y  = 0.0f;
-            m_particle[i].time      = 0.0f;
+            m_time[i]      = 0.0f;
             m_particle[i].phaseTime = 0.0f;
             m_particle[i].testTime  = 0.0f;
             m_particle[i].trackRank = -1;
@@ -521,22 +577,21 @@ int CParticle::CreateRay(Math::Vector pos, Math::Vector goal,
     if (t >= MAXPARTITYPE) return -1;
     if (t == -1) return -1;
 
-    for (int j = 0; j < MAXPARTICULE; j++)
+    for (int j = 0; j < m_poolSize; j++)
     {
-        int i = MAXPARTICULE*t+j;
+        int i = m_poolSize*t+j;
 
-        if (!m_particle[i].used)
+        if (!m_used[i])
         {
-            m_particle[i] = Particle();
-            m_particle[i].used      = true;
+            InitRank(i);
             m_particle[i].ray       = true;
             m_particle[i].uniqueStamp = m_uniqueStamp++;
             m_particle[i].sheet     = sheet;
             m_particle[i].mass      = 0.0f;
-            m_particle[i].duration  = duration;
-            m_particle[i].pos       = pos;
+            m_duration[i]  = duration;
+            m_pos[i]       = pos;
             m_particle[i].goal      = goal;
-            m_particle[i].speed     = Math::Vector(0.0f, 0.0f, 0.0f);
+            m_speed[i]     = Math::Vector(0.0f, 0.0f, 0.0f);
             m_particle[i].windSensitivity = 0.0f;
             m_particle[i].dim       = dim;
             m_particle[i].zoom      = 1.0f;
@@ -548,7 +603,7 @@ int CParticle::CreateRay(Math::Vector pos, Math::Vector goal,
             m_particle[i].texSup.y  = 0.0f;
             m_particle[i].texInf.x  = 0.0f;
             m_particle[i].texInf.y  = 0.0f;
-            m_particle[i].time      = 0.0f;
+            m_time[i]      = 0.0f;
             m_particle[i].phaseTime = 0.0f;
             m_particle[i].testTime  = 0.0f;
             m_particle[i].objLink   = nullptr;
@@ -611,6 +666,9 @@ void CParticle::CreateWheelTrace(const Math::Vector &p1, const Math::Vector &p2,
     m_wheelTrace[i].pos[2] = p3;  // ur
     m_wheelTrace[i].pos[3] = p4;  // dr
 
+    if (m_main == nullptr)
+        m_main = CRobotMain::GetInstancePointer();
+
     if (m_terrain == nullptr)
         m_terrain = m_main->GetTerrain();
 
@@ -641,9 +699,9 @@ bool CParticle::CheckChannel(int &channel)
     channel &= 0xffff;
 
     if (channel < 0)  return false;
-    if (channel >= MAXPARTICULE*MAXPARTITYPE) return false;
+    if (channel >= m_poolSize*MAXPARTITYPE) return false;
 
-    if (!m_particle[channel].used)
+    if (!m_used[channel])
     {
         GetLogger()->Error("CheckChannel used=false !\n");
         return false;
@@ -658,26 +716,54 @@ bool CParticle::CheckChannel(int &channel)
     return true;
 }
 
+void CParticle::InitRank(int rank)
+{
+    m_particle[rank] = Particle();
+    m_used[rank]     = true;
+    m_pos[rank]      = Math::Vector(0.0f, 0.0f, 0.0f);
+    m_speed[rank]    = Math::Vector(0.0f, 0.0f, 0.0f);
+    m_time[rank]     = 0.0f;
+    m_duration[rank] = 0.0f;
+    m_moveStep[rank] = 0.0f;  // not updated before the next frame
+    m_timeStep[rank] = 0.0f;
+
+    std::vector<int>& live = m_liveRanks[rank/m_poolSize];
+    m_livePos[rank] = live.size();
+    live.push_back(rank);
+}
+
 void CParticle::DeleteRank(int rank)
 {
-    if (m_totalInterface[rank/MAXPARTICULE][m_particle[rank].sheet] > 0)
-        m_totalInterface[rank/MAXPARTICULE][m_particle[rank].sheet]--;
+    if (m_totalInterface[rank/m_poolSize][m_particle[rank].sheet] > 0)
+        m_totalInterface[rank/m_poolSize][m_particle[rank].sheet]--;
 
     int i = m_particle[rank].trackRank;
     if (i != -1)  // drag associated?
         m_track[i].used = false;  // frees the drag
 
-    m_particle[rank].used = false;
+    m_used[rank] = false;
+    m_timeStep[rank] = 0.0f;
+
+    // Moves the last live rank in place of the deleted one
+    std::vector<int>& live = m_liveRanks[rank/m_poolSize];
+    int last = live.back();
+    live[m_livePos[rank]] = last;
+    m_livePos[last] = m_livePos[rank];
+    live.pop_back();
+    m_livePos[rank] = -1;
 }
 
 void CParticle::DeleteParticle(ParticleType type)
 {
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
+    for (int t = 0; t < MAXPARTITYPE; t++)
     {
-        if (!m_particle[i].used) continue;
-        if (m_particle[i].type != type) continue;
+        for (int j = static_cast<int>(m_liveRanks[t].size()) - 1; j >= 0; j--)
+        {
+            int i = m_liveRanks[t][j];
+            if (m_particle[i].type != type) continue;
 
-        DeleteRank(i);
+            DeleteRank(i);
+        }
     }
 }
 
@@ -685,14 +771,7 @@ void CParticle::DeleteParticle(int channel)
 {
     if (!CheckChannel(channel)) return;
 
-    if (m_totalInterface[channel/MAXPARTICULE][m_particle[channel].sheet] > 0 )
-        m_totalInterface[channel/MAXPARTICULE][m_particle[channel].sheet]--;
-
-    int i = m_particle[channel].trackRank;
-    if (i != -1)  // drag associated?
-        m_track[i].used = false;  // frees the drag
-
-    m_particle[channel].used = false;
+    DeleteRank(channel);
 }
 
 void CParticle::SetObjectLink(int channel, CObject *object)
@@ -710,7 +789,7 @@ void CParticle::SetObjectFather(int channel, CObject *object)
 void CParticle::SetPosition(int channel, Math::Vector pos)
 {
     if (!CheckChannel(channel))  return;
-    m_particle[channel].pos = pos;
+    m_pos[channel] = pos;
 }
 
 void CParticle::SetDimension(int channel, Math::Point dim)
@@ -741,7 +820,7 @@ void CParticle::SetParam(int channel, Math::Vector pos, Math::Point dim, float z
                           float angle, float intensity)
 {
     if (!CheckChannel(channel))  return;
-    m_particle[channel].pos       = pos;
+    m_pos[channel]       = pos;
     m_particle[channel].dim       = dim;
     m_particle[channel].zoom      = zoom;
     m_particle[channel].angle     = angle;
@@ -752,14 +831,14 @@ void CParticle::SetPhase(int channel, ParticlePhase phase, float duration)
 {
     if (!CheckChannel(channel))  return;
     m_particle[channel].phase = phase;
-    m_particle[channel].duration = duration;
-    m_particle[channel].phaseTime = m_particle[channel].time;
+    m_duration[channel] = duration;
+    m_particle[channel].phaseTime = m_time[channel];
 }
 
 bool CParticle::GetPosition(int channel, Math::Vector &pos)
 {
     if (!CheckChannel(channel))  return false;
-    pos = m_particle[channel].pos;
+    pos = m_pos[channel];
     return true;
 }
 
@@ -793,41 +872,63 @@ void CParticle::FrameParticle(float rTime)
     Math::Point ts, ti;
     Math::Vector pos;
 
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
-    {
-        if (!m_particle[i].used) continue;
-        if (!m_frameUpdate[m_particle[i].sheet]) continue;
+    // Selects the particles updated in this frame; the steps of all others are 0
+    m_frameRanks.clear();
 
-        if (m_particle[i].type != PARTISHOW)
+    for (int t = 0; t < MAXPARTITYPE; t++)
+    {
+        for (int i : m_liveRanks[t])
         {
-            if (pause && m_particle[i].sheet != SH_INTERFACE) continue;
+            if (!m_frameUpdate[m_particle[i].sheet]) continue;
+
+            if (m_particle[i].type != PARTISHOW)
+            {
+                if (pause && m_particle[i].sheet != SH_INTERFACE) continue;
+            }
+
+            if (m_particle[i].type != PARTIQUARTZ)
+                m_moveStep[i] = rTime;
+
+            m_timeStep[i] = rTime;
+            m_frameRanks.push_back(i);
         }
+    }
 
-        if (m_particle[i].type != PARTIQUARTZ)
-            m_particle[i].pos += m_particle[i].speed*rTime;
+    // Moves the particles at once, so that the work depends only on the number of live particles
+    for (int i : m_frameRanks)
+    {
+        m_pos[i].x += m_speed[i].x*m_moveStep[i];
+        m_pos[i].y += m_speed[i].y*m_moveStep[i];
+        m_pos[i].z += m_speed[i].z*m_moveStep[i];
+    }
+
+    for (int i : m_frameRanks)
+    {
+        // May have been removed by the update of another particle
+        if (!m_used[i]) continue;
 
         if (m_particle[i].sheet == SH_WORLD)
         {
             float h = rTime*m_particle[i].windSensitivity*Math::Rand()*2.0f;
-            m_particle[i].pos += wind*h;
+            m_pos[i] += wind*h;
         }
 
-        float progress = (m_particle[i].time-m_particle[i].phaseTime)/m_particle[i].duration;
+        float progress = (m_time[i]-m_particle[i].phaseTime)/m_duration[i];
 
         // Manages the particles with mass that bounce.
         if ( m_particle[i].mass != 0.0f        &&
              m_particle[i].type != PARTIQUARTZ )
         {
-            m_particle[i].speed.y -= m_particle[i].mass*rTime;
+            m_speed[i].y -= m_particle[i].mass*rTime;
 
             float h;
             if (m_particle[i].sheet == SH_INTERFACE)
                 h = 0.0f;
             else
-                h = m_terrain->GetFloorLevel(m_particle[i].pos, true);
+                h = m_terrain->GetFloorLevel(m_pos[i], true);
 
             h += m_particle[i].dim.y*0.75f;
-            if (m_particle[i].pos.y < h)  // impact with the ground?
+            if (m_pos[i].y < h)  // impact with the ground?
             {
                 if ( m_particle[i].type == PARTIPART &&
                      m_particle[i].weight > 3.0f &&  // heavy enough?
@@ -838,22 +939,22 @@ void CParticle::FrameParticle(float rTime)
                     if (amplitude > 1.0f)  amplitude = 1.0f;
                     if (amplitude > 0.0f)
                     {
-                        Play(SOUND_BOUM, m_particle[i].pos, amplitude);
+                        Play(SOUND_BOUM, m_pos[i], amplitude);
                     }
                 }
 
                 if (m_particle[i].bounce < 3)
                 {
-                    m_particle[i].pos.y = h;
-                    m_particle[i].speed.y *= -0.4f;
-                    m_particle[i].speed.x *=  0.4f;
-                    m_particle[i].speed.z *=  0.4f;
+                    m_pos[i].y = h;
+                    m_speed[i].y *= -0.4f;
+                    m_speed[i].x *=  0.4f;
+                    m_speed[i].z *=  0.4f;
                     m_particle[i].bounce ++;  // more impact
                 }
                 else    // disappears after 3 bounces?
                 {
-                    if ( m_particle[i].pos.y < h-10.0f ||
-                         m_particle[i].time >= 20.0f   )
+                    if ( m_pos[i].y < h-10.0f ||
+                         m_time[i] >= 20.0f   )
                     {
                         DeleteRank(i);
                         continue;
@@ -866,7 +967,7 @@ void CParticle::FrameParticle(float rTime)
         int r = m_particle[i].trackRank;
         if (r != -1)  // drag exists?
         {
-            if (TrackMove(r, m_particle[i].pos, progress))
+            if (TrackMove(r, m_pos[i], progress))
             {
                 DeleteRank(i);
                 continue;
@@ -877,7 +978,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK1)  // explosion technique?
         {
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_particle[i].zoom = 1.0f-(m_time[i]-m_duration[i]);
 
             ts.x = 0.375f;
             ts.y = 0.000f;
@@ -887,7 +988,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK2)  // spray blue?
         {
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_particle[i].zoom = 1.0f-(m_time[i]-m_duration[i]);
 
             ts.x = 0.500f;
             ts.y = 0.000f;
@@ -897,7 +998,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK3)  // spider?
         {
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_particle[i].zoom = 1.0f-(m_time[i]-m_duration[i]);
 
             ts.x = 0.500f;
             ts.y = 0.750f;
@@ -907,7 +1008,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK4)  // insect explosion?
         {
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_particle[i].zoom = 1.0f-(m_time[i]-m_duration[i]);
 
             ts.x = 0.625f;
             ts.y = 0.000f;
@@ -917,7 +1018,7 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK5)  // derrick?
         {
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_particle[i].zoom = 1.0f-(m_time[i]-m_duration[i]);
 
             ts.x = 0.750f;
             ts.y = 0.000f;
@@ -938,7 +1039,7 @@ void CParticle::FrameParticle(float rTime)
              m_particle[i].type == PARTITRACK9  ||  // win-3 ?
              m_particle[i].type == PARTITRACK10 )   // win-4 ?
         {
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_particle[i].zoom = 1.0f-(m_time[i]-m_duration[i]);
 
             ts.x = 0.25f*(m_particle[i].type-PARTITRACK7);
             ts.y = 0.25f;
@@ -948,15 +1049,15 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK11)  // phazer shot?
         {
-            CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-            m_particle[i].goal = m_particle[i].pos;
+            CObject* object = SearchObjectGun(m_particle[i].goal, m_pos[i], m_particle[i].type, m_particle[i].objFather);
+            m_particle[i].goal = m_pos[i];
             if (object != nullptr)
             {
                 assert(object->Implements(ObjectInterfaceType::Damageable));
                 dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Phazer, 0.002f);
             }
 
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_particle[i].zoom = 1.0f-(m_time[i]-m_duration[i]);
 
             ts.x = 0.375f;
             ts.y = 0.000f;
@@ -1109,7 +1210,7 @@ void CParticle::FrameParticle(float rTime)
             {
                 m_particle[i].testTime = 0.0f;
 
-                if (m_terrain->GetHeightToFloor(m_particle[i].pos, true) < -2.0f)
+                if (m_terrain->GetHeightToFloor(m_pos[i], true) < -2.0f)
                 {
                     m_exploGunCounter++;
 
@@ -1150,8 +1251,8 @@ void CParticle::FrameParticle(float rTime)
                     continue;
                 }
 
-                CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-                m_particle[i].goal = m_particle[i].pos;
+                CObject* object = SearchObjectGun(m_particle[i].goal, m_pos[i], m_particle[i].type, m_particle[i].objFather);
+                m_particle[i].goal = m_pos[i];
                 if (object != nullptr)
                 {
                     assert(object->Implements(ObjectInterfaceType::Damageable));
@@ -1161,7 +1262,7 @@ void CParticle::FrameParticle(float rTime)
 
                     if (m_exploGunCounter % 2 == 0)
                     {
-                        pos = m_particle[i].pos;
+                        pos = m_pos[i];
                         Math::Vector speed;
                         speed.x = 0.0f;
                         speed.z = 0.0f;
@@ -1216,17 +1317,17 @@ void CParticle::FrameParticle(float rTime)
             if (m_particle[i].testTime >= 0.2f)
             {
                 m_particle[i].testTime = 0.0f;
-                CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-                m_particle[i].goal = m_particle[i].pos;
+                CObject* object = SearchObjectGun(m_particle[i].goal, m_pos[i], m_particle[i].type, m_particle[i].objFather);
+                m_particle[i].goal = m_pos[i];
                 if (object != nullptr)
                 {
                     if (object->GetType() == OBJECT_MOBILErs && dynamic_cast<CShielder*>(object)->GetActiveShieldRadius() > 0.0f)  // protected by shield?
                     {
-                        CreateParticle(m_particle[i].pos, Math::Vector(0.0f, 0.0f, 0.0f), Math::Point(6.0f, 6.0f), PARTIGUNDEL, 2.0f);
+                        CreateParticle(m_pos[i], Math::Vector(0.0f, 0.0f, 0.0f), Math::Point(6.0f, 6.0f), PARTIGUNDEL, 2.0f);
                         if (m_lastTimeGunDel > 0.2f)
                         {
                             m_lastTimeGunDel = 0.0f;
-                            Play(SOUND_GUNDEL, m_particle[i].pos, 1.0f);
+                            Play(SOUND_GUNDEL, m_pos[i], 1.0f);
                         }
                         DeleteRank(i);
                         continue;
@@ -1234,7 +1335,7 @@ void CParticle::FrameParticle(float rTime)
                     else
                     {
                         if (object->GetType() != OBJECT_HUMAN)
-                            Play(SOUND_TOUCH, m_particle[i].pos, 1.0f);
+                            Play(SOUND_TOUCH, m_pos[i], 1.0f);
 
                         assert(object->Implements(ObjectInterfaceType::Damageable));
                         dynamic_cast<CDamageableObject*>(object)->DamageObject(DamageType::Organic, 0.2f);  // starts explosion
@@ -1262,17 +1363,17 @@ void CParticle::FrameParticle(float rTime)
             if (m_particle[i].testTime >= 0.2f)
             {
                 m_particle[i].testTime = 0.0f;
-                CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-                m_particle[i].goal = m_particle[i].pos;
+                CObject* object = SearchObjectGun(m_particle[i].goal, m_pos[i], m_particle[i].type, m_particle[i].objFather);
+                m_particle[i].goal = m_pos[i];
                 if (object != nullptr)
                 {
                     if (object->GetType() == OBJECT_MOBILErs && dynamic_cast<CShielder*>(object)->GetActiveShieldRadius() > 0.0f)
                     {
-                        CreateParticle(m_particle[i].pos, Math::Vector(0.0f, 0.0f, 0.0f), Math::Point(6.0f, 6.0f), PARTIGUNDEL, 2.0f);
+                        CreateParticle(m_pos[i], Math::Vector(0.0f, 0.0f, 0.0f), Math::Point(6.0f, 6.0f), PARTIGUNDEL, 2.0f);
                         if (m_lastTimeGunDel > 0.2f)
                         {
                             m_lastTimeGunDel = 0.0f;
-                            Play(SOUND_GUNDEL, m_particle[i].pos, 1.0f);
+                            Play(SOUND_GUNDEL, m_pos[i], 1.0f);
                         }
                         DeleteRank(i);
                         continue;
@@ -1303,7 +1404,7 @@ void CParticle::FrameParticle(float rTime)
             {
                 m_particle[i].testTime = 0.0f;
 
-                if (m_terrain->GetHeightToFloor(m_particle[i].pos, true) < -2.0f)
+                if (m_terrain->GetHeightToFloor(m_pos[i], true) < -2.0f)
                 {
                     m_exploGunCounter ++;
 
@@ -1332,8 +1433,8 @@ void CParticle::FrameParticle(float rTime)
                     continue;
                 }
 
-                CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-                m_particle[i].goal = m_particle[i].pos;
+                CObject* object = SearchObjectGun(m_particle[i].goal, m_pos[i], m_particle[i].type, m_particle[i].objFather);
+                m_particle[i].goal = m_pos[i];
                 if (object != nullptr)
                 {
                     assert(object->Implements(ObjectInterfaceType::Damageable));
@@ -1343,7 +1444,7 @@ void CParticle::FrameParticle(float rTime)
 
                     if (m_exploGunCounter % 2 == 0)
                     {
-                        pos = m_particle[i].pos;
+                        pos = m_pos[i];
                         Math::Vector speed;
                         speed.x = 0.0f;
                         speed.z = 0.0f;
@@ -1592,15 +1693,15 @@ void CParticle::FrameParticle(float rTime)
         {
             float h = 10.0f;
 
-            if ( m_particle[i].pos.y >= eye.y   &&
-                 m_particle[i].pos.y <  eye.y+h )
+            if ( m_pos[i].y >= eye.y   &&
+                 m_pos[i].y <  eye.y+h )
             {
-                m_particle[i].intensity *= (m_particle[i].pos.y-eye.y)/h;
+                m_particle[i].intensity *= (m_pos[i].y-eye.y)/h;
             }
-            if ( m_particle[i].pos.y >  eye.y-h &&
-                 m_particle[i].pos.y <  eye.y   )
+            if ( m_pos[i].y >  eye.y-h &&
+                 m_pos[i].y <  eye.y   )
             {
-                m_particle[i].intensity *= (eye.y-m_particle[i].pos.y)/h;
+                m_particle[i].intensity *= (eye.y-m_pos[i].y)/h;
             }
         }
 
@@ -1681,7 +1782,7 @@ void CParticle::FrameParticle(float rTime)
         if (m_particle[i].type == PARTIBUBBLE)
         {
             if ( progress >= 1.0f ||
-                 m_particle[i].pos.y >= m_water->GetLevel() )
+                 m_pos[i].y >= m_water->GetLevel() )
             {
                 DeleteRank(i);
                 continue;
@@ -1888,7 +1989,7 @@ void CParticle::FrameParticle(float rTime)
             {
                 m_particle[i].testTime = 0.0f;
 
-                pos = m_particle[i].pos;
+                pos = m_pos[i];
                 Math::Vector speed = Math::Vector(0.0f, 0.0f, 0.0f);
                 Math::Point dim;
                 dim.x = 1.0f*(Math::Rand()*0.8f+0.6f);
@@ -1908,11 +2009,11 @@ void CParticle::FrameParticle(float rTime)
             {
                 DeleteRank(i);
 
-                pos = m_particle[i].pos;
+                pos = m_pos[i];
                 Math::Point dim;
                 dim.x    = m_particle[i].dim.x/4.0f;
                 dim.y    = dim.x;
-                float duration = m_particle[i].duration;
+                float duration = m_duration[i];
                 float mass     = m_particle[i].mass;
                 int total = static_cast<int>((10.0f*m_engine->GetParticleDensity()));
                 for (int j = 0; j < total; j++)
@@ -1936,7 +2037,7 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = (m_particle[i].time-m_particle[i].duration);
+            m_particle[i].zoom = (m_time[i]-m_duration[i]);
 
             ts.x = 0.125f;
             ts.y = 0.875f;
@@ -1952,7 +2053,7 @@ void CParticle::FrameParticle(float rTime)
                 continue;
             }
 
-            m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration);
+            m_particle[i].zoom = 1.0f-(m_time[i]-m_duration[i]);
 
             ts.x = 0.125f;
             ts.y = 0.875f;
@@ -1971,7 +2072,7 @@ void CParticle::FrameParticle(float rTime)
             if (progress > 0.5f)
                 m_particle[i].zoom = 1.0f-(progress-0.5f)*2.0f;
 
-            m_particle[i].angle = m_particle[i].time*Math::PI;
+            m_particle[i].angle = m_time[i]*Math::PI;
 
             ts.x = 0.75f;
             ts.y = 0.25f;
@@ -1990,7 +2091,7 @@ void CParticle::FrameParticle(float rTime)
             if (progress > 0.5f)
                 m_particle[i].zoom = 1.0f-(progress-0.5f)*2.0f;
 
-            m_particle[i].angle = m_particle[i].time*Math::PI;
+            m_particle[i].angle = m_time[i]*Math::PI;
 
             ts.x = 0.75f;
             ts.y = 0.50f;
@@ -2009,7 +2110,7 @@ void CParticle::FrameParticle(float rTime)
             if (progress > 0.5f)
                 m_particle[i].zoom = 1.0f-(progress-0.5f)*2.0f;
 
-            m_particle[i].angle = m_particle[i].time*Math::PI;
+            m_particle[i].angle = m_time[i]*Math::PI;
 
             ts.x = 0.75f;
             ts.y = 0.00f;
@@ -2070,9 +2171,9 @@ void CParticle::FrameParticle(float rTime)
             }
 
             if (progress > 0.5f)
-                m_particle[i].zoom = 1.0f-(m_particle[i].time-m_particle[i].duration/2.0f);
+                m_particle[i].zoom = 1.0f-(m_time[i]-m_duration[i]/2.0f);
 
-            m_particle[i].angle = m_particle[i].time*Math::PI;
+            m_particle[i].angle = m_time[i]*Math::PI;
 
             ts.x = 0.75f;
             ts.y = 0.50f;
@@ -2084,11 +2185,11 @@ void CParticle::FrameParticle(float rTime)
         {
             if (progress >= 1.0f)
             {
-                m_particle[i].time = 0.0f;
-                m_particle[i].duration = 0.5f+Math::Rand()*2.0f;
-                m_particle[i].pos.x = m_particle[i].speed.x + (Math::Rand()-0.5f)*m_particle[i].mass;
-                m_particle[i].pos.y = m_particle[i].speed.y + (Math::Rand()-0.5f)*m_particle[i].mass;
-                m_particle[i].pos.z = m_particle[i].speed.z + (Math::Rand()-0.5f)*m_particle[i].mass;
+                m_time[i] = 0.0f;
+                m_duration[i] = 0.5f+Math::Rand()*2.0f;
+                m_pos[i].x = m_speed[i].x + (Math::Rand()-0.5f)*m_particle[i].mass;
+                m_pos[i].y = m_speed[i].y + (Math::Rand()-0.5f)*m_particle[i].mass;
+                m_pos[i].z = m_speed[i].z + (Math::Rand()-0.5f)*m_particle[i].mass;
                 m_particle[i].dim.x = 0.5f+Math::Rand()*1.5f;
                 m_particle[i].dim.y = m_particle[i].dim.x;
                 progress = 0.0f;
@@ -2236,7 +2337,7 @@ void CParticle::FrameParticle(float rTime)
                 m_particle[i].intensity = 1.0f-(progress-0.30f)/0.70f;
 
             m_particle[i].zoom = progress*m_particle[i].dim.x;
-            m_particle[i].angle = m_particle[i].time*Math::PI*2.0f;
+            m_particle[i].angle = m_time[i]*Math::PI*2.0f;
 
             ts.x = 0.000f;
             ts.y = 0.000f;
@@ -2258,7 +2359,7 @@ void CParticle::FrameParticle(float rTime)
                 m_particle[i].intensity = 1.0f-(progress-0.20f)/0.80f;
 
             m_particle[i].zoom = progress*m_particle[i].dim.x;
-            m_particle[i].angle = m_particle[i].time*Math::PI*2.0f;
+            m_particle[i].angle = m_time[i]*Math::PI*2.0f;
 
             ts.x = 0.125f;
             ts.y = 0.000f;
@@ -2286,7 +2387,7 @@ void CParticle::FrameParticle(float rTime)
                 m_particle[i].intensity = 1.0f-progress;
 
             m_particle[i].zoom = m_particle[i].dim.x;
-            m_particle[i].angle = m_particle[i].time*Math::PI*0.2f;
+            m_particle[i].angle = m_time[i]*Math::PI*0.2f;
 
             ts.x = 0.25f;
             ts.y = 0.75f;
@@ -2321,7 +2422,7 @@ void CParticle::FrameParticle(float rTime)
         {
             m_particle[i].intensity = 0.7f+sinf(progress)*0.3f;
             m_particle[i].zoom = m_particle[i].dim.x*(1.0f+sinf(progress*0.7f)*0.01f);
-            m_particle[i].angle = m_particle[i].time*Math::PI*0.2f;
+            m_particle[i].angle = m_time[i]*Math::PI*0.2f;
 
             ts.x = 0.25f;
             ts.y = 0.50f;
@@ -2366,7 +2467,7 @@ void CParticle::FrameParticle(float rTime)
         if (m_particle[i].type == PARTIDROP)
         {
             if (progress >= 1.0f ||
-                m_particle[i].pos.y < m_water->GetLevel())
+                m_pos[i].y < m_water->GetLevel())
             {
                 DeleteRank(i);
                 continue;
@@ -2384,7 +2485,7 @@ void CParticle::FrameParticle(float rTime)
         if (m_particle[i].type == PARTIWATER)
         {
             if (progress >= 1.0f ||
-                m_particle[i].pos.y < m_water->GetLevel())
+                m_pos[i].y < m_water->GetLevel())
             {
                 DeleteRank(i);
                 continue;
@@ -2409,7 +2510,7 @@ void CParticle::FrameParticle(float rTime)
             if (m_particle[i].testTime >= 0.2f)
             {
                 m_particle[i].testTime = 0.0f;
-                CObject* object = SearchObjectRay(m_particle[i].pos, m_particle[i].goal,
+                CObject* object = SearchObjectRay(m_pos[i], m_particle[i].goal,
                                          m_particle[i].type, m_particle[i].objFather);
                 if (object != nullptr)
                 {
@@ -2444,9 +2545,17 @@ void CParticle::FrameParticle(float rTime)
         m_particle[i].texSup.y = ts.y+dp;
         m_particle[i].texInf.x = ti.x-dp;
         m_particle[i].texInf.y = ti.y-dp;
-        m_particle[i].time     += rTime;
         m_particle[i].testTime += rTime;
     }
+
+    // Ages the particles which were updated and still exist; their step is 0 if removed
+    // or created again meanwhile. The steps are then cleared for the next frame.
+    for (int i : m_frameRanks)
+    {
+        m_time[i] += m_timeStep[i];
+        m_moveStep[i] = 0.0f;
+        m_timeStep[i] = 0.0f;
+    }
 }
 
 bool CParticle::TrackMove(int i, Math::Vector pos, float progress)
@@ -2669,7 +2778,7 @@ void CParticle::DrawParticleTriangle(int i)
     if (m_particle[i].zoom == 0.0f)  return;
 
     Math::Vector eye = m_engine->GetEyePt();
-    Math::Vector pos = m_particle[i].pos;
+    Math::Vector pos = m_pos[i];
 
     CObject* object = m_particle[i].objLink;
     if (object != nullptr)
@@ -2704,7 +2813,7 @@ void CParticle::DrawParticleNorm(int i)
 
     if (m_particle[i].sheet == SH_INTERFACE)
     {
-        Math::Vector pos = m_particle[i].pos;
+        Math::Vector pos = m_pos[i];
 
         Math::Vector n(0.0f, 0.0f, -1.0f);
 
@@ -2733,13 +2842,12 @@ void CParticle::DrawParticleNorm(int i)
         vertex[2] = Vertex(corner[3], n, Math::Point(m_particle[i].texSup.x, m_particle[i].texInf.y));
         vertex[3] = Vertex(corner[2], n, Math::Point(m_particle[i].texInf.x, m_particle[i].texInf.y));
 
-        m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, 4);
-        m_engine->AddStatisticTriangle(2);
+        BatchQuad(i, vertex, nullptr, Color(1.0f, 1.0f, 1.0f, 1.0f));
     }
     else
     {
         Math::Vector eye = m_engine->GetEyePt();
-        Math::Vector pos = m_particle[i].pos;
+        Math::Vector pos = m_pos[i];
 
         CObject* object = m_particle[i].objLink;
         if (object != nullptr)
@@ -2755,7 +2863,6 @@ void CParticle::DrawParticleNorm(int i)
         mat.Set(1, 4, pos.x);
         mat.Set(2, 4, pos.y);
         mat.Set(3, 4, pos.z);
-        m_device->SetTransform(TRANSFORM_WORLD, mat);
 
         Math::Vector n(0.0f, 0.0f, -1.0f);
 
@@ -2784,8 +2891,7 @@ void CParticle::DrawParticleNorm(int i)
         vertex[2] = Vertex(corner[3], n, Math::Point(m_particle[i].texSup.x, m_particle[i].texInf.y));
         vertex[3] = Vertex(corner[2], n, Math::Point(m_particle[i].texInf.x, m_particle[i].texInf.y));
 
-        m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, 4, m_particle[i].color);
-        m_engine->AddStatisticTriangle(2);
+        BatchQuad(i, vertex, &mat, m_particle[i].color);
     }
 }
 
@@ -2794,7 +2900,7 @@ void CParticle::DrawParticleFlat(int i)
     if (m_particle[i].zoom == 0.0f) return;
     if (m_particle[i].intensity == 0.0f) return;
 
-    Math::Vector pos = m_particle[i].pos;
+    Math::Vector pos = m_pos[i];
 
     CObject* object = m_particle[i].objLink;
     if (object != nullptr)
@@ -2817,7 +2923,6 @@ void CParticle::DrawParticleFlat(int i)
     mat.Set(1, 4, pos.x);
     mat.Set(2, 4, pos.y);
     mat.Set(3, 4, pos.z);
-    m_device->SetTransform(TRANSFORM_WORLD, mat);
 
     Math::Vector n(0.0f, 0.0f, -1.0f);
 
@@ -2848,8 +2953,7 @@ void CParticle::DrawParticleFlat(int i)
     vertex[2] = Vertex(corner[3], n, Math::Point(m_particle[i].texSup.x, m_particle[i].texInf.y));
     vertex[3] = Vertex(corner[2], n, Math::Point(m_particle[i].texInf.x, m_particle[i].texInf.y));
 
-    m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, 4);
-    m_engine->AddStatisticTriangle(2);
+    BatchQuad(i, vertex, &mat, Color(1.0f, 1.0f, 1.0f, 1.0f));
 }
 
 void CParticle::DrawParticleFog(int i)
@@ -2857,7 +2961,7 @@ void CParticle::DrawParticleFog(int i)
     if (!m_engine->GetFog()) return;
     if (m_particle[i].intensity == 0.0f) return;
 
-    Math::Vector pos = m_particle[i].pos;
+    Math::Vector pos = m_pos[i];
 
     Math::Point dim;
     dim.x = m_particle[i].dim.x;
@@ -2906,7 +3010,6 @@ void CParticle::DrawParticleFog(int i)
     mat.Set(1, 4, pos.x);
     mat.Set(2, 4, pos.y);
     mat.Set(3, 4, pos.z);
-    m_device->SetTransform(TRANSFORM_WORLD, mat);
 
     Math::Vector n(0.0f, 0.0f, -1.0f);
 
@@ -2935,8 +3038,7 @@ void CParticle::DrawParticleFog(int i)
     vertex[2] = Vertex(corner[3], n, Math::Point(m_particle[i].texSup.x, m_particle[i].texInf.y));
     vertex[3] = Vertex(corner[2], n, Math::Point(m_particle[i].texInf.x, m_particle[i].texInf.y));
 
-    m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, vertex, 4);
-    m_engine->AddStatisticTriangle(2);
+    BatchQuad(i, vertex, &mat, Color(1.0f, 1.0f, 1.0f, 1.0f));
 }
 
 void CParticle::DrawParticleRay(int i)
@@ -2945,7 +3047,7 @@ void CParticle::DrawParticleRay(int i)
     if (m_particle[i].intensity == 0.0f)  return;
 
     Math::Vector eye = m_engine->GetEyePt();
-    Math::Vector pos = m_particle[i].pos;
+    Math::Vector pos = m_pos[i];
     Math::Vector goal = m_particle[i].goal;
 
     CObject* object = m_particle[i].objLink;
@@ -3006,40 +3108,40 @@ void CParticle::DrawParticleRay(int i)
     }
     else if (m_particle[i].type == PARTIRAY3)
     {
-        if (m_particle[i].time < m_particle[i].duration*0.40f)
+        if (m_time[i] < m_duration[i]*0.40f)
         {
-            float prop = m_particle[i].time / (m_particle[i].duration*0.40f);
+            float prop = m_time[i] / (m_duration[i]*0.40f);
             first = 0;
             last  = static_cast<int>(prop*step);
         }
-        else if (m_particle[i].time < m_particle[i].duration*0.60f)
+        else if (m_time[i] < m_duration[i]*0.60f)
         {
             first = 0;
             last  = step;
         }
         else
         {
-            float prop = (m_particle[i].time-m_particle[i].duration*0.60f) / (m_particle[i].duration*0.40f);
+            float prop = (m_time[i]-m_duration[i]*0.60f) / (m_duration[i]*0.40f);
             first = static_cast<int>(prop*step);
             last  = step;
         }
     }
     else
     {
-        if (m_particle[i].time < m_particle[i].duration*0.50f)
+        if (m_time[i] < m_duration[i]*0.50f)
         {
-            float prop = m_particle[i].time / (m_particle[i].duration*0.50f);
+            float prop = m_time[i] / (m_duration[i]*0.50f);
             first = 0;
             last  = static_cast<int>(prop*step);
         }
-        else if (m_particle[i].time < m_particle[i].duration*0.75f)
+        else if (m_time[i] < m_duration[i]*0.75f)
         {
             first = 0;
             last  = step;
         }
         else
         {
-            float prop = (m_particle[i].time-m_particle[i].duration*0.75f) / (m_particle[i].duration*0.25f);
+            float prop = (m_time[i]-m_duration[i]*0.75f) / (m_duration[i]*0.25f);
             first = static_cast<int>(prop*step);
             last  = step;
         }
@@ -3110,9 +3212,9 @@ void CParticle::DrawParticleSphere(int i)
     mat.Set(1, 1, zoom);
     mat.Set(2, 2, zoom);
     mat.Set(3, 3, zoom);
-    mat.Set(1, 4, m_particle[i].pos.x);
-    mat.Set(2, 4, m_particle[i].pos.y);
-    mat.Set(3, 4, m_particle[i].pos.z);
+    mat.Set(1, 4, m_pos[i].x);
+    mat.Set(2, 4, m_pos[i].y);
+    mat.Set(3, 4, m_pos[i].z);
 
     if (m_particle[i].angle != 0.0f)
     {
@@ -3219,9 +3321,9 @@ void CParticle::DrawParticleCylinder(int i)
     mat.Set(1, 1, zoom);
     mat.Set(2, 2, zoom);
     mat.Set(3, 3, zoom);
-    mat.Set(1, 4, m_particle[i].pos.x);
-    mat.Set(2, 4, m_particle[i].pos.y);
-    mat.Set(3, 4, m_particle[i].pos.z);
+    mat.Set(1, 4, m_pos[i].x);
+    mat.Set(2, 4, m_pos[i].y);
+    mat.Set(3, 4, m_pos[i].z);
     m_device->SetTransform(TRANSFORM_WORLD, mat);
 
     Math::Point ts, ti;
@@ -3294,13 +3396,17 @@ void CParticle::DrawParticleText(int i)
 {
     CharTexture tex = m_engine->GetText()->GetCharTexture(static_cast<UTF8Char>(m_particle[i].text), FONT_COURIER, FONT_SIZE_BIG*2.0f);
     if (tex.id == 0) return;
-    m_device->SetTexture(0, tex.id);
-    m_engine->SetState(ENG_RSTATE_TTEXTURE_ALPHA, IntensityToColor(m_particle[i].intensity));
 
-    m_particle[i].texSup.x = 0.0f;
-    m_particle[i].texSup.y = 0.0f;
-    m_particle[i].texInf.x = static_cast<float>(tex.charSize.x) / static_cast<float>(tex.texSize.x);
-    m_particle[i].texInf.y = static_cast<float>(tex.charSize.y) / static_cast<float>(tex.texSize.y);
+    // Characters share a few font textures, so most of them end up in one batch
+    if (tex.id != m_batchTextTexture)
+    {
+        FlushBatch();
+        m_device->SetTexture(0, tex.id);
+        m_batchTextTexture = tex.id;
+    }
+
+    m_particle[i].texSup = tex.uv1;
+    m_particle[i].texInf = tex.uv2;
     m_particle[i].color = Color(0.0f, 0.0f, 0.0f);
 
     DrawParticleNorm(i);
@@ -3370,9 +3476,8 @@ void CParticle::DrawParticle(int sheet)
     // Draw the basic particles of triangles.
     if (m_totalInterface[0][sheet] > 0)
     {
-        for (int i = 0; i < MAXPARTICULE; i++)
+        for (int i : m_liveRanks[0])
         {
-            if (!m_particle[i].used)  continue;
             if (m_particle[i].sheet != sheet)  continue;
             if (m_particle[i].type == PARTIPART)  continue;
 
@@ -3411,16 +3516,41 @@ void CParticle::DrawParticle(int sheet)
         bool loadTexture = false;
 
         int state;
-        if (t == 4) state = ENG_RSTATE_TTEXTURE_WHITE;  // effect03.png
-        else        state = ENG_RSTATE_TTEXTURE_BLACK;  // effect[00..02].png
+        if (t == 4)      state = ENG_RSTATE_TTEXTURE_WHITE;  // effect03.png
+        else if (t == 5) state = ENG_RSTATE_TTEXTURE_ALPHA;  // text
+        else             state = ENG_RSTATE_TTEXTURE_BLACK;  // effect[00..02].png
         m_engine->SetState(state);
+        m_batchState = state;
+        m_batchTextTexture = 0;
 
-        for (int j = 0; j < MAXPARTICULE; j++)
+        m_drawRanks.clear();
+        for (int i : m_liveRanks[t])
         {
-            int i = MAXPARTICULE*t+j;
-            if (!m_particle[i].used)  continue;
-            if (m_particle[i].sheet != sheet)  continue;
+            if (m_particle[i].sheet == sheet)
+                m_drawRanks.push_back(i);
+        }
+
+        // The live list is in no particular order, so particles are drawn by rank to keep the same order each frame
+        if (t == 5)
+        {
+            // Blending of text depends on the order, it is not regrouped
+            std::sort(m_drawRanks.begin(), m_drawRanks.end());
+        }
+        else
+        {
+            // Particles with the same intensity and color follow each other, so that they end up in the same batch;
+            // the rank breaks the ties
+            auto batchKey = [this](int i)
+            {
+                const Color& color = m_particle[i].color;
+                return std::make_tuple(IntensityLevel(m_particle[i].intensity), color.r, color.g, color.b, color.a, i);
+            };
+            std::sort(m_drawRanks.begin(), m_drawRanks.end(),
+                      [&batchKey](int a, int b) { return batchKey(a) < batchKey(b); });
+        }
 
+        for (int i : m_drawRanks)
+        {
             if (!loadTexture && t != 5)
             {
                 std::string name;
@@ -3432,12 +3562,22 @@ void CParticle::DrawParticle(int sheet)
             int r = m_particle[i].trackRank;
             if (r != -1)
             {
+                FlushBatch();
                 m_engine->SetState(state);
                 TrackDraw(r, m_particle[i].type);  // draws the drag
                 if (!m_track[r].drawParticle)  continue;
             }
 
-            m_engine->SetState(state, IntensityToColor(m_particle[i].intensity));
+            ParticleType type = m_particle[i].type;
+            bool batched = !m_particle[i].ray &&
+                           !(type >= PARTISPHERE0 && type <= PARTISPHERE6) &&
+                           type != PARTIPLOUF0;
+            if (!batched)
+            {
+                // Drawn on its own, after the quads batched so far
+                FlushBatch();
+                m_engine->SetState(state, IntensityToColor(m_particle[i].intensity));
+            }
 
             if (m_particle[i].ray)  // ray?
             {
@@ -3473,7 +3613,65 @@ void CParticle::DrawParticle(int sheet)
                 DrawParticleNorm(i);
             }
         }
+
+        FlushBatch();
+    }
+}
+
+void CParticle::BatchQuad(int i, const Vertex* quad, const Math::Matrix* world, const Color& color)
+{
+    Color intensity = IntensityToColor(IntensityLevel(m_particle[i].intensity) / 255.0f);
+    bool worldCoords = (world != nullptr);
+
+    if (!m_batchVertices.empty() &&
+        (intensity != m_batchIntensity || color != m_batchColor || worldCoords != m_batchWorld))
+    {
+        FlushBatch();
+    }
+
+    m_batchIntensity = intensity;
+    m_batchColor = color;
+    m_batchWorld = worldCoords;
+
+    Vertex corners[4] = { quad[0], quad[1], quad[2], quad[3] };
+    if (world != nullptr)
+    {
+        Math::Vector origin = Math::Transform(*world, Math::Vector(0.0f, 0.0f, 0.0f));
+        Math::Vector normal = Math::Transform(*world, quad[0].normal) - origin;
+        for (int j = 0; j < 4; j++)
+        {
+            corners[j].coord = Math::Transform(*world, quad[j].coord);
+            corners[j].normal = normal;
+        }
     }
+
+    // The triangle strip 0-1-2-3 as two triangles
+    m_batchVertices.push_back(corners[0]);
+    m_batchVertices.push_back(corners[1]);
+    m_batchVertices.push_back(corners[2]);
+    m_batchVertices.push_back(corners[2]);
+    m_batchVertices.push_back(corners[1]);
+    m_batchVertices.push_back(corners[3]);
+}
+
+void CParticle::FlushBatch()
+{
+    if (m_batchVertices.empty()) return;
+
+    if (m_batchWorld)
+    {
+        Math::Matrix identity;
+        identity.LoadIdentity();
+        m_device->SetTransform(TRANSFORM_WORLD, identity);
+    }
+
+    m_engine->SetState(m_batchState, m_batchIntensity);
+
+    int count = static_cast<int>(m_batchVertices.size());
+    m_device->DrawPrimitive(PRIMITIVE_TRIANGLES, m_batchVertices.data(), count, m_batchColor);
+    m_engine->AddStatisticTriangle(count / 3);
+
+    m_batchVertices.clear();
 }
 
 CObject* CParticle::SearchObjectGun(Math::Vector old, Math::Vector pos,
@@ -3652,20 +3850,20 @@ Color CParticle::GetFogColor(Math::Vector pos)
     {
         int i = m_fog[fog];  // i = rank of the particle
 
-        if (pos.y >= m_particle[i].pos.y+FOG_HSUP)  continue;
-        if (pos.y <= m_particle[i].pos.y-FOG_HINF)  continue;
+        if (pos.y >= m_pos[i].y+FOG_HSUP)  continue;
+        if (pos.y <= m_pos[i].y-FOG_HINF)  continue;
 
-        float dist = Math::DistanceProjected(pos, m_particle[i].pos);
+        float dist = Math::DistanceProjected(pos, m_pos[i]);
         if (dist >= m_particle[i].dim.x*1.5f)  continue;
 
         // Calculates the horizontal distance.
         float factor = 1.0f-powf(dist/(m_particle[i].dim.x*1.5f), 4.0f);
 
         // Calculates the vertical distance.
-        if (pos.y > m_particle[i].pos.y)
-            factor *= 1.0f-(pos.y-m_particle[i].pos.y)/FOG_HSUP;
+        if (pos.y > m_pos[i].y)
+            factor *= 1.0f-(pos.y-m_pos[i].y)/FOG_HSUP;
         else
-            factor *= 1.0f-(m_particle[i].pos.y-pos.y)/FOG_HINF;
+            factor *= 1.0f-(m_pos[i].y-pos.y)/FOG_HINF;
 
         factor *= 0.3f;
 
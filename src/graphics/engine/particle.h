@@ -41,7 +41,7 @@ class CSoundInterface;
 namespace Gfx
 {
 
-const short MAXPARTICULE = 500;
+const short MAXPARTICULE = 500;     // default number of particles of each type, see CParticle::SetPoolSize()
 const short MAXPARTITYPE = 6;
 const short MAXTRACK = 100;
 const short MAXTRACKLEN = 10;
@@ -160,9 +160,15 @@ enum ParticlePhase
     PARPHEND        = 1,
 };
 
+/**
+ * \struct Particle
+ * \brief Rarely accessed data of a particle
+ *
+ * The data used in every frame (position, speed, time, duration and used flag)
+ * is kept by CParticle in separate arrays.
+ */
 struct Particle
 {
-    bool            used = false;      // TRUE -> particle used
     bool            ray = false;       // TRUE -> ray with goal
     unsigned short  uniqueStamp = 0;    // unique mark
     short           sheet = 0;      // sheet (0..n)
@@ -170,10 +176,7 @@ struct Particle
     ParticlePhase   phase = {};      // phase PARPH*
     float           mass = 0.0f;       // mass of the particle (in rebounding)
     float           weight = 0.0f;     // weight of the particle (for noise)
-    float           duration = 0.0f;   // length of life
-    Math::Vector    pos;        // absolute position (relative if object links)
     Math::Vector    goal;       // goal position (if ray)
-    Math::Vector    speed;      // speed of displacement
     float           windSensitivity = 0.0f;
     short           bounce = 0;     // number of rebounds
     Math::Point     dim;        // dimensions of the rectangle
@@ -182,7 +185,6 @@ struct Particle
     float           intensity = 0.0f;  // intensity
     Math::Point     texSup;     // coordinated upper texture
     Math::Point     texInf;     // coordinated lower texture
-    float           time = 0.0f;       // age of the particle (0..n)
     float           phaseTime = 0.0f;  // age at the beginning of phase
     float           testTime = 0.0f;   // time since last test
     CObject*        objLink = nullptr;    // father object (for example reactor)
@@ -235,6 +237,13 @@ public:
     //! Removes all particles of a sheet
     void        FlushParticle(int sheet);
 
+    //! Sets the maximum number of particles of each texture type; removes all particles
+    void        SetPoolSize(int size);
+    //! Returns the maximum number of particles of each texture type
+    int         GetPoolSize() const;
+    //! Returns the number of existing particles
+    int         GetParticleCount() const;
+
     //! Creates a new particle
     int         CreateParticle(Math::Vector pos, Math::Vector speed, Math::Point dim,
                                ParticleType type, float duration = 1.0f, float mass = 0.0f,
@@ -295,6 +304,8 @@ public:
     bool        WriteWheelTrace(const char *filename, int width, int height, Math::Vector dl, Math::Vector ur);
 
 protected:
+    //! Resets a free particle of given rank and marks it as used
+    void        InitRank(int rank);
     //! Removes a particle of given rank
     void        DeleteRank(int rank);
     //! Check a channel number
@@ -317,6 +328,10 @@ protected:
     void        DrawParticleText(int i);
     //! Draws a tire mark
     void        DrawParticleWheel(int i);
+    //! Adds a quad of particle i, given as a triangle strip, to the batch; \a world transforms it to the world
+    void        BatchQuad(int i, const Vertex* quad, const Math::Matrix* world, const Color& color);
+    //! Draws the quads waiting in the batch with one call
+    void        FlushBatch();
     //! Seeks if an object collided with a bullet
     CObject*    SearchObjectGun(Math::Vector old, Math::Vector pos, ParticleType type, CObject *father);
     //! Seeks if an object collided with a ray
@@ -336,8 +351,41 @@ protected:
     CRobotMain*       m_main = nullptr;
     CSoundInterface*  m_sound = nullptr;
 
-    Particle       m_particle[MAXPARTICULE*MAXPARTITYPE];
-    EngineTriangle m_triangle[MAXPARTICULE];  // triangle if PartiType == 0
+    //! Number of particles of each texture type
+    int            m_poolSize = 0;
+    //! Cold data, m_poolSize*MAXPARTITYPE entries
+    std::vector<Particle>       m_particle;
+    //@{
+    //! Hot data, same indexes as m_particle
+    std::vector<char>           m_used;         // true -> particle used
+    std::vector<Math::Vector>   m_pos;          // absolute position (relative if object links)
+    std::vector<Math::Vector>   m_speed;        // speed of displacement
+    std::vector<float>          m_time;         // age of the particle (0..n)
+    std::vector<float>          m_duration;     // length of life
+    //@}
+    //@{
+    //! Time steps of the current frame, 0 for particles not updated
+    std::vector<float>          m_moveStep;
+    std::vector<float>          m_timeStep;
+    //@}
+    //! Ranks of used particles of each texture type, in no particular order
+    std::vector<int>            m_liveRanks[MAXPARTITYPE];
+    //! Index of each used particle in m_liveRanks
+    std::vector<int>            m_livePos;
+    //! Ranks of particles updated in the current frame
+    std::vector<int>            m_frameRanks;
+    std::vector<EngineTriangle> m_triangle;  // triangle if PartiType == 0
+    //! Ranks of particles drawn with the current texture, ordered for batching
+    std::vector<int>            m_drawRanks;
+    //@{
+    //! Quads of normal, flat and fog particles waiting to be drawn with the same state
+    std::vector<Vertex>         m_batchVertices;
+    int                         m_batchState = 0;
+    Color                       m_batchIntensity;
+    Color                       m_batchColor;
+    bool                        m_batchWorld = false;   // true -> vertices in world coordinates
+    unsigned int                m_batchTextTexture = 0; // font texture bound for text particles
+    //@}
     Track          m_track[MAXTRACK];
     int           m_wheelTraceTotal = 0;
     int           m_wheelTraceIndex = 0;
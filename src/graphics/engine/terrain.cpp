@@ -39,6 +39,12 @@
 namespace Gfx
 {
 
+namespace
+{
+//! Relative distance beyond its limits for which a mosaic keeps its resolution
+const float LOD_HYSTERESIS = 0.1f;
+} // anonymous namespace
+
 
 CTerrain::CTerrain()
 {
@@ -53,6 +59,7 @@ CTerrain::CTerrain()
     m_scaleRelief     = 1.0f;
     m_textureSubdivCount   = 1;
     m_depth           = 2;
+    m_lodCount        = 1;
     m_maxMaterialID   = 0;
     m_wind            = Math::Vector(0.0f, 0.0f, 0.0f);
     m_defaultHardness = 0.5f;
@@ -99,6 +106,7 @@ bool CTerrain::Generate(int mosaicCount, int brickCountPow2, float brickSize,
 
     dim = m_mosaicCount*m_mosaicCount;
     std::vector<int>(dim, -1).swap(m_objRanks);
+    std::vector<int>(dim, 0).swap(m_lodLevels);
 
     return true;
 }
@@ -272,18 +280,19 @@ void CTerrain::FlushRelief()
 
     for (int objRank : m_objRanks)
     {
-        if (objRank == -1)
-            continue;
-
-        int baseObjRank = m_engine->GetObjectBaseRank(objRank);
+        if (objRank != -1)
+            m_engine->DeleteObject(objRank);
+    }
 
+    for (int baseObjRank : m_lodBaseObjRanks)
+    {
         if (baseObjRank != -1)
             m_engine->DeleteBaseObject(baseObjRank);
-
-        m_engine->DeleteObject(objRank);
     }
 
     m_objRanks.clear();
+    m_lodBaseObjRanks.clear();
+    m_lodLevels.clear();
 }
 
 /**
@@ -565,35 +574,29 @@ VertexTex2 CTerrain::GetVertex(int x, int y, int step)
   |
   +-------------------> x
 \endverbatim */
-bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank,
+bool CTerrain::CreateMosaic(int ox, int oy, int step, int baseObjRank,
                             const Material &mat)
 {
-    int baseObjRank = m_engine->GetObjectBaseRank(objRank);
-    if (baseObjRank == -1)
-    {
-        baseObjRank = m_engine->CreateBaseObject();
-        m_engine->SetObjectBaseRank(objRank, baseObjRank);
-    }
-
     std::string texName1;
     std::string texName2;
 
-    if ( step == 1 )
-    {
-        int i = (ox/5) + (oy/5)*(m_mosaicCount/5);
-        std::stringstream s;
-        s << "shadow";
-        s.width(2);
-        s.fill('0');
-        s << i;
-        s << ".png";
-        texName2 = s.str();
-    }
+    // All resolutions use the shadows, so that they do not pop when the resolution changes
+    int shadow = (ox/5) + (oy/5)*(m_mosaicCount/5);
+    std::stringstream shadowName;
+    shadowName << "shadow";
+    shadowName.width(2);
+    shadowName.fill('0');
+    shadowName << shadow;
+    shadowName << ".png";
+    texName2 = shadowName.str();
 
     int brick = m_brickCount/m_textureSubdivCount;
 
-    VertexTex2 o = GetVertex(ox*m_brickCount+m_brickCount/2, oy*m_brickCount+m_brickCount/2, step);
-    int total = ((brick/step)+1)*2;
+    Math::Vector o = GetVector(ox*m_brickCount+m_brickCount/2, oy*m_brickCount+m_brickCount/2);
+    int columns = brick/step;
+
+    std::vector<VertexTex2> row;
+    row.reserve((columns+1)*2);
 
     float pixel = 1.0f/256.0f;  // 1 pixel cover (*)
     float dp = 1.0f/512.0f;
@@ -622,26 +625,29 @@ bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank,
                 texName1 = s.str();
             }
 
-            for (int y = 0; y < brick; y += step)
-            {
-                EngineBaseObjDataTier buffer;
-                buffer.vertices.reserve(total);
+            // The whole surface is one triangle list, so that its shared vertices
+            // are welded into a single indexed static buffer
+            EngineBaseObjDataTier buffer;
+            buffer.vertices.reserve(columns*columns*6);
 
-                buffer.type = ENG_TRIANGLE_TYPE_SURFACE;
-                buffer.material = mat;
+            buffer.type = ENG_TRIANGLE_TYPE_TRIANGLES;
+            buffer.material = mat;
 
-                buffer.state = ENG_RSTATE_WRAP;
+            buffer.state = ENG_RSTATE_WRAP;
 
-                buffer.state |= ENG_RSTATE_SECOND;
-                if (step == 1)
-                    buffer.state |= ENG_RSTATE_DUAL_BLACK;
+            buffer.state |= ENG_RSTATE_SECOND;
+            buffer.state |= ENG_RSTATE_DUAL_BLACK;
+
+            for (int y = 0; y < brick; y += step)
+            {
+                row.clear();
 
                 for (int x = 0; x <= brick; x += step)
                 {
                     VertexTex2 p1 = GetVertex(ox*m_brickCount+mx*brick+x, oy*m_brickCount+my*brick+y+0   , step);
                     VertexTex2 p2 = GetVertex(ox*m_brickCount+mx*brick+x, oy*m_brickCount+my*brick+y+step, step);
-                    p1.coord.x -= o.coord.x;  p1.coord.z -= o.coord.z;
-                    p2.coord.x -= o.coord.x;  p2.coord.z -= o.coord.z;
+                    p1.coord.x -= o.x;  p1.coord.z -= o.z;
+                    p2.coord.x -= o.x;  p2.coord.z -= o.z;
 
                     // TODO: Find portable solution
                     //float offset = 0.5f / 256.0f;      // Direct3D
@@ -718,21 +724,27 @@ bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank,
                     p2.texCoord2.y = (p2.texCoord2.y+pixel)*(1.0f-pixel)/(1.0f+pixel);
 
 
-                    buffer.vertices.push_back(p1);
-                    buffer.vertices.push_back(p2);
+                    row.push_back(p1);
+                    row.push_back(p2);
                 }
 
-                m_engine->AddBaseObjQuick(baseObjRank, buffer, texName1, texName2, true);
+                // Triangles of the strip p1, p2, p1', p2', ...
+                for (int i = 0; i + 3 < static_cast<int>( row.size() ); i += 2)
+                {
+                    buffer.vertices.push_back(row[i+0]);
+                    buffer.vertices.push_back(row[i+1]);
+                    buffer.vertices.push_back(row[i+2]);
+
+                    buffer.vertices.push_back(row[i+2]);
+                    buffer.vertices.push_back(row[i+1]);
+                    buffer.vertices.push_back(row[i+3]);
+                }
             }
+
+            m_engine->AddBaseObjQuick(baseObjRank, std::move(buffer), texName1, texName2, true);
         }
     }
 
-    Math::Matrix transform;
-    transform.LoadIdentity();
-    transform.Set(1, 4, o.coord.x);
-    transform.Set(3, 4, o.coord.z);
-    m_engine->SetObjectTransform(objRank, transform);
-
     return true;
 }
 
@@ -1243,20 +1255,44 @@ void CTerrain::FlushMaterialPoints()
 
 bool CTerrain::CreateSquare(int x, int y)
 {
-    Material mat;
-    mat.diffuse = Color(1.0f, 1.0f, 1.0f);
-    mat.ambient = Color(0.0f, 0.0f, 0.0f);
-
     int objRank = m_engine->CreateObject();
     m_engine->SetObjectType(objRank, ENG_OBJTYPE_TERRAIN);
 
     m_objRanks[x+y*m_mosaicCount] = objRank;
 
-    for (int step = 0; step < m_depth; step++)
+    return CreateSquareGeometry(x, y);
+}
+
+bool CTerrain::CreateSquareGeometry(int x, int y)
+{
+    Material mat;
+    mat.diffuse = Color(1.0f, 1.0f, 1.0f);
+    mat.ambient = Color(0.0f, 0.0f, 0.0f);
+
+    int i = x+y*m_mosaicCount;
+    int objRank = m_objRanks[i];
+
+    // Each resolution has its own base object, the object uses one of them
+    for (int level = 0; level < m_lodCount; level++)
     {
-        CreateMosaic(x, y, 1 << step, objRank, mat);
+        int& baseObjRank = m_lodBaseObjRanks[i*m_lodCount+level];
+        if (baseObjRank == -1)
+            baseObjRank = m_engine->CreateBaseObject();
+        else
+            m_engine->ClearBaseObjGeometry(baseObjRank);
+
+        CreateMosaic(x, y, 1 << level, baseObjRank, mat);
     }
 
+    m_engine->SetObjectBaseRank(objRank, m_lodBaseObjRanks[i*m_lodCount+m_lodLevels[i]]);
+
+    Math::Vector o = GetVector(x*m_brickCount+m_brickCount/2, y*m_brickCount+m_brickCount/2);
+    Math::Matrix transform;
+    transform.LoadIdentity();
+    transform.Set(1, 4, o.x);
+    transform.Set(3, 4, o.z);
+    m_engine->SetObjectTransform(objRank, transform);
+
     return true;
 }
 
@@ -1264,6 +1300,15 @@ bool CTerrain::CreateObjects()
 {
     AdjustRelief();
 
+    // A step can't be larger than the surface of one texture, so coarser resolutions
+    // would only duplicate the coarsest one
+    int brick = m_brickCount/m_textureSubdivCount;
+    m_lodCount = 1;
+    while (m_lodCount < m_depth && (1 << m_lodCount) <= brick)
+        m_lodCount++;
+
+    std::vector<int>(m_mosaicCount*m_mosaicCount*m_lodCount, -1).swap(m_lodBaseObjRanks);
+
     for (int y = 0; y < m_mosaicCount; y++)
     {
         for (int x = 0; x < m_mosaicCount; x++)
@@ -1273,6 +1318,64 @@ bool CTerrain::CreateObjects()
     return true;
 }
 
+void CTerrain::UpdateLevelOfDetail(const Math::Vector& eye)
+{
+    if (m_lodCount <= 1 || m_objRanks.empty())
+        return;
+
+    float vision = m_vision * m_engine->GetClippingDistance();
+    float mosaicSize = m_brickCount*m_brickSize;
+    float dim = (m_mosaicCount*mosaicSize)/2.0f;
+
+    // Resolution step is doubled every time the distance doubles beyond the vision
+    auto getLevel = [&](float distance)
+    {
+        int level = 0;
+        for (float limit = vision; level < m_lodCount-1 && distance >= limit; limit *= 2.0f)
+            level++;
+        return level;
+    };
+
+    for (int y = 0; y < m_mosaicCount; y++)
+    {
+        for (int x = 0; x < m_mosaicCount; x++)
+        {
+            int i = x+y*m_mosaicCount;
+            if (m_objRanks[i] == -1)
+                continue;
+
+            // Distance to the closest point of the mosaic in XZ, and to its center in Y
+            Math::Vector center = GetVector(x*m_brickCount+m_brickCount/2, y*m_brickCount+m_brickCount/2);
+            float dx = Math::Max(fabs(eye.x - ((x+0.5f)*mosaicSize - dim)) - mosaicSize/2.0f, 0.0f);
+            float dz = Math::Max(fabs(eye.z - ((y+0.5f)*mosaicSize - dim)) - mosaicSize/2.0f, 0.0f);
+            float dy = eye.y - center.y;
+            float distance = sqrtf(dx*dx + dy*dy + dz*dz);
+
+            int level = getLevel(distance);
+            if (level == m_lodLevels[i])
+                continue;
+
+            // Keep the current resolution a bit beyond its limits,
+            // so that mosaics near a limit do not change it back and forth
+            if (level > m_lodLevels[i])
+                level = getLevel(distance / (1.0f + LOD_HYSTERESIS));
+            else
+                level = getLevel(distance * (1.0f + LOD_HYSTERESIS));
+
+            if (level == m_lodLevels[i])
+                continue;
+
+            m_lodLevels[i] = level;
+            m_engine->SetObjectBaseRank(m_objRanks[i], m_lodBaseObjRanks[i*m_lodCount+level]);
+        }
+    }
+}
+
+const std::vector<int>& CTerrain::GetLevelOfDetailBaseObjRanks()
+{
+    return m_lodBaseObjRanks;
+}
+
 /** ATTENTION: ok only with m_depth = 2! */
 bool CTerrain::Terraform(const Math::Vector &p1, const Math::Vector &p2, float height)
 {
@@ -1350,14 +1453,11 @@ bool CTerrain::Terraform(const Math::Vector &p1, const Math::Vector &p2, float h
     {
         for (int x = pp1.x; x <= pp2.x; x++)
         {
-            int objRank = m_objRanks[x+y*m_mosaicCount];
-            int baseObjRank = m_engine->GetObjectBaseRank(objRank);
-            m_engine->DeleteBaseObject(baseObjRank);
-            m_engine->DeleteObject(objRank);
-            CreateSquare(x, y);  // recreates the square
+            CreateSquareGeometry(x, y);  // rebuilds the square in place
         }
     }
-    m_engine->Update();
+    m_engine->Update();  // only the rebuilt squares are updated
+    m_engine->InvalidateGroundSpotLevels();
 
     return true;
 }
@@ -176,6 +176,10 @@ public:
 
     //! Creates all objects of the terrain within the 3D engine
     bool        CreateObjects();
+    //! Selects the resolution of each mosaic according to its distance from \a eye
+    void        UpdateLevelOfDetail(const Math::Vector& eye);
+    //! Returns base objects of all resolutions of all mosaics, -1 for those not created
+    const std::vector<int>& GetLevelOfDetailBaseObjRanks();
 
     //! Modifies the terrain's relief
     bool        Terraform(const Math::Vector& p1, const Math::Vector& p2, float height);
@@ -253,10 +257,12 @@ protected:
     Math::Vector GetVector(int x, int y);
     //! Calculates a vertex of the terrain
     VertexTex2  GetVertex(int x, int y, int step);
-    //! Creates all objects of a mosaic
-    bool        CreateMosaic(int ox, int oy, int step, int objRank, const Material& mat);
+    //! Creates the geometry of a mosaic with given resolution in base object \a baseObjRank
+    bool        CreateMosaic(int ox, int oy, int step, int baseObjRank, const Material& mat);
     //! Creates all objects in a mesh square ground
     bool        CreateSquare(int x, int y);
+    //! Builds the geometry of a mesh square ground, reusing its buffers if it already exists
+    bool        CreateSquareGeometry(int x, int y);
 
     struct TerrainMaterial;
     //! Seeks a material based on its ID
@@ -295,6 +301,10 @@ protected:
     std::vector<int> m_textures;
     //! Object ranks for mosaic objects
     std::vector<int> m_objRanks;
+    //! Base object ranks of mosaics, m_lodCount resolutions for each mosaic
+    std::vector<int> m_lodBaseObjRanks;
+    //! Resolution currently used by each mosaic
+    std::vector<int> m_lodLevels;
 
     //! Number of mosaics (along one dimension)
     int             m_mosaicCount;
@@ -310,6 +320,8 @@ protected:
     int             m_textureSubdivCount;
     //! Number of different resolutions (1,2,3,4)
     int             m_depth;
+    //! Number of resolutions built for each mosaic, m_depth limited by size of texture surface
+    int             m_lodCount;
     //! Scale of texture mapping
     float           m_textureScale;
     //! Vision before a change of resolution
@@ -32,6 +32,8 @@
 
 #include "math/func.h"
 
+#include <algorithm>
+
 #include <SDL.h>
 #include <SDL_ttf.h>
 
@@ -78,9 +80,67 @@ struct CachedFont
 };
 
 
+/**
+ * \struct FontTexture
+ * \brief Texture page holding many rendered characters
+ *
+ * Characters are packed in shelves: horizontal strips as high as the first
+ * character put in them, filled from left to right. Characters of one font
+ * size are nearly of the same height, so little space is lost.
+ */
+struct FontTexture
+{
+    struct Shelf
+    {
+        int y;
+        int height;
+        int x;  //!< first free column
+    };
+
+    Texture texture;
+    std::vector<Shelf> shelves;
+    //! First row below the last shelf
+    int freeY = 0;
+
+    //! Finds room for a rectangle of given size; returns false if the page is full
+    bool Allocate(Math::IntPoint size, Math::IntPoint& pos)
+    {
+        Shelf* best = nullptr;
+        for (Shelf& shelf : shelves)
+        {
+            // Don't put small characters in much higher shelves
+            if (shelf.height < size.y || shelf.height > size.y + size.y / 4 + 1)
+                continue;
+            if (shelf.x + size.x > texture.size.x)
+                continue;
+            if (best == nullptr || shelf.height < best->height)
+                best = &shelf;
+        }
+
+        if (best == nullptr)
+        {
+            if (freeY + size.y > texture.size.y || size.x > texture.size.x)
+                return false;
+
+            shelves.push_back({freeY, size.y, 0});
+            freeY += size.y;
+            best = &shelves.back();
+        }
+
+        pos = Math::IntPoint(best->x, best->y);
+        best->x += size.x;
+        return true;
+    }
+};
+
+
 namespace
 {
 const Math::IntPoint REFERENCE_SIZE(800, 600);
+//! Size of font texture pages
+const int FONT_TEXTURE_SIZE = 512;
+//! Empty pixels left around each character, so that neighbours don't bleed in
+const int CHAR_PADDING = 1;
 } // anonymous namespace
 
 
@@ -95,6 +155,8 @@ CText::CText(CEngine* engine)
     m_lastFontType = FONT_COLOBOT;
     m_lastFontSize = 0;
     m_lastCachedFont = nullptr;
+
+    m_quadTexture = 0;
 }
 
 CText::~CText()
@@ -132,6 +194,8 @@ bool CText::Create()
 void CText::Destroy()
 {
     m_fonts.clear();
+    m_fontTextures.clear();
+    m_quads.clear();
 
     m_lastCachedFont = nullptr;
     m_lastFontType = FONT_COLOBOT;
@@ -155,17 +219,13 @@ void CText::FlushCache()
     for (auto& multisizeFont : m_fonts)
     {
         for (auto& cachedFont : multisizeFont.second->fonts)
-        {
-            for (auto& charTexture : cachedFont.second->cache)
-            {
-                Texture tex;
-                tex.id = charTexture.second.id;
-                m_device->DestroyTexture(tex);
-            }
             cachedFont.second->cache.clear();
-        }
     }
 
+    for (auto& fontTexture : m_fontTextures)
+        m_device->DestroyTexture(fontTexture->texture);
+    m_fontTextures.clear();
+
     m_lastCachedFont = nullptr;
     m_lastFontType = FONT_COLOBOT;
     m_lastFontSize = 0;
@@ -712,6 +772,8 @@ void CText::DrawString(const std::string &text, std::vector<FontMetaChar>::itera
         color = Color(1.0f, 0.0f, 0.0f);
         DrawCharAndAdjustPos(ch, font, size, pos, color);
     }
+
+    FlushCharQuads();
 }
 
 void CText::StringToUTFCharList(const std::string &text, std::vector<UTF8Char> &chars)
@@ -787,6 +849,8 @@ void CText::DrawString(const std::string &text, FontType font,
     {
         DrawCharAndAdjustPos(*it, font, size, pos, color);
     }
+
+    FlushCharQuads();
 }
 
 void CText::DrawHighlight(FontHighlight hl, Math::Point pos, Math::Point size)
@@ -811,6 +875,9 @@ void CText::DrawHighlight(FontHighlight hl, Math::Point pos, Math::Point size)
             return;
     }
 
+    // The highlight goes below the characters drawn after it, not above those before
+    FlushCharQuads();
+
     Math::IntPoint vsize = m_engine->GetWindowSize();
     float h = 0.0f;
     if (vsize.y <= 768.0f)    // 1024x768 or less?
@@ -853,6 +920,8 @@ void CText::DrawCharAndAdjustPos(UTF8Char ch, FontType font, float size, Math::P
 {
     if(font == FONT_BUTTON)
     {
+        FlushCharQuads();
+
         Math::IntPoint windowSize = m_engine->GetWindowSize();
         float height = GetHeight(FONT_COLOBOT, size);
         float width = height*(static_cast<float>(windowSize.y)/windowSize.x);
@@ -926,27 +995,51 @@ void CText::DrawCharAndAdjustPos(UTF8Char ch, FontType font, float size, Math::P
 
         CharTexture tex = GetCharTexture(ch, font, size);
 
-        Math::Point p1(pos.x, pos.y + tex.charSize.y - tex.texSize.y);
-        Math::Point p2(pos.x + tex.texSize.x, pos.y + tex.charSize.y);
-
-        Math::Vector n(0.0f, 0.0f, -1.0f);  // normal
-
-        Vertex quad[4] =
-        {
-            Vertex(Math::Vector(p1.x, p1.y, 0.0f), n, Math::Point(0.0f, 1.0f)),
-            Vertex(Math::Vector(p1.x, p2.y, 0.0f), n, Math::Point(0.0f, 0.0f)),
-            Vertex(Math::Vector(p2.x, p1.y, 0.0f), n, Math::Point(1.0f, 1.0f)),
-            Vertex(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(1.0f, 0.0f))
-        };
+        Math::Point p1(pos.x, pos.y);
+        Math::Point p2(pos.x + tex.charSize.x, pos.y + tex.charSize.y);
 
-        m_device->SetTexture(0, tex.id);
-        m_device->DrawPrimitive(PRIMITIVE_TRIANGLE_STRIP, quad, 4, color);
-        m_engine->AddStatisticTriangle(2);
+        if (tex.id != 0)
+            BatchCharQuad(tex, p1, p2, color);
 
         pos.x += tex.charSize.x * width;
     }
 }
 
+void CText::BatchCharQuad(const CharTexture& tex, Math::Point p1, Math::Point p2, Color color)
+{
+    if (!m_quads.empty() && (tex.id != m_quadTexture || color != m_quadColor))
+        FlushCharQuads();
+
+    m_quadTexture = tex.id;
+    m_quadColor = color;
+
+    Math::Vector n(0.0f, 0.0f, -1.0f);  // normal
+
+    Vertex quad[4] =
+    {
+        Vertex(Math::Vector(p1.x, p1.y, 0.0f), n, Math::Point(tex.uv1.x, tex.uv2.y)),
+        Vertex(Math::Vector(p1.x, p2.y, 0.0f), n, Math::Point(tex.uv1.x, tex.uv1.y)),
+        Vertex(Math::Vector(p2.x, p1.y, 0.0f), n, Math::Point(tex.uv2.x, tex.uv2.y)),
+        Vertex(Math::Vector(p2.x, p2.y, 0.0f), n, Math::Point(tex.uv2.x, tex.uv1.y))
+    };
+
+    // Two triangles per quad, as separate quads can't share a strip
+    for (int index : { 0, 1, 2, 2, 1, 3 })
+        m_quads.push_back(quad[index]);
+}
+
+void CText::FlushCharQuads()
+{
+    if (m_quads.empty())
+        return;
+
+    m_device->SetTexture(0, m_quadTexture);
+    m_device->DrawPrimitive(PRIMITIVE_TRIANGLES, m_quads.data(), m_quads.size(), m_quadColor);
+    m_engine->AddStatisticTriangle(m_quads.size() / 3);
+
+    m_quads.clear();
+}
+
 CachedFont* CText::GetOrOpenFont(FontType font, float size)
 {
     Math::IntPoint windowSize = m_engine->GetWindowSize();
@@ -1011,41 +1104,93 @@ CharTexture CText::CreateCharTexture(UTF8Char ch, CachedFont* font)
         return texture;
     }
 
-    int w = Math::NextPowerOfTwo(textSurface->w);
-    int h = Math::NextPowerOfTwo(textSurface->h);
+    Math::IntPoint pos;
+    FontTexture* fontTexture = AllocateCharSpace(Math::IntPoint(textSurface->w + CHAR_PADDING,
+                                                                textSurface->h + CHAR_PADDING), pos);
+    if (fontTexture == nullptr)
+    {
+        SDL_FreeSurface(textSurface);
+        return texture;
+    }
 
     textSurface->flags = textSurface->flags & (~SDL_SRCALPHA);
-    SDL_Surface* textureSurface = SDL_CreateRGBSurface(0, w, h, 32, 0x00ff0000, 0x0000ff00,
-                                                       0x000000ff, 0xff000000);
-    SDL_BlitSurface(textSurface, nullptr, textureSurface, nullptr);
+    SDL_Surface* charSurface = SDL_CreateRGBSurface(0, textSurface->w, textSurface->h, 32, 0x00ff0000, 0x0000ff00,
+                                                    0x000000ff, 0xff000000);
+    SDL_BlitSurface(textSurface, nullptr, charSurface, nullptr);
+
+    ImageData data;
+    data.surface = charSurface;
+
+    m_device->UpdateTexture(fontTexture->texture, pos, &data, TEX_IMG_BGRA);
+
+    data.surface = nullptr;
+
+    Math::Point pageSize(fontTexture->texture.size.x, fontTexture->texture.size.y);
+
+    texture.id = fontTexture->texture.id;
+    texture.uv1 = Math::Point(pos.x / pageSize.x, pos.y / pageSize.y);
+    texture.uv2 = Math::Point((pos.x + textSurface->w) / pageSize.x, (pos.y + textSurface->h) / pageSize.y);
+    texture.charSize = m_engine->WindowToInterfaceSize(Math::IntPoint(textSurface->w, textSurface->h));
+
+    SDL_FreeSurface(textSurface);
+    SDL_FreeSurface(charSurface);
+
+    return texture;
+}
+
+FontTexture* CText::AllocateCharSpace(Math::IntPoint size, Math::IntPoint& pos)
+{
+    // Only the last pages can have room left; older ones are usually full
+    for (auto it = m_fontTextures.rbegin(); it != m_fontTextures.rend(); ++it)
+    {
+        if ((*it)->Allocate(size, pos))
+            return it->get();
+    }
+
+    int pageSize = FONT_TEXTURE_SIZE;
+    int maxTextureSize = m_device->GetMaxTextureSize();
+    if (maxTextureSize > 0)
+        pageSize = std::min(pageSize, maxTextureSize);
+    if (size.x > pageSize || size.y > pageSize)
+    {
+        m_error = "Character too big for font texture";
+        return nullptr;
+    }
+
+    SDL_Surface* pageSurface = SDL_CreateRGBSurface(0, pageSize, pageSize, 32, 0x00ff0000, 0x0000ff00,
+                                                    0x000000ff, 0xff000000);
+    SDL_FillRect(pageSurface, nullptr, 0);
 
     ImageData data;
-    data.surface = textureSurface;
+    data.surface = pageSurface;
 
     TextureCreateParams createParams;
-    createParams.format = TEX_IMG_RGBA;
+    createParams.format = TEX_IMG_BGRA;
     createParams.filter = TEX_FILTER_NEAREST;
     createParams.mipmap = false;
 
     Texture tex = m_device->CreateTexture(&data, createParams);
 
     data.surface = nullptr;
+    SDL_FreeSurface(pageSurface);
 
     if (! tex.Valid())
     {
         m_error = "Texture create error";
+        return nullptr;
     }
-    else
+
+    auto fontTexture = MakeUnique<FontTexture>();
+    fontTexture->texture = tex;
+    fontTexture->texture.size = Math::IntPoint(pageSize, pageSize);
+    if (!fontTexture->Allocate(size, pos))
     {
-        texture.id = tex.id;
-        texture.texSize =  m_engine->WindowToInterfaceSize(Math::IntPoint(textureSurface->w, textureSurface->h));
-        texture.charSize = m_engine->WindowToInterfaceSize(Math::IntPoint(textSurface->w, textSurface->h));
+        m_device->DestroyTexture(tex);
+        return nullptr;
     }
 
-    SDL_FreeSurface(textSurface);
-    SDL_FreeSurface(textureSurface);
-
-    return texture;
+    m_fontTextures.push_back(std::move(fontTexture));
+    return m_fontTextures.back().get();
 }
 
 CharTexture CText::GetCharTexture(UTF8Char ch, FontType font, float size)
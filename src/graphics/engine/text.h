@@ -26,7 +26,9 @@
 
 
 #include "graphics/core/color.h"
+#include "graphics/core/vertex.h"
 
+#include "math/intpoint.h"
 #include "math/point.h"
 
 #include <map>
@@ -185,18 +187,22 @@ struct UTF8Char
 
 /**
  * \struct CharTexture
- * \brief Texture of font character
+ * \brief Location of a rendered character in one of the font textures
  */
 struct CharTexture
 {
+    //! Texture of the atlas page holding the character
     unsigned int id = 0;
-    Math::Point texSize;
+    //! Texture coordinates of top left and bottom right corners
+    Math::Point uv1, uv2;
+    //! Size of the character in interface coordinates
     Math::Point charSize;
 };
 
 // Definition is private - in text.cpp
 struct CachedFont;
 struct MultisizeFont;
+struct FontTexture;
 
 /**
  * \enum SpecialChar
@@ -310,6 +316,8 @@ public:
 protected:
     CachedFont* GetOrOpenFont(FontType type, float size);
     CharTexture CreateCharTexture(UTF8Char ch, CachedFont* font);
+    //! Finds room for a character in the font textures, adding a new page if needed
+    FontTexture* AllocateCharSpace(Math::IntPoint size, Math::IntPoint& pos);
 
     void        DrawString(const std::string &text, std::vector<FontMetaChar>::iterator format,
                            std::vector<FontMetaChar>::iterator end,
@@ -318,6 +326,10 @@ protected:
                            float size, Math::Point pos, float width, int eol, Color color);
     void        DrawHighlight(FontHighlight hl, Math::Point pos, Math::Point size);
     void        DrawCharAndAdjustPos(UTF8Char ch, FontType font, float size, Math::Point &pos, Color color);
+    //! Adds a character quad to the pending batch, drawing the batch first if texture or color differ
+    void        BatchCharQuad(const CharTexture& tex, Math::Point p1, Math::Point p2, Color color);
+    //! Draws the pending batch of character quads
+    void        FlushCharQuads();
     void        StringToUTFCharList(const std::string &text, std::vector<UTF8Char> &chars);
     void        StringToUTFCharList(const std::string &text, std::vector<UTF8Char> &chars, std::vector<FontMetaChar>::iterator format, std::vector<FontMetaChar>::iterator end);
 
@@ -334,6 +346,14 @@ protected:
     FontType     m_lastFontType;
     int          m_lastFontSize;
     CachedFont*  m_lastCachedFont;
+
+    //! Atlas pages shared by characters of all fonts and sizes
+    std::vector<std::unique_ptr<FontTexture>> m_fontTextures;
+
+    //! Character quads waiting to be drawn, as a triangle list
+    std::vector<Vertex> m_quads;
+    unsigned int m_quadTexture;
+    Color        m_quadColor;
 };
 
 
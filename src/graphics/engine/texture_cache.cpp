@@ -0,0 +1,319 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+
+#include "graphics/engine/texture_cache.h"
+
+#include "common/ioutils.h"
+#include "common/logger.h"
+#include "common/make_unique.h"
+
+#include "common/resources/inputstream.h"
+#include "common/resources/outputstream.h"
+#include "common/resources/resourcemanager.h"
+
+#include "math/func.h"
+
+#include <cstring>
+#include <vector>
+
+#include <SDL.h>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+namespace
+{
+
+const char BAKED_TEXTURE_MAGIC[4] = { 'C', 'T', 'E', 'X' };
+
+//! Returns bytes from one row to the next of a stored level, padded to a multiple of 4
+std::size_t GetLevelPitch(int width, int bytesPerPixel)
+{
+    return (width * bytesPerPixel + 3) & ~3;
+}
+
+//! Returns the number of mipmap levels of image with given size, down to 1x1
+int GetLevelCount(int width, int height)
+{
+    int count = 1;
+    while (width > 1 || height > 1)
+    {
+        width = Math::Max(width / 2, 1);
+        height = Math::Max(height / 2, 1);
+        ++count;
+    }
+    return count;
+}
+
+//! Returns the next mipmap level of \a pixels, averaging each 2x2 block of pixels
+std::vector<unsigned char> Downsample(const std::vector<unsigned char>& pixels, int width, int height, int bytesPerPixel)
+{
+    int newWidth = Math::Max(width / 2, 1);
+    int newHeight = Math::Max(height / 2, 1);
+    std::size_t pitch = GetLevelPitch(width, bytesPerPixel);
+    std::size_t newPitch = GetLevelPitch(newWidth, bytesPerPixel);
+
+    std::vector<unsigned char> result(newPitch * newHeight, 0);
+    for (int y = 0; y < newHeight; ++y)
+    {
+        // Odd sizes repeat the last row or column
+        const unsigned char* row0 = &pixels[2 * y * pitch];
+        const unsigned char* row1 = &pixels[Math::Min(2 * y + 1, height - 1) * pitch];
+        for (int x = 0; x < newWidth; ++x)
+        {
+            int x0 = 2 * x * bytesPerPixel;
+            int x1 = Math::Min(2 * x + 1, width - 1) * bytesPerPixel;
+            for (int c = 0; c < bytesPerPixel; ++c)
+            {
+                int sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                result[y * newPitch + x * bytesPerPixel + c] = static_cast<unsigned char>((sum + 2) / 4);
+            }
+        }
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+
+CBakedTexture::CBakedTexture()
+{
+}
+
+CBakedTexture::~CBakedTexture()
+{
+    for (ImageData& level : m_levels)
+        SDL_FreeSurface(level.surface);  // does not free the mapped pixels
+}
+
+bool CBakedTexture::Open(const std::string& path, uint64_t sourceHash)
+{
+    if (!m_file.Open(path))
+        return false;
+
+    if (m_file.GetSize() < sizeof(BakedTextureHeader))
+        return false;
+
+    BakedTextureHeader header;
+    memcpy(&header, m_file.GetData(), sizeof(BakedTextureHeader));
+
+    if (memcmp(header.magic, BAKED_TEXTURE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CTextureCache::VERSION ||
+        header.sourceHash != sourceHash)
+        return false;
+
+    if (header.bytesPerPixel != 3 && header.bytesPerPixel != 4)
+        return false;
+
+    std::size_t pitch = header.pitch;
+    if (pitch < header.width * header.bytesPerPixel || pitch % 4 != 0)
+        return false;
+
+    if (header.originalWidth > header.width || header.originalHeight > header.height)
+        return false;
+
+    if (header.levelCount != static_cast<uint32_t>(GetLevelCount(header.width, header.height)))
+        return false;
+
+    m_originalSize = Math::IntPoint(header.originalWidth, header.originalHeight);
+
+    std::size_t offset = sizeof(BakedTextureHeader);
+    int width = header.width;
+    int height = header.height;
+    for (uint32_t i = 0; i < header.levelCount; ++i)
+    {
+        if (i > 0)
+        {
+            width = Math::Max(width / 2, 1);
+            height = Math::Max(height / 2, 1);
+            pitch = GetLevelPitch(width, header.bytesPerPixel);
+        }
+
+        if (m_file.GetSize() < offset + pitch * height)
+            return false;
+
+        ImageData level;
+        void* pixels = const_cast<unsigned char*>(m_file.GetData() + offset);
+        level.surface = SDL_CreateRGBSurfaceFrom(pixels, width, height, header.bytesPerPixel * 8, pitch,
+                                                 header.rmask, header.gmask, header.bmask, header.amask);
+        if (level.surface == nullptr)
+            return false;
+
+        m_levels.push_back(level);
+        offset += pitch * height;
+    }
+
+    return true;
+}
+
+std::vector<ImageData*> CBakedTexture::GetLevels()
+{
+    std::vector<ImageData*> levels;
+    for (ImageData& level : m_levels)
+        levels.push_back(&level);
+
+    return levels;
+}
+
+Math::IntPoint CBakedTexture::GetSize() const
+{
+    if (m_levels.empty())
+        return Math::IntPoint();
+
+    return Math::IntPoint(m_levels[0].surface->w, m_levels[0].surface->h);
+}
+
+Math::IntPoint CBakedTexture::GetOriginalSize() const
+{
+    return m_originalSize;
+}
+
+bool CBakedTexture::MatchesPadding(bool pad) const
+{
+    Math::IntPoint size = GetSize();
+    if (pad)
+        return Math::IsPowerOfTwo(size.x) && Math::IsPowerOfTwo(size.y);
+
+    return size == m_originalSize;
+}
+
+
+CTextureCache::CTextureCache(const std::string& directory)
+    : m_directory(directory)
+{
+}
+
+bool CTextureCache::GetSourceHash(const std::string& name, uint64_t& hash)
+{
+    CInputStream stream;
+    stream.open(name);
+    if (!stream.is_open())
+        return false;
+
+    hash = IOUtils::HashStream(stream);
+    return true;
+}
+
+std::unique_ptr<CBakedTexture> CTextureCache::Load(const std::string& name, uint64_t sourceHash) const
+{
+    std::string saveLocation = CResourceManager::GetSaveLocation();
+    if (saveLocation.empty())
+        return nullptr;
+
+    auto baked = MakeUnique<CBakedTexture>();
+    if (!baked->Open(saveLocation + "/" + GetCachePath(name), sourceHash))
+        return nullptr;
+
+    return baked;
+}
+
+bool CTextureCache::Store(const std::string& name, uint64_t sourceHash, CImage& image, Math::IntPoint originalSize) const
+{
+    if (image.IsEmpty() || CResourceManager::GetSaveLocation().empty())
+        return false;
+
+    SDL_Surface* surface = image.GetData()->surface;
+    SDL_PixelFormat* format = surface->format;
+    if (format->BytesPerPixel != 3 && format->BytesPerPixel != 4)
+        return false;
+
+    BakedTextureHeader header;
+    memcpy(header.magic, BAKED_TEXTURE_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.sourceHash = sourceHash;
+    header.width = surface->w;
+    header.height = surface->h;
+    header.bytesPerPixel = format->BytesPerPixel;
+    header.rmask = format->Rmask;
+    header.gmask = format->Gmask;
+    header.bmask = format->Bmask;
+    header.amask = format->Amask;
+    header.pitch = GetLevelPitch(surface->w, format->BytesPerPixel);
+    header.originalWidth = originalSize.x;
+    header.originalHeight = originalSize.y;
+    header.levelCount = GetLevelCount(surface->w, surface->h);
+    header.reserved = 0;
+
+    std::string path = GetCachePath(name);
+    std::string directory = path.substr(0, path.find_last_of('/'));
+    if (!CResourceManager::DirectoryExists(directory) && !CResourceManager::CreateDirectory(directory))
+    {
+        GetLogger()->Warn("Couldn't create texture cache directory '%s'\n", directory.c_str());
+        return false;
+    }
+
+    // Written under a temporary name, so that a reader never maps an unfinished file
+    std::string tempPath = path + "." + std::to_string(SDL_ThreadID()) + ".tmp";
+    {
+        COutputStream stream;
+        stream.open(tempPath);
+        if (!stream.is_open())
+            return false;
+
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(BakedTextureHeader));
+
+        // Rows are padded with zeros up to the pitch
+        std::size_t rowSize = surface->w * format->BytesPerPixel;
+        std::vector<unsigned char> level(header.pitch * surface->h, 0);
+        const unsigned char* pixels = static_cast<const unsigned char*>(surface->pixels);
+        for (int y = 0; y < surface->h; ++y)
+            memcpy(&level[y * header.pitch], pixels + y * surface->pitch, rowSize);
+
+        int width = surface->w;
+        int height = surface->h;
+        for (uint32_t i = 0; i < header.levelCount; ++i)
+        {
+            if (i > 0)
+            {
+                level = Downsample(level, width, height, format->BytesPerPixel);
+                width = Math::Max(width / 2, 1);
+                height = Math::Max(height / 2, 1);
+            }
+
+            stream.write(reinterpret_cast<const char*>(level.data()), level.size());
+        }
+
+        bool ok = !stream.fail();
+        stream.close();
+        if (!ok)
+        {
+            CResourceManager::Remove(tempPath);
+            return false;
+        }
+    }
+
+    if (!CResourceManager::Move(tempPath, path))
+    {
+        CResourceManager::Remove(tempPath);
+        return false;
+    }
+
+    return true;
+}
+
+std::string CTextureCache::GetCachePath(const std::string& name) const
+{
+    return m_directory + "/" + CResourceManager::CleanPath(name) + ".ctex";
+}
+
+} // namespace Gfx
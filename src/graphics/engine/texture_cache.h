@@ -0,0 +1,160 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+/**
+ * \file graphics/engine/texture_cache.h
+ * \brief Cache of decoded texture images - CTextureCache
+ */
+
+#pragma once
+
+#include "common/image.h"
+
+#include "common/resources/mapped_file.h"
+
+#include "math/intpoint.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \struct BakedTextureHeader
+ * \brief Header of texture cache file
+ *
+ * The header is followed by rows of pixels, \a pitch bytes apart, exactly
+ * as in the SDL surface described by the header. The image is stored as it
+ * is given to the device, converted to 24 or 32 bits and possibly padded to
+ * powers of two. Rows start at multiples of
+ * 4 bytes, as OpenGL expects with the default GL_UNPACK_ALIGNMENT. Values are
+ * stored in native byte order, as the cache is never moved between machines.
+ *
+ * The image is followed by its mipmap levels, each half the size of the
+ * previous one (rounded down, at least 1) down to 1x1, in the same format.
+ * Their rows are also padded to multiples of 4 bytes.
+ */
+struct BakedTextureHeader
+{
+    //! "CTEX"
+    char magic[4];
+    //! Format version, see CTextureCache::VERSION
+    uint32_t version;
+    //! Hash of the contents of source file
+    uint64_t sourceHash;
+    //! Image dimensions
+    uint32_t width;
+    uint32_t height;
+    //! 3 or 4
+    uint32_t bytesPerPixel;
+    //! Masks of color components, as in SDL_PixelFormat
+    uint32_t rmask;
+    uint32_t gmask;
+    uint32_t bmask;
+    uint32_t amask;
+    //! Bytes from one row to the next, a multiple of 4
+    uint32_t pitch;
+    //! Image dimensions before padding to powers of two
+    uint32_t originalWidth;
+    uint32_t originalHeight;
+    //! Number of stored mipmap levels, including the full size image
+    uint32_t levelCount;
+    //! Unused, keeps the pixel data 16-byte aligned
+    uint32_t reserved;
+};
+
+/**
+ * \class CBakedTexture
+ * \brief Texture image mapped from the cache
+ *
+ * The surfaces of the image and of its mipmap levels point straight into the
+ * mapped file, so they can be given to CDevice::CreateTexture() without
+ * copying. They must not be modified.
+ */
+class CBakedTexture
+{
+public:
+    CBakedTexture();
+    ~CBakedTexture();
+
+    CBakedTexture(const CBakedTexture&) = delete;
+    CBakedTexture& operator=(const CBakedTexture&) = delete;
+
+    //! Maps cache file at real \a path; fails if it is invalid or not made from source with \a sourceHash
+    bool Open(const std::string& path, uint64_t sourceHash);
+
+    //! Returns the image data of each mipmap level, starting from the full size image
+    std::vector<ImageData*> GetLevels();
+    //! Returns the image size
+    Math::IntPoint GetSize() const;
+    //! Returns the image size before padding to powers of two
+    Math::IntPoint GetOriginalSize() const;
+    //! Returns whether the image is padded to powers of two if \a pad, or not padded otherwise
+    bool MatchesPadding(bool pad) const;
+
+private:
+    CMappedFile m_file;
+    std::vector<ImageData> m_levels;
+    Math::IntPoint m_originalSize;
+};
+
+/**
+ * \class CTextureCache
+ * \brief Stores decoded texture images in the save location
+ *
+ * Reading a texture from cache means mapping one file, instead of decoding
+ * a PNG. Cache files are checked against the hash of the source file, so
+ * a changed texture is decoded again and its cache file replaced. The cache
+ * is filled as textures are loaded or beforehand with the bake_textures tool.
+ *
+ * All functions may be called from any thread.
+ */
+class CTextureCache
+{
+public:
+    //! Version of file format, increased on each change
+    static const uint32_t VERSION = 4;
+
+    //! Creates cache in \a directory of the save location
+    explicit CTextureCache(const std::string& directory = "texture_cache");
+
+    //! Computes hash of the contents of texture file \a name; returns false if the file cannot be read
+    static bool GetSourceHash(const std::string& name, uint64_t& hash);
+
+    //! Returns the cached image of texture \a name or nullptr if there is none made from source with \a sourceHash
+    std::unique_ptr<CBakedTexture> Load(const std::string& name, uint64_t sourceHash) const;
+    //! Stores \a image of texture \a name, as given to the device, in the cache together with its mipmap levels
+    /** \a originalSize is the size of the image before padding to powers of two */
+    bool Store(const std::string& name, uint64_t sourceHash, CImage& image, Math::IntPoint originalSize) const;
+
+private:
+    //! Returns path of cache file for texture \a name, relative to the save location
+    std::string GetCachePath(const std::string& name) const;
+
+private:
+    std::string m_directory;
+};
+
+} // namespace Gfx
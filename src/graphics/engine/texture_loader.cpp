@@ -0,0 +1,243 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+
+#include "graphics/engine/texture_loader.h"
+
+#include "common/image.h"
+#include "common/logger.h"
+#include "common/make_unique.h"
+
+#include "graphics/engine/texture_cache.h"
+
+#include <algorithm>
+#include <thread>
+
+#include <SDL.h>
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+CTextureLoader::CTextureLoader(CTextureCache* cache, int threadCount)
+    : m_cache(cache)
+{
+    // Reading files is a large part of the work, so a few threads are enough;
+    // at least one is needed even with a single core
+    if (threadCount < 0)
+        threadCount = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    threadCount = std::max(1, std::min(threadCount, 4));
+
+    for (int i = 0; i < threadCount; ++i)
+    {
+        SDL_Thread* thread = SDL_CreateThread(WorkerMain, this);
+        if (thread == nullptr)
+        {
+            GetLogger()->Warn("Could not create texture loader thread, using %d threads\n", i);
+            break;
+        }
+        m_threads.push_back(thread);
+    }
+}
+
+CTextureLoader::~CTextureLoader()
+{
+    SDL_LockMutex(*m_mutex);
+    m_quit = true;
+    m_jobs.clear();
+    SDL_CondBroadcast(*m_jobCond);
+    SDL_UnlockMutex(*m_mutex);
+
+    for (SDL_Thread* thread : m_threads)
+        SDL_WaitThread(thread, nullptr);
+}
+
+void CTextureLoader::Request(const std::string& name, const TextureCreateParams& params)
+{
+    if (m_pending.find(name) != m_pending.end())
+        return;
+
+    Job job;
+    job.id = m_nextId++;
+    job.name = name;
+    job.pad = params.padToNearestPowerOfTwo;
+
+    Pending pending;
+    pending.id = job.id;
+    pending.params = params;
+    m_pending[name] = pending;
+
+    if (m_threads.empty())
+    {
+        // No threads could be created, so load at the next GetLoaded()
+        m_results.push_back(Decode(job));
+        return;
+    }
+
+    SDL_LockMutex(*m_mutex);
+    m_jobs.push_back(job);
+    SDL_CondSignal(*m_jobCond);
+    SDL_UnlockMutex(*m_mutex);
+}
+
+bool CTextureLoader::IsPending(const std::string& name) const
+{
+    return m_pending.find(name) != m_pending.end();
+}
+
+bool CTextureLoader::HasPending() const
+{
+    return !m_pending.empty();
+}
+
+void CTextureLoader::Cancel(const std::string& name)
+{
+    auto it = m_pending.find(name);
+    if (it == m_pending.end())
+        return;
+
+    m_pending.erase(it);
+
+    SDL_LockMutex(*m_mutex);
+    m_jobs.erase(std::remove_if(m_jobs.begin(), m_jobs.end(),
+                                [&name](const Job& job) { return job.name == name; }),
+                 m_jobs.end());
+    SDL_UnlockMutex(*m_mutex);
+}
+
+void CTextureLoader::CancelAll()
+{
+    m_pending.clear();
+
+    SDL_LockMutex(*m_mutex);
+    m_jobs.clear();
+    m_results.clear();
+    SDL_UnlockMutex(*m_mutex);
+}
+
+int CTextureLoader::GetLoaded(std::vector<LoadedTexture>& loaded, int maxCount)
+{
+    int count = 0;
+
+    SDL_LockMutex(*m_mutex);
+    while (count < maxCount && !m_results.empty())
+    {
+        Result result = std::move(m_results.front());
+        m_results.pop_front();
+
+        // Results of cancelled requests, possibly requested again since
+        auto it = m_pending.find(result.name);
+        if (it == m_pending.end() || it->second.id != result.id)
+            continue;
+
+        LoadedTexture texture;
+        texture.name = result.name;
+        texture.params = it->second.params;
+        texture.baked = std::move(result.baked);
+        texture.image = std::move(result.image);
+        texture.originalSize = result.originalSize;
+        texture.error = result.error;
+        loaded.push_back(std::move(texture));
+
+        m_pending.erase(it);
+        count++;
+    }
+    SDL_UnlockMutex(*m_mutex);
+
+    return count;
+}
+
+int CTextureLoader::WorkerMain(void* data)
+{
+    static_cast<CTextureLoader*>(data)->WorkerLoop();
+    return 0;
+}
+
+void CTextureLoader::WorkerLoop()
+{
+    SDL_LockMutex(*m_mutex);
+    for (;;)
+    {
+        while (!m_quit && m_jobs.empty())
+            SDL_CondWait(*m_jobCond, *m_mutex);
+
+        if (m_quit)
+            break;
+
+        Job job = m_jobs.front();
+        m_jobs.pop_front();
+        SDL_UnlockMutex(*m_mutex);
+
+        Result result = Decode(job);
+
+        SDL_LockMutex(*m_mutex);
+        m_results.push_back(std::move(result));
+    }
+    SDL_UnlockMutex(*m_mutex);
+}
+
+CTextureLoader::Result CTextureLoader::Decode(const Job& job)
+{
+    Result result;
+    result.id = job.id;
+    result.name = job.name;
+
+    uint64_t sourceHash = 0;
+    bool hashed = m_cache != nullptr && CTextureCache::GetSourceHash(job.name, sourceHash);
+
+    bool cached = false;
+    if (hashed)
+    {
+        std::unique_ptr<CBakedTexture> baked = m_cache->Load(job.name, sourceHash);
+        cached = baked != nullptr;
+        if (cached && baked->MatchesPadding(job.pad))
+        {
+            result.originalSize = baked->GetOriginalSize();
+            result.baked = std::move(baked);
+            return result;
+        }
+    }
+
+    auto image = MakeUnique<CImage>();
+    if (!image->Load(job.name))
+    {
+        result.error = image->GetError();
+        return result;
+    }
+
+    // Formats other than 24 and 32 bit are not handled by the devices
+    int bpp = image->GetData()->surface->format->BytesPerPixel;
+    if (bpp != 3 && bpp != 4)
+        image->ConvertToRGBA();
+
+    result.originalSize = image->GetSize();
+    if (job.pad)
+        image->PadToNearestPowerOfTwo();
+
+    // A texture loaded both with and without padding keeps the first one cached
+    if (hashed && !cached)
+        m_cache->Store(job.name, sourceHash, *image, result.originalSize);
+
+    result.image = std::move(image);
+    return result;
+}
+
+} // namespace Gfx
@@ -0,0 +1,152 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+/**
+ * \file graphics/engine/texture_loader.h
+ * \brief Background decoding of texture images - CTextureLoader
+ */
+
+#pragma once
+
+#include "common/thread/sdl_cond_wrapper.h"
+#include "common/thread/sdl_mutex_wrapper.h"
+
+#include "graphics/core/texture.h"
+
+#include "math/intpoint.h"
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+class CImage;
+
+// Graphics module namespace
+namespace Gfx
+{
+
+class CBakedTexture;
+class CTextureCache;
+
+/**
+ * \struct LoadedTexture
+ * \brief Texture image decoded by CTextureLoader, ready to be uploaded
+ */
+struct LoadedTexture
+{
+    //! Name of texture file
+    std::string name;
+    //! Parameters given in CTextureLoader::Request()
+    TextureCreateParams params;
+    //! Image from texture cache, if it was there
+    std::unique_ptr<CBakedTexture> baked;
+    //! Decoded image, nullptr if loading failed or the image was in cache
+    std::unique_ptr<CImage> image;
+    //! Size of image before padding
+    Math::IntPoint originalSize;
+    //! Error message if loading failed
+    std::string error;
+};
+
+/**
+ * \class CTextureLoader
+ * \brief Loads and decodes texture images on background threads
+ *
+ * Request() queues a texture file; a background thread maps it from
+ * \a cache or reads it, decodes it, stores it in \a cache and converts it
+ * to a format the device can upload directly, including padding if requested. Finished images are collected on the main thread
+ * with GetLoaded(), which is where the textures must be created, as the
+ * device can only be used from the main thread.
+ *
+ * All public functions must be called from the main thread.
+ */
+class CTextureLoader
+{
+public:
+    //! Creates the loader; \a cache may be nullptr, \a threadCount < 0 chooses the count from the number of cores
+    explicit CTextureLoader(CTextureCache* cache, int threadCount = -1);
+    ~CTextureLoader();
+
+    CTextureLoader(const CTextureLoader&) = delete;
+    CTextureLoader& operator=(const CTextureLoader&) = delete;
+
+    //! Queues loading of texture \a name; does nothing if it is already pending
+    void Request(const std::string& name, const TextureCreateParams& params);
+    //! Returns whether texture \a name is requested and not yet collected
+    bool IsPending(const std::string& name) const;
+    //! Returns whether any texture is requested and not yet collected
+    bool HasPending() const;
+
+    //! Forgets the request for \a name; a late result is discarded
+    void Cancel(const std::string& name);
+    //! Forgets all requests
+    void CancelAll();
+
+    //! Moves at most \a maxCount finished textures to \a loaded; returns the number moved
+    int GetLoaded(std::vector<LoadedTexture>& loaded, int maxCount);
+
+private:
+    struct Job
+    {
+        int id;
+        std::string name;
+        bool pad;
+    };
+
+    struct Result
+    {
+        int id;
+        std::string name;
+        std::unique_ptr<CBakedTexture> baked;
+        std::unique_ptr<CImage> image;
+        Math::IntPoint originalSize;
+        std::string error;
+    };
+
+    struct Pending
+    {
+        int id;
+        TextureCreateParams params;
+    };
+
+    static int WorkerMain(void* data);
+    void WorkerLoop();
+    Result Decode(const Job& job);
+
+private:
+    CTextureCache* m_cache;
+    std::vector<SDL_Thread*> m_threads;
+    CSDLMutexWrapper m_mutex;
+    CSDLCondWrapper m_jobCond;
+    //! Jobs not yet taken by a thread, guarded by m_mutex
+    std::deque<Job> m_jobs;
+    //! Results not yet collected, guarded by m_mutex
+    std::deque<Result> m_results;
+    bool m_quit = false;
+
+    //! Requests not yet collected, used only by the main thread
+    std::map<std::string, Pending> m_pending;
+    int m_nextId = 1;
+};
+
+} // namespace Gfx
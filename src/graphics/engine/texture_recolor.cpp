@@ -0,0 +1,525 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+#include "graphics/engine/texture_recolor.h"
+
+#include "common/image.h"
+#include "common/make_unique.h"
+
+#include "math/func.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <SDL.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define COLOBOT_RECOLOR_SSE2
+#endif
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+namespace
+{
+
+#ifdef COLOBOT_RECOLOR_SSE2
+
+inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+inline __m128 Norm(__m128 value)
+{
+    return _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+}
+
+inline __m128 Abs(__m128 value)
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), value);
+}
+
+//! Returns mask of |dr| + |dg| + |db| < tolerance, summed in double precision like the scalar loop
+inline __m128 DistanceBelow(__m128 dr, __m128 dg, __m128 db, double tolerance)
+{
+    const __m128d sign = _mm_set1_pd(-0.0);
+    __m128d limit = _mm_set1_pd(tolerance);
+
+    __m128d lo = _mm_add_pd(_mm_add_pd(_mm_andnot_pd(sign, _mm_cvtps_pd(dr)),
+                                       _mm_andnot_pd(sign, _mm_cvtps_pd(dg))),
+                            _mm_andnot_pd(sign, _mm_cvtps_pd(db)));
+    __m128d hi = _mm_add_pd(_mm_add_pd(_mm_andnot_pd(sign, _mm_cvtps_pd(_mm_movehl_ps(dr, dr))),
+                                       _mm_andnot_pd(sign, _mm_cvtps_pd(_mm_movehl_ps(dg, dg)))),
+                            _mm_andnot_pd(sign, _mm_cvtps_pd(_mm_movehl_ps(db, db))));
+
+    // Each 64-bit mask is two equal 32-bit halves, take one of each
+    return _mm_shuffle_ps(_mm_castpd_ps(_mm_cmplt_pd(lo, limit)),
+                          _mm_castpd_ps(_mm_cmplt_pd(hi, limit)),
+                          _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+inline void StoreChanged(char* changed, __m128 mask)
+{
+    int bits = _mm_movemask_ps(mask);
+    changed[0] = (bits >> 0) & 1;
+    changed[1] = (bits >> 1) & 1;
+    changed[2] = (bits >> 2) & 1;
+    changed[3] = (bits >> 3) & 1;
+}
+
+#endif // COLOBOT_RECOLOR_SSE2
+
+//! Returns true if pixel lies in one of the rectangles of \a exclude (in 256x256 texture coordinates)
+bool IsExcluded(const Math::Point* exclude, int x, int y)
+{
+    int i = 0;
+    while ( exclude[i+0].x != 0.0f || exclude[i+0].y != 0.0f ||
+            exclude[i+1].y != 0.0f || exclude[i+1].y != 0.0f )
+    {
+        if ( x >= static_cast<int>(exclude[i+0].x*256.0f) &&
+             x <  static_cast<int>(exclude[i+1].x*256.0f) &&
+             y >= static_cast<int>(exclude[i+0].y*256.0f) &&
+             y <  static_cast<int>(exclude[i+1].y*256.0f) )
+            return true;
+
+        i += 2;
+    }
+
+    return false;
+}
+
+void AppendFloat(std::string& key, float value)
+{
+    char bytes[sizeof(float)];
+    memcpy(bytes, &value, sizeof(float));
+    key.append(bytes, sizeof(float));
+}
+
+void AppendColor(std::string& key, const Color& color)
+{
+    AppendFloat(key, color.r);
+    AppendFloat(key, color.g);
+    AppendFloat(key, color.b);
+}
+
+std::unique_ptr<CImage> CopyImage(CImage& image)
+{
+    auto copy = MakeUnique<CImage>(image.GetSize());
+
+    // Copy alpha as it is instead of blending with it
+    SDL_Surface* surface = image.GetData()->surface;
+    Uint32 flags = surface->flags;
+    surface->flags &= ~SDL_SRCALPHA;
+    SDL_BlitSurface(surface, nullptr, copy->GetData()->surface, nullptr);
+    surface->flags = flags;
+
+    return copy;
+}
+
+} // anonymous namespace
+
+
+void RecolorPixels(const RecolorParams& params, float* r, float* g, float* b, char* changed, int count)
+{
+    // The SSE2 loops do four pixels at a time with the same operations in the
+    // same order as the scalar loops, which do the rest
+    int i = 0;
+
+    if (params.hsv)
+    {
+        ColorHSV cr1 = RGB2HSV(params.colorRef1);
+        ColorHSV cn1 = RGB2HSV(params.colorNew1);
+        ColorHSV cr2 = RGB2HSV(params.colorRef2);
+        ColorHSV cn2 = RGB2HSV(params.colorNew2);
+        bool useSecond = params.tolerance2 != -1.0f;
+
+#ifdef COLOBOT_RECOLOR_SSE2
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 useSecondMask = _mm_castsi128_ps(_mm_set1_epi32(useSecond ? -1 : 0));
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 vr = _mm_loadu_ps(r + i);
+            __m128 vg = _mm_loadu_ps(g + i);
+            __m128 vb = _mm_loadu_ps(b + i);
+
+            // RGB2HSV()
+            __m128 min = _mm_min_ps(_mm_min_ps(vr, vg), vb);
+            __m128 max = _mm_max_ps(_mm_max_ps(vr, vg), vb);
+            __m128 delta = _mm_sub_ps(max, min);
+
+            __m128 hueDelta = Select(_mm_cmpgt_ps(delta, zero), delta, one);
+            __m128 hr = _mm_div_ps(_mm_sub_ps(vg, vb), hueDelta);
+            __m128 hg = _mm_add_ps(_mm_set1_ps(2.0f), _mm_div_ps(_mm_sub_ps(vb, vr), hueDelta));
+            __m128 hb = _mm_add_ps(_mm_set1_ps(4.0f), _mm_div_ps(_mm_sub_ps(vr, vg), hueDelta));
+            __m128 h = Select(_mm_cmpeq_ps(vr, max), hr, Select(_mm_cmpeq_ps(vg, max), hg, hb));
+            h = _mm_mul_ps(h, _mm_set1_ps(60.0f));
+            h = Select(_mm_cmplt_ps(h, zero), _mm_add_ps(h, _mm_set1_ps(360.0f)), h);
+            h = _mm_div_ps(h, _mm_set1_ps(360.0f));
+
+            __m128 s = _mm_div_ps(delta, Select(_mm_cmpgt_ps(max, zero), max, one));
+            __m128 v = max;
+
+            __m128 saturated = _mm_cmpgt_ps(s, _mm_set1_ps(0.01f));
+            __m128 first = _mm_and_ps(saturated,
+                _mm_cmplt_ps(Abs(_mm_sub_ps(h, _mm_set1_ps(cr1.h))), _mm_set1_ps(params.tolerance1)));
+            __m128 second = _mm_andnot_ps(first, _mm_and_ps(_mm_and_ps(saturated, useSecondMask),
+                _mm_cmplt_ps(Abs(_mm_sub_ps(h, _mm_set1_ps(cr2.h))), _mm_set1_ps(params.tolerance2))));
+
+            h = _mm_add_ps(h, Select(first, _mm_set1_ps(cn1.h - cr1.h), _mm_set1_ps(cn2.h - cr2.h)));
+            s = _mm_add_ps(s, Select(first, _mm_set1_ps(cn1.s - cr1.s), _mm_set1_ps(cn2.s - cr2.s)));
+            v = _mm_add_ps(v, Select(first, _mm_set1_ps(cn1.v - cr1.v), _mm_set1_ps(cn2.v - cr2.v)));
+            h = Select(_mm_cmplt_ps(h, zero), _mm_sub_ps(h, one), h);
+            h = Select(_mm_cmpgt_ps(h, one), _mm_add_ps(h, one), h);
+
+            // HSV2RGB()
+            h = _mm_mul_ps(Norm(h), _mm_set1_ps(360.0f));
+            s = Norm(s);
+            v = Norm(v);
+
+            h = Select(_mm_cmpeq_ps(h, _mm_set1_ps(360.0f)), zero, h);
+            h = _mm_div_ps(h, _mm_set1_ps(60.0f));
+            __m128 f = _mm_sub_ps(h, _mm_cvtepi32_ps(_mm_cvttps_epi32(h)));
+
+            __m128 p = _mm_mul_ps(v, _mm_sub_ps(one, s));
+            __m128 q = _mm_mul_ps(v, _mm_sub_ps(one, _mm_mul_ps(s, f)));
+            __m128 t = _mm_mul_ps(v, _mm_sub_ps(one, _mm_mul_ps(s, _mm_sub_ps(one, f))));
+
+            // Integer part of h is the sector, selected from the last one down
+            __m128 nr = v, ng = p, nb = q;
+            __m128 below = _mm_cmplt_ps(h, _mm_set1_ps(5.0f));
+            nr = Select(below, t, nr);
+            nb = Select(below, v, nb);
+            below = _mm_cmplt_ps(h, _mm_set1_ps(4.0f));
+            nr = Select(below, p, nr);
+            ng = Select(below, q, ng);
+            below = _mm_cmplt_ps(h, _mm_set1_ps(3.0f));
+            ng = Select(below, v, ng);
+            nb = Select(below, t, nb);
+            below = _mm_cmplt_ps(h, _mm_set1_ps(2.0f));
+            nr = Select(below, q, nr);
+            nb = Select(below, p, nb);
+            below = _mm_cmplt_ps(h, one);
+            nr = Select(below, v, nr);
+            ng = Select(below, t, ng);
+
+            __m128 gray = _mm_cmpeq_ps(s, zero);
+            nr = Select(gray, v, nr);
+            ng = Select(gray, v, ng);
+            nb = Select(gray, v, nb);
+
+            __m128 shift = _mm_set1_ps(params.shift);
+            __m128 apply = _mm_or_ps(first, second);
+            _mm_storeu_ps(r + i, Select(apply, Norm(_mm_add_ps(nr, shift)), vr));
+            _mm_storeu_ps(g + i, Select(apply, Norm(_mm_add_ps(ng, shift)), vg));
+            _mm_storeu_ps(b + i, Select(apply, Norm(_mm_add_ps(nb, shift)), vb));
+            StoreChanged(changed + i, apply);
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            // RGB2HSV()
+            float min = Math::Min(r[i], g[i], b[i]);
+            float max = Math::Max(r[i], g[i], b[i]);
+            float delta = max-min;
+
+            // Gray pixels get hue 0 instead of 0/0; they are never changed anyway
+            float hueDelta = delta > 0.0f ? delta : 1.0f;
+            float h = r[i] == max ? (g[i]-b[i])/hueDelta :
+                      g[i] == max ? 2.0f+(b[i]-r[i])/hueDelta :
+                                    4.0f+(r[i]-g[i])/hueDelta;
+            h *= 60.0f;
+            if (h < 0.0f) h += 360.0f;
+            h /= 360.0f;
+
+            float s = max > 0.0f ? delta/max : 0.0f;
+            float v = max;
+
+            bool first = s > 0.01f && std::fabs(h - cr1.h) < params.tolerance1;
+            bool second = !first && useSecond && s > 0.01f && std::fabs(h - cr2.h) < params.tolerance2;
+            changed[i] = first || second;
+            if (!changed[i])
+                continue;
+
+            const ColorHSV& from = first ? cr1 : cr2;
+            const ColorHSV& to = first ? cn1 : cn2;
+            h += to.h - from.h;
+            s += to.s - from.s;
+            v += to.v - from.v;
+            if (h < 0.0f) h -= 1.0f;
+            if (h > 1.0f) h += 1.0f;
+
+            // HSV2RGB()
+            h = Math::Norm(h)*360.0f;
+            s = Math::Norm(s);
+            v = Math::Norm(v);
+
+            if (h == 360.0f) h = 0.0f;
+            h /= 60.0f;
+            float f = h-static_cast<int>(h);   // fractional part
+
+            float p = v*(1.0f-s);
+            float q = v*(1.0f-(s*f));
+            float t = v*(1.0f-(s*(1.0f-f)));
+
+            float nr, ng, nb;
+            if (s == 0.0f)     { nr = v; ng = v; nb = v; }  // gray
+            else if (h < 1.0f) { nr = v; ng = t; nb = p; }
+            else if (h < 2.0f) { nr = q; ng = v; nb = p; }
+            else if (h < 3.0f) { nr = p; ng = v; nb = t; }
+            else if (h < 4.0f) { nr = p; ng = q; nb = v; }
+            else if (h < 5.0f) { nr = t; ng = p; nb = v; }
+            else               { nr = v; ng = p; nb = q; }
+
+            r[i] = Math::Norm(nr + params.shift);
+            g[i] = Math::Norm(ng + params.shift);
+            b[i] = Math::Norm(nb + params.shift);
+        }
+    }
+    else
+    {
+        const Color& ref1 = params.colorRef1;
+        const Color& new1 = params.colorNew1;
+        const Color& ref2 = params.colorRef2;
+        const Color& new2 = params.colorNew2;
+        bool useSecond = params.tolerance2 != -1.0f;
+
+#ifdef COLOBOT_RECOLOR_SSE2
+        const __m128 shift = _mm_set1_ps(params.shift);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 vr = _mm_loadu_ps(r + i);
+            __m128 vg = _mm_loadu_ps(g + i);
+            __m128 vb = _mm_loadu_ps(b + i);
+
+            __m128 first = DistanceBelow(_mm_sub_ps(vr, _mm_set1_ps(ref1.r)),
+                                         _mm_sub_ps(vg, _mm_set1_ps(ref1.g)),
+                                         _mm_sub_ps(vb, _mm_set1_ps(ref1.b)), params.tolerance1 * 3.0f);
+            __m128 second = _mm_setzero_ps();
+            if (useSecond)
+            {
+                second = _mm_andnot_ps(first, DistanceBelow(_mm_sub_ps(vr, _mm_set1_ps(ref2.r)),
+                                                            _mm_sub_ps(vg, _mm_set1_ps(ref2.g)),
+                                                            _mm_sub_ps(vb, _mm_set1_ps(ref2.b)), params.tolerance2 * 3.0f));
+            }
+
+            __m128 nr = Select(first, _mm_sub_ps(_mm_add_ps(_mm_set1_ps(new1.r), vr), _mm_set1_ps(ref1.r)),
+                                      _mm_sub_ps(_mm_add_ps(_mm_set1_ps(new2.r), vr), _mm_set1_ps(ref2.r)));
+            __m128 ng = Select(first, _mm_sub_ps(_mm_add_ps(_mm_set1_ps(new1.g), vg), _mm_set1_ps(ref1.g)),
+                                      _mm_sub_ps(_mm_add_ps(_mm_set1_ps(new2.g), vg), _mm_set1_ps(ref2.g)));
+            __m128 nb = Select(first, _mm_sub_ps(_mm_add_ps(_mm_set1_ps(new1.b), vb), _mm_set1_ps(ref1.b)),
+                                      _mm_sub_ps(_mm_add_ps(_mm_set1_ps(new2.b), vb), _mm_set1_ps(ref2.b)));
+
+            __m128 apply = _mm_or_ps(first, second);
+            _mm_storeu_ps(r + i, Select(apply, Norm(_mm_add_ps(nr, shift)), vr));
+            _mm_storeu_ps(g + i, Select(apply, Norm(_mm_add_ps(ng, shift)), vg));
+            _mm_storeu_ps(b + i, Select(apply, Norm(_mm_add_ps(nb, shift)), vb));
+            StoreChanged(changed + i, apply);
+        }
+#endif
+
+        // Distances are summed in double precision, as they always were, so that
+        // pixels on the tolerance boundary are classified the same way
+        for (; i < count; i++)
+        {
+            bool first = std::fabs(static_cast<double>(r[i] - ref1.r)) +
+                         std::fabs(static_cast<double>(g[i] - ref1.g)) +
+                         std::fabs(static_cast<double>(b[i] - ref1.b)) < params.tolerance1 * 3.0f;
+            bool second = !first && useSecond &&
+                          std::fabs(static_cast<double>(r[i] - ref2.r)) +
+                          std::fabs(static_cast<double>(g[i] - ref2.g)) +
+                          std::fabs(static_cast<double>(b[i] - ref2.b)) < params.tolerance2 * 3.0f;
+            changed[i] = first || second;
+            if (!changed[i])
+                continue;
+
+            const Color& ref = first ? ref1 : ref2;
+            const Color& to  = first ? new1 : new2;
+            r[i] = Math::Norm(to.r + r[i] - ref.r + params.shift);
+            g[i] = Math::Norm(to.g + g[i] - ref.g + params.shift);
+            b[i] = Math::Norm(to.b + b[i] - ref.b + params.shift);
+        }
+    }
+}
+
+void RecolorImage(CImage& image, const RecolorParams& params,
+                  Math::IntPoint min, Math::IntPoint max, const Math::Point* exclude)
+{
+    SDL_Surface* surface = image.GetData()->surface;
+    int bpp = surface->format->BytesPerPixel;
+    if (bpp != 3 && bpp != 4)
+    {
+        image.ConvertToRGBA();
+        surface = image.GetData()->surface;
+        bpp = surface->format->BytesPerPixel;
+    }
+
+    int count = max.x - min.x;
+    if (count <= 0 || min.y >= max.y)
+        return;
+
+    std::vector<float> r(count), g(count), b(count);
+    std::vector<Uint8> a(count);
+    std::vector<char> changed(count);
+
+    for (int y = min.y; y < max.y; y++)
+    {
+        Uint8* row = static_cast<Uint8*>(surface->pixels) + y * surface->pitch + min.x * bpp;
+
+        for (int i = 0; i < count; i++)
+        {
+            Uint8* p = row + i * bpp;
+            Uint32 u = 0;
+            if (bpp == 4)
+                u = *reinterpret_cast<Uint32*>(p);
+            else if (SDL_BYTEORDER == SDL_BIG_ENDIAN)
+                u = (p[0] << 16) | (p[1] << 8) | p[2];
+            else
+                u = p[0] | (p[1] << 8) | (p[2] << 16);
+
+            Uint8 cr = 0, cg = 0, cb = 0;
+            SDL_GetRGBA(u, surface->format, &cr, &cg, &cb, &a[i]);
+            r[i] = cr / 255.0f;
+            g[i] = cg / 255.0f;
+            b[i] = cb / 255.0f;
+        }
+
+        RecolorPixels(params, r.data(), g.data(), b.data(), changed.data(), count);
+
+        for (int i = 0; i < count; i++)
+        {
+            if (!changed[i])
+                continue;
+            if (exclude != nullptr && IsExcluded(exclude, min.x + i, y))
+                continue;
+
+            // Same rounding as CImage::SetPixel(CImage::GetPixel())
+            Uint32 u = SDL_MapRGBA(surface->format,
+                                   static_cast<Uint8>(r[i] * 255.0f),
+                                   static_cast<Uint8>(g[i] * 255.0f),
+                                   static_cast<Uint8>(b[i] * 255.0f),
+                                   static_cast<Uint8>((a[i] / 255.0f) * 255.0f));
+
+            Uint8* p = row + i * bpp;
+            if (bpp == 4)
+            {
+                *reinterpret_cast<Uint32*>(p) = u;
+            }
+            else if (SDL_BYTEORDER == SDL_BIG_ENDIAN)
+            {
+                p[0] = (u >> 16) & 0xFF;
+                p[1] = (u >> 8) & 0xFF;
+                p[2] = u & 0xFF;
+            }
+            else
+            {
+                p[0] = u & 0xFF;
+                p[1] = (u >> 8) & 0xFF;
+                p[2] = (u >> 16) & 0xFF;
+            }
+        }
+    }
+}
+
+
+CTextureRecolorCache::CTextureRecolorCache(std::size_t maxEntries)
+    : m_maxEntries(maxEntries)
+{
+}
+
+CTextureRecolorCache::~CTextureRecolorCache()
+{
+}
+
+std::string CTextureRecolorCache::GetKey(const std::string& srcName, const RecolorParams& params,
+                                         Math::Point ts, Math::Point ti, const Math::Point* exclude)
+{
+    std::string key = srcName;
+    key += '\0';
+    AppendColor(key, params.colorRef1);
+    AppendColor(key, params.colorNew1);
+    AppendColor(key, params.colorRef2);
+    AppendColor(key, params.colorNew2);
+    AppendFloat(key, params.tolerance1);
+    AppendFloat(key, params.tolerance2);
+    AppendFloat(key, params.shift);
+    key += params.hsv ? '\1' : '\0';
+    AppendFloat(key, ts.x);
+    AppendFloat(key, ts.y);
+    AppendFloat(key, ti.x);
+    AppendFloat(key, ti.y);
+
+    if (exclude != nullptr)
+    {
+        for (int i = 0; exclude[i+0].x != 0.0f || exclude[i+0].y != 0.0f ||
+                        exclude[i+1].y != 0.0f || exclude[i+1].y != 0.0f; i += 2)
+        {
+            AppendFloat(key, exclude[i+0].x);
+            AppendFloat(key, exclude[i+0].y);
+            AppendFloat(key, exclude[i+1].x);
+            AppendFloat(key, exclude[i+1].y);
+        }
+    }
+
+    return key;
+}
+
+std::unique_ptr<CImage> CTextureRecolorCache::Get(const std::string& key)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+        return nullptr;
+
+    return CopyImage(*it->second);
+}
+
+void CTextureRecolorCache::Add(const std::string& key, CImage& image)
+{
+    if (image.IsEmpty())
+        return;
+
+    // Textures of a level are recolored together, so there is no point in keeping the oldest ones
+    if (m_entries.size() >= m_maxEntries)
+        m_entries.clear();
+
+    m_entries[key] = CopyImage(image);
+}
+
+void CTextureRecolorCache::Clear()
+{
+    m_entries.clear();
+}
+
+std::size_t CTextureRecolorCache::GetCount() const
+{
+    return m_entries.size();
+}
+
+
+} // namespace Gfx
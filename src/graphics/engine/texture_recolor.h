@@ -0,0 +1,122 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+/**
+ * \file graphics/engine/texture_recolor.h
+ * \brief Color changes of textures - RecolorParams and CTextureRecolorCache
+ */
+
+#pragma once
+
+
+#include "graphics/core/color.h"
+
+#include "math/intpoint.h"
+#include "math/point.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+
+class CImage;
+
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \struct RecolorParams
+ * \brief Color change done by CEngine::ChangeTextureColor()
+ *
+ * Pixels close to \a colorRef1 are moved towards \a colorNew1, the others
+ * close to \a colorRef2 towards \a colorNew2. Closeness is measured on hue
+ * if \a hsv is set, otherwise on the sum of RGB differences.
+ */
+struct RecolorParams
+{
+    Color colorRef1, colorNew1;
+    Color colorRef2, colorNew2;
+    float tolerance1 = 0.0f;
+    //! -1 disables the second color
+    float tolerance2 = -1.0f;
+    float shift = 0.0f;
+    bool  hsv = false;
+};
+
+/**
+ * \brief Changes the colors of \a count pixels given as separate channels in 0..1
+ *
+ * Gives the same results as the per-pixel conversions with RGB2HSV() and
+ * HSV2RGB(). Where SSE2 is available, four pixels are done at a time.
+ *
+ * \param r,g,b channels, changed in place
+ * \param changed set to 1 for pixels which were changed, 0 for the others
+ */
+void RecolorPixels(const RecolorParams& params, float* r, float* g, float* b, char* changed, int count);
+
+/**
+ * \brief Changes colors of \a image in the rectangle from \a min to \a max (excluded)
+ * \param exclude list of rectangles left as they are, see CEngine::ChangeTextureColor()
+ */
+void RecolorImage(CImage& image, const RecolorParams& params,
+                  Math::IntPoint min, Math::IntPoint max, const Math::Point* exclude);
+
+/**
+ * \class CTextureRecolorCache
+ * \brief Images recolored by CEngine::ChangeTextureColor(), kept between levels
+ *
+ * Entries are keyed by the source file and all parameters of the color
+ * change, so the same texture of several teams or of a restarted level
+ * is loaded and recolored only once.
+ */
+class CTextureRecolorCache
+{
+public:
+    //! Creates the cache; \a maxEntries is the number of images kept
+    explicit CTextureRecolorCache(std::size_t maxEntries = 128);
+    ~CTextureRecolorCache();
+
+    CTextureRecolorCache(const CTextureRecolorCache&) = delete;
+    CTextureRecolorCache& operator=(const CTextureRecolorCache&) = delete;
+
+    //! Returns the key of given color change of \a srcName
+    static std::string GetKey(const std::string& srcName, const RecolorParams& params,
+                               Math::Point ts, Math::Point ti, const Math::Point* exclude);
+
+    //! Returns a copy of the cached image, or nullptr if not cached
+    std::unique_ptr<CImage> Get(const std::string& key);
+    //! Stores a copy of \a image
+    void Add(const std::string& key, CImage& image);
+
+    //! Removes all entries
+    void Clear();
+    //! Returns the number of images in the cache
+    std::size_t GetCount() const;
+
+private:
+    std::size_t m_maxEntries;
+    std::unordered_map<std::string, std::unique_ptr<CImage>> m_entries;
+};
+
+
+} // namespace Gfx
@@ -28,9 +28,10 @@ namespace Gfx
  */
 enum class ModelFormat
 {
-    Text,   //!< new text format
-    Binary, //!< new binary format
-    Old        //!< old binary format, deprecated
+    Text,    //!< new text format
+    Binary,  //!< new binary format
+    Old,     //!< old binary format, deprecated
+    Grouped  //!< binary format with triangles grouped as in engine, see CModelGroups
 };
 
 } // namespace Gfx
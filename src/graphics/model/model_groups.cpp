@@ -0,0 +1,263 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+#include "graphics/model/model_groups.h"
+
+#include "graphics/model/model_io_exception.h"
+#include "graphics/model/model_io_structs.h"
+
+#include <cstring>
+#include <iterator>
+
+namespace Gfx
+{
+
+namespace
+{
+
+const char GROUPED_MODEL_MAGIC[4] = { 'C', 'G', 'M', 'D' };
+
+static_assert(sizeof(VertexTex2) == 10 * sizeof(float), "VertexTex2 must not be padded");
+static_assert(sizeof(GroupedModelHeader) % sizeof(float) == 0 && sizeof(GroupedModelGroup) % sizeof(float) == 0,
+              "Vertices in grouped model file must be aligned");
+
+bool HaveSameAttributes(const ModelTriangle& a, const ModelTriangle& b)
+{
+    return a.tex1Name == b.tex1Name &&
+           a.tex2Name == b.tex2Name &&
+           a.variableTex2 == b.variableTex2 &&
+           a.doubleSided == b.doubleSided &&
+           a.transparentMode == b.transparentMode &&
+           a.specialMark == b.specialMark &&
+           a.diffuse == b.diffuse &&
+           a.ambient == b.ambient &&
+           a.specular == b.specular;
+}
+
+void CopyName(char (&dest)[32], const std::string& name)
+{
+    if (name.size() >= sizeof(dest))
+        throw CModelIOException(std::string("Texture name too long for grouped model: ") + name);
+
+    memcpy(dest, name.c_str(), name.size() + 1);
+}
+
+std::string ReadName(const char (&source)[32])
+{
+    if (memchr(source, '\0', sizeof(source)) == nullptr)
+        throw CModelIOException("Texture name is not terminated");
+
+    return std::string(source);
+}
+
+} // anonymous namespace
+
+
+void CModelGroups::SetMesh(const CModelMesh& mesh)
+{
+    const std::vector<ModelTriangle>& triangles = mesh.GetTriangles();
+
+    // Find the group of each triangle first, so that vertices can be placed at once
+    std::vector<int> triangleGroups(triangles.size());
+    std::vector<int> groupCounts;
+    m_groups.clear();
+
+    for (int i = 0; i < static_cast<int>( triangles.size() ); i++)
+    {
+        int group = 0;
+        while (group < static_cast<int>( m_groups.size() ) && !HaveSameAttributes(m_groups[group].attributes, triangles[i]))
+            group++;
+
+        if (group == static_cast<int>( m_groups.size() ))
+        {
+            ModelTriangleGroup newGroup;
+            newGroup.attributes = triangles[i];
+            newGroup.attributes.p1 = newGroup.attributes.p2 = newGroup.attributes.p3 = VertexTex2();
+            m_groups.push_back(newGroup);
+        }
+
+        triangleGroups[i] = group;
+        m_groups[group].vertexCount += 3;
+    }
+
+    int firstVertex = 0;
+    for (ModelTriangleGroup& group : m_groups)
+    {
+        group.firstVertex = firstVertex;
+        firstVertex += group.vertexCount;
+    }
+
+    m_vertexStorage.resize(firstVertex);
+    std::vector<int> next(m_groups.size());
+    for (int i = 0; i < static_cast<int>( m_groups.size() ); i++)
+        next[i] = m_groups[i].firstVertex;
+
+    for (int i = 0; i < static_cast<int>( triangles.size() ); i++)
+    {
+        int& index = next[triangleGroups[i]];
+        m_vertexStorage[index++] = triangles[i].p1;
+        m_vertexStorage[index++] = triangles[i].p2;
+        m_vertexStorage[index++] = triangles[i].p3;
+    }
+
+    m_fileStorage.clear();
+    m_vertices = m_vertexStorage.data();
+    m_vertexCount = firstVertex;
+}
+
+CModelMesh CModelGroups::ToMesh() const
+{
+    std::vector<ModelTriangle> triangles;
+    triangles.reserve(m_vertexCount / 3);
+
+    for (const ModelTriangleGroup& group : m_groups)
+    {
+        for (int i = 0; i < group.vertexCount; i += 3)
+        {
+            ModelTriangle triangle = group.attributes;
+            triangle.p1 = m_vertices[group.firstVertex + i];
+            triangle.p2 = m_vertices[group.firstVertex + i + 1];
+            triangle.p3 = m_vertices[group.firstVertex + i + 2];
+            triangles.push_back(triangle);
+        }
+    }
+
+    CModelMesh mesh;
+    mesh.SetTriangles(std::move(triangles));
+    return mesh;
+}
+
+void CModelGroups::SetSourceHash(uint64_t hash)
+{
+    m_sourceHash = hash;
+}
+
+uint64_t CModelGroups::GetSourceHash() const
+{
+    return m_sourceHash;
+}
+
+void CModelGroups::Read(const void* data, std::size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+
+    GroupedModelHeader header;
+    if (size < sizeof(GroupedModelHeader))
+        throw CModelIOException("Grouped model file too short");
+
+    memcpy(&header, bytes, sizeof(GroupedModelHeader));
+
+    if (memcmp(header.magic, GROUPED_MODEL_MAGIC, sizeof(header.magic)) != 0)
+        throw CModelIOException("Not a grouped model file");
+
+    if (header.version != VERSION)
+        throw CModelIOException(std::string("Unexpected version number: ") + std::to_string(header.version));
+
+    std::size_t groupsOffset = sizeof(GroupedModelHeader);
+    std::size_t verticesOffset = groupsOffset + static_cast<std::size_t>(header.totalGroups) * sizeof(GroupedModelGroup);
+    if (size < verticesOffset + static_cast<std::size_t>(header.totalVertices) * sizeof(VertexTex2))
+        throw CModelIOException("Grouped model file too short");
+
+    std::vector<ModelTriangleGroup> groups(header.totalGroups);
+    for (uint32_t i = 0; i < header.totalGroups; i++)
+    {
+        GroupedModelGroup fileGroup;
+        memcpy(&fileGroup, bytes + groupsOffset + i * sizeof(GroupedModelGroup), sizeof(GroupedModelGroup));
+
+        if (fileGroup.vertexCount % 3 != 0 ||
+            fileGroup.firstVertex > header.totalVertices ||
+            fileGroup.vertexCount > header.totalVertices - fileGroup.firstVertex)
+            throw CModelIOException("Invalid vertex range of group");
+
+        ModelTriangleGroup& group = groups[i];
+        group.firstVertex = fileGroup.firstVertex;
+        group.vertexCount = fileGroup.vertexCount;
+        group.attributes.diffuse = fileGroup.diffuse;
+        group.attributes.ambient = fileGroup.ambient;
+        group.attributes.specular = fileGroup.specular;
+        group.attributes.transparentMode = static_cast<ModelTransparentMode>(fileGroup.transparentMode);
+        group.attributes.specialMark = static_cast<ModelSpecialMark>(fileGroup.specialMark);
+        group.attributes.variableTex2 = fileGroup.variableTex2 != 0;
+        group.attributes.doubleSided = fileGroup.doubleSided != 0;
+        group.attributes.tex1Name = ReadName(fileGroup.tex1Name);
+        group.attributes.tex2Name = ReadName(fileGroup.tex2Name);
+    }
+
+    m_groups = std::move(groups);
+    m_vertexStorage.clear();
+    m_vertices = reinterpret_cast<const VertexTex2*>(bytes + verticesOffset);
+    m_vertexCount = header.totalVertices;
+    m_sourceHash = header.sourceHash;
+}
+
+void CModelGroups::Read(std::istream& stream)
+{
+    std::vector<char> contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    Read(contents.data(), contents.size());
+    m_fileStorage = std::move(contents);  // the buffer itself stays the same
+}
+
+void CModelGroups::Write(std::ostream& stream) const
+{
+    GroupedModelHeader header;
+    memcpy(header.magic, GROUPED_MODEL_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.totalGroups = m_groups.size();
+    header.totalVertices = m_vertexCount;
+    header.sourceHash = m_sourceHash;
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(GroupedModelHeader));
+
+    for (const ModelTriangleGroup& group : m_groups)
+    {
+        GroupedModelGroup fileGroup;
+        fileGroup.firstVertex = group.firstVertex;
+        fileGroup.vertexCount = group.vertexCount;
+        fileGroup.diffuse = group.attributes.diffuse;
+        fileGroup.ambient = group.attributes.ambient;
+        fileGroup.specular = group.attributes.specular;
+        fileGroup.transparentMode = static_cast<uint8_t>(group.attributes.transparentMode);
+        fileGroup.specialMark = static_cast<uint8_t>(group.attributes.specialMark);
+        fileGroup.variableTex2 = group.attributes.variableTex2 ? 1 : 0;
+        fileGroup.doubleSided = group.attributes.doubleSided ? 1 : 0;
+        CopyName(fileGroup.tex1Name, group.attributes.tex1Name);
+        CopyName(fileGroup.tex2Name, group.attributes.tex2Name);
+        stream.write(reinterpret_cast<const char*>(&fileGroup), sizeof(GroupedModelGroup));
+    }
+
+    stream.write(reinterpret_cast<const char*>(m_vertices), m_vertexCount * sizeof(VertexTex2));
+}
+
+const std::vector<ModelTriangleGroup>& CModelGroups::GetGroups() const
+{
+    return m_groups;
+}
+
+const VertexTex2* CModelGroups::GetVertices() const
+{
+    return m_vertices;
+}
+
+int CModelGroups::GetVertexCount() const
+{
+    return m_vertexCount;
+}
+
+} // namespace Gfx
@@ -0,0 +1,125 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+/**
+ * \file graphics/model/model_groups.h
+ * \brief Triangles of a mesh grouped by textures, material and state - CModelGroups
+ */
+
+#pragma once
+
+#include "graphics/model/model_mesh.h"
+#include "graphics/model/model_triangle.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace Gfx
+{
+
+/**
+ * \struct ModelTriangleGroup
+ * \brief Consecutive vertices of triangles which have the same attributes
+ */
+struct ModelTriangleGroup
+{
+    //! Textures, material and flags common to the triangles; the vertices are not used
+    ModelTriangle attributes;
+    //! Index of first vertex in CModelGroups::GetVertices()
+    int firstVertex = 0;
+    //! Number of vertices, 3 for each triangle
+    int vertexCount = 0;
+};
+
+/**
+ * \class CModelGroups
+ * \brief Triangles of a mesh, grouped as they are stored in engine tiers
+ *
+ * Groups contain triangles which differ only in vertices, so each of them
+ * gives one data tier of base object and the vertices of a group can be given
+ * to the engine as they are. Groups are in order of their first triangles,
+ * which is also the order in which the engine creates tiers for the mesh.
+ *
+ * This is the contents of ModelFormat::Grouped files. Such a file can be used
+ * without copying its vertices by Read() from memory, e.g. from a mapped file.
+ */
+class CModelGroups
+{
+public:
+    //! Version of grouped model file
+    static const int VERSION = 2;
+
+    CModelGroups() = default;
+    CModelGroups(CModelGroups&&) = default;
+    CModelGroups& operator=(CModelGroups&&) = default;
+
+    // Vertices may point into own storage
+    CModelGroups(const CModelGroups&) = delete;
+    CModelGroups& operator=(const CModelGroups&) = delete;
+
+    //! Groups the triangles of \a mesh
+    void SetMesh(const CModelMesh& mesh);
+    //! Returns mesh with the grouped triangles
+    CModelMesh ToMesh() const;
+
+    //! Sets hash of the model file the groups are made from, written to the file
+    void SetSourceHash(uint64_t hash);
+    //! Returns hash of the model file the groups were made from, 0 if not known
+    uint64_t GetSourceHash() const;
+
+    //! Uses grouped model file of \a size bytes at \a data, which must remain valid as long as the groups are used
+    /**
+     * @throws CModelIOException if data are invalid
+     */
+    void Read(const void* data, std::size_t size);
+    //! Reads grouped model file from \a stream
+    /**
+     * @throws CModelIOException if data are invalid
+     */
+    void Read(std::istream& stream);
+    //! Writes grouped model file to \a stream
+    /**
+     * @throws CModelIOException if a texture name is too long
+     */
+    void Write(std::ostream& stream) const;
+
+    //! Returns the groups
+    const std::vector<ModelTriangleGroup>& GetGroups() const;
+    //! Returns vertices of all groups
+    const VertexTex2* GetVertices() const;
+    //! Returns the number of vertices of all groups
+    int GetVertexCount() const;
+
+private:
+    std::vector<ModelTriangleGroup> m_groups;
+    //! Vertices pointing either to m_vertexStorage or to external data
+    const VertexTex2* m_vertices = nullptr;
+    int m_vertexCount = 0;
+    uint64_t m_sourceHash = 0;
+    //! Vertices of SetMesh()
+    std::vector<VertexTex2> m_vertexStorage;
+    //! File contents of Read() from stream
+    std::vector<char> m_fileStorage;
+};
+
+} // namespace Gfx
@@ -24,6 +24,7 @@
 
 #include "common/resources/inputstream.h"
 
+#include "graphics/model/model_groups.h"
 #include "graphics/model/model_io_exception.h"
 #include "graphics/model/model_io_structs.h"
 
@@ -55,6 +56,8 @@ namespace ModelInput
     std::vector<ModelTriangle> ReadOldModelV2(std::istream &stream, int totalTriangles);
     std::vector<ModelTriangle> ReadOldModelV3(std::istream &stream, int totalTriangles);
 
+    void ReadGroupedModel(CModel &model, std::istream &stream);
+
     Vertex ReadBinaryVertex(std::istream& stream);
     VertexTex2 ReadBinaryVertexTex2(std::istream& stream);
     Material ReadBinaryMaterial(std::istream& stream);
@@ -98,6 +101,10 @@ CModel ModelInput::Read(std::istream &stream, ModelFormat format)
             case ModelFormat::Old:
                 ReadOldModel(model, stream);
                 break;
+
+            case ModelFormat::Grouped:
+                ReadGroupedModel(model, stream);
+                break;
         }
     }
     catch (const CModelIOException& e)
@@ -569,6 +576,14 @@ std::vector<ModelTriangle> ModelInput::ReadOldModelV3(std::istream &stream, int
     return triangles;
 }
 
+void ModelInput::ReadGroupedModel(CModel &model, std::istream &stream)
+{
+    CModelGroups groups;
+    groups.Read(stream);
+
+    model.AddMesh("main", groups.ToMesh());
+}
+
 ModelLODLevel ModelInput::MinMaxToLodLevel(float min, float max)
 {
     if (min == 0.0f && max == 100.0f)
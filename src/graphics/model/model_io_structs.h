@@ -23,6 +23,8 @@
 
 #include "graphics/model/model_triangle.h"
 
+#include <cstdint>
+
 namespace Gfx
 {
 
@@ -149,6 +151,52 @@ struct ModelMeshHeaderV3
  */
 struct ModelTriangleV3 : ModelTriangle {};
 
+/**
+ * \struct GroupedModelHeader
+ * \brief Header of grouped model file
+ *
+ * Unlike the other formats, grouped model files are stored exactly as
+ * in memory, so that they can be used without parsing. The header is followed
+ * by \a totalGroups of GroupedModelGroup and then \a totalVertices of VertexTex2.
+ */
+struct GroupedModelHeader
+{
+    //! "CGMD"
+    char magic[4] = {};
+    //! File version (1, ...)
+    uint32_t version = 0;
+    //! Number of groups
+    uint32_t totalGroups = 0;
+    //! Number of vertices of all groups
+    uint32_t totalVertices = 0;
+    //! Hash of the model file the groups were made from, 0 if not known
+    uint64_t sourceHash = 0;
+};
+
+/**
+ * \struct GroupedModelGroup
+ * \brief Triangles with common textures, material and state in grouped model file
+ */
+struct GroupedModelGroup
+{
+    //! Index of first vertex of the group
+    uint32_t firstVertex = 0;
+    //! Number of vertices, 3 for each triangle
+    uint32_t vertexCount = 0;
+    Color diffuse;
+    Color ambient;
+    Color specular;
+    //! ModelTransparentMode
+    uint8_t transparentMode = 0;
+    //! ModelSpecialMark
+    uint8_t specialMark = 0;
+    uint8_t variableTex2 = 0;
+    uint8_t doubleSided = 0;
+    //! Null-terminated texture names
+    char tex1Name[32] = {};
+    char tex2Name[32] = {};
+};
+
 
 
 /*******************************************************
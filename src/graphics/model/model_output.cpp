@@ -22,6 +22,7 @@
 #include "common/ioutils.h"
 
 #include "graphics/model/model.h"
+#include "graphics/model/model_groups.h"
 #include "graphics/model/model_io_exception.h"
 #include "graphics/model/model_io_structs.h"
 
@@ -47,6 +48,8 @@ namespace ModelOutput
 
     void WriteOldModel(const CModel& model, std::ostream &stream);
 
+    void WriteGroupedModel(const CModel& model, std::ostream &stream);
+
     int ConvertToOldState(const ModelTriangle& triangle);
 
     void WriteBinaryVertexTex2(VertexTex2 vertex, std::ostream &stream);
@@ -77,6 +80,10 @@ void ModelOutput::Write(const CModel& model, std::ostream &stream, ModelFormat f
             case ModelFormat::Old:
                 WriteOldModel(model, stream);
                 break;
+
+            case ModelFormat::Grouped:
+                WriteGroupedModel(model, stream);
+                break;
         }
     }
     catch (const CModelIOException& e)
@@ -364,6 +371,17 @@ void ModelOutput::WriteOldModel(const CModel& model, std::ostream &stream)
     }
 }
 
+void ModelOutput::WriteGroupedModel(const CModel& model, std::ostream &stream)
+{
+    const CModelMesh* mesh = model.GetMesh("main");
+    if (mesh == nullptr)
+        throw CModelIOException("No main mesh found in model");
+
+    CModelGroups groups;
+    groups.SetMesh(*mesh);
+    groups.Write(stream);
+}
+
 int ModelOutput::ConvertToOldState(const ModelTriangle& triangle)
 {
     int state = 0;
@@ -567,6 +567,13 @@ Texture CGL21Device::CreateTexture(CImage *image, const TextureCreateParams &par
 
 Texture CGL21Device::CreateTexture(ImageData *data, const TextureCreateParams &params)
 {
+    return CreateTexture(std::vector<ImageData*>{ data }, params);
+}
+
+Texture CGL21Device::CreateTexture(const std::vector<ImageData*> &levels, const TextureCreateParams &params)
+{
+    ImageData* data = levels[0];
+
     Texture result;
 
     result.size.x = data->surface->w;
@@ -607,12 +614,19 @@ Texture CGL21Device::CreateTexture(ImageData *data, const TextureCreateParams &p
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minF);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magF);
 
+    // Given mipmap levels are uploaded as they are, otherwise they are generated
+    bool generateMipmap = levels.size() == 1;
+    int levelCount = 1;
+
     // Set mipmap level and automatic mipmap generation if neccesary
     if (params.mipmap)
     {
+        if (!generateMipmap)
+            levelCount = Math::Min(static_cast<int>(levels.size()), mipmapLevel);
+
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipmapLevel - 1);
-        glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, generateMipmap ? mipmapLevel - 1 : levelCount - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, generateMipmap ? GL_TRUE : GL_FALSE);
     }
     else
     {
@@ -710,35 +724,40 @@ Texture CGL21Device::CreateTexture(ImageData *data, const TextureCreateParams &p
     else
         assert(false);
 
-    SDL_Surface* actualSurface = data->surface;
-    SDL_Surface* convertedSurface = nullptr;
-
-    if (convert)
+    // Surfaces in other formats are converted to RGBA
+    SDL_PixelFormat format;
+    format.BytesPerPixel = 4;
+    format.BitsPerPixel = 32;
+    format.alpha = 0;
+    format.colorkey = 0;
+    format.Aloss = format.Bloss = format.Gloss = format.Rloss = 0;
+    format.Amask = 0xFF000000;
+    format.Ashift = 24;
+    format.Bmask = 0x00FF0000;
+    format.Bshift = 16;
+    format.Gmask = 0x0000FF00;
+    format.Gshift = 8;
+    format.Rmask = 0x000000FF;
+    format.Rshift = 0;
+    format.palette = nullptr;
+
+    for (int level = 0; level < levelCount; ++level)
     {
-        SDL_PixelFormat format;
-        format.BytesPerPixel = 4;
-        format.BitsPerPixel = 32;
-        format.alpha = 0;
-        format.colorkey = 0;
-        format.Aloss = format.Bloss = format.Gloss = format.Rloss = 0;
-        format.Amask = 0xFF000000;
-        format.Ashift = 24;
-        format.Bmask = 0x00FF0000;
-        format.Bshift = 16;
-        format.Gmask = 0x0000FF00;
-        format.Gshift = 8;
-        format.Rmask = 0x000000FF;
-        format.Rshift = 0;
-        format.palette = nullptr;
-        convertedSurface = SDL_ConvertSurface(data->surface, &format, SDL_SWSURFACE);
-        if (convertedSurface != nullptr)
-            actualSurface = convertedSurface;
-    }
+        SDL_Surface* actualSurface = levels[level]->surface;
+        SDL_Surface* convertedSurface = nullptr;
+
+        if (convert)
+        {
+            convertedSurface = SDL_ConvertSurface(levels[level]->surface, &format, SDL_SWSURFACE);
+            if (convertedSurface != nullptr)
+                actualSurface = convertedSurface;
+        }
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, actualSurface->w, actualSurface->h,
-                 0, sourceFormat, GL_UNSIGNED_BYTE, actualSurface->pixels);
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, actualSurface->w, actualSurface->h,
+                     0, sourceFormat, GL_UNSIGNED_BYTE, actualSurface->pixels);
 
-    SDL_FreeSurface(convertedSurface);
+        SDL_FreeSurface(convertedSurface);
+    }
 
     m_allTextures.insert(result);
 
@@ -797,6 +816,41 @@ Texture CGL21Device::CreateDepthTexture(int width, int height, int depth)
     return result;
 }
 
+void CGL21Device::UpdateTexture(const Texture& texture, Math::IntPoint offset, ImageData* data, TexImgFormat format)
+{
+    if (texture.id == 0 || data->surface == nullptr)
+        return;
+
+    GLenum sourceFormat = 0;
+    switch (format)
+    {
+    case TEX_IMG_RGB:
+        sourceFormat = GL_RGB;
+        break;
+    case TEX_IMG_BGR:
+        sourceFormat = GL_BGR;
+        break;
+    case TEX_IMG_RGBA:
+        sourceFormat = GL_RGBA;
+        break;
+    case TEX_IMG_BGRA:
+        sourceFormat = GL_BGRA;
+        break;
+    default:
+        GetLogger()->Error("Texture update needs an explicit image format\n");
+        return;
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture.id);
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, offset.x, offset.y, data->surface->w, data->surface->h,
+                    sourceFormat, GL_UNSIGNED_BYTE, data->surface->pixels);
+
+    // Restore the previous state of 1st stage
+    glBindTexture(GL_TEXTURE_2D, m_currentTextures[0].id);
+}
+
 void CGL21Device::DestroyTexture(const Texture &texture)
 {
     // Unbind the texture if in use anywhere
@@ -1176,6 +1230,7 @@ void CGL21Device::DrawPrimitive(PrimitiveType type, const Vertex *vertices, int
 
     glColor4fv(color.Array());
 
+    m_drawCallCount++;
     glDrawArrays(TranslateGfxPrimitive(type), 0, vertexCount);
 
     glDisableClientState(GL_VERTEX_ARRAY);
@@ -1207,6 +1262,7 @@ void CGL21Device::DrawPrimitive(PrimitiveType type, const VertexTex2 *vertices,
 
     glColor4fv(color.Array());
 
+    m_drawCallCount++;
     glDrawArrays(TranslateGfxPrimitive(type), 0, vertexCount);
 
     glDisableClientState(GL_VERTEX_ARRAY);
@@ -1229,6 +1285,7 @@ void CGL21Device::DrawPrimitive(PrimitiveType type, const VertexCol *vertices, i
     glEnableClientState(GL_COLOR_ARRAY);
     glColorPointer(4, GL_FLOAT, sizeof(VertexCol), reinterpret_cast<GLfloat*>(&vs[0].color));
 
+    m_drawCallCount++;
     glDrawArrays(TranslateGfxPrimitive(type), 0, vertexCount);
 
     glDisableClientState(GL_VERTEX_ARRAY);
@@ -1295,6 +1352,16 @@ unsigned int CGL21Device::CreateStaticBuffer(PrimitiveType primitiveType, const
     return id;
 }
 
+unsigned int CGL21Device::CreateStaticBuffer(PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                                             const unsigned int* indices, int indexCount)
+{
+    unsigned int id = CreateStaticBuffer(primitiveType, vertices, vertexCount);
+
+    UpdateStaticBufferIndices(m_vboObjects[id], indices, indexCount);
+
+    return id;
+}
+
 void CGL21Device::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const Vertex* vertices, int vertexCount)
 {
     auto it = m_vboObjects.find(bufferId);
@@ -1307,6 +1374,7 @@ void CGL21Device::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primit
     info.primitiveType = primitiveType;
     info.vertexType = VERTEX_TYPE_NORMAL;
     info.vertexCount = vertexCount;
+    info.indexCount = 0;
 
     BindVBO(info.bufferId);
 
@@ -1331,6 +1399,7 @@ void CGL21Device::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primit
     info.primitiveType = primitiveType;
     info.vertexType = VERTEX_TYPE_TEX2;
     info.vertexCount = vertexCount;
+    info.indexCount = 0;
 
     int newSize = vertexCount * sizeof(VertexTex2);
 
@@ -1357,6 +1426,7 @@ void CGL21Device::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primit
     info.primitiveType = primitiveType;
     info.vertexType = VERTEX_TYPE_COL;
     info.vertexCount = vertexCount;
+    info.indexCount = 0;
 
     int newSize = vertexCount * sizeof(VertexCol);
 
@@ -1373,6 +1443,42 @@ void CGL21Device::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primit
     }
 }
 
+void CGL21Device::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                                     const unsigned int* indices, int indexCount)
+{
+    auto it = m_vboObjects.find(bufferId);
+    if (it == m_vboObjects.end())
+        return;
+
+    UpdateStaticBuffer(bufferId, primitiveType, vertices, vertexCount);
+
+    UpdateStaticBufferIndices((*it).second, indices, indexCount);
+}
+
+void CGL21Device::UpdateStaticBufferIndices(VboObjectInfo& info, const unsigned int* indices, int indexCount)
+{
+    if (info.indexBufferId == 0)
+        glGenBuffers(1, &info.indexBufferId);
+
+    int newSize = indexCount * sizeof(unsigned int);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, info.indexBufferId);
+
+    if (info.indexSize < newSize)
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, newSize, indices, GL_STATIC_DRAW);
+        info.indexSize = newSize;
+    }
+    else
+    {
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, newSize, indices);
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    info.indexCount = indexCount;
+}
+
 void CGL21Device::DrawStaticBuffer(unsigned int bufferId)
 {
     auto it = m_vboObjects.find(bufferId);
@@ -1422,7 +1528,17 @@ void CGL21Device::DrawStaticBuffer(unsigned int bufferId)
     }
 
     GLenum mode = TranslateGfxPrimitive((*it).second.primitiveType);
-    glDrawArrays(mode, 0, (*it).second.vertexCount);
+    m_drawCallCount++;
+    if ((*it).second.indexCount > 0)
+    {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, (*it).second.indexBufferId);
+        glDrawElements(mode, (*it).second.indexCount, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+    else
+    {
+        glDrawArrays(mode, 0, (*it).second.vertexCount);
+    }
 
     if ((*it).second.vertexType == VERTEX_TYPE_NORMAL)
     {
@@ -1447,6 +1563,20 @@ void CGL21Device::DrawStaticBuffer(unsigned int bufferId)
     glDisable(GL_VERTEX_ARRAY);
 }
 
+void CGL21Device::DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount)
+{
+    // No instanced rendering in this version of OpenGL, draw the instances one by one
+    Math::Matrix worldMat = m_worldMat;
+
+    for (int i = 0; i < instanceCount; ++i)
+    {
+        SetTransform(TRANSFORM_WORLD, transforms[i]);
+        DrawStaticBuffer(bufferId);
+    }
+
+    SetTransform(TRANSFORM_WORLD, worldMat);
+}
+
 void CGL21Device::DestroyStaticBuffer(unsigned int bufferId)
 {
     auto it = m_vboObjects.find(bufferId);
@@ -1457,10 +1587,17 @@ void CGL21Device::DestroyStaticBuffer(unsigned int bufferId)
         BindVBO(0);
 
     glDeleteBuffers(1, &(*it).second.bufferId);
+    if ((*it).second.indexBufferId != 0)
+        glDeleteBuffers(1, &(*it).second.indexBufferId);
 
     m_vboObjects.erase(it);
 }
 
+long long CGL21Device::GetDrawCallCount()
+{
+    return m_drawCallCount;
+}
+
 /* Based on libwine's implementation */
 
 int CGL21Device::ComputeSphereVisibility(const Math::Vector &center, float radius)
@@ -80,7 +80,9 @@ public:
 
     Texture CreateTexture(CImage *image, const TextureCreateParams &params) override;
     Texture CreateTexture(ImageData *data, const TextureCreateParams &params) override;
+    Texture CreateTexture(const std::vector<ImageData*> &levels, const TextureCreateParams &params) override;
     Texture CreateDepthTexture(int width, int height, int depth) override;
+    void UpdateTexture(const Texture& texture, Math::IntPoint offset, ImageData* data, TexImgFormat format) override;
     void DestroyTexture(const Texture &texture) override;
     void DestroyAllTextures() override;
 
@@ -103,12 +105,19 @@ public:
     unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const Vertex* vertices, int vertexCount) override;
     unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount) override;
     unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount) override;
+    unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                                    const unsigned int* indices, int indexCount) override;
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const Vertex* vertices, int vertexCount) override;
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount) override;
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount) override;
+    void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                            const unsigned int* indices, int indexCount) override;
     void DrawStaticBuffer(unsigned int bufferId) override;
+    void DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount) override;
     void DestroyStaticBuffer(unsigned int bufferId) override;
 
+    long long GetDrawCallCount() override;
+
     int ComputeSphereVisibility(const Math::Vector &center, float radius) override;
 
     void SetViewport(int x, int y, int width, int height) override;
@@ -222,8 +231,16 @@ private:
         VertexType vertexType = {};
         int vertexCount = 0;
         int size = 0;
+        //! Element array buffer, 0 if not used yet
+        unsigned int indexBufferId = 0;
+        //! Number of indices, 0 if the buffer is drawn without them
+        int indexCount = 0;
+        int indexSize = 0;
     };
 
+    //! Uploads indices of static buffer
+    void UpdateStaticBufferIndices(VboObjectInfo& info, const unsigned int* indices, int indexCount);
+
     //! Detected capabilities
     //! OpenGL version
     int m_glMajor = 1, m_glMinor = 1;
@@ -239,6 +256,8 @@ private:
     std::map<unsigned int, VboObjectInfo> m_vboObjects;
     //! Last ID of VBO object
     unsigned int m_lastVboId = 0;
+    //! Number of draw calls issued since creation
+    long long m_drawCallCount = 0;
     //! Currently bound VBO
     GLuint m_currentVBO = 0;
 
@@ -249,6 +249,8 @@ bool CGL33Device::Create()
     m_vertexTex2 = CreateStaticBuffer(PRIMITIVE_POINTS, static_cast<VertexTex2*>(nullptr), 1);
     m_vertexCol = CreateStaticBuffer(PRIMITIVE_POINTS, static_cast<VertexCol*>(nullptr), 1);
 
+    glGenBuffers(1, &m_instanceBuffer);
+
     int value;
     if (CConfigFile::GetInstance().GetIntProperty("Setup", "PerPixelLighting", value))
     {
@@ -294,6 +296,7 @@ bool CGL33Device::Create()
     uni_ModelMatrix = glGetUniformLocation(m_shaderProgram, "uni_ModelMatrix");
     uni_NormalMatrix = glGetUniformLocation(m_shaderProgram, "uni_NormalMatrix");
     uni_ShadowMatrix = glGetUniformLocation(m_shaderProgram, "uni_ShadowMatrix");
+    uni_Instanced = glGetUniformLocation(m_shaderProgram, "uni_Instanced");
 
     uni_PrimaryTexture = glGetUniformLocation(m_shaderProgram, "uni_PrimaryTexture");
     uni_SecondaryTexture = glGetUniformLocation(m_shaderProgram, "uni_SecondaryTexture");
@@ -350,6 +353,7 @@ bool CGL33Device::Create()
     glUniformMatrix4fv(uni_ModelMatrix, 1, GL_FALSE, matrix.Array());
     glUniformMatrix4fv(uni_NormalMatrix, 1, GL_FALSE, matrix.Array());
     glUniformMatrix4fv(uni_ShadowMatrix, 1, GL_FALSE, matrix.Array());
+    glUniform1i(uni_Instanced, 0);
 
     glUniform1i(uni_PrimaryTexture, 0);
     glUniform1i(uni_SecondaryTexture, 1);
@@ -397,6 +401,12 @@ void CGL33Device::Destroy()
     glUseProgram(0);
     glDeleteProgram(m_shaderProgram);
 
+    // delete instance buffer
+    if (m_currentVBO == m_instanceBuffer)
+        BindVBO(0);
+    glDeleteBuffers(1, &m_instanceBuffer);
+    m_instanceBuffer = 0;
+
     // delete framebuffers
     for (auto& framebuffer : m_framebuffers)
         framebuffer.second->Destroy();
@@ -600,6 +610,13 @@ Texture CGL33Device::CreateTexture(CImage *image, const TextureCreateParams &par
 
 Texture CGL33Device::CreateTexture(ImageData *data, const TextureCreateParams &params)
 {
+    return CreateTexture(std::vector<ImageData*>{ data }, params);
+}
+
+Texture CGL33Device::CreateTexture(const std::vector<ImageData*> &levels, const TextureCreateParams &params)
+{
+    ImageData* data = levels[0];
+
     Texture result;
 
     result.size.x = data->surface->w;
@@ -636,11 +653,18 @@ Texture CGL33Device::CreateTexture(ImageData *data, const TextureCreateParams &p
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minF);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magF);
 
+    // Given mipmap levels are uploaded as they are, otherwise they are generated
+    bool generateMipmap = levels.size() == 1;
+    int levelCount = 1;
+
     // Set mipmap level and automatic mipmap generation if neccesary
     if (params.mipmap)
     {
+        if (!generateMipmap)
+            levelCount = Math::Min(static_cast<int>(levels.size()), mipmapLevel);
+
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipmapLevel - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, generateMipmap ? mipmapLevel - 1 : levelCount - 1);
     }
     else
     {
@@ -737,38 +761,47 @@ Texture CGL33Device::CreateTexture(ImageData *data, const TextureCreateParams &p
     else
         assert(false);
 
-    SDL_Surface* actualSurface = data->surface;
-    SDL_Surface* convertedSurface = nullptr;
-
-    if (convert)
+    // Surfaces in other formats are converted to RGBA
+    SDL_PixelFormat format;
+    format.BytesPerPixel = 4;
+    format.BitsPerPixel = 32;
+    format.alpha = 0;
+    format.colorkey = 0;
+    format.Aloss = format.Bloss = format.Gloss = format.Rloss = 0;
+    format.Amask = 0xFF000000;
+    format.Ashift = 24;
+    format.Bmask = 0x00FF0000;
+    format.Bshift = 16;
+    format.Gmask = 0x0000FF00;
+    format.Gshift = 8;
+    format.Rmask = 0x000000FF;
+    format.Rshift = 0;
+    format.palette = nullptr;
+
+    for (int level = 0; level < levelCount; ++level)
     {
-        SDL_PixelFormat format;
-        format.BytesPerPixel = 4;
-        format.BitsPerPixel = 32;
-        format.alpha = 0;
-        format.colorkey = 0;
-        format.Aloss = format.Bloss = format.Gloss = format.Rloss = 0;
-        format.Amask = 0xFF000000;
-        format.Ashift = 24;
-        format.Bmask = 0x00FF0000;
-        format.Bshift = 16;
-        format.Gmask = 0x0000FF00;
-        format.Gshift = 8;
-        format.Rmask = 0x000000FF;
-        format.Rshift = 0;
-        format.palette = nullptr;
-        convertedSurface = SDL_ConvertSurface(data->surface, &format, SDL_SWSURFACE);
-        if (convertedSurface != nullptr)
-            actualSurface = convertedSurface;
-    }
+        SDL_Surface* actualSurface = levels[level]->surface;
+        SDL_Surface* convertedSurface = nullptr;
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, actualSurface->w, actualSurface->h,
-                 0, sourceFormat, GL_UNSIGNED_BYTE, actualSurface->pixels);
+        if (convert)
+        {
+            convertedSurface = SDL_ConvertSurface(levels[level]->surface, &format, SDL_SWSURFACE);
+            if (convertedSurface != nullptr)
+                actualSurface = convertedSurface;
+        }
 
-    if (params.mipmap)
-        glGenerateMipmap(GL_TEXTURE_2D);
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, actualSurface->w, actualSurface->h,
+                     0, sourceFormat, GL_UNSIGNED_BYTE, actualSurface->pixels);
 
-    SDL_FreeSurface(convertedSurface);
+        SDL_FreeSurface(convertedSurface);
+    }
+
+    if (params.mipmap)
+    {
+        if (generateMipmap)
+            glGenerateMipmap(GL_TEXTURE_2D);
+        m_mipmapTextures.insert(result.id);
+    }
 
     m_allTextures.insert(result);
 
@@ -823,6 +856,44 @@ Texture CGL33Device::CreateDepthTexture(int width, int height, int depth)
     return result;
 }
 
+void CGL33Device::UpdateTexture(const Texture& texture, Math::IntPoint offset, ImageData* data, TexImgFormat format)
+{
+    if (texture.id == 0 || data->surface == nullptr)
+        return;
+
+    GLenum sourceFormat = 0;
+    switch (format)
+    {
+    case TEX_IMG_RGB:
+        sourceFormat = GL_RGB;
+        break;
+    case TEX_IMG_BGR:
+        sourceFormat = GL_BGR;
+        break;
+    case TEX_IMG_RGBA:
+        sourceFormat = GL_RGBA;
+        break;
+    case TEX_IMG_BGRA:
+        sourceFormat = GL_BGRA;
+        break;
+    default:
+        GetLogger()->Error("Texture update needs an explicit image format\n");
+        return;
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture.id);
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, offset.x, offset.y, data->surface->w, data->surface->h,
+                    sourceFormat, GL_UNSIGNED_BYTE, data->surface->pixels);
+
+    if (m_mipmapTextures.count(texture.id) > 0)
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+    // Restore the previous state of 1st stage
+    glBindTexture(GL_TEXTURE_2D, m_currentTextures[0].id);
+}
+
 void CGL33Device::DestroyTexture(const Texture &texture)
 {
     // Unbind the texture if in use anywhere
@@ -837,6 +908,7 @@ void CGL33Device::DestroyTexture(const Texture &texture)
     {
         glDeleteTextures(1, &texture.id);
         m_allTextures.erase(it);
+        m_mipmapTextures.erase(texture.id);
     }
 }
 
@@ -850,6 +922,7 @@ void CGL33Device::DestroyAllTextures()
         glDeleteTextures(1, &(*it).id);
 
     m_allTextures.clear();
+    m_mipmapTextures.clear();
 }
 
 int CGL33Device::GetMaxTextureStageCount()
@@ -1212,6 +1285,7 @@ void CGL33Device::DrawPrimitive(PrimitiveType type, const Vertex *vertices, int
 
     UpdateRenderingMode();
 
+    m_drawCallCount++;
     glDrawArrays(TranslateGfxPrimitive(type), 0, vertexCount);
 }
 
@@ -1261,6 +1335,7 @@ void CGL33Device::DrawPrimitive(PrimitiveType type, const VertexTex2 *vertices,
 
     UpdateRenderingMode();
 
+    m_drawCallCount++;
     glDrawArrays(TranslateGfxPrimitive(type), 0, vertexCount);
 }
 
@@ -1308,6 +1383,7 @@ void CGL33Device::DrawPrimitive(PrimitiveType type, const VertexCol *vertices, i
 
     UpdateRenderingMode();
 
+    m_drawCallCount++;
     glDrawArrays(TranslateGfxPrimitive(type), 0, vertexCount);
 }
 
@@ -1444,6 +1520,16 @@ unsigned int CGL33Device::CreateStaticBuffer(PrimitiveType primitiveType, const
     return id;
 }
 
+unsigned int CGL33Device::CreateStaticBuffer(PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                                             const unsigned int* indices, int indexCount)
+{
+    unsigned int id = CreateStaticBuffer(primitiveType, vertices, vertexCount);
+
+    UpdateStaticBufferIndices(m_vboObjects[id], indices, indexCount);
+
+    return id;
+}
+
 void CGL33Device::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const Vertex* vertices, int vertexCount)
 {
     auto it = m_vboObjects.find(bufferId);
@@ -1461,6 +1547,7 @@ void CGL33Device::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primit
     info.primitiveType = primitiveType;
     info.vertexType = VERTEX_TYPE_NORMAL;
     info.vertexCount = vertexCount;
+    info.indexCount = 0;
 
     BindVBO(info.vbo);
 
@@ -1518,6 +1605,7 @@ void CGL33Device::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primit
     info.primitiveType = primitiveType;
     info.vertexType = VERTEX_TYPE_TEX2;
     info.vertexCount = vertexCount;
+    info.indexCount = 0;
 
     BindVBO(info.vbo);
 
@@ -1575,6 +1663,7 @@ void CGL33Device::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primit
     info.primitiveType = primitiveType;
     info.vertexType = VERTEX_TYPE_COL;
     info.vertexCount = vertexCount;
+    info.indexCount = 0;
 
     BindVBO(info.vbo);
 
@@ -1615,6 +1704,44 @@ void CGL33Device::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primit
     }
 }
 
+void CGL33Device::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                                     const unsigned int* indices, int indexCount)
+{
+    auto it = m_vboObjects.find(bufferId);
+    if (it == m_vboObjects.end())
+        return;
+
+    UpdateStaticBuffer(bufferId, primitiveType, vertices, vertexCount);
+
+    UpdateStaticBufferIndices((*it).second, indices, indexCount);
+}
+
+void CGL33Device::UpdateStaticBufferIndices(VertexBufferInfo& info, const unsigned int* indices, int indexCount)
+{
+    // Element array buffer binding is a part of the vertex array state
+    BindVAO(info.vao);
+
+    if (info.ibo == 0)
+    {
+        glGenBuffers(1, &info.ibo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, info.ibo);
+    }
+
+    unsigned int size = indexCount * sizeof(unsigned int);
+
+    if (info.indexSize < size)
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW);
+        info.indexSize = size;
+    }
+    else
+    {
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, size, indices);
+    }
+
+    info.indexCount = indexCount;
+}
+
 void CGL33Device::DrawStaticBuffer(unsigned int bufferId)
 {
     auto it = m_vboObjects.find(bufferId);
@@ -1628,7 +1755,79 @@ void CGL33Device::DrawStaticBuffer(unsigned int bufferId)
     BindVAO(info.vao);
 
     GLenum mode = TranslateGfxPrimitive(info.primitiveType);
-    glDrawArrays(mode, 0, info.vertexCount);
+    m_drawCallCount++;
+    if (info.indexCount > 0)
+        glDrawElements(mode, info.indexCount, GL_UNSIGNED_INT, nullptr);
+    else
+        glDrawArrays(mode, 0, info.vertexCount);
+}
+
+void CGL33Device::DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount)
+{
+    auto it = m_vboObjects.find(bufferId);
+    if (it == m_vboObjects.end() || instanceCount <= 0)
+        return;
+
+    VertexBufferInfo &info = (*it).second;
+
+    UpdateRenderingMode();
+
+    BindVAO(info.vao);
+
+    // Normal matrices are computed here once per instance instead of for each vertex in the shader
+    m_instanceNormalMatrices.resize(instanceCount * 9);
+    for (int i = 0; i < instanceCount; ++i)
+    {
+        Math::Matrix inverse = transforms[i];
+        if (fabs(inverse.Det()) > 1e-6)
+            inverse = inverse.Inverse();
+
+        // Transposed inverse, column by column
+        float* normalMatrix = &m_instanceNormalMatrices[i * 9];
+        for (int col = 0; col < 3; ++col)
+        {
+            for (int row = 0; row < 3; ++row)
+                normalMatrix[col * 3 + row] = inverse.m[row * 4 + col];
+        }
+    }
+
+    // Upload the transforms followed by normal matrices, letting the driver orphan the previous storage
+    std::size_t transformsSize = instanceCount * sizeof(Math::Matrix);
+    std::size_t normalsSize = m_instanceNormalMatrices.size() * sizeof(float);
+    BindVBO(m_instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, transformsSize + normalsSize, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, transformsSize, transforms);
+    glBufferSubData(GL_ARRAY_BUFFER, transformsSize, normalsSize, m_instanceNormalMatrices.data());
+
+    // Matrix is passed as 4 column vectors
+    for (int i = 0; i < 4; ++i)
+    {
+        glEnableVertexAttribArray(5 + i);
+        glVertexAttribPointer(5 + i, 4, GL_FLOAT, GL_FALSE, sizeof(Math::Matrix), reinterpret_cast<void*>(i * 4 * sizeof(float)));
+        glVertexAttribDivisor(5 + i, 1);
+    }
+
+    // Normal matrix as 3 column vectors
+    for (int i = 0; i < 3; ++i)
+    {
+        glEnableVertexAttribArray(9 + i);
+        glVertexAttribPointer(9 + i, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), reinterpret_cast<void*>(transformsSize + i * 3 * sizeof(float)));
+        glVertexAttribDivisor(9 + i, 1);
+    }
+
+    glUniform1i(uni_Instanced, 1);
+
+    GLenum mode = TranslateGfxPrimitive(info.primitiveType);
+    m_drawCallCount++;
+    if (info.indexCount > 0)
+        glDrawElementsInstanced(mode, info.indexCount, GL_UNSIGNED_INT, nullptr, instanceCount);
+    else
+        glDrawArraysInstanced(mode, 0, info.vertexCount, instanceCount);
+
+    glUniform1i(uni_Instanced, 0);
+
+    for (int i = 0; i < 7; ++i)
+        glDisableVertexAttribArray(5 + i);
 }
 
 void CGL33Device::DestroyStaticBuffer(unsigned int bufferId)
@@ -1645,14 +1844,22 @@ void CGL33Device::DestroyStaticBuffer(unsigned int bufferId)
         BindVBO(0);
 
     glDeleteBuffers(1, &info.vbo);
+    if (info.ibo != 0)
+        glDeleteBuffers(1, &info.ibo);
     glDeleteVertexArrays(1, &info.vao);
 
     info.vbo = 0;
+    info.ibo = 0;
     info.vao = 0;
 
     m_vboObjects.erase(it);
 }
 
+long long CGL33Device::GetDrawCallCount()
+{
+    return m_drawCallCount;
+}
+
 /* Based on libwine's implementation */
 
 int CGL33Device::ComputeSphereVisibility(const Math::Vector &center, float radius)
@@ -80,7 +80,9 @@ public:
 
     Texture CreateTexture(CImage *image, const TextureCreateParams &params) override;
     Texture CreateTexture(ImageData *data, const TextureCreateParams &params) override;
+    Texture CreateTexture(const std::vector<ImageData*> &levels, const TextureCreateParams &params) override;
     Texture CreateDepthTexture(int width, int height, int depth) override;
+    void UpdateTexture(const Texture& texture, Math::IntPoint offset, ImageData* data, TexImgFormat format) override;
     void DestroyTexture(const Texture &texture) override;
     void DestroyAllTextures() override;
 
@@ -103,12 +105,19 @@ public:
     unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const Vertex* vertices, int vertexCount) override;
     unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount) override;
     unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount) override;
+    unsigned int CreateStaticBuffer(PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                                    const unsigned int* indices, int indexCount) override;
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const Vertex* vertices, int vertexCount) override;
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount) override;
     void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount) override;
+    void UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                            const unsigned int* indices, int indexCount) override;
     void DrawStaticBuffer(unsigned int bufferId) override;
+    void DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount) override;
     void DestroyStaticBuffer(unsigned int bufferId) override;
 
+    long long GetDrawCallCount() override;
+
     int ComputeSphereVisibility(const Math::Vector &center, float radius) override;
 
     void SetViewport(int x, int y, int width, int height) override;
@@ -205,6 +214,8 @@ private:
 
     //! Set of all created textures
     std::set<Texture> m_allTextures;
+    //! IDs of textures created with mipmaps, regenerated after UpdateTexture()
+    std::set<unsigned int> m_mipmapTextures;
 
     //! Type of vertex structure
     enum VertexType
@@ -223,8 +234,16 @@ private:
         VertexType vertexType = {};
         int vertexCount = 0;
         unsigned int size = 0;
+        //! Element array buffer, 0 if not used yet
+        GLuint ibo = 0;
+        //! Number of indices, 0 if the buffer is drawn without them
+        int indexCount = 0;
+        unsigned int indexSize = 0;
     };
 
+    //! Uploads indices of static buffer
+    void UpdateStaticBufferIndices(VertexBufferInfo& info, const unsigned int* indices, int indexCount);
+
     //! Detected capabilities
     //! OpenGL version
     int m_glMajor = 1, m_glMinor = 1;
@@ -238,6 +257,8 @@ private:
     std::map<unsigned int, VertexBufferInfo> m_vboObjects;
     //! Last ID of VBO object
     unsigned int m_lastVboId = 0;
+    //! Number of draw calls issued since creation
+    long long m_drawCallCount = 0;
     //! Currently bound VBO
     GLuint m_currentVBO = 0;
     //! Currently bound VAO
@@ -255,6 +276,10 @@ private:
     unsigned int m_vertex = 0;
     unsigned int m_vertexTex2 = 0;
     unsigned int m_vertexCol = 0;
+    //! Buffer with world transforms and their normal matrices for instanced rendering
+    GLuint m_instanceBuffer = 0;
+    //! Normal matrices of instances, as 3 columns of 3 floats each
+    std::vector<float> m_instanceNormalMatrices;
 
     // Uniforms
     //! Projection matrix
@@ -267,6 +292,8 @@ private:
     GLint uni_ShadowMatrix = 0;
     //! Normal matrix
     GLint uni_NormalMatrix = 0;
+    //! true uses per-instance model matrices
+    GLint uni_Instanced = 0;
 
     //! Primary texture sampler
     GLint uni_PrimaryTexture = 0;
@@ -533,6 +533,13 @@ Texture CGLDevice::CreateTexture(CImage *image, const TextureCreateParams &param
 
 Texture CGLDevice::CreateTexture(ImageData *data, const TextureCreateParams &params)
 {
+    return CreateTexture(std::vector<ImageData*>{ data }, params);
+}
+
+Texture CGLDevice::CreateTexture(const std::vector<ImageData*> &levels, const TextureCreateParams &params)
+{
+    ImageData* data = levels[0];
+
     Texture result;
 
     result.size.x = data->surface->w;
@@ -576,12 +583,19 @@ Texture CGLDevice::CreateTexture(ImageData *data, const TextureCreateParams &par
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minF);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magF);
 
+    // Given mipmap levels are uploaded as they are, otherwise they are generated
+    bool generateMipmap = levels.size() == 1;
+    int levelCount = 1;
+
     // Set mipmap level and automatic mipmap generation if neccesary
     if (params.mipmap)
     {
+        if (!generateMipmap)
+            levelCount = Math::Min(static_cast<int>(levels.size()), mipmapLevel);
+
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipmapLevel - 1);
-        glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, generateMipmap ? mipmapLevel - 1 : levelCount - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, generateMipmap ? GL_TRUE : GL_FALSE);
     }
     else
     {
@@ -679,35 +693,40 @@ Texture CGLDevice::CreateTexture(ImageData *data, const TextureCreateParams &par
     else
         assert(false);
 
-    SDL_Surface* actualSurface = data->surface;
-    SDL_Surface* convertedSurface = nullptr;
-
-    if (convert)
+    // Surfaces in other formats are converted to RGBA
+    SDL_PixelFormat format;
+    format.BytesPerPixel = 4;
+    format.BitsPerPixel = 32;
+    format.alpha = 0;
+    format.colorkey = 0;
+    format.Aloss = format.Bloss = format.Gloss = format.Rloss = 0;
+    format.Amask = 0xFF000000;
+    format.Ashift = 24;
+    format.Bmask = 0x00FF0000;
+    format.Bshift = 16;
+    format.Gmask = 0x0000FF00;
+    format.Gshift = 8;
+    format.Rmask = 0x000000FF;
+    format.Rshift = 0;
+    format.palette = nullptr;
+
+    for (int level = 0; level < levelCount; ++level)
     {
-        SDL_PixelFormat format;
-        format.BytesPerPixel = 4;
-        format.BitsPerPixel = 32;
-        format.alpha = 0;
-        format.colorkey = 0;
-        format.Aloss = format.Bloss = format.Gloss = format.Rloss = 0;
-        format.Amask = 0xFF000000;
-        format.Ashift = 24;
-        format.Bmask = 0x00FF0000;
-        format.Bshift = 16;
-        format.Gmask = 0x0000FF00;
-        format.Gshift = 8;
-        format.Rmask = 0x000000FF;
-        format.Rshift = 0;
-        format.palette = nullptr;
-        convertedSurface = SDL_ConvertSurface(data->surface, &format, SDL_SWSURFACE);
-        if (convertedSurface != nullptr)
-            actualSurface = convertedSurface;
-    }
+        SDL_Surface* actualSurface = levels[level]->surface;
+        SDL_Surface* convertedSurface = nullptr;
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, actualSurface->w, actualSurface->h,
-                 0, sourceFormat, GL_UNSIGNED_BYTE, actualSurface->pixels);
+        if (convert)
+        {
+            convertedSurface = SDL_ConvertSurface(levels[level]->surface, &format, SDL_SWSURFACE);
+            if (convertedSurface != nullptr)
+                actualSurface = convertedSurface;
+        }
 
-    SDL_FreeSurface(convertedSurface);
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, actualSurface->w, actualSurface->h,
+                     0, sourceFormat, GL_UNSIGNED_BYTE, actualSurface->pixels);
+
+        SDL_FreeSurface(convertedSurface);
+    }
 
     m_allTextures.insert(result);
 
@@ -800,6 +819,41 @@ Texture CGLDevice::CreateDepthTexture(int width, int height, int depth)
     return result;
 }
 
+void CGLDevice::UpdateTexture(const Texture& texture, Math::IntPoint offset, ImageData* data, TexImgFormat format)
+{
+    if (texture.id == 0 || data->surface == nullptr)
+        return;
+
+    GLenum sourceFormat = 0;
+    switch (format)
+    {
+    case TEX_IMG_RGB:
+        sourceFormat = GL_RGB;
+        break;
+    case TEX_IMG_BGR:
+        sourceFormat = GL_BGR;
+        break;
+    case TEX_IMG_RGBA:
+        sourceFormat = GL_RGBA;
+        break;
+    case TEX_IMG_BGRA:
+        sourceFormat = GL_BGRA;
+        break;
+    default:
+        GetLogger()->Error("Texture update needs an explicit image format\n");
+        return;
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture.id);
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, offset.x, offset.y, data->surface->w, data->surface->h,
+                    sourceFormat, GL_UNSIGNED_BYTE, data->surface->pixels);
+
+    // Restore the previous state of 1st stage
+    glBindTexture(GL_TEXTURE_2D, m_currentTextures[0].id);
+}
+
 void CGLDevice::DestroyTexture(const Texture &texture)
 {
     // Unbind the texture if in use anywhere
@@ -1190,6 +1244,7 @@ void CGLDevice::DrawPrimitive(PrimitiveType type, const Vertex *vertices, int ve
 
     glColor4fv(color.Array());
 
+    m_drawCallCount++;
     glDrawArrays(TranslateGfxPrimitive(type), 0, vertexCount);
 
     glDisableClientState(GL_VERTEX_ARRAY);
@@ -1223,6 +1278,7 @@ void CGLDevice::DrawPrimitive(PrimitiveType type, const VertexTex2 *vertices, in
 
     glColor4fv(color.Array());
 
+    m_drawCallCount++;
     glDrawArrays(TranslateGfxPrimitive(type), 0, vertexCount);
 
     glDisableClientState(GL_VERTEX_ARRAY);
@@ -1245,6 +1301,7 @@ void CGLDevice::DrawPrimitive(PrimitiveType type, const VertexCol *vertices, int
     glEnableClientState(GL_COLOR_ARRAY);
     glColorPointer(4, GL_FLOAT, sizeof(VertexCol), reinterpret_cast<GLfloat*>(&vs[0].color));
 
+    m_drawCallCount++;
     glDrawArrays(TranslateGfxPrimitive(type), 0, vertexCount);
 
     glDisableClientState(GL_VERTEX_ARRAY);
@@ -1339,6 +1396,17 @@ unsigned int CGLDevice::CreateStaticBuffer(PrimitiveType primitiveType, const Ve
     return id;
 }
 
+unsigned int CGLDevice::CreateStaticBuffer(PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                                           const unsigned int* indices, int indexCount)
+{
+    // Display lists and ARB buffers are used without indices, so the primitives are stored expanded
+    std::vector<VertexTex2> expanded(indexCount);
+    for (int i = 0; i < indexCount; ++i)
+        expanded[i] = vertices[indices[i]];
+
+    return CreateStaticBuffer(primitiveType, expanded.data(), indexCount);
+}
+
 unsigned int CGLDevice::CreateStaticBuffer(PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount)
 {
     unsigned int id = 0;
@@ -1455,6 +1523,16 @@ void CGLDevice::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiv
     }
 }
 
+void CGLDevice::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexTex2* vertices, int vertexCount,
+                                   const unsigned int* indices, int indexCount)
+{
+    std::vector<VertexTex2> expanded(indexCount);
+    for (int i = 0; i < indexCount; ++i)
+        expanded[i] = vertices[indices[i]];
+
+    UpdateStaticBuffer(bufferId, primitiveType, expanded.data(), indexCount);
+}
+
 void CGLDevice::UpdateStaticBuffer(unsigned int bufferId, PrimitiveType primitiveType, const VertexCol* vertices, int vertexCount)
 {
     if (m_vboAvailable)
@@ -1551,6 +1629,7 @@ void CGLDevice::DrawStaticBuffer(unsigned int bufferId)
         }
 
         GLenum mode = TranslateGfxPrimitive((*it).second.primitiveType);
+        m_drawCallCount++;
         glDrawArrays(mode, 0, (*it).second.vertexCount);
 
         if ((*it).second.vertexType == VERTEX_TYPE_NORMAL)
@@ -1585,10 +1664,25 @@ void CGLDevice::DrawStaticBuffer(unsigned int bufferId)
     }
     else
     {
+        m_drawCallCount++;
         glCallList(bufferId);
     }
 }
 
+void CGLDevice::DrawStaticBufferInstanced(unsigned int bufferId, const Math::Matrix* transforms, int instanceCount)
+{
+    // No instanced rendering in this version of OpenGL, draw the instances one by one
+    Math::Matrix worldMat = m_worldMat;
+
+    for (int i = 0; i < instanceCount; ++i)
+    {
+        SetTransform(TRANSFORM_WORLD, transforms[i]);
+        DrawStaticBuffer(bufferId);
+    }
+
+    SetTransform(TRANSFORM_WORLD, worldMat);
+}
+
 void CGLDevice::DestroyStaticBuffer(unsigned int bufferId)
 {
     if (m_vboAvailable)
@@ -1610,6 +1704,11 @@ void CGLDevice::DestroyStaticBuffer(unsigned int bufferId)
     }
 }
 
+long long CGLDevice::GetDrawCallCount()
+{
+    return m_drawCallCount;
+}
+
 /* Based on libwine's implementation */
 
 int CGLDevice::ComputeSphereVisibility(const Math::Vector &center, float radius)
@@ -43,12 +43,15 @@ uniform mat4 uni_ViewMatrix;
 uniform mat4 uni_ModelMatrix;
 uniform mat4 uni_ShadowMatrix;
 uniform mat4 uni_NormalMatrix;
+uniform bool uni_Instanced;
 
 layout(location = 0) in vec4 in_VertexCoord;
 layout(location = 1) in vec3 in_Normal;
 layout(location = 2) in vec4 in_Color;
 layout(location = 3) in vec2 in_TexCoord0;
 layout(location = 4) in vec2 in_TexCoord1;
+layout(location = 5) in mat4 in_InstanceMatrix;
+layout(location = 9) in mat3 in_InstanceNormalMatrix;
 
 out VertexData
 {
@@ -62,7 +65,16 @@ out VertexData
 
 void main()
 {
-    vec4 position = uni_ModelMatrix * in_VertexCoord;
+    mat4 modelMatrix = uni_ModelMatrix;
+    mat4 normalMatrix = uni_NormalMatrix;
+
+    if (uni_Instanced)
+    {
+        modelMatrix = in_InstanceMatrix;
+        normalMatrix = mat4(in_InstanceNormalMatrix);
+    }
+
+    vec4 position = modelMatrix * in_VertexCoord;
     vec4 eyeSpace = uni_ViewMatrix * position;
     gl_Position = uni_ProjectionMatrix * eyeSpace;
     vec4 shadowCoord = uni_ShadowMatrix * position;
@@ -81,7 +93,7 @@ void main()
         vec4 diffuse = vec4(0.0f);
         vec4 specular = vec4(0.0f);
 
-        vec3 normal = normalize((uni_NormalMatrix * vec4(in_Normal, 0.0f)).xyz);
+        vec3 normal = normalize((normalMatrix * vec4(in_Normal, 0.0f)).xyz);
 
         for(int i=0; i<8; i++)
         {
@@ -82,6 +82,8 @@
 
 #include "script/cbottoken.h"
 #include "script/script.h"
+#include "script/script_cache.h"
+#include "script/script_scheduler.h"
 #include "script/scriptfunc.h"
 
 #include "sound/sound.h"
@@ -148,6 +150,8 @@ CRobotMain::CRobotMain()
     m_ui          = MakeUnique<Ui::CMainUserInterface>();
     m_short       = MakeUnique<Ui::CMainShort>();
     m_map         = MakeUnique<Ui::CMainMap>();
+    m_scriptScheduler = MakeUnique<CScriptScheduler>();
+    m_scriptCache = MakeUnique<CScriptCache>();
 
     m_objMan = MakeUnique<CObjectManager>(
         m_engine,
@@ -294,6 +298,11 @@ Ui::CDisplayText* CRobotMain::GetDisplayText()
     return m_displayText.get();
 }
 
+CScriptCache* CRobotMain::GetScriptCache()
+{
+    return m_scriptCache.get();
+}
+
 void CRobotMain::ResetAfterDeviceChanged()
 {
     if (m_phase == PHASE_SETUPds ||
@@ -1579,6 +1588,11 @@ float CRobotMain::GetGameTime()
     return m_gameTime;
 }
 
+Error CRobotMain::GetMissionResult()
+{
+    return m_missionResult;
+}
+
 
 //! Start of the visit instead of an error
 void CRobotMain::StartDisplayVisit(EventType event)
@@ -1911,25 +1925,33 @@ CObject* CRobotMain::SearchToto()
 //! Returns the nearest selectable object from a given position
 CObject* CRobotMain::SearchNearest(Math::Vector pos, CObject* exclu)
 {
-    float min = 100000.0f;
+    const float maxDist = 100000.0f;
+    float min = maxDist;
     CObject* best = nullptr;
-    for (CObject* obj : m_objMan->GetAllObjects())
+
+    // Widen the search until something is found; anything outside the range is further away
+    for (float range = OBJECT_GRID_CELL_SIZE; ; range *= 4.0f)
     {
-        if (obj == exclu) continue;
-        if (!IsSelectable(obj)) continue;
+        for (CObject* obj : m_objMan->GetObjectsInRange(pos, range))
+        {
+            if (obj == exclu) continue;
+            if (!IsSelectable(obj)) continue;
 
-        ObjectType type = obj->GetType();
-        if (type == OBJECT_TOTO) continue;
+            ObjectType type = obj->GetType();
+            if (type == OBJECT_TOTO) continue;
 
-        Math::Vector oPos = obj->GetPosition();
-        float dist = Math::DistanceProjected(oPos, pos);
-        if (dist < min)
-        {
-            min = dist;
-            best = obj;
+            Math::Vector oPos = obj->GetPosition();
+            float dist = Math::DistanceProjected(oPos, pos);
+            if (dist < min)
+            {
+                min = dist;
+                best = obj;
+            }
         }
+
+        if (min <= range || range >= maxDist)
+            return best;
     }
-    return best;
 }
 
 //! Returns the selected object
@@ -2447,6 +2469,23 @@ bool CRobotMain::EventFrame(const Event &event)
     CObject* toto = nullptr;
     if (!m_freePhoto)
     {
+        // Runs the programs in parallel up to their first access to the world,
+        // they are completed by CScript::Continue() in the loop below
+        std::vector<CScript*> scripts;
+        for (CObject* obj : m_objMan->GetAllObjects())
+        {
+            if (IsObjectBeingTransported(obj))
+                continue;
+
+            if (!obj->Implements(ObjectInterfaceType::Programmable))
+                continue;
+
+            CProgrammableObject* programmable = dynamic_cast<CProgrammableObject*>(obj);
+            if (programmable->GetActivity() && programmable->IsProgram())
+                scripts.push_back(programmable->GetCurrentProgram()->script.get());
+        }
+        m_scriptScheduler->Run(scripts);
+
         // Advances all the robots, but not toto.
         for (CObject* obj : m_objMan->GetAllObjects())
         {
@@ -3991,9 +4030,25 @@ void CRobotMain::ChangeColor()
 
 //! Calculates the distance to the nearest object
 float CRobotMain::SearchNearestObject(Math::Vector center, CObject *exclu)
+{
+    const float maxDist = 100000.0f;
+    float min = maxDist;
+
+    // Widen the search until something is found; objects outside the range
+    // can't be closer than the range itself, even counting their crash spheres
+    for (float range = OBJECT_GRID_CELL_SIZE; ; range *= 4.0f)
+    {
+        min = Math::Min(maxDist, SearchNearestObjectInRange(center, exclu, range+MAX_OBJECT_EXTENT));
+        if (min <= range || range >= maxDist)
+            return min;
+    }
+}
+
+//! Calculates the distance to the nearest object among the objects closer than range
+float CRobotMain::SearchNearestObjectInRange(Math::Vector center, CObject *exclu, float range)
 {
     float min = 100000.0f;
-    for (CObject* obj : m_objMan->GetAllObjects())
+    for (CObject* obj : m_objMan->GetObjectsInRange(center, range, false))
     {
         if (!obj->GetDetectable()) continue;  // inactive?
         if (IsObjectBeingTransported(obj)) continue;
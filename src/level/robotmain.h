@@ -90,6 +90,8 @@ class CPlayerProfile;
 class CSettings;
 class COldObject;
 class CPauseManager;
+class CScriptCache;
+class CScriptScheduler;
 struct ActivePause;
 
 namespace Gfx
@@ -158,6 +160,7 @@ public:
     Gfx::CTerrain* GetTerrain();
     Ui::CInterface* GetInterface();
     Ui::CDisplayText* GetDisplayText();
+    CScriptCache* GetScriptCache();
 
     void        CreateConfigFile();
     void        LoadConfigFile();
@@ -225,6 +228,8 @@ public:
     void        StopSuspend();
 
     float       GetGameTime();
+    //! Returns the result of the last check of end of mission conditions
+    Error       GetMissionResult();
 
     char*       GetTitle();
     char*       GetResume();
@@ -260,6 +265,7 @@ public:
     void        ChangeColor();
 
     float       SearchNearestObject(Math::Vector center, CObject *exclu);
+    float       SearchNearestObjectInRange(Math::Vector center, CObject *exclu, float range);
     bool        FreeSpace(Math::Vector &center, float minRadius, float maxRadius, float space, CObject *exclu);
     bool        FlatFreeSpace(Math::Vector &center, float minFlat, float minRadius, float maxRadius, float space, CObject *exclu);
     float       GetFlatZoneRadius(Math::Vector center, float maxRadius, CObject *exclu);
@@ -448,6 +454,8 @@ protected:
     std::unique_ptr<Ui::CDisplayInfo> m_displayInfo;
     std::unique_ptr<Ui::CDisplayText> m_displayText;
     std::unique_ptr<CSettings> m_settings;
+    std::unique_ptr<CScriptScheduler> m_scriptScheduler;
+    std::unique_ptr<CScriptCache> m_scriptCache;
 
     //! Progress of loaded player
     std::unique_ptr<CPlayerProfile> m_playerProfile;
@@ -630,6 +630,115 @@ inline Math::Vector Projection(const Math::Vector &a, const Math::Vector &b, con
     return a + k*(b-a);
 }
 
+//! Interpolates between transform matrices \a a (\a t = 0) and \a b (\a t = 1)
+/**
+ * Translation and scale along the axes are interpolated linearly and rotation
+ * by normalized linear interpolation of quaternions, so that a rotating part
+ * keeps its shape, unlike with a linear blend of the matrices.
+ * The matrices must be affine and without shear.
+ */
+inline Math::Matrix InterpolateTransform(const Math::Matrix &a, const Math::Matrix &b, float t)
+{
+    const Math::Matrix* mats[2] = { &a, &b };
+    float scale[2][3];
+    float quat[2][4];  // x, y, z, w
+
+    for (int i = 0; i < 2; ++i)
+    {
+        const float* m = mats[i]->m;
+
+        for (int c = 0; c < 3; ++c)
+        {
+            scale[i][c] = sqrtf(m[4*c+0]*m[4*c+0] + m[4*c+1]*m[4*c+1] + m[4*c+2]*m[4*c+2]);
+            if (IsZero(scale[i][c]))
+                return t < 0.5f ? a : b;
+        }
+
+        // Mirroring is kept in the scale of the X axis
+        float det = m[0]*(m[5]*m[10] - m[9]*m[6]) - m[4]*(m[1]*m[10] - m[9]*m[2]) + m[8]*(m[1]*m[6] - m[5]*m[2]);
+        if (det < 0.0f)
+            scale[i][0] = -scale[i][0];
+
+        // r[row][col] of the rotation part
+        float r[3][3];
+        for (int c = 0; c < 3; ++c)
+        {
+            for (int row = 0; row < 3; ++row)
+                r[row][c] = m[4*c+row] / scale[i][c];
+        }
+
+        float* q = quat[i];
+        float trace = r[0][0] + r[1][1] + r[2][2];
+        if (trace > 0.0f)
+        {
+            float s = sqrtf(trace + 1.0f) * 2.0f;
+            q[3] = 0.25f * s;
+            q[0] = (r[2][1] - r[1][2]) / s;
+            q[1] = (r[0][2] - r[2][0]) / s;
+            q[2] = (r[1][0] - r[0][1]) / s;
+        }
+        else if (r[0][0] > r[1][1] && r[0][0] > r[2][2])
+        {
+            float s = sqrtf(1.0f + r[0][0] - r[1][1] - r[2][2]) * 2.0f;
+            q[3] = (r[2][1] - r[1][2]) / s;
+            q[0] = 0.25f * s;
+            q[1] = (r[0][1] + r[1][0]) / s;
+            q[2] = (r[0][2] + r[2][0]) / s;
+        }
+        else if (r[1][1] > r[2][2])
+        {
+            float s = sqrtf(1.0f + r[1][1] - r[0][0] - r[2][2]) * 2.0f;
+            q[3] = (r[0][2] - r[2][0]) / s;
+            q[0] = (r[0][1] + r[1][0]) / s;
+            q[1] = 0.25f * s;
+            q[2] = (r[1][2] + r[2][1]) / s;
+        }
+        else
+        {
+            float s = sqrtf(1.0f + r[2][2] - r[0][0] - r[1][1]) * 2.0f;
+            q[3] = (r[1][0] - r[0][1]) / s;
+            q[0] = (r[0][2] + r[2][0]) / s;
+            q[1] = (r[1][2] + r[2][1]) / s;
+            q[2] = 0.25f * s;
+        }
+    }
+
+    // Go the shorter way around
+    float dot = quat[0][0]*quat[1][0] + quat[0][1]*quat[1][1] + quat[0][2]*quat[1][2] + quat[0][3]*quat[1][3];
+    float sign = dot < 0.0f ? -1.0f : 1.0f;
+
+    float q[4];
+    float length = 0.0f;
+    for (int k = 0; k < 4; ++k)
+    {
+        q[k] = quat[0][k] + (sign * quat[1][k] - quat[0][k]) * t;
+        length += q[k] * q[k];
+    }
+    length = sqrtf(length);
+    for (int k = 0; k < 4; ++k)
+        q[k] /= length;
+
+    float x = q[0], y = q[1], z = q[2], w = q[3];
+    float r[3][3] =
+    {
+        { 1.0f - 2.0f*(y*y + z*z), 2.0f*(x*y - z*w),        2.0f*(x*z + y*w)        },
+        { 2.0f*(x*y + z*w),        1.0f - 2.0f*(x*x + z*z), 2.0f*(y*z - x*w)        },
+        { 2.0f*(x*z - y*w),        2.0f*(y*z + x*w),        1.0f - 2.0f*(x*x + y*y) }
+    };
+
+    Math::Matrix result;
+    for (int c = 0; c < 3; ++c)
+    {
+        float s = scale[0][c] + (scale[1][c] - scale[0][c]) * t;
+        for (int row = 0; row < 3; ++row)
+            result.m[4*c+row] = r[row][c] * s;
+
+        result.m[12+c] = a.m[12+c] + (b.m[12+c] - a.m[12+c]) * t;
+    }
+
+    return result;
+}
+
 //! Calculates point of view to look at a center two angles and a distance
 inline Math::Vector RotateView(Math::Vector center, float angleH, float angleV, float dist)
 {
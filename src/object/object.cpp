@@ -90,11 +90,16 @@ void CObject::AddCrashSphere(const CrashSphere& crashSphere)
 
 CrashSphere CObject::GetFirstCrashSphere()
 {
-    assert(m_crashSpheres.size() >= 1);
+    return GetCrashSphere(0);
+}
+
+CrashSphere CObject::GetCrashSphere(int index)
+{
+    assert(index >= 0 && index < static_cast<int>(m_crashSpheres.size()));
 
-    CrashSphere transformedFirstCrashSphere = m_crashSpheres[0];
-    TransformCrashSphere(transformedFirstCrashSphere.sphere);
-    return transformedFirstCrashSphere;
+    CrashSphere transformedCrashSphere = m_crashSpheres[index];
+    TransformCrashSphere(transformedCrashSphere.sphere);
+    return transformedCrashSphere;
 }
 
 std::vector<CrashSphere> CObject::GetAllCrashSpheres()
@@ -144,6 +144,9 @@ public:
     //! Returns the first crash sphere (assumes it exists)
     /** Crash sphere position is returned in world coordinates */
     CrashSphere GetFirstCrashSphere();
+    //! Returns crash sphere at given index (doesn't allocate, unlike GetAllCrashSpheres())
+    /** Crash sphere position is returned in world coordinates */
+    CrashSphere GetCrashSphere(int index);
     //! Returns all crash spheres
     /** Crash sphere position is returned in world coordinates */
     std::vector<CrashSphere> GetAllCrashSpheres();
@@ -22,6 +22,8 @@
 #include "common/global.h"
 #include "common/make_unique.h"
 
+#include "graphics/engine/terrain.h"
+
 #include "math/all.h"
 
 #include "object/object.h"
@@ -45,7 +47,9 @@ CObjectManager::CObjectManager(Gfx::CEngine* engine,
                                Gfx::COldModelManager* oldModelManager,
                                Gfx::CModelManager* modelManager,
                                Gfx::CParticle* particle)
-  : m_objectFactory(MakeUnique<CObjectFactory>(engine,
+  : m_terrain(terrain),
+    m_objectGrid(OBJECT_GRID_CELL_SIZE),
+    m_objectFactory(MakeUnique<CObjectFactory>(engine,
                                                terrain,
                                                oldModelManager,
                                                modelManager,
@@ -69,6 +73,8 @@ bool CObjectManager::DeleteObject(CObject* instance)
     if (oldObj != nullptr)
         oldObj->DeleteObject();
 
+    m_objectGrid.Remove(instance);
+
     auto it = m_objects.find(instance->GetID());
     if (it != m_objects.end())
     {
@@ -112,6 +118,7 @@ void CObjectManager::DeleteAllObjects()
     }
 
     m_objects.clear();
+    m_objectGrid.Clear();
 
     m_nextId = 0;
 }
@@ -156,6 +163,7 @@ CObject* CObjectManager::CreateObject(ObjectCreateParams params)
     CObject* objectPtr = objectUPtr.get();
 
     m_objects[params.id] = std::move(objectUPtr);
+    m_objectGrid.Insert(objectPtr, objectPtr->GetPosition());
 
     return objectPtr;
 }
@@ -171,6 +179,50 @@ CObject* CObjectManager::CreateObject(Math::Vector pos, float angle, ObjectType
     return CreateObject(params);
 }
 
+void CObjectManager::UpdateObjectPosition(CObject* object)
+{
+    m_objectGrid.Update(object, object->GetPosition());
+}
+
+std::vector<CObject*> CObjectManager::GetObjectsInRange(const Math::Vector& center, float radius, bool sorted)
+{
+    std::vector<CObject*> result;
+    GetObjectsInRange(center, radius, result, sorted);
+    return result;
+}
+
+void CObjectManager::GetObjectsInRange(const Math::Vector& center, float radius, std::vector<CObject*>& result, bool sorted)
+{
+    result.clear();
+
+    // A range covering the whole map would visit every cell anyway
+    if (RangeCoversMap(center, radius))
+    {
+        for (CObject* object : GetAllObjects())
+            result.push_back(object);
+        return;
+    }
+
+    m_objectGrid.Query(center, radius, result);
+
+    // Keep the same order as iteration over m_objects so that ties are resolved identically
+    if (sorted)
+        std::sort(result.begin(), result.end(), [](CObject* a, CObject* b) { return a->GetID() < b->GetID(); });
+}
+
+bool CObjectManager::RangeCoversMap(const Math::Vector& center, float radius)
+{
+    if (m_terrain == nullptr)
+        return false;
+
+    float dim = (m_terrain->GetMosaicCount()*m_terrain->GetBrickCount()*m_terrain->GetBrickSize())/2.0f;
+    if (dim <= 0.0f)
+        return false;
+
+    return center.x - radius <= -dim && center.x + radius >= dim &&
+           center.z - radius <= -dim && center.z + radius >= dim;
+}
+
 std::vector<CObject*> CObjectManager::GetObjectsOfTeam(int team)
 {
     std::vector<CObject*> result;
@@ -266,7 +318,7 @@ CObject* CObjectManager::Radar(CObject* pThis, Math::Vector thisPosition, float
 
 CObject* CObjectManager::Radar(CObject* pThis, Math::Vector thisPosition, float thisAngle, std::vector<ObjectType> type, float angle, float focus, float minDist, float maxDist, bool furthest, RadarFilter filter, bool cbotTypes)
 {
-    CObject     *pObj, *pBest;
+    CObject     *pBest;
     Math::Vector    iPos, oPos;
     float       best, iAngle, d, a;
     ObjectType  oType;
@@ -285,12 +337,10 @@ CObject* CObjectManager::Radar(CObject* pThis, Math::Vector thisPosition, float
     if ( !furthest )  best = 100000.0f;
     else              best = 0.0f;
     pBest = nullptr;
-    for ( auto it = m_objects.begin() ; it != m_objects.end() ; ++it )
+    for ( CObject* pObj : GetObjectsInRange(iPos, maxDist) )
     {
-        pObj = it->second.get();
         if ( pObj == pThis )  continue; // pThis may be nullptr but it doesn't matter
 
-        if (pObj == nullptr) continue;
         if (IsObjectBeingTransported(pObj))  continue;
         if ( !pObj->GetDetectable() )  continue;
         if ( pObj->GetProxyActivate() )  continue;
@@ -25,6 +25,7 @@
 #pragma once
 
 #include "common/singleton.h"
+#include "common/spatial_grid.h"
 
 #include "math/const.h"
 #include "math/vector.h"
@@ -49,6 +50,11 @@ class CTerrain;
 class CObject;
 class CObjectFactory;
 
+//! Size of cells in the object spatial index (in world units)
+const float OBJECT_GRID_CELL_SIZE = 40.0f;
+//! Upper bound of distance from object's origin to the outer edge of its crash spheres (in world units)
+const float MAX_OBJECT_EXTENT = 100.0f;
+
 enum RadarFilter
 {
     FILTER_NONE        = 0,
@@ -185,6 +191,19 @@ public:
     //! Counts all objects implementing given interface
     int CountObjectsImplementing(ObjectInterfaceType interface);
 
+    //! Updates object's position in the spatial index; must be called whenever object moves
+    void UpdateObjectPosition(CObject* object);
+
+    //! Returns objects which may be closer than \a radius to \a center on the XZ plane
+    /**
+     * The result is a superset of objects in range, ordered by id like GetAllObjects().
+     * Callers must still check the actual distance. Callers which don't depend
+     * on the order (e.g. only look for the minimal distance) can pass \a sorted = false.
+     */
+    std::vector<CObject*> GetObjectsInRange(const Math::Vector& center, float radius, bool sorted = true);
+    //! Same as above, but reuses the given vector to avoid allocations
+    void GetObjectsInRange(const Math::Vector& center, float radius, std::vector<CObject*>& result, bool sorted = true);
+
     //! Returns all objects
     CObjectContainerProxy GetAllObjects()
     {
@@ -259,9 +278,13 @@ public:
 
 private:
     void CleanRemovedObjectsIfNeeded();
+    //! Returns true if the square of half-side \a radius around \a center contains the whole terrain
+    bool RangeCoversMap(const Math::Vector& center, float radius);
 
 private:
+    Gfx::CTerrain* m_terrain;
     CObjectMap m_objects;
+    CSpatialGrid<CObject*> m_objectGrid;
     std::unique_ptr<CObjectFactory> m_objectFactory;
     int m_nextId;
     int m_activeObjectIterators;
@@ -1325,6 +1325,11 @@ void COldObject::SetPartPosition(int part, const Math::Vector &pos)
     m_objectPart[part].position = pos;
     m_objectPart[part].bTranslate = true;  // it will recalculate the matrices
 
+    if ( part == 0 && CObjectManager::IsCreated() )
+    {
+        CObjectManager::GetInstancePointer()->UpdateObjectPosition(this);
+    }
+
     if ( part == 0 && !m_bFlat )  // main part?
     {
         int rank = m_objectPart[0].object;
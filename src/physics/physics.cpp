@@ -2494,7 +2494,10 @@ int CPhysics::ObjectAdapt(const Math::Vector &pos, const Math::Vector &angle)
     iPos = iiPos + (pos - m_object->GetPosition());
     iType = m_object->GetType();
 
-    for (CObject* pObj : CObjectManager::GetInstancePointer()->GetAllObjects())
+    // Broad phase: only objects whose crash spheres may reach the new position
+    CObjectManager::GetInstancePointer()->GetObjectsInRange(iPos, iRad+MAX_OBJECT_EXTENT, m_collisionCandidates);
+
+    for (CObject* pObj : m_collisionCandidates)
     {
         if ( pObj == m_object )  continue;  // yourself?
         if (IsObjectBeingTransported(pObj))  continue;
@@ -2533,8 +2536,9 @@ int CPhysics::ObjectAdapt(const Math::Vector &pos, const Math::Vector &angle)
             }
         }
 
-        for (const auto& crashSphere : pObj->GetAllCrashSpheres())
+        for (int sphereIndex = 0; sphereIndex < pObj->GetCrashSphereCount(); sphereIndex++)
         {
+            CrashSphere crashSphere = pObj->GetCrashSphere(sphereIndex);
             Math::Vector oPos = crashSphere.sphere.pos;
             float oRad = crashSphere.sphere.radius;
 
@@ -33,6 +33,8 @@
 
 #include "object/interface/trace_drawing_object.h"
 
+#include <vector>
+
 
 class CObject;
 class COldObject;
@@ -254,4 +256,6 @@ protected:
     float       m_fallingHeight;
     float       m_fallDamageFraction;
     float       m_minFallingHeight;
+
+    std::vector<CObject*> m_collisionCandidates; // reused by ObjectAdapt() to avoid allocations
 };
@@ -35,6 +35,7 @@
 #include "object/old_object.h"
 
 #include "script/cbottoken.h"
+#include "script/script_cache.h"
 
 #include "ui/displaytext.h"
 
@@ -249,7 +250,7 @@ bool CScript::Compile()
         m_botProg = MakeUnique<CBotProgram>(m_object->GetBotVar());
     }
 
-    if ( m_botProg->Compile(m_script.get(), liste, this) )
+    if ( m_main->GetScriptCache()->Compile(m_botProg.get(), m_script.get(), m_object->GetType(), liste, this) )
     {
         if ( liste.GetSize() == 0 )
         {
@@ -337,6 +338,7 @@ bool CScript::Run()
 
     m_bRun = true;
     m_bContinue = false;
+    m_bParallel = false;
     m_ipf = CBOT_IPF;
     m_errMode = ERM_STOP;
 
@@ -358,6 +360,8 @@ bool CScript::Continue()
 
     if ( m_bStepMode )  // step by step mode?
     {
+        m_bParallel = false;
+
         if ( m_bContinue )  // instuction "move", "goto", etc. ?
         {
             if ( m_botProg->Run(this, 0) )
@@ -388,7 +392,22 @@ bool CScript::Continue()
         return false;
     }
 
-    if ( m_botProg->Run(this, m_ipf) )
+    bool end;
+    if ( m_bParallel )  // started by ContinueParallel()?
+    {
+        m_bParallel = false;
+        end = m_parallelEnd;
+        if ( !end && m_botProg->IsWaitingExtern() )
+        {
+            end = m_botProg->Resume(this);
+        }
+    }
+    else
+    {
+        end = m_botProg->Run(this, m_ipf);
+    }
+
+    if ( end )
     {
         m_botProg->GetError(m_error, m_cursor1, m_cursor2);
         if ( m_cursor1 < 0 || m_cursor1 > m_len ||
@@ -415,6 +434,19 @@ bool CScript::Continue()
     return false;
 }
 
+// Runs the current program up to its first access to the game world.
+// May be called from another thread; the program is then completed
+// by Continue() on the main thread.
+
+void CScript::ContinueParallel()
+{
+    if (m_botProg == nullptr)  return;
+    if ( !m_bRun || m_bStepMode || m_bParallel )  return;
+
+    m_parallelEnd = m_botProg->RunUntilExtern(this, m_ipf);
+    m_bParallel = true;
+}
+
 // Continues the execution of current program.
 // Returns true when execution is finished.
 
@@ -464,6 +496,7 @@ void CScript::Stop()
     }
 
     m_bRun = false;
+    m_bParallel = false;
 }
 
 // Indicates whether the program runs.
@@ -1024,6 +1057,7 @@ bool CScript::ReadStack(FILE *file)
 
     m_bRun = true;
     m_bContinue = false;
+    m_bParallel = false;
     return true;
 }
 
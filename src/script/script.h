@@ -72,6 +72,7 @@ public:
     bool        GetStepMode();
     bool        Run();
     bool        Continue();
+    void        ContinueParallel();
     bool        Step();
     void        Stop();
     bool        IsRunning();
@@ -119,6 +120,8 @@ protected:
     bool    m_bStepMode = false;        // step by step
     bool    m_bContinue = false;        // external function to continue
     bool    m_bCompile = false;     // compilation ok?
+    bool    m_bParallel = false;        // ContinueParallel() already run this frame?
+    bool    m_parallelEnd = false;      // result of ContinueParallel()
     char    m_title[50] = {};        // script title
     char    m_mainFunction[50] = {};
     char    m_filename[50] = {};     // file name
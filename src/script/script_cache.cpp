@@ -0,0 +1,106 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "script/script_cache.h"
+
+#include "common/make_unique.h"
+
+#include <cassert>
+
+
+CScriptCache::CScriptCache(std::size_t maxEntries)
+    : m_maxEntries(maxEntries)
+{
+    assert(maxEntries > 0);
+}
+
+CScriptCache::~CScriptCache()
+{
+}
+
+bool CScriptCache::Compile(CBotProgram* program, const char* source, ObjectType type,
+                           CBotStringArray& externFunctions, void* user)
+{
+    Key key{source, type};
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+    {
+        Entry& entry = it->second;
+        if (entry.version == CBotProgram::GetDefinitionVersion() &&
+            program->Share(entry.program.get(), externFunctions))
+        {
+            entry.lastUse = ++m_useCounter;
+            m_hits++;
+            return true;
+        }
+
+        // Compiled with other definitions, it may not even compile any more
+        m_entries.erase(it);
+    }
+
+    m_misses++;
+    if (!program->Compile(source, externFunctions, user))
+        return false;
+
+    // The code is kept alive by a program of our own, so that
+    // it outlives the robot which compiled it
+    auto cached = MakeUnique<CBotProgram>();
+    CBotStringArray unused;
+    if (!cached->Share(program, unused))
+        return true; // defines classes or public functions
+
+    if (m_entries.size() >= m_maxEntries)
+        RemoveOldest();
+
+    Entry& entry = m_entries[key];
+    entry.program = std::move(cached);
+    entry.version = CBotProgram::GetDefinitionVersion();
+    entry.lastUse = ++m_useCounter;
+    return true;
+}
+
+void CScriptCache::Clear()
+{
+    m_entries.clear();
+}
+
+std::size_t CScriptCache::GetCount() const
+{
+    return m_entries.size();
+}
+
+void CScriptCache::GetStats(long& hits, long& misses) const
+{
+    hits = m_hits;
+    misses = m_misses;
+}
+
+void CScriptCache::RemoveOldest()
+{
+    auto oldest = m_entries.end();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (oldest == m_entries.end() || it->second.lastUse < oldest->second.lastUse)
+            oldest = it;
+    }
+
+    if (oldest != m_entries.end())
+        m_entries.erase(oldest);
+}
@@ -0,0 +1,120 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file script/script_cache.h
+ * \brief CScriptCache - shares compiled code between identical robot programs
+ */
+
+#pragma once
+
+#include "CBot/CBotDll.h"
+
+#include "object/object_type.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+
+/**
+ * \class CScriptCache
+ * \brief Cache of compiled programs keyed by their source text
+ *
+ * When many robots carry the same program, or when a mission is restarted,
+ * the program is compiled only once and the other robots share its instruction
+ * tree (see CBotProgram::Share()). Each robot keeps its own execution stack.
+ *
+ * The key is the source text together with the type of the robot, as a few
+ * functions compile differently depending on it (e.g. fire()). An entry is
+ * only reused while CBotProgram::GetDefinitionVersion() is the one it was
+ * compiled with, i.e. no function, constant, class or public function was
+ * defined or removed since.
+ *
+ * Programs defining classes or public functions are never shared
+ * and are compiled each time.
+ */
+class CScriptCache
+{
+public:
+    //! Creates the cache; \a maxEntries is the number of distinct programs kept
+    explicit CScriptCache(std::size_t maxEntries = 256);
+    ~CScriptCache();
+
+    CScriptCache(const CScriptCache&) = delete;
+    CScriptCache& operator=(const CScriptCache&) = delete;
+
+    /**
+     * \brief Compiles \a source into \a program, reusing an identical program compiled before
+     * \param program program to set up
+     * \param source program text
+     * \param type type of the robot running the program
+     * \param externFunctions returns the names of functions declared as extern
+     * \param user passed to the compile functions (see CBotProgram::Compile())
+     * \return false on compilation error; the error is available with CBotProgram::GetError()
+     */
+    bool Compile(CBotProgram* program, const char* source, ObjectType type,
+                 CBotStringArray& externFunctions, void* user);
+
+    //! Removes all entries; programs already set up keep their code
+    void Clear();
+
+    //! Returns the number of programs in the cache
+    std::size_t GetCount() const;
+    //! Returns the number of compilations avoided and done since creation
+    void GetStats(long& hits, long& misses) const;
+
+private:
+    struct Key
+    {
+        std::string source;
+        ObjectType  type;
+
+        bool operator==(const Key& other) const
+        {
+            return type == other.type && source == other.source;
+        }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const
+        {
+            return std::hash<std::string>()(key.source) ^ (static_cast<std::size_t>(key.type) * 0x9E3779B9u);
+        }
+    };
+
+    struct Entry
+    {
+        std::unique_ptr<CBotProgram> program;   // holds the shared code
+        long version = 0;                       // CBotProgram::GetDefinitionVersion() at compile time
+        long lastUse = 0;
+    };
+
+    void RemoveOldest();
+
+private:
+    std::size_t m_maxEntries;
+    std::unordered_map<Key, Entry, KeyHash> m_entries;
+    long m_useCounter = 0;
+    long m_hits = 0;
+    long m_misses = 0;
+};
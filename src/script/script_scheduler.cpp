@@ -0,0 +1,49 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "script/script_scheduler.h"
+
+#include "common/make_unique.h"
+
+#include "common/thread/worker_pool.h"
+
+#include "script/script.h"
+
+
+CScriptScheduler::CScriptScheduler(int threadCount)
+    : m_pool(MakeUnique<CWorkerPool>(threadCount))
+{
+}
+
+CScriptScheduler::~CScriptScheduler()
+{
+}
+
+int CScriptScheduler::GetThreadCount() const
+{
+    return m_pool->GetThreadCount();
+}
+
+void CScriptScheduler::Run(const std::vector<CScript*>& scripts)
+{
+    m_pool->Run(static_cast<int>(scripts.size()), [&scripts](int i)
+    {
+        scripts[i]->ContinueParallel();
+    });
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file script/script_scheduler.h
+ * \brief CScriptScheduler - runs robot programs on worker threads
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+class CScript;
+class CWorkerPool;
+
+
+/**
+ * \class CScriptScheduler
+ * \brief Calls CScript::ContinueParallel() on a pool of worker threads
+ *
+ * Each frame, the programs of all running robots are advanced in parallel
+ * up to their first access to the game world (see CBotProgram::RunUntilExtern()).
+ * The rest of each program is then run by CScript::Continue() from the usual
+ * object loop on the main thread, so the game state is modified in the same
+ * order as without the scheduler.
+ *
+ * Programs are distributed over the threads by CWorkerPool.
+ */
+class CScriptScheduler
+{
+public:
+    //! Creates the pool; \a threadCount < 0 means one thread less than the number of cores
+    explicit CScriptScheduler(int threadCount = -1);
+    ~CScriptScheduler();
+
+    CScriptScheduler(const CScriptScheduler&) = delete;
+    CScriptScheduler& operator=(const CScriptScheduler&) = delete;
+
+    //! Returns the number of worker threads
+    int GetThreadCount() const;
+
+    //! Calls ContinueParallel() on all given scripts and waits for them to finish
+    void Run(const std::vector<CScript*>& scripts);
+
+private:
+    std::unique_ptr<CWorkerPool> m_pool;
+};
@@ -0,0 +1,239 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+#include "common/image.h"
+#include "common/logger.h"
+
+#include "common/resources/resourcemanager.h"
+
+#include "graphics/engine/texture_cache.h"
+
+#include <iostream>
+#include <string>
+
+using namespace Gfx;
+
+
+bool EndsWith(std::string const &fullString, std::string const &ending)
+{
+    if (fullString.length() >= ending.length())
+        return (0 == fullString.compare (fullString.length() - ending.length(), ending.length(), ending));
+    else
+        return false;
+}
+
+
+struct Args
+{
+    bool usage;
+    bool force;
+    std::string dataDir;
+    std::string saveDir;
+    std::string directory;
+
+    Args()
+    {
+        usage = false;
+        force = false;
+        directory = "textures";
+    }
+};
+
+Args ARGS;
+
+struct Stats
+{
+    int baked = 0;
+    int upToDate = 0;
+    int failed = 0;
+};
+
+void PrintUsage(const std::string& program)
+{
+    std::cerr << "Colobot texture cache builder" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Fills the texture cache for all PNG files in a directory of game data." << std::endl;
+    std::cerr << "The cache is read by the game from its save directory." << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Usage:" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << " Build cache:" << std::endl;
+    std::cerr << "   " << program << " -d data_dir -o save_dir [-p directory] [-f]" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << " Help:" << std::endl;
+    std::cerr << "   " << program << " -h" << std::endl;
+    std::cerr << std::endl;
+
+    std::cerr << "Options:" << std::endl;
+    std::cerr << " -p directory => directory in data to process (default: textures)" << std::endl;
+    std::cerr << " -f           => rebuild cache files which are up to date" << std::endl;
+}
+
+bool ParseArgs(int argc, char *argv[])
+{
+    bool waitD = false, waitO = false, waitP = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = std::string(argv[i]);
+
+        if (arg == "-d")
+        {
+            waitD = true;
+            continue;
+        }
+        if (arg == "-o")
+        {
+            waitO = true;
+            continue;
+        }
+        if (arg == "-p")
+        {
+            waitP = true;
+            continue;
+        }
+
+        if (waitD)
+        {
+            waitD = false;
+            ARGS.dataDir = arg;
+        }
+        else if (waitO)
+        {
+            waitO = false;
+            ARGS.saveDir = arg;
+        }
+        else if (waitP)
+        {
+            waitP = false;
+            ARGS.directory = arg;
+        }
+        else if (arg == "-h")
+        {
+            PrintUsage(argv[0]);
+            ARGS.usage = true;
+        }
+        else if (arg == "-f")
+        {
+            ARGS.force = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if (waitD || waitO || waitP)
+        return false;
+
+    if (ARGS.usage)
+        return true;
+
+    if (ARGS.dataDir.empty() || ARGS.saveDir.empty())
+        return false;
+
+    return true;
+}
+
+void BakeTexture(const CTextureCache& cache, const std::string& name, Stats& stats)
+{
+    uint64_t sourceHash = 0;
+    if (!CTextureCache::GetSourceHash(name, sourceHash))
+    {
+        std::cerr << "Could not read: " << name << std::endl;
+        stats.failed++;
+        return;
+    }
+
+    if (!ARGS.force && cache.Load(name, sourceHash) != nullptr)
+    {
+        stats.upToDate++;
+        return;
+    }
+
+    CImage image;
+    if (!image.Load(name))
+    {
+        std::cerr << "Could not load: " << name << ": " << image.GetError() << std::endl;
+        stats.failed++;
+        return;
+    }
+
+    // Converted as the game does before uploading; textures are not padded by default
+    int bpp = image.GetData()->surface->format->BytesPerPixel;
+    if (bpp != 3 && bpp != 4)
+        image.ConvertToRGBA();
+
+    if (!cache.Store(name, sourceHash, image, image.GetSize()))
+    {
+        std::cerr << "Could not store: " << name << std::endl;
+        stats.failed++;
+        return;
+    }
+
+    stats.baked++;
+}
+
+void BakeDirectory(const CTextureCache& cache, const std::string& directory, Stats& stats)
+{
+    for (const std::string& dir : CResourceManager::ListDirectories(directory))
+        BakeDirectory(cache, directory + "/" + dir, stats);
+
+    for (const std::string& file : CResourceManager::ListFiles(directory))
+    {
+        std::string name = directory + "/" + file;
+        if (EndsWith(file, ".png") && !CResourceManager::DirectoryExists(name))
+            BakeTexture(cache, name, stats);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    CLogger logger;
+    logger.SetLogLevel(LOG_ERROR);
+
+    if (!ParseArgs(argc, argv))
+    {
+        std::cerr << "Invalid arguments! Run with -h for usage info." << std::endl;
+        return 1;
+    }
+
+    if (ARGS.usage)
+        return 0;
+
+    CResourceManager resourceManager(argv[0]);
+    if (!CResourceManager::AddLocation(ARGS.dataDir) ||
+        !CResourceManager::SetSaveLocation(ARGS.saveDir))
+        return 1;
+
+    if (!CResourceManager::DirectoryExists(ARGS.directory))
+    {
+        std::cerr << "Directory not found in data: " << ARGS.directory << std::endl;
+        return 1;
+    }
+
+    CTextureCache cache;
+    Stats stats;
+    BakeDirectory(cache, ARGS.directory, stats);
+
+    std::cerr << "Baked: " << stats.baked << ", up to date: " << stats.upToDate
+              << ", failed: " << stats.failed << std::endl;
+
+    return stats.failed > 0 ? 1 : 0;
+}
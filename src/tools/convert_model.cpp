@@ -17,15 +17,21 @@
  * along with this program. If not, see http://gnu.org/licenses
  */
 
+#include "common/ioutils.h"
 #include "common/logger.h"
 
+#include "graphics/model/model_groups.h"
 #include "graphics/model/model_input.h"
 #include "graphics/model/model_io_exception.h"
 #include "graphics/model/model_output.h"
 
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <sstream>
 
 using namespace Gfx;
 
@@ -43,6 +49,7 @@ struct Args
 {
     bool usage;
     bool dumpInfo;
+    int benchmarkLoads;
     std::string inputFile;
     std::string outputFile;
     std::string inputFormat;
@@ -52,6 +59,7 @@ struct Args
     {
         usage = false;
         dumpInfo = false;
+        benchmarkLoads = 0;
     }
 };
 
@@ -69,6 +77,9 @@ void PrintUsage(const std::string& program)
     std::cerr << " Dump info:" << std::endl;
     std::cerr << "   " << program << " -d -i input_file -if input_format" << std::endl;
     std::cerr << std::endl;
+    std::cerr << " Benchmark loading against grouped format:" << std::endl;
+    std::cerr << "   " << program << " -b count -i input_file -if input_format" << std::endl;
+    std::cerr << std::endl;
     std::cerr << " Help:" << std::endl;
     std::cerr << "   " << program << " -h" << std::endl;
     std::cerr << std::endl;
@@ -77,12 +88,14 @@ void PrintUsage(const std::string& program)
     std::cerr << " old       => old binary format" << std::endl;
     std::cerr << " new_bin   => new binary format" << std::endl;
     std::cerr << " new_txt   => new text format" << std::endl;
+    std::cerr << " grouped   => grouped binary format" << std::endl;
 }
 
 bool ParseArgs(int argc, char *argv[])
 {
     bool waitI = false, waitO = false;
     bool waitIf = false, waitOf = false;
+    bool waitB = false;
     for (int i = 1; i < argc; ++i)
     {
         std::string arg = std::string(argv[i]);
@@ -107,6 +120,11 @@ bool ParseArgs(int argc, char *argv[])
             waitOf = true;
             continue;
         }
+        if (arg == "-b")
+        {
+            waitB = true;
+            continue;
+        }
 
         if (waitI)
         {
@@ -128,6 +146,13 @@ bool ParseArgs(int argc, char *argv[])
             waitOf = false;
             ARGS.outputFormat = arg;
         }
+        else if (waitB)
+        {
+            waitB = false;
+            ARGS.benchmarkLoads = atoi(arg.c_str());
+            if (ARGS.benchmarkLoads <= 0)
+                return false;
+        }
         else if (arg == "-h")
         {
             PrintUsage(argv[0]);
@@ -143,16 +168,18 @@ bool ParseArgs(int argc, char *argv[])
         }
     }
 
-    if (waitI || waitO || waitIf || waitOf)
+    if (waitI || waitO || waitIf || waitOf || waitB)
         return false;
 
     if (ARGS.usage)
         return true;
 
-    if (ARGS.inputFile.empty() || (!ARGS.dumpInfo && ARGS.outputFile.empty() ))
+    bool onlyInput = ARGS.dumpInfo || ARGS.benchmarkLoads > 0;
+
+    if (ARGS.inputFile.empty() || (!onlyInput && ARGS.outputFile.empty() ))
         return false;
 
-    if (ARGS.inputFormat.empty() || (!ARGS.dumpInfo && ARGS.outputFormat.empty() ))
+    if (ARGS.inputFormat.empty() || (!onlyInput && ARGS.outputFormat.empty() ))
         return false;
 
     return true;
@@ -218,6 +245,136 @@ void DumpInfo(const CModel& model)
     std::cerr << std::endl;
 }
 
+bool ParseFormat(const std::string& name, ModelFormat& format)
+{
+    if (name == "old")
+        format = ModelFormat::Old;
+    else if (name == "new_bin")
+        format = ModelFormat::Binary;
+    else if (name == "new_txt")
+        format = ModelFormat::Text;
+    else if (name == "grouped")
+        format = ModelFormat::Grouped;
+    else
+        return false;
+
+    return true;
+}
+
+template<typename Func>
+double MeasureLoads(int count, Func load)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i)
+        load();
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count() / count;
+}
+
+//! Reads whole file, as the game maps grouped files into memory
+std::string ReadFile(const std::string& fileName)
+{
+    std::ifstream stream;
+    stream.open(fileName, std::ios_base::in | std::ios_base::binary);
+    if (!stream.good())
+        throw CModelIOException(std::string("Could not open file: ") + fileName);
+
+    std::ostringstream data;
+    data << stream.rdbuf();
+    return data.str();
+}
+
+//! Copies vertices of each group, as COldModelManager does when adding them to the engine
+std::size_t CopyGroups(const CModelGroups& groups)
+{
+    std::size_t copied = 0;
+    for (const ModelTriangleGroup& group : groups.GetGroups())
+    {
+        const VertexTex2* vertices = groups.GetVertices() + group.firstVertex;
+        std::vector<VertexTex2> groupVertices(vertices, vertices + group.vertexCount);
+        copied += groupVertices.size();
+    }
+    return copied;
+}
+
+/**
+ * \brief Compares loading of the input file with loading of grouped file made from it
+ *
+ * Both are read from disk and follow COldModelManager::LoadModel(). The input file
+ * is parsed and its triangles are grouped, which is what CEngine::AddBaseObjTriangles()
+ * does. The grouped file is read, the input file is hashed to check it is up to date
+ * and the groups are copied as in COldModelManager::LoadGroupedModel().
+ */
+void Benchmark(const CModel& model, ModelFormat inputFormat, int count)
+{
+    const CModelMesh* mesh = model.GetMesh("main");
+    if (mesh == nullptr)
+    {
+        std::cerr << "Main mesh not found!" << std::endl;
+        return;
+    }
+
+    std::string groupedFile = ARGS.inputFile + ".benchmark.gmod";
+    {
+        std::ifstream input;
+        input.open(ARGS.inputFile, std::ios_base::in | std::ios_base::binary);
+
+        CModelGroups groups;
+        groups.SetMesh(*mesh);
+        groups.SetSourceHash(IOUtils::HashStream(input));
+
+        std::ofstream stream;
+        stream.open(groupedFile, std::ios_base::out | std::ios_base::binary);
+        if (!stream.good())
+            throw CModelIOException(std::string("Could not open file: ") + groupedFile);
+
+        groups.Write(stream);
+    }
+
+    std::size_t copied = 0;
+
+    double inputTime = MeasureLoads(count, [&]()
+    {
+        std::ifstream stream;
+        stream.open(ARGS.inputFile, std::ios_base::in | std::ios_base::binary);
+        CModel loaded = ModelInput::Read(stream, inputFormat);
+
+        CModelGroups groups;
+        groups.SetMesh(*loaded.GetMesh("main"));
+        copied += CopyGroups(groups);
+    });
+
+    double hashTime = 0.0;
+    double groupedTime = MeasureLoads(count, [&]()
+    {
+        std::string data = ReadFile(groupedFile);
+        CModelGroups loaded;
+        loaded.Read(data.data(), data.size());
+
+        auto hashStart = std::chrono::steady_clock::now();
+        std::ifstream input;
+        input.open(ARGS.inputFile, std::ios_base::in | std::ios_base::binary);
+        if (IOUtils::HashStream(input) != loaded.GetSourceHash())
+            throw CModelIOException("Grouped model is out of date");
+        hashTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - hashStart).count();
+
+        copied += CopyGroups(loaded);
+    });
+    hashTime /= count;
+
+    std::size_t groupedSize = ReadFile(groupedFile).size();
+    std::size_t inputSize = ReadFile(ARGS.inputFile).size();
+    std::remove(groupedFile.c_str());
+
+    std::cerr << "---- Benchmark ----" << std::endl;
+    std::cerr << "Loads: " << count << std::endl;
+    std::cerr << "Triangles: " << mesh->GetTriangleCount() << ", vertices copied: " << copied << std::endl;
+    std::cerr << " " << ARGS.inputFormat << ": " << inputTime << " ms per load (" << inputSize << " bytes)" << std::endl;
+    std::cerr << " grouped: " << groupedTime << " ms per load (" << groupedSize << " bytes), "
+              << "of which hashing input: " << hashTime << " ms" << std::endl;
+}
+
 int main(int argc, char *argv[])
 {
     CLogger logger;
@@ -234,13 +391,7 @@ int main(int argc, char *argv[])
 
     ModelFormat inputFormat = ModelFormat::Old;
 
-    if (ARGS.inputFormat == "old")
-        inputFormat = ModelFormat::Old;
-    else if (ARGS.inputFormat == "new_bin")
-        inputFormat = ModelFormat::Binary;
-    else if (ARGS.inputFormat == "new_txt")
-        inputFormat = ModelFormat::Text;
-    else
+    if (!ParseFormat(ARGS.inputFormat, inputFormat))
     {
         std::cerr << "Invalid input format: " << ARGS.inputFormat << std::endl;
         return 1;
@@ -271,15 +422,25 @@ int main(int argc, char *argv[])
         return 0;
     }
 
+    if (ARGS.benchmarkLoads > 0)
+    {
+        try
+        {
+            Benchmark(model, inputFormat, ARGS.benchmarkLoads);
+        }
+        catch (const CModelIOException& e)
+        {
+            std::cerr << "Benchmark failed with error:" << std::endl;
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
     ModelFormat outputFormat = ModelFormat::Old;
 
-    if (ARGS.outputFormat == "old")
-        outputFormat = ModelFormat::Old;
-    else if (ARGS.outputFormat == "new_bin")
-        outputFormat = ModelFormat::Binary;
-    else if (ARGS.outputFormat == "new_txt")
-        outputFormat = ModelFormat::Text;
-    else
+    if (!ParseFormat(ARGS.outputFormat, outputFormat))
     {
         std::cerr << "Invalid output format: " << ARGS.outputFormat << std::endl;
         return 1;
@@ -291,7 +452,26 @@ int main(int argc, char *argv[])
         stream.open(ARGS.outputFile, std::ios_base::out | std::ios_base::binary);
         if (!stream.good())
             throw CModelIOException(std::string("Could not open file: ") + ARGS.inputFile);
-        ModelOutput::Write(model, stream, outputFormat);
+
+        if (outputFormat == ModelFormat::Grouped)
+        {
+            const CModelMesh* mesh = model.GetMesh("main");
+            if (mesh == nullptr)
+                throw CModelIOException("No main mesh found in model");
+
+            // The game uses the grouped file only as long as the input file is unchanged
+            std::ifstream input;
+            input.open(ARGS.inputFile, std::ios_base::in | std::ios_base::binary);
+
+            CModelGroups groups;
+            groups.SetMesh(*mesh);
+            groups.SetSourceHash(IOUtils::HashStream(input));
+            groups.Write(stream);
+        }
+        else
+        {
+            ModelOutput::Write(model, stream, outputFormat);
+        }
     }
     catch (const CModelIOException& e)
     {
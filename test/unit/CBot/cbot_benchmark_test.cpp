@@ -0,0 +1,167 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "CBot/CBotDll.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+
+namespace
+{
+
+const int STEPS_PER_RUN = 1000;
+
+const char* const ARITHMETIC_PROGRAM =
+    "extern void Main()\n"
+    "{\n"
+    "    int s = 0;\n"
+    "    float f = 0.0;\n"
+    "    for (int i = 0; i < 20000; i++)\n"
+    "    {\n"
+    "        s = (s + i * 3) % 1000;\n"
+    "        f = f * 0.5 + i / 4.0;\n"
+    "        if (s > 500 && f > 10.0) s = s - 1;\n"
+    "    }\n"
+    "}\n";
+
+const char* const SORT_PROGRAM =
+    "extern void Main()\n"
+    "{\n"
+    "    int[] a;\n"
+    "    int n = 100;\n"
+    "    for (int i = 0; i < n; i++) a[i] = (i * 7919) % 1000;\n"
+    "    for (int i = 0; i < n; i++)\n"
+    "    {\n"
+    "        for (int j = 0; j < n - 1 - i; j++)\n"
+    "        {\n"
+    "            if (a[j] > a[j+1]) { int t = a[j]; a[j] = a[j+1]; a[j+1] = t; }\n"
+    "        }\n"
+    "    }\n"
+    "}\n";
+
+const char* const FUNCTION_PROGRAM =
+    "float DistSquared(float x1, float y1, float x2, float y2)\n"
+    "{\n"
+    "    return (x2-x1)*(x2-x1) + (y2-y1)*(y2-y1);\n"
+    "}\n"
+    "extern void Main()\n"
+    "{\n"
+    "    float total = 0;\n"
+    "    for (int i = 0; i < 5000; i++) total += DistSquared(i, 0, 0, i % 100);\n"
+    "}\n";
+
+const char* const STRING_PROGRAM =
+    "extern void Main()\n"
+    "{\n"
+    "    string s = \"\";\n"
+    "    for (int i = 0; i < 2000; i++)\n"
+    "    {\n"
+    "        s += \"x\";\n"
+    "        string line = \"value \" + i + \" = \" + (i * 2);\n"
+    "        if (line == s) s = \"\";\n"
+    "    }\n"
+    "}\n";
+
+struct RunResult
+{
+    bool ok = false;
+    long runs = 0;
+    long heap = 0;
+    long pooled = 0;
+    long long microseconds = 0;
+};
+
+RunResult RunProgram(const char* source)
+{
+    RunResult result;
+
+    CBotProgram program;
+    CBotStringArray functions;
+    if (!program.Compile(source, functions) || !program.Start(functions[0]))
+        return result;
+
+    long heapBefore = 0, pooledBefore = 0;
+    CBotVar::GetAllocCount(heapBefore, pooledBefore);
+
+    auto start = std::chrono::steady_clock::now();
+    while (!program.Run(nullptr, STEPS_PER_RUN))
+        result.runs++;
+    auto end = std::chrono::steady_clock::now();
+
+    CBotVar::GetAllocCount(result.heap, result.pooled);
+    result.heap -= heapBefore;
+    result.pooled -= pooledBefore;
+    result.microseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    result.ok = program.GetError() == 0;
+    return result;
+}
+
+} // anonymous namespace
+
+
+class CBotBenchmarkTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        CBotProgram::Init();
+    }
+
+    void TearDown() override
+    {
+        CBotProgram::Free();
+    }
+};
+
+TEST_F(CBotBenchmarkTest, TemporariesAreReused)
+{
+    RunResult result = RunProgram(ARITHMETIC_PROGRAM);
+    ASSERT_TRUE(result.ok);
+
+    // Intermediate results come back from the free list,
+    // only the first ones are allocated on the heap
+    EXPECT_GT(result.pooled, 100000);
+    EXPECT_LT(result.heap, result.pooled / 100);
+}
+
+// Benchmark of the interpreter; run with --gtest_also_run_disabled_tests
+TEST_F(CBotBenchmarkTest, DISABLED_Benchmark)
+{
+    struct { const char* name; const char* source; } programs[] = {
+        { "arithmetic", ARITHMETIC_PROGRAM },
+        { "sort",       SORT_PROGRAM },
+        { "functions",  FUNCTION_PROGRAM },
+        { "strings",    STRING_PROGRAM },
+    };
+
+    for (const auto& program : programs)
+    {
+        RunResult result = RunProgram(program.source);
+        EXPECT_TRUE(result.ok);
+
+        long long steps = static_cast<long long>(result.runs + 1) * STEPS_PER_RUN;
+        std::cout << program.name << ": " << result.microseconds << " us, "
+                  << steps * 1000000 / std::max(result.microseconds, 1LL) << " steps/s, "
+                  << result.heap << " heap / " << result.pooled << " pooled variables" << std::endl;
+    }
+}
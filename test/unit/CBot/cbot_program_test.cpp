@@ -0,0 +1,379 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "CBot/CBotDll.h"
+
+#include "script/script_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+
+const char* const SUM_PROGRAM =
+    "float Twice(float x)\n"
+    "{\n"
+    "    return x * 2;\n"
+    "}\n"
+    "extern void Main()\n"
+    "{\n"
+    "    float total = 0;\n"
+    "    for (int i = 0; i < 10; i++) total += Twice(i);\n"
+    "    Result(total);\n"
+    "}\n";
+
+const char* const PUBLIC_PROGRAM =
+    "public float Twice(float x)\n"
+    "{\n"
+    "    return x * 2;\n"
+    "}\n"
+    "extern void Main()\n"
+    "{\n"
+    "    Result(Twice(1));\n"
+    "}\n";
+
+// Class shared by the programs below through a static field, defined by the first one
+const char* const SHARED_CLASS =
+    "public class SharedBox\n"
+    "{\n"
+    "    static SharedBox shared = null;\n"
+    "    static int counter = 0;\n"
+    "    int value = 1;\n"
+    "    synchronized void Add(int n)\n"
+    "    {\n"
+    "        value = (value * 3 + n) % 1000;\n"
+    "    }\n"
+    "}\n";
+
+// Mixes work on its own data with accesses to the instance shared with the other programs
+std::string SharingProgram(int id)
+{
+    std::string n = std::to_string(id);
+    return std::string(id == 1 ? SHARED_CLASS : "") +
+        "extern void Main()\n"
+        "{\n"
+        "    SharedBox own = new SharedBox();\n"
+        "    if (own.shared == null) own.shared = new SharedBox();\n"
+        "    SharedBox box = own.shared;\n"
+        "    int local[];\n"
+        "    for (int i = 0; i < 8; i++)\n"
+        "    {\n"
+        "        int sum = 0;\n"
+        "        for (int j = 0; j < 5; j++) sum += j * " + n + ";\n"
+        "        local[i] = sum;\n"
+        "        try\n"
+        "        {\n"
+        "            box.Add(" + n + " + local[i]);\n"
+        "            box.value = box.value + own.counter++;\n"
+        "            if (i == " + n + ") throw(" + n + ");\n"
+        "        }\n"
+        "        catch (true)\n"
+        "        {\n"
+        "            own.value += 10;\n"
+        "        }\n"
+        "        Log(" + n + " * 100000 + box.value * 100 + own.value);\n"
+        "    }\n"
+        "}\n";
+}
+
+// Log(value) keeps the values in the order of calls
+std::vector<int> g_log;
+std::thread::id g_mainThread;
+bool g_logOutsideMainThread = false;
+
+bool rLog(CBotVar* var, CBotVar* result, int& exception, void* user)
+{
+    if (std::this_thread::get_id() != g_mainThread)
+        g_logOutsideMainThread = true;
+
+    g_log.push_back(var->GetValInt());
+    return true;
+}
+
+CBotTypResult cLog(CBotVar* &var, void* user)
+{
+    if (var == nullptr) return CBotTypResult(CBotErrLowParam);
+    var = var->GetNext();
+    if (var != nullptr) return CBotTypResult(CBotErrOverParam);
+    return CBotTypResult(CBotTypVoid);
+}
+
+// Result(value) stores the value in the float given as pUser to Run()
+bool rResult(CBotVar* var, CBotVar* result, int& exception, void* user)
+{
+    *static_cast<float*>(user) = var->GetValFloat();
+    return true;
+}
+
+CBotTypResult cResult(CBotVar* &var, void* user)
+{
+    if (var == nullptr) return CBotTypResult(CBotErrLowParam);
+    var = var->GetNext();
+    if (var != nullptr) return CBotTypResult(CBotErrOverParam);
+    return CBotTypResult(CBotTypFloat);
+}
+
+// Program giving Result(value)
+std::string ResultProgram(int value)
+{
+    return "extern void Main()\n{\n    Result(" + std::to_string(value) + ");\n}\n";
+}
+
+// Compiles program through the cache and returns what it gives to Result()
+float CompileAndRun(CScriptCache& cache, const std::string& source, ObjectType type)
+{
+    CBotStringArray functions;
+    CBotProgram program;
+    if (!cache.Compile(&program, source.c_str(), type, functions, nullptr) ||
+        functions.GetSize() != 1 || !program.Start(functions[0]))
+        return -1.0f;
+
+    float result = -1.0f;
+    while (!program.Run(&result)) {}
+    return result;
+}
+
+// Runs the programs with the same steps per frame, either one after the other, or first
+// in parallel up to their first access outside of themselves and then in order,
+// and returns what they logged
+std::vector<int> RunSharingPrograms(bool parallel)
+{
+    const int PROGRAM_COUNT = 4;
+    const int STEPS_PER_FRAME = 13;
+
+    CBotStringArray functions;
+    std::vector<std::unique_ptr<CBotProgram>> programs;
+    for (int i = 0; i < PROGRAM_COUNT; ++i)
+    {
+        programs.emplace_back(new CBotProgram());
+        EXPECT_TRUE(programs[i]->Compile(SharingProgram(i + 1).c_str(), functions));
+        EXPECT_EQ(1, functions.GetSize());
+        EXPECT_TRUE(programs[i]->Start("Main"));
+    }
+
+    g_log.clear();
+    g_mainThread = std::this_thread::get_id();
+    g_logOutsideMainThread = false;
+
+    std::vector<bool> done(PROGRAM_COUNT, false);
+    std::vector<char> parallelDone(PROGRAM_COUNT, false);  // not vector<bool>, it is written by several threads
+    for (int frame = 0; frame < 10000; ++frame)
+    {
+        if (parallel)
+        {
+            std::vector<std::thread> threads;
+            for (int i = 0; i < PROGRAM_COUNT; ++i)
+            {
+                if (done[i]) continue;
+                threads.emplace_back([&programs, &parallelDone, i]()
+                {
+                    parallelDone[i] = programs[i]->RunUntilExtern(nullptr, STEPS_PER_FRAME);
+                });
+            }
+            for (std::thread& thread : threads)
+                thread.join();
+        }
+
+        bool allDone = true;
+        for (int i = 0; i < PROGRAM_COUNT; ++i)
+        {
+            if (done[i]) continue;
+
+            if (!parallel)
+                done[i] = programs[i]->Run(nullptr, STEPS_PER_FRAME);
+            else if (!parallelDone[i] && programs[i]->IsWaitingExtern())
+                done[i] = programs[i]->Resume(nullptr);
+            else
+                done[i] = parallelDone[i];
+
+            EXPECT_EQ(0, programs[i]->GetError());
+            allDone = allDone && done[i];
+        }
+        if (allDone) break;
+    }
+
+    for (int i = 0; i < PROGRAM_COUNT; ++i)
+        EXPECT_TRUE(done[i]);
+    EXPECT_FALSE(g_logOutsideMainThread);
+
+    // the program defining the class goes last
+    programs.erase(programs.begin() + 1, programs.end());
+    programs.clear();
+    return g_log;
+}
+
+} // anonymous namespace
+
+
+class CBotProgramTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        CBotProgram::Init();
+        CBotProgram::AddFunction("Result", rResult, cResult);
+        CBotProgram::AddFunction("Log", rLog, cLog);
+    }
+
+    void TearDown() override
+    {
+        CBotProgram::Free();
+    }
+};
+
+TEST_F(CBotProgramTest, SharedCodeKeepsOwnState)
+{
+    CBotStringArray functions;
+    auto compiled = std::unique_ptr<CBotProgram>(new CBotProgram());
+    ASSERT_TRUE(compiled->Compile(SUM_PROGRAM, functions));
+
+    CBotProgram first, second;
+    ASSERT_TRUE(first.Share(compiled.get(), functions));
+    ASSERT_EQ(1, functions.GetSize());
+    ASSERT_TRUE(second.Share(compiled.get(), functions));
+
+    // The code outlives the program which compiled it
+    compiled.reset();
+
+    ASSERT_TRUE(first.Start(functions[0]));
+    ASSERT_TRUE(second.Start(functions[0]));
+
+    // Interleaved runs don't disturb each other
+    float firstResult = 0.0f, secondResult = 0.0f;
+    bool firstDone = false, secondDone = false;
+    while (!firstDone || !secondDone)
+    {
+        if (!firstDone) firstDone = first.Run(&firstResult, 7);
+        if (!secondDone) secondDone = second.Run(&secondResult, 11);
+    }
+
+    EXPECT_EQ(0, first.GetError());
+    EXPECT_EQ(0, second.GetError());
+    EXPECT_FLOAT_EQ(90.0f, firstResult);
+    EXPECT_FLOAT_EQ(90.0f, secondResult);
+}
+
+TEST_F(CBotProgramTest, PublicFunctionsAreNotShared)
+{
+    CBotStringArray functions;
+    CBotProgram compiled, other;
+    ASSERT_TRUE(compiled.Compile(PUBLIC_PROGRAM, functions));
+    EXPECT_FALSE(other.Share(&compiled, functions));
+
+    CBotProgram empty;
+    EXPECT_FALSE(other.Share(&empty, functions));
+}
+
+TEST_F(CBotProgramTest, DefinitionVersion)
+{
+    long version = CBotProgram::GetDefinitionVersion();
+
+    CBotStringArray functions;
+    CBotProgram program;
+    ASSERT_TRUE(program.Compile(SUM_PROGRAM, functions));
+    EXPECT_EQ(version, CBotProgram::GetDefinitionVersion());
+
+    ASSERT_TRUE(program.Compile(PUBLIC_PROGRAM, functions));
+    EXPECT_NE(version, CBotProgram::GetDefinitionVersion());
+
+    version = CBotProgram::GetDefinitionVersion();
+    CBotProgram::DefineNum("TestConstant", 42);
+    EXPECT_NE(version, CBotProgram::GetDefinitionVersion());
+}
+
+TEST_F(CBotProgramTest, ScriptCacheSharesSameSourceAndType)
+{
+    CScriptCache cache;
+    long hits = 0, misses = 0;
+
+    EXPECT_FLOAT_EQ(1.0f, CompileAndRun(cache, ResultProgram(1), OBJECT_MOBILEwa));
+    EXPECT_FLOAT_EQ(1.0f, CompileAndRun(cache, ResultProgram(1), OBJECT_MOBILEwa));
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(1, misses);
+
+    // Other type or other source is compiled again
+    EXPECT_FLOAT_EQ(1.0f, CompileAndRun(cache, ResultProgram(1), OBJECT_MOBILEta));
+    EXPECT_FLOAT_EQ(2.0f, CompileAndRun(cache, ResultProgram(2), OBJECT_MOBILEwa));
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(3, misses);
+    EXPECT_EQ(3u, cache.GetCount());
+}
+
+TEST_F(CBotProgramTest, ScriptCacheRecompilesAfterNewDefinitions)
+{
+    CScriptCache cache;
+    long hits = 0, misses = 0;
+
+    EXPECT_FLOAT_EQ(1.0f, CompileAndRun(cache, ResultProgram(1), OBJECT_MOBILEwa));
+    CBotProgram::DefineNum("TestConstant", 42);
+    EXPECT_FLOAT_EQ(1.0f, CompileAndRun(cache, ResultProgram(1), OBJECT_MOBILEwa));
+
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(0, hits);
+    EXPECT_EQ(2, misses);
+    EXPECT_EQ(1u, cache.GetCount());
+
+    // The new entry is used again
+    EXPECT_FLOAT_EQ(1.0f, CompileAndRun(cache, ResultProgram(1), OBJECT_MOBILEwa));
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(1, hits);
+}
+
+TEST_F(CBotProgramTest, ScriptCacheRemovesLeastRecentlyUsed)
+{
+    CScriptCache cache(2);
+    long hits = 0, misses = 0;
+
+    CompileAndRun(cache, ResultProgram(1), OBJECT_MOBILEwa);
+    CompileAndRun(cache, ResultProgram(2), OBJECT_MOBILEwa);
+    CompileAndRun(cache, ResultProgram(1), OBJECT_MOBILEwa);  // 2 is now the oldest
+    CompileAndRun(cache, ResultProgram(3), OBJECT_MOBILEwa);
+    EXPECT_EQ(2u, cache.GetCount());
+
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(3, misses);
+
+    CompileAndRun(cache, ResultProgram(1), OBJECT_MOBILEwa);
+    CompileAndRun(cache, ResultProgram(3), OBJECT_MOBILEwa);
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(3, hits);
+    EXPECT_EQ(3, misses);
+
+    CompileAndRun(cache, ResultProgram(2), OBJECT_MOBILEwa);
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(4, misses);
+}
+
+TEST_F(CBotProgramTest, RunUntilExternGivesSameResultAsRun)
+{
+    std::vector<int> serial = RunSharingPrograms(false);
+    std::vector<int> parallel = RunSharingPrograms(true);
+
+    EXPECT_EQ(32u, serial.size());
+    EXPECT_EQ(serial, parallel);
+}
@@ -59,6 +59,16 @@ public:
     {
         return CApplication::CreateUpdateEvent();
     }
+
+    int PrepareFixedSteps() override
+    {
+        return CApplication::PrepareFixedSteps();
+    }
+
+    Event CreateFixedUpdateEvent() override
+    {
+        return CApplication::CreateFixedUpdateEvent();
+    }
 };
 
 class ApplicationUT : public testing::Test
@@ -325,3 +335,46 @@ TEST_F(ApplicationUT, UpdateEventTimeCalculation_SuspendingAndResumingSimulation
 
     TestCreateUpdateEvent(relTimeExact, absTimeExact, relTime, absTime, relTimeReal, absTimeReal);
 }
+
+TEST_F(ApplicationUT, UpdateEventTimeCalculation_FixedStep)
+{
+    const long long step = 10000000LL;
+    m_app->SetFixedStepRate(100);
+
+    // 1st frame -- two steps and a half
+
+    NextInstant(step * 5 / 2);
+
+    EXPECT_EQ(2, m_app->PrepareFixedSteps());
+    for (int i = 1; i <= 2; ++i)
+    {
+        Event event = m_app->CreateFixedUpdateEvent();
+        EXPECT_EQ(EVENT_FRAME, event.type);
+        EXPECT_FLOAT_EQ(step / 1e9f, event.rTime);
+        EXPECT_EQ(step, m_app->GetExactRelTime());
+        EXPECT_EQ(step * i, m_app->GetExactAbsTime());
+    }
+    EXPECT_EQ(step * 5 / 2, m_app->GetRealAbsTime());
+
+    // 2nd frame -- the remaining half step is carried over
+
+    NextInstant(step / 2);
+    EXPECT_EQ(1, m_app->PrepareFixedSteps());
+
+    // 3rd frame -- speed 2x
+
+    m_app->SetSimulationSpeed(2.0f);
+    NextInstant(step * 2);
+    EXPECT_EQ(4, m_app->PrepareFixedSteps());
+
+    // 4th frame -- a long frame doesn't make the simulation catch up
+
+    NextInstant(step * 1000);
+    EXPECT_EQ(5, m_app->PrepareFixedSteps());
+
+    // Suspended simulation
+
+    m_app->SuspendSimulation();
+    NextInstant(step * 10);
+    EXPECT_EQ(0, m_app->PrepareFixedSteps());
+}
@@ -0,0 +1,166 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "common/spatial_grid.h"
+
+#include "math/geometry.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+namespace
+{
+
+const float CELL_SIZE = 40.0f;
+const float MAP_SIZE = 3200.0f;
+
+std::vector<Math::Vector> GeneratePositions(int count)
+{
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<float> dist(-MAP_SIZE/2.0f, MAP_SIZE/2.0f);
+
+    std::vector<Math::Vector> positions;
+    for (int i = 0; i < count; ++i)
+        positions.push_back(Math::Vector(dist(gen), 0.0f, dist(gen)));
+
+    return positions;
+}
+
+std::vector<int> LinearScan(const std::vector<Math::Vector>& positions, Math::Vector center, float radius)
+{
+    std::vector<int> result;
+    for (int i = 0; i < static_cast<int>(positions.size()); ++i)
+    {
+        if (Math::DistanceProjected(positions[i], center) <= radius)
+            result.push_back(i);
+    }
+    return result;
+}
+
+std::vector<int> GridScan(const CSpatialGrid<int>& grid, const std::vector<Math::Vector>& positions,
+                          Math::Vector center, float radius, std::vector<int>& candidates)
+{
+    candidates.clear();
+    grid.Query(center, radius, candidates);
+
+    std::vector<int> result;
+    for (int i : candidates)
+    {
+        if (Math::DistanceProjected(positions[i], center) <= radius)
+            result.push_back(i);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // anonymous namespace
+
+
+TEST(SpatialGridTest, QueryMatchesLinearScan)
+{
+    std::vector<Math::Vector> positions = GeneratePositions(1000);
+
+    CSpatialGrid<int> grid(CELL_SIZE);
+    for (int i = 0; i < static_cast<int>(positions.size()); ++i)
+        grid.Insert(i, positions[i]);
+
+    EXPECT_EQ(1000u, grid.GetCount());
+
+    std::vector<int> candidates;
+    for (float radius : { 0.0f, 10.0f, 80.0f, 400.0f, 4000.0f })
+    {
+        for (int i = 0; i < 50; ++i)
+        {
+            Math::Vector center = positions[i * 7];
+            EXPECT_EQ(LinearScan(positions, center, radius), GridScan(grid, positions, center, radius, candidates));
+        }
+    }
+}
+
+TEST(SpatialGridTest, UpdateAndRemove)
+{
+    CSpatialGrid<int> grid(CELL_SIZE);
+    grid.Insert(1, Math::Vector(0.0f, 0.0f, 0.0f));
+    grid.Insert(2, Math::Vector(-500.0f, 0.0f, 500.0f));
+
+    std::vector<int> result;
+    grid.Query(Math::Vector(0.0f, 0.0f, 0.0f), 10.0f, result);
+    EXPECT_EQ(std::vector<int>{1}, result);
+
+    // Unknown items are not added by Update()
+    grid.Update(3, Math::Vector(0.0f, 0.0f, 0.0f));
+    EXPECT_FALSE(grid.Contains(3));
+
+    grid.Update(1, Math::Vector(-490.0f, 100.0f, 495.0f));
+    result.clear();
+    grid.Query(Math::Vector(0.0f, 0.0f, 0.0f), 10.0f, result);
+    EXPECT_TRUE(result.empty());
+
+    result.clear();
+    grid.Query(Math::Vector(-500.0f, 0.0f, 500.0f), 20.0f, result);
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ((std::vector<int>{1, 2}), result);
+
+    grid.Remove(2);
+    result.clear();
+    grid.Query(Math::Vector(-500.0f, 0.0f, 500.0f), 20.0f, result);
+    EXPECT_EQ(std::vector<int>{1}, result);
+
+    grid.Clear();
+    EXPECT_EQ(0u, grid.GetCount());
+}
+
+// Benchmark of linear scan vs grid query; run with --gtest_also_run_disabled_tests
+TEST(SpatialGridTest, DISABLED_Benchmark)
+{
+    const int queryCount = 10000;
+    const float radius = 80.0f; // radar() with 20 m range
+
+    for (int count : { 100, 1000, 5000 })
+    {
+        std::vector<Math::Vector> positions = GeneratePositions(count);
+
+        CSpatialGrid<int> grid(CELL_SIZE);
+        for (int i = 0; i < count; ++i)
+            grid.Insert(i, positions[i]);
+
+        std::size_t linearFound = 0, gridFound = 0;
+        std::vector<int> candidates;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int q = 0; q < queryCount; ++q)
+            linearFound += LinearScan(positions, positions[q % count], radius).size();
+        auto mid = std::chrono::steady_clock::now();
+        for (int q = 0; q < queryCount; ++q)
+            gridFound += GridScan(grid, positions, positions[q % count], radius, candidates).size();
+        auto end = std::chrono::steady_clock::now();
+
+        EXPECT_EQ(linearFound, gridFound);
+
+        auto linearTime = std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count();
+        auto gridTime = std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count();
+        std::cout << count << " objects: linear " << linearTime << " us, grid " << gridTime << " us" << std::endl;
+    }
+}
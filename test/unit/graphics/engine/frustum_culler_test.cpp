@@ -0,0 +1,118 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/frustum_culler.h"
+
+#include "math/geometry.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Gfx;
+
+
+namespace
+{
+
+//! Camera at origin looking along +X, with the same conventions as CEngine
+Math::Matrix CreateViewProjection()
+{
+    Math::Matrix proj, view, scale;
+    Math::LoadProjectionMatrix(proj, Math::PI / 2.0f, 1.0f, 1.0f, 100.0f);
+    Math::LoadViewMatrix(view, Math::Vector(0.0f, 0.0f, 0.0f), Math::Vector(1.0f, 0.0f, 0.0f), Math::Vector(0.0f, 1.0f, 0.0f));
+    Math::LoadScaleMatrix(scale, Math::Vector(1.0f, 1.0f, -1.0f));
+    return Math::MultiplyMatrices(proj, Math::MultiplyMatrices(scale, view));
+}
+
+} // anonymous namespace
+
+
+TEST(FrustumCullerTest, SphereVisibility)
+{
+    CFrustum frustum(CreateViewProjection());
+
+    EXPECT_TRUE(frustum.IsSphereVisible(Math::Vector(10.0f, 0.0f, 0.0f), 1.0f));
+    EXPECT_TRUE(frustum.IsSphereVisible(Math::Vector(50.0f, 20.0f, -20.0f), 1.0f));
+
+    // Behind, too far, outside the sides
+    EXPECT_FALSE(frustum.IsSphereVisible(Math::Vector(-10.0f, 0.0f, 0.0f), 1.0f));
+    EXPECT_FALSE(frustum.IsSphereVisible(Math::Vector(110.0f, 0.0f, 0.0f), 1.0f));
+    EXPECT_FALSE(frustum.IsSphereVisible(Math::Vector(10.0f, 20.0f, 0.0f), 1.0f));
+    EXPECT_FALSE(frustum.IsSphereVisible(Math::Vector(10.0f, 0.0f, -20.0f), 1.0f));
+
+    // Partially inside
+    EXPECT_TRUE(frustum.IsSphereVisible(Math::Vector(10.0f, 0.0f, 0.0f), 50.0f));
+    EXPECT_TRUE(frustum.IsSphereVisible(Math::Vector(-2.0f, 0.0f, 0.0f), 5.0f));
+
+    // Default frustum contains everything
+    EXPECT_TRUE(CFrustum().IsSphereVisible(Math::Vector(-1000.0f, 0.0f, 0.0f), 0.0f));
+}
+
+TEST(FrustumCullerTest, CullMatchesSphereTests)
+{
+    CFrustum frustum(CreateViewProjection());
+
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+    std::uniform_real_distribution<float> size(0.1f, 10.0f);
+
+    CFrustumCuller culler;
+    std::vector<int> expected;
+    for (int i = 0; i < 2000; ++i)
+    {
+        Math::Vector center(pos(gen), pos(gen), pos(gen));
+        float radius = size(gen);
+
+        culler.Add(i, center, radius);
+        if (frustum.IsSphereVisible(center, radius))
+            expected.push_back(i);
+    }
+    culler.Build();
+
+    EXPECT_EQ(2000, culler.GetCount());
+
+    std::vector<int> result;
+    culler.Cull(frustum, result);
+    std::sort(result.begin(), result.end());
+
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(expected, result);
+}
+
+TEST(FrustumCullerTest, Empty)
+{
+    CFrustumCuller culler;
+    culler.Build();
+
+    std::vector<int> result;
+    culler.Cull(CFrustum(CreateViewProjection()), result);
+    EXPECT_TRUE(result.empty());
+
+    culler.Add(1, Math::Vector(10.0f, 0.0f, 0.0f), 1.0f);
+    culler.Build();
+    culler.Cull(CFrustum(CreateViewProjection()), result);
+    EXPECT_EQ(std::vector<int>{1}, result);
+
+    culler.Clear();
+    culler.Build();
+    EXPECT_EQ(0, culler.GetCount());
+}
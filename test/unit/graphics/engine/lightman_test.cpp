@@ -187,3 +187,23 @@ TEST_F(LightManagerUT, LightSorting_SortingAccordingToDistance)
     std::vector<int> expectedLights = { 2, 1, 3 };
     CheckLightSorting(ENG_OBJTYPE_TERRAIN, expectedLights);
 }
+
+TEST_F(LightManagerUT, LightSorting_UnchangedLightsAreNotSetAgain)
+{
+    const int lightCount = 3;
+    const Math::Vector eyePos(0.0f, 0.0f, 0.0f);
+    PrepareLightTesting(lightCount, eyePos);
+
+    AddLight(1, LIGHT_PRI_LOW, true, true, Math::Vector(0.0f, 0.0f, 0.0f), ENG_OBJTYPE_NULL, ENG_OBJTYPE_NULL);
+    AddLight(2, LIGHT_PRI_LOW, true, true, Math::Vector(0.0f, 0.0f, 0.0f), ENG_OBJTYPE_NULL, ENG_OBJTYPE_TERRAIN);
+
+    std::vector<int> expectedLights = { 1, 2 };
+    CheckLightSorting(ENG_OBJTYPE_FIX, expectedLights);
+
+    // Same lights for other type of objects, nothing to set in the device
+    m_lightManager->UpdateDeviceLights(ENG_OBJTYPE_VEHICLE);
+
+    // Light 2 is not used for terrain
+    m_mocks.ExpectCall(m_device, CDevice::SetLightEnabled).With(1, false);
+    m_lightManager->UpdateDeviceLights(ENG_OBJTYPE_TERRAIN);
+}
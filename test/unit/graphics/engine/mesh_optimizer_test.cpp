@@ -0,0 +1,141 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/mesh_optimizer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+using namespace Gfx;
+
+
+namespace
+{
+
+// Triangle list of a regular grid of size x size quads, triangles in random order
+std::vector<VertexTex2> MakeShuffledGrid(int size)
+{
+    std::vector<std::array<VertexTex2, 3>> triangles;
+    for (int x = 0; x < size; ++x)
+    {
+        for (int y = 0; y < size; ++y)
+        {
+            VertexTex2 v00(Math::Vector(x, 0.0f, y));
+            VertexTex2 v10(Math::Vector(x + 1, 0.0f, y));
+            VertexTex2 v01(Math::Vector(x, 0.0f, y + 1));
+            VertexTex2 v11(Math::Vector(x + 1, 0.0f, y + 1));
+            triangles.push_back({{ v00, v10, v01 }});
+            triangles.push_back({{ v10, v11, v01 }});
+        }
+    }
+
+    std::mt19937 generator(7);
+    std::shuffle(triangles.begin(), triangles.end(), generator);
+
+    std::vector<VertexTex2> vertices;
+    for (const auto& triangle : triangles)
+        vertices.insert(vertices.end(), triangle.begin(), triangle.end());
+
+    return vertices;
+}
+
+std::vector<std::array<float, 9>> GetSortedTriangles(const std::vector<VertexTex2>& vertices, const std::vector<unsigned int>& indices)
+{
+    std::vector<std::array<float, 9>> triangles;
+    for (std::size_t i = 0; i < indices.size(); i += 3)
+    {
+        std::array<float, 9> triangle;
+        for (int k = 0; k < 3; ++k)
+        {
+            const Math::Vector& coord = vertices[indices[i + k]].coord;
+            triangle[k * 3] = coord.x;
+            triangle[k * 3 + 1] = coord.y;
+            triangle[k * 3 + 2] = coord.z;
+        }
+
+        // Same triangle regardless of the first vertex
+        std::array<float, 9> rotated = triangle;
+        for (int r = 1; r < 3; ++r)
+        {
+            std::rotate(rotated.begin(), rotated.begin() + 3, rotated.end());
+            triangle = std::min(triangle, rotated);
+        }
+        triangles.push_back(triangle);
+    }
+
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+} // anonymous namespace
+
+
+TEST(MeshOptimizerTest, WeldsSharedVertices)
+{
+    std::vector<VertexTex2> vertices = MakeShuffledGrid(4);
+
+    IndexedMesh mesh = WeldVertices(vertices.data(), vertices.size());
+
+    EXPECT_EQ(25u, mesh.vertices.size());
+    ASSERT_EQ(vertices.size(), mesh.indices.size());
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+        EXPECT_TRUE(Math::VectorsEqual(vertices[i].coord, mesh.vertices[mesh.indices[i]].coord));
+}
+
+TEST(MeshOptimizerTest, KeepsVerticesDifferingInTexCoords)
+{
+    VertexTex2 a(Math::Vector(0.0f, 0.0f, 0.0f), Math::Vector(), Math::Point(0.0f, 0.0f));
+    VertexTex2 b(Math::Vector(0.0f, 0.0f, 0.0f), Math::Vector(), Math::Point(1.0f, 0.0f));
+    VertexTex2 c(Math::Vector(1.0f, 0.0f, 0.0f));
+    std::vector<VertexTex2> vertices = { a, c, a, b, c, b };
+
+    IndexedMesh mesh = WeldVertices(vertices.data(), vertices.size());
+
+    EXPECT_EQ(3u, mesh.vertices.size());
+    EXPECT_EQ((std::vector<unsigned int>{ 0, 1, 0, 2, 1, 2 }), mesh.indices);
+}
+
+TEST(MeshOptimizerTest, IndexedMeshKeepsTrianglesAndReducesCacheMisses)
+{
+    std::vector<VertexTex2> vertices = MakeShuffledGrid(32);
+
+    IndexedMesh welded = WeldVertices(vertices.data(), vertices.size());
+    IndexedMesh mesh = BuildIndexedMesh(vertices.data(), vertices.size());
+
+    EXPECT_EQ(welded.vertices.size(), mesh.vertices.size());
+    EXPECT_EQ(GetSortedTriangles(welded.vertices, welded.indices), GetSortedTriangles(mesh.vertices, mesh.indices));
+
+    float weldedRatio = GetAverageCacheMissRatio(welded.indices, welded.vertices.size());
+    float optimizedRatio = GetAverageCacheMissRatio(mesh.indices, mesh.vertices.size());
+    EXPECT_GT(weldedRatio, 2.0f);
+    EXPECT_LT(optimizedRatio, 1.0f);
+
+    // Vertices are in order of first use
+    unsigned int nextVertex = 0;
+    for (unsigned int index : mesh.indices)
+    {
+        ASSERT_LE(index, nextVertex);
+        if (index == nextVertex)
+            ++nextVertex;
+    }
+}
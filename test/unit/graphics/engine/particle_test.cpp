@@ -0,0 +1,92 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/particle.h"
+
+#include "app/system.h"
+
+#include "common/make_unique.h"
+
+#include "graphics/core/nulldevice.h"
+#include "graphics/engine/engine.h"
+
+#include <gtest/gtest.h>
+#include <hippomocks.h>
+
+#include <memory>
+
+using namespace Gfx;
+using namespace HippoMocks;
+
+class ParticleUT : public testing::Test
+{
+protected:
+    ~ParticleUT() NOEXCEPT
+    {}
+
+    void SetUp() override;
+    void TearDown() override;
+
+    MockRepository m_mocks;
+    CSystemUtils* m_systemUtils = nullptr;
+    CNullDevice m_device;
+    std::unique_ptr<CEngine> m_engine;
+    std::unique_ptr<CParticle> m_particle;
+};
+
+void ParticleUT::SetUp()
+{
+    m_systemUtils = m_mocks.Mock<CSystemUtils>();
+    m_mocks.OnCall(m_systemUtils, CSystemUtils::CreateTimeStamp).Return(nullptr);
+    m_mocks.OnCall(m_systemUtils, CSystemUtils::DestroyTimeStamp);
+
+    m_engine = MakeUnique<CEngine>(nullptr, m_systemUtils);
+    m_engine->SetDevice(&m_device);
+
+    m_particle = MakeUnique<CParticle>(m_engine.get());
+    m_particle->SetDevice(&m_device);
+}
+
+void ParticleUT::TearDown()
+{
+    m_particle.reset();
+    m_engine.reset();
+}
+
+TEST_F(ParticleUT, ParticlesOfSameIntensityShareDrawCall)
+{
+    const int count = 20;
+
+    // Two intensities, interleaved in creation order
+    for (int i = 0; i < count; i++)
+    {
+        Math::Vector pos(10.0f, 0.0f, static_cast<float>(i));
+        int channel = m_particle->CreateParticle(pos, Math::Vector(), Math::Point(1.0f, 1.0f), PARTIGLINT);
+        ASSERT_NE(-1, channel);
+        m_particle->SetIntensity(channel, i % 2 == 0 ? 0.25f : 0.75f);
+    }
+
+    long long before = m_device.GetDrawCallCount();
+    m_particle->DrawParticle(SH_WORLD);
+    long long drawCalls = m_device.GetDrawCallCount() - before;
+
+    // One draw call per particle without batching
+    EXPECT_LT(drawCalls, count);
+    EXPECT_EQ(2, drawCalls);
+}
@@ -0,0 +1,194 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+
+#include "graphics/engine/texture_recolor.h"
+
+#include "math/func.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Gfx;
+
+
+namespace
+{
+
+// The per-pixel color change as done before RecolorPixels()
+bool ReferenceRecolor(const RecolorParams& params, Color& color)
+{
+    if (params.hsv)
+    {
+        ColorHSV cr1 = RGB2HSV(params.colorRef1);
+        ColorHSV cn1 = RGB2HSV(params.colorNew1);
+        ColorHSV cr2 = RGB2HSV(params.colorRef2);
+        ColorHSV cn2 = RGB2HSV(params.colorNew2);
+
+        ColorHSV c = RGB2HSV(color);
+        ColorHSV from, to;
+        if (c.s > 0.01f && fabs(c.h - cr1.h) < params.tolerance1)
+        {
+            from = cr1;
+            to = cn1;
+        }
+        else if (params.tolerance2 != -1.0f && c.s > 0.01f && fabs(c.h - cr2.h) < params.tolerance2)
+        {
+            from = cr2;
+            to = cn2;
+        }
+        else
+        {
+            return false;
+        }
+
+        c.h += to.h - from.h;
+        c.s += to.s - from.s;
+        c.v += to.v - from.v;
+        if (c.h < 0.0f) c.h -= 1.0f;
+        if (c.h > 1.0f) c.h += 1.0f;
+        color = HSV2RGB(c);
+        color.r = Math::Norm(color.r + params.shift);
+        color.g = Math::Norm(color.g + params.shift);
+        color.b = Math::Norm(color.b + params.shift);
+        return true;
+    }
+
+    Color from, to;
+    if (fabs(color.r - params.colorRef1.r) +
+        fabs(color.g - params.colorRef1.g) +
+        fabs(color.b - params.colorRef1.b) < params.tolerance1 * 3.0f)
+    {
+        from = params.colorRef1;
+        to = params.colorNew1;
+    }
+    else if (params.tolerance2 != -1.0f &&
+             fabs(color.r - params.colorRef2.r) +
+             fabs(color.g - params.colorRef2.g) +
+             fabs(color.b - params.colorRef2.b) < params.tolerance2 * 3.0f)
+    {
+        from = params.colorRef2;
+        to = params.colorNew2;
+    }
+    else
+    {
+        return false;
+    }
+
+    color.r = Math::Norm(to.r + color.r - from.r + params.shift);
+    color.g = Math::Norm(to.g + color.g - from.g + params.shift);
+    color.b = Math::Norm(to.b + color.b - from.b + params.shift);
+    return true;
+}
+
+void ExpectSameAsReference(const RecolorParams& params)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    const int count = 10003;  // not a multiple of the SIMD width
+    std::vector<float> r(count), g(count), b(count);
+    std::vector<char> changed(count);
+    for (int i = 0; i < count; i++)
+    {
+        r[i] = dist(gen) / 255.0f;
+        g[i] = dist(gen) / 255.0f;
+        b[i] = dist(gen) / 255.0f;
+    }
+    // Grays and black
+    r[0] = g[0] = b[0] = 0.0f;
+    r[1] = g[1] = b[1] = 0.5f;
+
+    std::vector<float> r0 = r, g0 = g, b0 = b;
+    RecolorPixels(params, r.data(), g.data(), b.data(), changed.data(), count);
+
+    int changedCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        Color color(r0[i], g0[i], b0[i]);
+        bool expected = ReferenceRecolor(params, color);
+        ASSERT_EQ(expected, changed[i] != 0) << "pixel " << i;
+        EXPECT_EQ(color.r, r[i]) << "pixel " << i;
+        EXPECT_EQ(color.g, g[i]) << "pixel " << i;
+        EXPECT_EQ(color.b, b[i]) << "pixel " << i;
+        if (expected) changedCount++;
+    }
+
+    EXPECT_GT(changedCount, 0);
+}
+
+} // anonymous namespace
+
+
+TEST(TextureRecolorTest, HsvMatchesReference)
+{
+    RecolorParams params;
+    params.colorRef1 = Color(0.50f, 0.50f, 0.90f);
+    params.colorNew1 = Color(0.90f, 0.30f, 0.20f);
+    params.colorRef2 = Color(0.20f, 0.80f, 0.20f);
+    params.colorNew2 = Color(0.80f, 0.80f, 0.10f);
+    params.tolerance1 = 0.10f;
+    params.tolerance2 = 0.05f;
+    params.shift = 0.05f;
+    params.hsv = true;
+    ExpectSameAsReference(params);
+
+    params.tolerance2 = -1.0f;
+    params.shift = 0.0f;
+    ExpectSameAsReference(params);
+}
+
+TEST(TextureRecolorTest, RgbMatchesReference)
+{
+    RecolorParams params;
+    params.colorRef1 = Color(0.30f, 0.40f, 0.50f);
+    params.colorNew1 = Color(0.60f, 0.10f, 0.10f);
+    params.colorRef2 = Color(0.70f, 0.70f, 0.20f);
+    params.colorNew2 = Color(0.20f, 0.20f, 0.70f);
+    params.tolerance1 = 0.30f;
+    params.tolerance2 = 0.20f;
+    params.shift = -0.02f;
+    ExpectSameAsReference(params);
+}
+
+TEST(TextureRecolorTest, KeyDependsOnAllParameters)
+{
+    RecolorParams params;
+    params.colorNew1 = Color(1.0f, 0.0f, 0.0f);
+    Math::Point ts(0.0f, 0.0f), ti(1.0f, 1.0f);
+
+    std::string key = CTextureRecolorCache::GetKey("textures/objects/base1.png", params, ts, ti, nullptr);
+    EXPECT_EQ(key, CTextureRecolorCache::GetKey("textures/objects/base1.png", params, ts, ti, nullptr));
+    EXPECT_NE(key, CTextureRecolorCache::GetKey("textures/objects/base2.png", params, ts, ti, nullptr));
+
+    RecolorParams other = params;
+    other.colorNew1 = Color(0.0f, 1.0f, 0.0f);
+    EXPECT_NE(key, CTextureRecolorCache::GetKey("textures/objects/base1.png", other, ts, ti, nullptr));
+
+    other = params;
+    other.hsv = true;
+    EXPECT_NE(key, CTextureRecolorCache::GetKey("textures/objects/base1.png", other, ts, ti, nullptr));
+
+    Math::Point exclude[] = { Math::Point(0.0f, 0.5f), Math::Point(0.5f, 1.0f), Math::Point(0.0f, 0.0f), Math::Point(0.0f, 0.0f) };
+    EXPECT_NE(key, CTextureRecolorCache::GetKey("textures/objects/base1.png", params, ts, ti, exclude));
+    EXPECT_NE(key, CTextureRecolorCache::GetKey("textures/objects/base1.png", params, ts, Math::Point(0.5f, 1.0f), nullptr));
+}
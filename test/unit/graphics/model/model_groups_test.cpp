@@ -0,0 +1,115 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2015, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/model/model_groups.h"
+
+#include "graphics/model/model_io_exception.h"
+#include "graphics/model/model_io_structs.h"
+#include "graphics/model/model_mesh.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+using namespace Gfx;
+
+
+namespace
+{
+
+ModelTriangle MakeTriangle(const std::string& tex1Name, float z)
+{
+    ModelTriangle triangle;
+    triangle.p1.coord = Math::Vector(0.0f, 0.0f, z);
+    triangle.p2.coord = Math::Vector(1.0f, 0.0f, z);
+    triangle.p3.coord = Math::Vector(0.0f, 1.0f, z);
+    triangle.tex1Name = tex1Name;
+    return triangle;
+}
+
+} // anonymous namespace
+
+
+TEST(ModelGroupsTest, GroupsInOrderOfFirstTriangle)
+{
+    CModelMesh mesh;
+    mesh.AddTriangle(MakeTriangle("b.png", 0.0f));
+    mesh.AddTriangle(MakeTriangle("a.png", 1.0f));
+    mesh.AddTriangle(MakeTriangle("b.png", 2.0f));
+
+    CModelGroups groups;
+    groups.SetMesh(mesh);
+
+    ASSERT_EQ(2u, groups.GetGroups().size());
+    EXPECT_EQ("b.png", groups.GetGroups()[0].attributes.tex1Name);
+    EXPECT_EQ(0, groups.GetGroups()[0].firstVertex);
+    EXPECT_EQ(6, groups.GetGroups()[0].vertexCount);
+    EXPECT_EQ("a.png", groups.GetGroups()[1].attributes.tex1Name);
+    EXPECT_EQ(6, groups.GetGroups()[1].firstVertex);
+    EXPECT_EQ(3, groups.GetGroups()[1].vertexCount);
+    EXPECT_EQ(9, groups.GetVertexCount());
+    EXPECT_EQ(2.0f, groups.GetVertices()[3].coord.z);
+}
+
+TEST(ModelGroupsTest, ReadsWrittenFileFromMemory)
+{
+    CModelMesh mesh;
+    mesh.AddTriangle(MakeTriangle("b.png", 0.0f));
+    mesh.AddTriangle(MakeTriangle("a.png", 1.0f));
+    mesh.AddTriangle(MakeTriangle("b.png", 2.0f));
+
+    CModelGroups groups;
+    groups.SetMesh(mesh);
+    groups.SetSourceHash(0x0123456789abcdefULL);
+    std::ostringstream stream;
+    groups.Write(stream);
+    std::string data = stream.str();
+
+    CModelGroups loaded;
+    loaded.Read(data.data(), data.size());
+
+    EXPECT_EQ(0x0123456789abcdefULL, loaded.GetSourceHash());
+    ASSERT_EQ(2u, loaded.GetGroups().size());
+    EXPECT_EQ("a.png", loaded.GetGroups()[1].attributes.tex1Name);
+    EXPECT_EQ(9, loaded.GetVertexCount());
+    EXPECT_EQ(reinterpret_cast<const char*>(loaded.GetVertices()) - data.data(),
+              static_cast<std::ptrdiff_t>(sizeof(GroupedModelHeader) + 2 * sizeof(GroupedModelGroup)));
+
+    CModelMesh result = loaded.ToMesh();
+    ASSERT_EQ(3, result.GetTriangleCount());
+    EXPECT_EQ(2.0f, result.GetTriangles()[1].p1.coord.z);
+    EXPECT_EQ("a.png", result.GetTriangles()[2].tex1Name);
+}
+
+TEST(ModelGroupsTest, RejectsTruncatedFile)
+{
+    CModelMesh mesh;
+    mesh.AddTriangle(MakeTriangle("a.png", 0.0f));
+
+    CModelGroups groups;
+    groups.SetMesh(mesh);
+    std::ostringstream stream;
+    groups.Write(stream);
+    std::string data = stream.str();
+
+    CModelGroups loaded;
+    EXPECT_THROW(loaded.Read(data.data(), data.size() - 1), CModelIOException);
+}
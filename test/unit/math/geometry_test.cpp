@@ -50,6 +50,39 @@ TEST(GeometryTest, RotateAngleTest)
     EXPECT_TRUE(Math::IsEqual(Math::RotateAngle(1.0f, -1.0f), 1.75f * Math::PI, TEST_TOLERANCE));
 }
 
+namespace
+{
+
+Math::Matrix MakeTransform(const Math::Vector& pos, float angleY, float scale)
+{
+    Math::Matrix translation, rotation, scaling;
+    Math::LoadTranslationMatrix(translation, pos);
+    Math::LoadRotationYMatrix(rotation, angleY);
+    Math::LoadScaleMatrix(scaling, Math::Vector(scale, scale, scale));
+    return Math::MultiplyMatrices(translation, Math::MultiplyMatrices(rotation, scaling));
+}
+
+} // anonymous namespace
+
+TEST(GeometryTest, InterpolateTransformTest)
+{
+    Math::Matrix a = MakeTransform(Math::Vector(1.0f, 2.0f, 3.0f), 0.2f, 2.0f);
+    Math::Matrix b = MakeTransform(Math::Vector(3.0f, 2.0f, -1.0f), 2.8f, 2.0f);
+
+    EXPECT_TRUE(Math::MatricesEqual(Math::InterpolateTransform(a, b, 0.0f), a, TEST_TOLERANCE));
+    EXPECT_TRUE(Math::MatricesEqual(Math::InterpolateTransform(a, b, 1.0f), b, TEST_TOLERANCE));
+
+    // Rotation is interpolated by angle and keeps the scale, unlike a linear blend of the matrices
+    Math::Matrix expected = MakeTransform(Math::Vector(2.0f, 2.0f, 1.0f), 1.5f, 2.0f);
+    EXPECT_TRUE(Math::MatricesEqual(Math::InterpolateTransform(a, b, 0.5f), expected, TEST_TOLERANCE));
+
+    // The shorter way around, from just below 2 pi to just above 0
+    a = MakeTransform(Math::Vector(), 2.0f * Math::PI - 0.1f, 1.0f);
+    b = MakeTransform(Math::Vector(), 0.3f, 1.0f);
+    expected = MakeTransform(Math::Vector(), 0.1f, 1.0f);
+    EXPECT_TRUE(Math::MatricesEqual(Math::InterpolateTransform(a, b, 0.5f), expected, TEST_TOLERANCE));
+}
+
 // Tests for other altered, complex or uncertain functions
 
 /*